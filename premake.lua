@@ -8,6 +8,16 @@ elseif not SDL_ROOT then
 	SDL_ROOT = ""
 end
 
+newoption {
+	trigger = "null-graphics",
+	description = "Build with a recording no-op OpenGL implementation and run windowless (for benchmarking without a GPU)"
+}
+
+newoption {
+	trigger = "no-simd",
+	description = "Build math code without SSE/NEON, using the scalar reference implementations only"
+}
+
 if _ACTION == "clean" then
 	os.rmdir(BUILD_DIR)
 end
@@ -41,6 +51,18 @@ project "MyGameFramework"
 	}
 	debugdir "."
 	
+	if _OPTIONS["null-graphics"] then
+		defines {
+			"NULL_GRAPHICS",
+		}
+	end
+	
+	if _OPTIONS["no-simd"] then
+		defines {
+			"NO_SIMD",
+		}
+	end
+	
 	---- PLATFORM SPECIFICS ----------------------------------------------------
 	configuration "vs*"
 		flags {
@@ -132,3 +154,91 @@ project "MyGameFramework"
 			"NDEBUG",
 		}
 		flags { "Optimize" }
+
+project "TextureConverter"
+	kind "ConsoleApp"
+	language "C++"
+	location (BUILD_DIR .. "/" .. _ACTION)
+	files {
+		"./tools/textureconverter/**.c*",
+		"./lib/stb/stb_image.c",
+	}
+	includedirs {
+		"./lib/stb",
+	}
+	
+	configuration "vs*"
+		defines {
+			"_CRT_SECURE_NO_WARNINGS",
+		}
+	
+	configuration "Debug"
+		defines {
+			"DEBUG",
+		}
+		flags { "Symbols" }
+	
+	configuration "Release"
+		defines {
+			"NDEBUG",
+		}
+		flags { "Optimize" }
+
+-- standalone benchmark tools which only link in the parts of the framework
+-- they test, along with anything else listed in fileList
+function benchmark_project(name, fileList)
+	project (name)
+		kind "ConsoleApp"
+		language "C++"
+		location (BUILD_DIR .. "/" .. _ACTION)
+		files (fileList)
+		includedirs {
+			"./lib/stl/include",
+			"./lib/portable-crt/include",
+			"./lib/eastl/include",
+		}
+		
+		if _OPTIONS["no-simd"] then
+			defines {
+				"NO_SIMD",
+			}
+		end
+		
+		configuration "vs*"
+			defines {
+				"_CRT_SECURE_NO_WARNINGS",
+			}
+		
+		-- DEBUG is left undefined, framework asserts need the rest of the
+		-- framework linked in
+		configuration "Debug"
+			flags { "Symbols" }
+		
+		configuration "Release"
+			defines {
+				"NDEBUG",
+			}
+			flags { "Optimize" }
+end
+
+benchmark_project("FrustumBenchmark", {
+	"./tools/frustumbenchmark/**.c*",
+	"./src/framework/math/frustum.cpp",
+	"./lib/eastl/**.c*",
+})
+
+benchmark_project("MathBenchmark", {
+	"./tools/mathbenchmark/**.c*",
+	"./src/framework/math/mathhelpers.cpp",
+})
+
+benchmark_project("BvhBenchmark", {
+	"./tools/bvhbenchmark/**.c*",
+	"./src/framework/log.cpp",
+	"./src/framework/file/memoryfile.cpp",
+	"./src/framework/math/boundingbox.cpp",
+	"./src/framework/math/intersectiontester.cpp",
+	"./src/framework/math/mathhelpers.cpp",
+	"./src/framework/math/trianglebvh.cpp",
+	"./lib/eastl/**.c*",
+})
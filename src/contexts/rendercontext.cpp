@@ -9,6 +9,7 @@
 #include "../framework/graphics/billboardspritebatch.h"
 #include "../framework/graphics/geometrydebugrenderer.h"
 #include "../framework/graphics/graphicsdevice.h"
+#include "../framework/graphics/rendercommandqueue.h"
 #include "../framework/graphics/renderstate.h"
 #include "../framework/graphics/spritebatch.h"
 #include "../framework/graphics/viewcontext.h"
@@ -27,6 +28,7 @@ RenderContext::RenderContext(GraphicsDevice *graphicsDevice, ContentManager *con
 	m_keyframeMeshRenderer = new KeyframeMeshRenderer();
 	m_skeletalMeshRenderer = new SkeletalMeshRenderer();
 	m_staticMeshRenderer = new StaticMeshRenderer();
+	m_renderCommandQueue = new RenderCommandQueue();
 
 	CalculateScreenScale();
 }
@@ -38,6 +40,7 @@ RenderContext::~RenderContext()
 	SAFE_DELETE(m_keyframeMeshRenderer);
 	SAFE_DELETE(m_skeletalMeshRenderer);
 	SAFE_DELETE(m_staticMeshRenderer);
+	SAFE_DELETE(m_renderCommandQueue);
 }
 
 void RenderContext::OnLoadGame()
@@ -46,8 +49,10 @@ void RenderContext::OnLoadGame()
 
 void RenderContext::OnPreRender()
 {
-	RENDERSTATE_DEFAULT.Apply();
-	BLENDSTATE_DEFAULT.Apply();
+	RENDERSTATE_DEFAULT.Apply(m_graphicsDevice);
+	BLENDSTATE_DEFAULT.Apply(m_graphicsDevice);
+
+	m_renderCommandQueue->Clear();
 
 	m_graphicsDevice->GetDebugRenderer()->Begin();
 	m_spriteBatch->Begin();
@@ -56,6 +61,9 @@ void RenderContext::OnPreRender()
 
 void RenderContext::OnPostRender()
 {
+	// draw queued commands first, so sprites/billboards get drawn on top
+	m_renderCommandQueue->Execute(m_graphicsDevice);
+
 	m_billboardSpriteBatch->End();
 	m_spriteBatch->End();
 	m_graphicsDevice->GetDebugRenderer()->End();
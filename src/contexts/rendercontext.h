@@ -10,6 +10,7 @@ class BillboardSpriteBatch;
 class ContentManager;
 class GraphicsDevice;
 class KeyframeMeshRenderer;
+class RenderCommandQueue;
 class SkeletalMeshRenderer;
 class SpriteBatch;
 class StaticMeshRenderer;
@@ -31,6 +32,7 @@ public:
 	KeyframeMeshRenderer* GetKeyframeMeshRenderer() const  { return m_keyframeMeshRenderer; }
 	SkeletalMeshRenderer* GetSkeletalMeshRenderer() const  { return m_skeletalMeshRenderer; }
 	StaticMeshRenderer* GetStaticMeshRenderer() const      { return m_staticMeshRenderer; }
+	RenderCommandQueue* GetRenderCommandQueue() const      { return m_renderCommandQueue; }
 
 	uint GetScreenScale() const                            { return m_screenScale; }
 
@@ -44,6 +46,7 @@ private:
 	KeyframeMeshRenderer *m_keyframeMeshRenderer;
 	SkeletalMeshRenderer *m_skeletalMeshRenderer;
 	StaticMeshRenderer *m_staticMeshRenderer;
+	RenderCommandQueue *m_renderCommandQueue;
 
 	uint m_screenScale;
 };
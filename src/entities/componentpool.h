@@ -0,0 +1,219 @@
+#ifndef __ENTITIES_COMPONENTPOOL_H_INCLUDED__
+#define __ENTITIES_COMPONENTPOOL_H_INCLUDED__
+
+#include "../framework/common.h"
+#include "../framework/debug.h"
+
+#include <stl/vector.h>
+
+#include "component.h"
+
+class Entity;
+
+const uint INVALID_COMPONENT_INDEX = 0xffffffff;
+
+/**
+ * Stores all of the components of a single type as a sparse set. The
+ * components are packed together in one array (in no particular order),
+ * alongside a parallel array of the entities they belong to. A second,
+ * sparse, array indexed by entity ID gives the position of an entity's
+ * component in the packed array, so looking one up takes constant time
+ * and iterating over all of them just walks an array.
+ *
+ * Removing a component moves the last component in the packed array into
+ * the removed one's place, so pointers to components of a type are only
+ * valid until the next time a component of that type is added or removed.
+ */
+class ComponentPoolBase
+{
+public:
+	virtual ~ComponentPoolBase()                           {}
+
+	/**
+	 * @return the number of components in this pool
+	 */
+	uint GetCount() const                                  { return m_entities.size(); }
+
+	/**
+	 * @return the entity that the component at the given index belongs to
+	 */
+	Entity* GetEntity(uint index) const                    { return m_entities[index]; }
+
+	/**
+	 * @return the index of the given entity's component in this pool, or
+	 *         INVALID_COMPONENT_INDEX if it doesn't have one
+	 */
+	uint GetIndexOf(uint entityId) const;
+
+	/**
+	 * @return true if the given entity has a component in this pool
+	 */
+	bool Has(uint entityId) const                          { return GetIndexOf(entityId) != INVALID_COMPONENT_INDEX; }
+
+	/**
+	 * @return the component at the given index
+	 */
+	virtual Component* GetComponentAt(uint index) = 0;
+
+	/**
+	 * Removes the given entity's component, if it has one.
+	 */
+	virtual void Remove(uint entityId) = 0;
+
+	/**
+	 * Removes all components.
+	 */
+	virtual void RemoveAll() = 0;
+
+	/**
+	 * @return a small, unique index for the component type T that can be
+	 *         used to quickly find its pool
+	 */
+	template<class T> static uint GetTypeIndex();
+
+protected:
+	uint AddIndex(Entity *entity, uint entityId);
+	uint RemoveIndex(uint entityId);
+	void RemoveAllIndices();
+
+private:
+	static uint GetNextTypeIndex();
+
+	stl::vector<uint> m_sparse;
+	stl::vector<Entity*> m_entities;
+	stl::vector<uint> m_entityIds;
+};
+
+inline uint ComponentPoolBase::GetIndexOf(uint entityId) const
+{
+	if (entityId >= m_sparse.size())
+		return INVALID_COMPONENT_INDEX;
+	else
+		return m_sparse[entityId];
+}
+
+inline uint ComponentPoolBase::AddIndex(Entity *entity, uint entityId)
+{
+	ASSERT(!Has(entityId));
+	if (entityId >= m_sparse.size())
+		m_sparse.resize(entityId + 1, INVALID_COMPONENT_INDEX);
+
+	uint index = m_entities.size();
+	m_sparse[entityId] = index;
+	m_entities.push_back(entity);
+	m_entityIds.push_back(entityId);
+	return index;
+}
+
+inline uint ComponentPoolBase::RemoveIndex(uint entityId)
+{
+	uint index = GetIndexOf(entityId);
+	if (index == INVALID_COMPONENT_INDEX)
+		return INVALID_COMPONENT_INDEX;
+
+	// fill the hole with the last entity so the packed arrays stay packed.
+	// the caller does the same with the component itself
+	uint last = m_entities.size() - 1;
+	m_entities[index] = m_entities[last];
+	m_entityIds[index] = m_entityIds[last];
+	m_sparse[m_entityIds[index]] = index;
+
+	m_entities.pop_back();
+	m_entityIds.pop_back();
+	m_sparse[entityId] = INVALID_COMPONENT_INDEX;
+
+	return index;
+}
+
+inline void ComponentPoolBase::RemoveAllIndices()
+{
+	m_sparse.clear();
+	m_entities.clear();
+	m_entityIds.clear();
+}
+
+template<class T>
+inline uint ComponentPoolBase::GetTypeIndex()
+{
+	static uint index = GetNextTypeIndex();
+	return index;
+}
+
+inline uint ComponentPoolBase::GetNextTypeIndex()
+{
+	static uint next = 0;
+	return next++;
+}
+
+/**
+ * Sparse set storage for all components of type T. See ComponentPoolBase.
+ */
+template<class T>
+class ComponentPool : public ComponentPoolBase
+{
+public:
+	/**
+	 * Adds a new component for an entity, which must not already have one.
+	 * @return the new component
+	 */
+	T* Add(Entity *entity, uint entityId);
+
+	/**
+	 * @return the given entity's component, or NULL if it doesn't have one
+	 */
+	T* Get(uint entityId);
+
+	/**
+	 * @return the component at the given index
+	 */
+	T* GetAt(uint index)                                   { return &m_components[index]; }
+
+	Component* GetComponentAt(uint index)                  { return &m_components[index]; }
+	void Remove(uint entityId);
+	void RemoveAll();
+
+private:
+	stl::vector<T> m_components;
+};
+
+template<class T>
+inline T* ComponentPool<T>::Add(Entity *entity, uint entityId)
+{
+	uint index = AddIndex(entity, entityId);
+	ASSERT(index == m_components.size());
+	m_components.push_back(T());
+	return &m_components[index];
+}
+
+template<class T>
+inline T* ComponentPool<T>::Get(uint entityId)
+{
+	uint index = GetIndexOf(entityId);
+	if (index == INVALID_COMPONENT_INDEX)
+		return NULL;
+	else
+		return &m_components[index];
+}
+
+template<class T>
+inline void ComponentPool<T>::Remove(uint entityId)
+{
+	uint index = RemoveIndex(entityId);
+	if (index == INVALID_COMPONENT_INDEX)
+		return;
+
+	uint last = m_components.size() - 1;
+	if (index != last)
+		m_components[index] = m_components[last];
+	m_components.pop_back();
+}
+
+template<class T>
+inline void ComponentPool<T>::RemoveAll()
+{
+	RemoveAllIndices();
+	m_components.clear();
+}
+
+#endif
+
@@ -3,9 +3,9 @@
 #include "entity.h"
 #include "entitymanager.h"
 
-Entity::Entity(EntityManager *entityManager)
+Entity::Entity()
 {
-	m_entityManager = entityManager;
+	m_entityManager = NULL;
 }
 
 Entity::~Entity()
@@ -3,15 +3,25 @@
 
 #include "../framework/common.h"
 
+#include "entityhandle.h"
 #include "entitymanager.h"
 #include "entitypreset.h"
 
+/**
+ * An entity owned by an EntityManager. Entities live in slots within their
+ * manager which are reused after an entity is removed, so a pointer to a
+ * removed entity may end up pointing at a different one later on. Use
+ * GetHandle() to get a reference that can be safely kept around instead.
+ */
 class Entity
 {
+	friend class EntityManager;
+
 public:
-	Entity(EntityManager *entityManager);
 	virtual ~Entity();
 
+	EntityHandle GetHandle() const                         { return m_handle; }
+
 	template<class T> T* Get() const;
 	template<class T> T* Add();
 	template<class T> void Remove();
@@ -21,7 +31,10 @@ public:
 	bool WasCreatedUsingPreset(ENTITYPRESET_TYPE type) const;
 
 protected:
+	Entity();
+
 	EntityManager *m_entityManager;
+	EntityHandle m_handle;
 };
 
 template<class T>
@@ -0,0 +1,64 @@
+#ifndef __ENTITIES_ENTITYHANDLE_H_INCLUDED__
+#define __ENTITIES_ENTITYHANDLE_H_INCLUDED__
+
+#include "../framework/common.h"
+
+/**
+ * Identifies an entity by the index of the slot it occupies in its
+ * EntityManager, plus the generation of that slot. A slot's generation is
+ * bumped every time the entity in it is removed, so a handle to a removed
+ * entity stays safely invalid even after its slot gets reused, unlike a
+ * plain Entity pointer. Handles are small and cheap to copy, so they can
+ * be kept around (e.g. in events) in place of Entity pointers.
+ */
+struct EntityHandle
+{
+	/**
+	 * Creates a null handle which doesn't refer to any entity.
+	 */
+	EntityHandle();
+
+	/**
+	 * Creates a handle with the specified properties.
+	 * @param index the index of the entity's slot
+	 * @param generation the generation of the entity's slot
+	 */
+	EntityHandle(uint index, uint generation);
+
+	/**
+	 * @return true if this handle doesn't refer to any entity
+	 */
+	bool IsNull() const                                    { return generation == 0; }
+
+	uint index;
+	uint generation;
+};
+
+#define NULL_ENTITY_HANDLE EntityHandle()
+
+bool operator==(const EntityHandle &left, const EntityHandle &right);
+bool operator!=(const EntityHandle &left, const EntityHandle &right);
+
+inline EntityHandle::EntityHandle()
+{
+	index = 0;
+	generation = 0;
+}
+
+inline EntityHandle::EntityHandle(uint index, uint generation)
+{
+	this->index = index;
+	this->generation = generation;
+}
+
+inline bool operator==(const EntityHandle &left, const EntityHandle &right)
+{
+	return (left.index == right.index && left.generation == right.generation);
+}
+
+inline bool operator!=(const EntityHandle &left, const EntityHandle &right)
+{
+	return !(left == right);
+}
+
+#endif
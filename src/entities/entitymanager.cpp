@@ -10,6 +10,7 @@
 EntityManager::EntityManager(EventManager *eventManager)
 {
 	m_eventManager = eventManager;
+	m_numEntities = 0;
 }
 
 EntityManager::~EntityManager()
@@ -18,6 +19,12 @@ EntityManager::~EntityManager()
 	RemoveAllSubsystems();
 	RemoveAllPresets();
 	RemoveAllGlobalComponents();
+
+	for (ComponentStore::iterator i = m_components.begin(); i != m_components.end(); ++i)
+		SAFE_DELETE(*i);
+
+	for (EntityBlockList::iterator i = m_entityBlocks.begin(); i != m_entityBlocks.end(); ++i)
+		SAFE_DELETE_ARRAY(*i);
 }
 
 void EntityManager::RemoveAllSubsystems()
@@ -43,11 +50,38 @@ void EntityManager::RemoveAllPresets()
 
 Entity* EntityManager::Add()
 {
-	Entity *entity = new Entity(this);
-	m_entities.insert(entity);
+	// reuse the slots of removed entities so the component pools' sparse
+	// arrays stay only as big as the most entities alive at once
+	uint index;
+	if (!m_freeEntityIndices.empty())
+	{
+		index = m_freeEntityIndices.back();
+		m_freeEntityIndices.pop_back();
+	}
+	else
+	{
+		index = m_generations.size();
+		if (index % ENTITY_BLOCK_SIZE == 0)
+			m_entityBlocks.push_back(new Entity[ENTITY_BLOCK_SIZE]);
+		m_generations.push_back(1);
+	}
+
+	Entity *entity = GetSlot(index);
+	entity->m_entityManager = this;
+	entity->m_handle = EntityHandle(index, m_generations[index]);
+	++m_numEntities;
+
 	return entity;
 }
 
+Entity* EntityManager::Get(EntityHandle handle) const
+{
+	if (!IsValid(handle))
+		return NULL;
+	else
+		return GetSlot(handle.index);
+}
+
 Entity* EntityManager::AddUsingPreset(ENTITYPRESET_TYPE preset, EntityPresetArgs *args)
 {
 	EntityPresetMap::iterator i = m_entityPresets.find(preset);
@@ -82,24 +116,34 @@ void EntityManager::Remove(Entity *entity)
 	if (!IsValid(entity))
 		return;
 
-	EntitySet::iterator itor = m_entities.find(entity);
-
 	RemoveAllComponentsFrom(entity);
-	
-	m_entities.erase(itor);
-	SAFE_DELETE(entity);
+	FreeSlot(entity->GetHandle().index);
+}
+
+void EntityManager::Remove(EntityHandle handle)
+{
+	if (!IsValid(handle))
+		return;
+
+	Remove(GetSlot(handle.index));
 }
 
 void EntityManager::RemoveAll()
 {
-	for (EntitySet::iterator i = m_entities.begin(); i != m_entities.end(); ++i)
+	for (ComponentStore::iterator i = m_components.begin(); i != m_components.end(); ++i)
+	{
+		if (*i != NULL)
+			(*i)->RemoveAll();
+	}
+
+	// go backwards so that the lowest indices end up being reused first
+	for (uint i = m_generations.size(); i > 0; --i)
 	{
-		Entity *entity = *i;
-		RemoveAllComponentsFrom(entity);
-		SAFE_DELETE(entity);
+		if (IsSlotInUse(i - 1))
+			FreeSlot(i - 1);
 	}
 
-	m_entities.clear();
+	ASSERT(m_numEntities == 0);
 }
 
 void EntityManager::RemoveAllComponentsFrom(Entity *entity)
@@ -108,27 +152,41 @@ void EntityManager::RemoveAllComponentsFrom(Entity *entity)
 	
 	for (ComponentStore::iterator i = m_components.begin(); i != m_components.end(); ++i)
 	{
-		EntityComponentsMap &entitiesWithComponent = i->second;
-		EntityComponentsMap::iterator j = entitiesWithComponent.find(entity);
-		if (j != entitiesWithComponent.end())
-		{
-			SAFE_DELETE(j->second);
-			entitiesWithComponent.erase(entity);
-		}
+		if (*i != NULL)
+			(*i)->Remove(entity->GetHandle().index);
 	}
 }
 
 bool EntityManager::IsValid(const Entity *entity) const
 {
-	if (entity == NULL)
-		return false;
-	
-	// HACK: lol, this cast is aboslutely terrible and I shouldn't be doing this
-	EntitySet::const_iterator i = m_entities.find((Entity*)entity);
-	if (i == m_entities.end())
+	if (entity == NULL || entity->m_entityManager != this)
 		return false;
 	else
-		return true;
+		return IsValid(entity->GetHandle());
+}
+
+inline Entity* EntityManager::GetSlot(uint index) const
+{
+	return &m_entityBlocks[index / ENTITY_BLOCK_SIZE][index % ENTITY_BLOCK_SIZE];
+}
+
+inline bool EntityManager::IsSlotInUse(uint index) const
+{
+	return GetSlot(index)->GetHandle().generation == m_generations[index];
+}
+
+void EntityManager::FreeSlot(uint index)
+{
+	ASSERT(IsSlotInUse(index));
+
+	// any handles to the entity that was in this slot are now invalid.
+	// generation 0 is skipped so that null handles are never valid
+	++m_generations[index];
+	if (m_generations[index] == 0)
+		m_generations[index] = 1;
+
+	m_freeEntityIndices.push_back(index);
+	--m_numEntities;
 }
 
 void EntityManager::GetAllComponentsFor(const Entity *entity, ComponentList &list) const
@@ -139,10 +197,13 @@ void EntityManager::GetAllComponentsFor(const Entity *entity, ComponentList &lis
 	
 	for (ComponentStore::const_iterator i = m_components.begin(); i != m_components.end(); ++i)
 	{
-		const EntityComponentsMap &entitiesWithComponent = i->second;
-		EntityComponentsMap::const_iterator j = entitiesWithComponent.find(entity);
-		if (j != entitiesWithComponent.end())
-			list.push_back(j->second);
+		ComponentPoolBase *pool = *i;
+		if (pool == NULL)
+			continue;
+
+		uint index = pool->GetIndexOf(entity->GetHandle().index);
+		if (index != INVALID_COMPONENT_INDEX)
+			list.push_back(pool->GetComponentAt(index));
 	}
 }
 
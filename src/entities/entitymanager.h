@@ -6,9 +6,11 @@
 
 #include <stl/list.h>
 #include <stl/map.h>
-#include <stl/set.h>
+#include <stl/vector.h>
 
 #include "component.h"
+#include "componentpool.h"
+#include "entityhandle.h"
 #include "componentsystem.h"
 #include "entitypreset.h"
 #include "globalcomponent.h"
@@ -19,13 +21,17 @@ class RenderContext;
 
 typedef stl::list<Entity*> EntityList;
 typedef stl::list<Component*> ComponentList;
-typedef stl::set<Entity*> EntitySet;
-typedef stl::map<const Entity*, Component*> EntityComponentsMap;
-typedef stl::map<COMPONENT_TYPE, EntityComponentsMap> ComponentStore;
+typedef stl::vector<ComponentPoolBase*> ComponentStore;
+typedef stl::vector<uint> EntityIndexList;
+typedef stl::vector<Entity*> EntityBlockList;
+typedef stl::vector<uint> EntityGenerationList;
 typedef stl::list<ComponentSystem*> ComponentSystemList;
 typedef stl::map<ENTITYPRESET_TYPE, EntityPreset*> EntityPresetMap;
 typedef stl::map<GLOBAL_COMPONENT_TYPE, GlobalComponent*> GlobalComponentStore;
 
+// entities are allocated in blocks of this many at a time
+const uint ENTITY_BLOCK_SIZE = 256;
+
 class EntityManager
 {
 public:
@@ -45,20 +51,25 @@ public:
 	Entity* Add();
 	template<class T> Entity* AddUsingPreset(EntityPresetArgs *args = NULL);
 	Entity* AddUsingPreset(ENTITYPRESET_TYPE type, EntityPresetArgs *args = NULL);
+	Entity* Get(EntityHandle handle) const;
 	template<class T> Entity* GetWith() const;
 	template<class T> void GetAllWith(EntityList &matches) const;
 	template<class T> bool WasCreatedUsingPreset(Entity *entity) const;
 	bool WasCreatedUsingPreset(const Entity *entity, ENTITYPRESET_TYPE type) const;
 	void Remove(Entity *entity);
+	void Remove(EntityHandle handle);
 	void RemoveAll();
 	bool IsValid(const Entity *entity) const;
-	uint GetNumEntities() const                        { return m_entities.size(); }
+	bool IsValid(EntityHandle handle) const;
+	uint GetNumEntities() const                        { return m_numEntities; }
 
 	template<class T> T* AddComponent(Entity *entity);
 	template<class T> T* GetComponent(const Entity *entity) const;
+	template<class T> T* GetComponent(EntityHandle handle) const;
 	template<class T> void RemoveComponent(Entity *entity);
 	template<class T> bool HasComponent(const Entity *entity) const;
 	void GetAllComponentsFor(const Entity *entity, ComponentList &list) const;
+	template<class T> ComponentPool<T>* GetComponentPool() const;
 
 	template<class T> T* AddGlobalComponent();
 	template<class T> T* GetGlobalComponent() const;
@@ -77,8 +88,20 @@ public:
 private:
 	void RemoveAllComponentsFrom(Entity *entity);
 	template<class T> ComponentSystemList::const_iterator FindSubsystem() const;
+	template<class T> ComponentPool<T>* GetOrCreateComponentPool();
+
+	// Entity is only forward declared at this point, going through a
+	// template puts off needing its definition until this is instantiated
+	template<class TEntity> static uint GetEntityIndex(const TEntity *entity)  { return entity->GetHandle().index; }
+
+	Entity* GetSlot(uint index) const;
+	bool IsSlotInUse(uint index) const;
+	void FreeSlot(uint index);
 
-	EntitySet m_entities;
+	EntityBlockList m_entityBlocks;
+	EntityGenerationList m_generations;
+	EntityIndexList m_freeEntityIndices;
+	uint m_numEntities;
 	ComponentStore m_components;
 	GlobalComponentStore m_globalComponents;
 	ComponentSystemList m_componentSystems;
@@ -162,57 +185,73 @@ template<class T>
 T* EntityManager::AddComponent(Entity *entity)
 {
 	ASSERT(GetComponent<T>(entity) == NULL);
-	T* component = new T();
-	m_components[T::GetType()].insert(EntityComponentsMap::value_type(entity, component));
-	return component;
+	return GetOrCreateComponentPool<T>()->Add(entity, GetEntityIndex(entity));
 }
 
 template <class T>
 T* EntityManager::GetComponent(const Entity *entity) const
 {
-	ComponentStore::const_iterator i = m_components.find(T::GetType());
-	if (i == m_components.end())
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool == NULL)
+		return NULL;
+	else
+		return pool->Get(GetEntityIndex(entity));
+}
+
+template<class T>
+T* EntityManager::GetComponent(EntityHandle handle) const
+{
+	if (!IsValid(handle))
 		return NULL;
 
-	const EntityComponentsMap &entitiesWithComponent = i->second;
-	EntityComponentsMap::const_iterator j = entitiesWithComponent.find(entity);
-	if (j == entitiesWithComponent.end())
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool == NULL)
 		return NULL;
 	else
-		return j->second->As<T>();
+		return pool->Get(handle.index);
 }
 
 template<class T>
 void EntityManager::RemoveComponent(Entity *entity)
 {
-	ComponentStore::iterator i = m_components.find(T::GetType());
-	if (i == m_components.end())
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool == NULL)
 		return;
 
-	EntityComponentsMap &entitiesWithComponent = i->second;
-	EntityComponentsMap::iterator j = entitiesWithComponent.find(entity);
-	if (j == entitiesWithComponent.end())
-		return;
-	else
-	{
-		SAFE_DELETE(j->second);
-		entitiesWithComponent.erase(entity);
-	}
+	pool->Remove(GetEntityIndex(entity));
 }
 
 template<class T>
 bool EntityManager::HasComponent(const Entity *entity) const
 {
-	ComponentStore::const_iterator i = m_components.find(T::GetType());
-	if (i == m_components.end())
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool == NULL)
 		return false;
+	else
+		return pool->Has(GetEntityIndex(entity));
+}
 
-	const EntityComponentsMap &entitiesWithComponent = i->second;
-	EntityComponentsMap::const_iterator j = entitiesWithComponent.find(entity);
-	if (j == entitiesWithComponent.end())
-		return false;
+template<class T>
+ComponentPool<T>* EntityManager::GetComponentPool() const
+{
+	uint index = ComponentPoolBase::GetTypeIndex<T>();
+	if (index >= m_components.size())
+		return NULL;
 	else
-		return true;
+		return (ComponentPool<T>*)m_components[index];
+}
+
+template<class T>
+ComponentPool<T>* EntityManager::GetOrCreateComponentPool()
+{
+	uint index = ComponentPoolBase::GetTypeIndex<T>();
+	if (index >= m_components.size())
+		m_components.resize(index + 1, NULL);
+
+	if (m_components[index] == NULL)
+		m_components[index] = new ComponentPool<T>();
+
+	return (ComponentPool<T>*)m_components[index];
 }
 
 template<class T>
@@ -258,13 +297,9 @@ bool EntityManager::HasGlobalComponent() const
 template<class T>
 Entity* EntityManager::GetWith() const
 {
-	ComponentStore::const_iterator i = m_components.find(T::GetType());
-	if (i == m_components.end())
-		return NULL;
-
-	const EntityComponentsMap &entitiesWithComponent = i->second;
-	if (!entitiesWithComponent.empty())
-		return (Entity*)entitiesWithComponent.begin()->first;
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool != NULL && pool->GetCount() > 0)
+		return pool->GetEntity(0);
 	else
 		return NULL;
 }
@@ -272,13 +307,12 @@ Entity* EntityManager::GetWith() const
 template<class T>
 void EntityManager::GetAllWith(EntityList &matches) const
 {
-	ComponentStore::const_iterator i = m_components.find(T::GetType());
-	if (i == m_components.end())
+	ComponentPool<T> *pool = GetComponentPool<T>();
+	if (pool == NULL)
 		return;
 
-	const EntityComponentsMap &entitiesWithComponent = i->second;
-	for (EntityComponentsMap::const_iterator j = entitiesWithComponent.begin(); j != entitiesWithComponent.end(); ++j)
-		matches.push_back((Entity*)j->first);
+	for (uint i = 0; i < pool->GetCount(); ++i)
+		matches.push_back(pool->GetEntity(i));
 }
 
 template<class T>
@@ -303,5 +337,13 @@ ComponentSystemList::const_iterator EntityManager::FindSubsystem() const
 	return i;
 }
 
+inline bool EntityManager::IsValid(EntityHandle handle) const
+{
+	if (handle.index >= m_generations.size())
+		return false;
+	else
+		return m_generations[handle.index] == handle.generation;
+}
+
 #endif
 
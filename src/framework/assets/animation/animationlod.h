@@ -0,0 +1,70 @@
+#ifndef __FRAMEWORK_ASSETS_ANIMATION_ANIMATIONLOD_H_INCLUDED__
+#define __FRAMEWORK_ASSETS_ANIMATION_ANIMATIONLOD_H_INCLUDED__
+
+#include "../../common.h"
+#include "../../math/boundingsphere.h"
+
+const uint MAX_ANIMATION_LOD_UPDATE_INTERVAL = 4;
+
+/**
+ * Animation level of detail state for an animated mesh instance. Used by
+ * AnimationSystem to decide how often the instance's pose needs to be
+ * calculated based on how big it appears on screen. Instances without
+ * bounds set are always updated at full rate.
+ */
+struct AnimationLod
+{
+	AnimationLod();
+
+	/**
+	 * Sets the world-space bounds of the instance. Should be kept up to
+	 * date as the instance moves.
+	 * @param bounds the area the instance occupies
+	 */
+	void SetBounds(const BoundingSphere &bounds);
+
+	/**
+	 * Clears the instance's bounds, so it will always be updated at full rate.
+	 */
+	void ClearBounds();
+
+	BoundingSphere bounds;
+	bool hasBounds;
+
+	// when true, poses for updates in between calculated poses are blended
+	// from the previous two calculated poses instead of the last calculated
+	// pose just being held. this is smoother but shows the animation up to
+	// one update interval late
+	bool interpolate;
+
+	// results of the most recent update
+	bool isVisible;
+	bool isPoseUpdateNeeded;
+	uint updateInterval;
+	uint updatesSincePoseUpdate;
+	bool hasPoseHistory;
+};
+
+inline AnimationLod::AnimationLod()
+{
+	hasBounds = false;
+	interpolate = false;
+	isVisible = true;
+	isPoseUpdateNeeded = true;
+	updateInterval = 1;
+	updatesSincePoseUpdate = MAX_ANIMATION_LOD_UPDATE_INTERVAL;
+	hasPoseHistory = false;
+}
+
+inline void AnimationLod::SetBounds(const BoundingSphere &bounds)
+{
+	this->bounds = bounds;
+	hasBounds = true;
+}
+
+inline void AnimationLod::ClearBounds()
+{
+	hasBounds = false;
+}
+
+#endif
@@ -0,0 +1,301 @@
+#include "../../debug.h"
+
+#include "animationsystem.h"
+
+#include "keyframemeshinstance.h"
+#include "skeletalmeshanimationinstance.h"
+#include "skeletalmeshposecache.h"
+#include "../../math/camera.h"
+#include "../../math/frustum.h"
+#include "../../math/matrix4x4.h"
+#include "../../math/quaternion.h"
+#include "../../math/vector3.h"
+#include "../../util/workerthreadpool.h"
+#include <stl/algorithm.h>
+
+// advancing an instance's frame is very cheap, calculating a skeletal
+// mesh pose means evaluating every joint
+const uint FRAME_ADVANCE_INSTANCES_PER_BATCH = 64;
+const uint POSE_INSTANCES_PER_BATCH = 4;
+
+// fraction of the viewport's height covered by an instance below which it's
+// pose is only calculated every 2nd or 4th update
+const float DEFAULT_LOD_HALF_RATE_SCREEN_SIZE = 0.15f;
+const float DEFAULT_LOD_QUARTER_RATE_SCREEN_SIZE = 0.05f;
+
+AnimationSystem::AnimationSystem(WorkerThreadPool *workerThreads)
+{
+	ASSERT(workerThreads != NULL);
+	m_workerThreads = workerThreads;
+	m_poseCache = NULL;
+	m_lodCamera = NULL;
+	m_lodHalfRateScreenSize = DEFAULT_LOD_HALF_RATE_SCREEN_SIZE;
+	m_lodQuarterRateScreenSize = DEFAULT_LOD_QUARTER_RATE_SCREEN_SIZE;
+	m_delta = 0.0f;
+}
+
+AnimationSystem::~AnimationSystem()
+{
+	SAFE_DELETE(m_poseCache);
+}
+
+void AnimationSystem::Add(KeyframeMeshInstance *instance)
+{
+	ASSERT(instance != NULL);
+	ASSERT(stl::find(m_keyframeMeshInstances.begin(), m_keyframeMeshInstances.end(), instance) == m_keyframeMeshInstances.end());
+	m_keyframeMeshInstances.push_back(instance);
+}
+
+void AnimationSystem::Add(SkeletalMeshAnimationInstance *instance)
+{
+	ASSERT(instance != NULL);
+	ASSERT(stl::find(m_skeletalMeshInstances.begin(), m_skeletalMeshInstances.end(), instance) == m_skeletalMeshInstances.end());
+	m_skeletalMeshInstances.push_back(instance);
+}
+
+void AnimationSystem::Remove(KeyframeMeshInstance *instance)
+{
+	KeyframeMeshInstanceList::iterator i = stl::find(m_keyframeMeshInstances.begin(), m_keyframeMeshInstances.end(), instance);
+	if (i == m_keyframeMeshInstances.end())
+		return;
+
+	// update order doesn't matter, so avoid shifting everything after it
+	*i = m_keyframeMeshInstances.back();
+	m_keyframeMeshInstances.pop_back();
+}
+
+void AnimationSystem::Remove(SkeletalMeshAnimationInstance *instance)
+{
+	SkeletalMeshAnimationInstanceList::iterator i = stl::find(m_skeletalMeshInstances.begin(), m_skeletalMeshInstances.end(), instance);
+	if (i == m_skeletalMeshInstances.end())
+		return;
+
+	*i = m_skeletalMeshInstances.back();
+	m_skeletalMeshInstances.pop_back();
+}
+
+void AnimationSystem::RemoveAll()
+{
+	m_keyframeMeshInstances.clear();
+	m_skeletalMeshInstances.clear();
+}
+
+void AnimationSystem::EnablePoseCache(uint maxPoses, uint interpolationSteps)
+{
+	SAFE_DELETE(m_poseCache);
+	m_poseCache = new SkeletalMeshPoseCache(maxPoses, interpolationSteps);
+	ASSERT(m_poseCache != NULL);
+}
+
+void AnimationSystem::DisablePoseCache()
+{
+	SAFE_DELETE(m_poseCache);
+	m_sharedPoses.clear();
+}
+
+void AnimationSystem::SetLodScreenSizes(float halfRateScreenSize, float quarterRateScreenSize)
+{
+	ASSERT(halfRateScreenSize >= quarterRateScreenSize);
+	m_lodHalfRateScreenSize = halfRateScreenSize;
+	m_lodQuarterRateScreenSize = quarterRateScreenSize;
+}
+
+void AnimationSystem::OnUpdate(float delta)
+{
+	m_delta = delta;
+	m_workerThreads->ParallelFor(UpdateKeyframeMeshInstances, this, m_keyframeMeshInstances.size(), FRAME_ADVANCE_INSTANCES_PER_BATCH);
+
+	uint numSkeletalMeshInstances = m_skeletalMeshInstances.size();
+	if (m_poseCache == NULL)
+	{
+		m_workerThreads->ParallelFor(UpdateSkeletalMeshInstances, this, numSkeletalMeshInstances, POSE_INSTANCES_PER_BATCH);
+		return;
+	}
+
+	// the cache itself isn't thread-safe, so instead of looking up poses
+	// from the worker threads this is split into separate passes:
+	//   1. advance all instances to their new frame
+	//   2. look up the pose for every instance (on this thread)
+	//   3. calculate poses that weren't cached, storing them in the cache
+	//   4. copy cached poses to all instances that share them
+	m_workerThreads->ParallelFor(AdvanceSkeletalMeshInstances, this, numSkeletalMeshInstances, FRAME_ADVANCE_INSTANCES_PER_BATCH);
+	AssignSharedPoses();
+	m_workerThreads->ParallelFor(CalculateSkeletalMeshPoses, this, numSkeletalMeshInstances, POSE_INSTANCES_PER_BATCH);
+	m_workerThreads->ParallelFor(CopySharedSkeletalMeshPoses, this, numSkeletalMeshInstances, POSE_INSTANCES_PER_BATCH);
+}
+
+void AnimationSystem::AssignSharedPoses()
+{
+	m_poseCache->BeginUpdate();
+	m_sharedPoses.resize(m_skeletalMeshInstances.size());
+
+	for (uint i = 0; i < m_skeletalMeshInstances.size(); ++i)
+	{
+		SkeletalMeshAnimationInstance *instance = m_skeletalMeshInstances[i];
+		SharedPose &sharedPose = m_sharedPoses[i];
+
+		if (!instance->GetAnimationLod().isPoseUpdateNeeded || instance->HasFixedRootJointTransformation())
+		{
+			sharedPose.pose = NULL;
+			sharedPose.isCalculatedByThisInstance = false;
+			continue;
+		}
+
+		// the first instance to look up a pose that wasn't cached yet is
+		// the one that will calculate it for everyone else
+		bool isNew = false;
+		sharedPose.pose = m_poseCache->Get(instance->GetMesh(), instance->GetCurrentFrame(), instance->GetNextFrame(), instance->GetInterpolation(), &isNew);
+		sharedPose.isCalculatedByThisInstance = isNew;
+	}
+}
+
+void AnimationSystem::UpdateKeyframeMeshInstances(void *context, uint start, uint end)
+{
+	AnimationSystem *system = (AnimationSystem*)context;
+	for (uint i = start; i < end; ++i)
+		system->m_keyframeMeshInstances[i]->OnUpdate(system->m_delta);
+}
+
+void AnimationSystem::UpdateSkeletalMeshInstances(void *context, uint start, uint end)
+{
+	// each instance has it's own output and scratch buffers for pose
+	// evaluation, so separate instances can safely be updated at the same
+	// time even when they share the same mesh
+	AnimationSystem *system = (AnimationSystem*)context;
+	for (uint i = start; i < end; ++i)
+	{
+		SkeletalMeshAnimationInstance *instance = system->m_skeletalMeshInstances[i];
+		instance->OnUpdate(system->m_delta);
+		system->UpdateLod(instance);
+		if (instance->GetAnimationLod().isPoseUpdateNeeded)
+		{
+			instance->UpdatePose();
+			OnPoseUpdated(instance);
+		}
+	}
+}
+
+void AnimationSystem::AdvanceSkeletalMeshInstances(void *context, uint start, uint end)
+{
+	AnimationSystem *system = (AnimationSystem*)context;
+	for (uint i = start; i < end; ++i)
+	{
+		SkeletalMeshAnimationInstance *instance = system->m_skeletalMeshInstances[i];
+		instance->OnUpdate(system->m_delta);
+		system->UpdateLod(instance);
+	}
+}
+
+void AnimationSystem::CalculateSkeletalMeshPoses(void *context, uint start, uint end)
+{
+	AnimationSystem *system = (AnimationSystem*)context;
+	for (uint i = start; i < end; ++i)
+	{
+		SkeletalMeshAnimationInstance *instance = system->m_skeletalMeshInstances[i];
+		const SharedPose &sharedPose = system->m_sharedPoses[i];
+		if (!instance->GetAnimationLod().isPoseUpdateNeeded)
+			continue;
+
+		if (sharedPose.pose == NULL)
+		{
+			instance->UpdatePose();
+			OnPoseUpdated(instance);
+		}
+		else if (sharedPose.isCalculatedByThisInstance)
+		{
+			// every instance sharing this pose needs to end up with the exact
+			// same joints, so calculate it with the quantized interpolation
+			SkeletalMeshPose *pose = sharedPose.pose;
+			instance->UpdatePose(system->m_poseCache->QuantizeInterpolation(instance->GetInterpolation()));
+
+			const Vector3 *positions = instance->GetJointPositions();
+			const Quaternion *rotations = instance->GetJointRotations();
+			for (uint j = 0; j < pose->numJoints; ++j)
+			{
+				pose->positions[j] = positions[j];
+				pose->rotations[j] = rotations[j];
+			}
+			OnPoseUpdated(instance);
+		}
+	}
+}
+
+void AnimationSystem::CopySharedSkeletalMeshPoses(void *context, uint start, uint end)
+{
+	AnimationSystem *system = (AnimationSystem*)context;
+	for (uint i = start; i < end; ++i)
+	{
+		const SharedPose &sharedPose = system->m_sharedPoses[i];
+		if (sharedPose.pose != NULL && !sharedPose.isCalculatedByThisInstance)
+		{
+			SkeletalMeshAnimationInstance *instance = system->m_skeletalMeshInstances[i];
+			instance->SetPose(sharedPose.pose->positions, sharedPose.pose->rotations);
+			OnPoseUpdated(instance);
+		}
+	}
+}
+
+void AnimationSystem::UpdateLod(SkeletalMeshAnimationInstance *instance) const
+{
+	AnimationLod &lod = instance->GetAnimationLod();
+	CalculateLod(&lod);
+
+	if (!lod.isVisible)
+	{
+		// only the animation clock keeps going while out of view. the pose
+		// will be calculated right away once it's back in view
+		lod.isPoseUpdateNeeded = false;
+		lod.updatesSincePoseUpdate = MAX_ANIMATION_LOD_UPDATE_INTERVAL;
+		lod.hasPoseHistory = false;
+		return;
+	}
+
+	++lod.updatesSincePoseUpdate;
+	if (lod.updatesSincePoseUpdate >= lod.updateInterval)
+	{
+		lod.isPoseUpdateNeeded = true;
+		lod.updatesSincePoseUpdate = 0;
+	}
+	else
+	{
+		lod.isPoseUpdateNeeded = false;
+		instance->InterpolateHeldPose((float)lod.updatesSincePoseUpdate / (float)lod.updateInterval);
+	}
+}
+
+void AnimationSystem::CalculateLod(AnimationLod *lod) const
+{
+	lod->isVisible = true;
+	lod->updateInterval = 1;
+	if (m_lodCamera == NULL || !lod->hasBounds)
+		return;
+
+	const BoundingSphere &bounds = lod->bounds;
+	if (!m_lodCamera->GetFrustum()->Test(bounds))
+	{
+		lod->isVisible = false;
+		return;
+	}
+
+	float distance = Vector3::Distance(m_lodCamera->GetPosition(), bounds.center);
+	if (distance <= bounds.radius)
+		return;
+
+	// projection matrix's Y scale is cot(fov / 2), so this works out to the
+	// sphere's projected diameter over the viewport height
+	float screenSize = (bounds.radius * m_lodCamera->GetProjection().m[_22]) / distance;
+	if (screenSize < m_lodQuarterRateScreenSize)
+		lod->updateInterval = 4;
+	else if (screenSize < m_lodHalfRateScreenSize)
+		lod->updateInterval = 2;
+}
+
+void AnimationSystem::OnPoseUpdated(SkeletalMeshAnimationInstance *instance)
+{
+	// when interpolating, the pose shown always trails one update interval
+	// behind so that there are two calculated poses to blend between. at
+	// the update that a pose is calculated, that means showing the previous
+	// calculated pose
+	if (instance->GetAnimationLod().interpolate)
+		instance->InterpolateHeldPose(0.0f);
+}
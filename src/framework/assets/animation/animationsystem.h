@@ -0,0 +1,168 @@
+#ifndef __FRAMEWORK_ASSETS_ANIMATION_ANIMATIONSYSTEM_H_INCLUDED__
+#define __FRAMEWORK_ASSETS_ANIMATION_ANIMATIONSYSTEM_H_INCLUDED__
+
+#include "../../common.h"
+#include <stl/vector.h>
+
+class Camera;
+class KeyframeMeshInstance;
+class SkeletalMeshAnimationInstance;
+class SkeletalMeshPoseCache;
+class WorkerThreadPool;
+struct AnimationLod;
+struct SkeletalMeshPose;
+
+typedef stl::vector<KeyframeMeshInstance*> KeyframeMeshInstanceList;
+typedef stl::vector<SkeletalMeshAnimationInstance*> SkeletalMeshAnimationInstanceList;
+
+/**
+ * Updates all registered animated mesh instances at once, spreading the
+ * work out over all available worker threads. For each instance the
+ * current animation frame is advanced and, for skeletal meshes, the joint
+ * positions and rotations for the new frame are calculated. Renderers
+ * then only need to upload the already calculated joints.
+ *
+ * Optionally, skeletal mesh instances can share calculated poses through
+ * a SkeletalMeshPoseCache. Instances at the same point in the same
+ * animation then only have it calculated once between all of them.
+ *
+ * Skeletal mesh instances that have bounds set in their AnimationLod can
+ * also have their pose calculated less often when they appear small on
+ * screen, and not at all when outside of the view (only their animation
+ * clock is advanced then).
+ *
+ * Instances are not owned by the animation system and must be removed
+ * from it before they are destroyed.
+ */
+class AnimationSystem
+{
+public:
+	/**
+	 * Creates an animation system.
+	 * @param workerThreads the worker threads to run updates on
+	 */
+	AnimationSystem(WorkerThreadPool *workerThreads);
+
+	virtual ~AnimationSystem();
+
+	/**
+	 * Registers a keyframe mesh instance to be updated.
+	 * @param instance the instance to add
+	 */
+	void Add(KeyframeMeshInstance *instance);
+
+	/**
+	 * Registers a skeletal mesh instance to be updated.
+	 * @param instance the instance to add
+	 */
+	void Add(SkeletalMeshAnimationInstance *instance);
+
+	/**
+	 * Stops updating a keyframe mesh instance.
+	 * @param instance the instance to remove
+	 */
+	void Remove(KeyframeMeshInstance *instance);
+
+	/**
+	 * Stops updating a skeletal mesh instance.
+	 * @param instance the instance to remove
+	 */
+	void Remove(SkeletalMeshAnimationInstance *instance);
+
+	/**
+	 * Removes all registered instances.
+	 */
+	void RemoveAll();
+
+	/**
+	 * @return the number of keyframe mesh instances being updated
+	 */
+	uint GetNumKeyframeMeshInstances() const               { return m_keyframeMeshInstances.size(); }
+
+	/**
+	 * @return the number of skeletal mesh instances being updated
+	 */
+	uint GetNumSkeletalMeshInstances() const               { return m_skeletalMeshInstances.size(); }
+
+	/**
+	 * Enables sharing of calculated poses between skeletal mesh instances
+	 * which are at the same point in the same animation. Instances with a
+	 * fixed root joint transformation never share their pose.
+	 * @param maxPoses the maximum number of poses to hold at once
+	 * @param interpolationSteps the number of distinct poses that can be
+	 *                           shared between each pair of keyframes.
+	 *                           fewer means poses are shared more often,
+	 *                           but animation will be less smooth
+	 */
+	void EnablePoseCache(uint maxPoses, uint interpolationSteps);
+
+	/**
+	 * Disables sharing of calculated poses. Every skeletal mesh instance
+	 * will calculate it's own pose.
+	 */
+	void DisablePoseCache();
+
+	/**
+	 * @return the pose cache being used, or NULL if it is not enabled.
+	 *         poses of a mesh should be removed from it before that
+	 *         mesh is freed
+	 */
+	SkeletalMeshPoseCache* GetPoseCache() const            { return m_poseCache; }
+
+	/**
+	 * Sets the camera used to determine animation level of detail.
+	 * @param camera the camera the scene is being viewed through, or NULL
+	 *               to update all instances at full rate
+	 */
+	void SetLodCamera(const Camera *camera)                { m_lodCamera = camera; }
+
+	/**
+	 * Sets the on-screen sizes below which instance poses are calculated
+	 * less often.
+	 * @param halfRateScreenSize fraction of the viewport's height an
+	 *                           instance has to cover to be updated every
+	 *                           update. below this, every 2nd update
+	 * @param quarterRateScreenSize fraction of the viewport's height below
+	 *                              which an instance is updated every 4th
+	 *                              update
+	 */
+	void SetLodScreenSizes(float halfRateScreenSize, float quarterRateScreenSize);
+
+	/**
+	 * Advances the animations of all registered instances and calculates
+	 * their new poses. Should be called once per update after any game
+	 * logic that changes animation sequences has run.
+	 * @param delta time since last update
+	 */
+	void OnUpdate(float delta);
+
+private:
+	struct SharedPose
+	{
+		SkeletalMeshPose *pose;
+		bool isCalculatedByThisInstance;
+	};
+
+	void AssignSharedPoses();
+	void UpdateLod(SkeletalMeshAnimationInstance *instance) const;
+	void CalculateLod(AnimationLod *lod) const;
+	static void OnPoseUpdated(SkeletalMeshAnimationInstance *instance);
+
+	static void UpdateKeyframeMeshInstances(void *context, uint start, uint end);
+	static void UpdateSkeletalMeshInstances(void *context, uint start, uint end);
+	static void AdvanceSkeletalMeshInstances(void *context, uint start, uint end);
+	static void CalculateSkeletalMeshPoses(void *context, uint start, uint end);
+	static void CopySharedSkeletalMeshPoses(void *context, uint start, uint end);
+
+	WorkerThreadPool *m_workerThreads;
+	KeyframeMeshInstanceList m_keyframeMeshInstances;
+	SkeletalMeshAnimationInstanceList m_skeletalMeshInstances;
+	SkeletalMeshPoseCache *m_poseCache;
+	stl::vector<SharedPose> m_sharedPoses;
+	const Camera *m_lodCamera;
+	float m_lodHalfRateScreenSize;
+	float m_lodQuarterRateScreenSize;
+	float m_delta;
+};
+
+#endif
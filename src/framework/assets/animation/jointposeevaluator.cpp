@@ -0,0 +1,248 @@
+#include "../../debug.h"
+
+#include "jointposeevaluator.h"
+
+#include "joint.h"
+#include "jointkeyframe.h"
+#include "skeletalmesh.h"
+#include "../../math/matrix4x4.h"
+#include "../../math/quaternion.h"
+#include "../../math/simdfloat4.h"
+#include "../../math/vector3.h"
+#include <math.h>
+
+JointPoseEvaluator::JointPoseEvaluator(const SkeletalMesh *mesh)
+{
+	ASSERT(mesh != NULL);
+
+	m_numJoints = mesh->GetNumJoints();
+	m_numFrames = mesh->GetNumFrames();
+
+	// pad out to a multiple of 4 so the SIMD loops never need to deal with
+	// a partial group of joints. padding joints are just identity transforms
+	m_numPaddedJoints = (m_numJoints + 3) & ~3;
+
+	m_parentIndices = new int[m_numJoints];
+	m_relative = new float[NUM_COMPONENTS * m_numPaddedJoints];
+	m_frames = new float[m_numFrames * NUM_COMPONENTS * m_numPaddedJoints];
+
+	for (uint i = 0; i < m_numPaddedJoints; ++i)
+	{
+		SetIdentity(m_relative, i);
+		for (uint j = 0; j < m_numFrames; ++j)
+			SetIdentity(GetFrame(j), i);
+	}
+
+	for (uint i = 0; i < m_numJoints; ++i)
+	{
+		const Joint *joint = &mesh->GetJoints()[i];
+		m_parentIndices[i] = joint->parentIndex;
+
+		// joint relative transforms are always built from just a translation
+		// and a rotation, so they break down into a quaternion + vector cleanly
+		Vector3 relativePosition = joint->relative.GetTranslation();
+		Quaternion relativeRotation = Quaternion::CreateFromRotationMatrix(joint->relative);
+		m_relative[POSITION_X * m_numPaddedJoints + i] = relativePosition.x;
+		m_relative[POSITION_Y * m_numPaddedJoints + i] = relativePosition.y;
+		m_relative[POSITION_Z * m_numPaddedJoints + i] = relativePosition.z;
+		m_relative[ROTATION_X * m_numPaddedJoints + i] = relativeRotation.x;
+		m_relative[ROTATION_Y * m_numPaddedJoints + i] = relativeRotation.y;
+		m_relative[ROTATION_Z * m_numPaddedJoints + i] = relativeRotation.z;
+		m_relative[ROTATION_W * m_numPaddedJoints + i] = relativeRotation.w;
+
+		for (uint j = 0; j < m_numFrames; ++j)
+		{
+			const JointKeyFrame *keyframe = &joint->frames[j];
+			float *frame = GetFrame(j);
+			frame[POSITION_X * m_numPaddedJoints + i] = keyframe->position.x;
+			frame[POSITION_Y * m_numPaddedJoints + i] = keyframe->position.y;
+			frame[POSITION_Z * m_numPaddedJoints + i] = keyframe->position.z;
+			frame[ROTATION_X * m_numPaddedJoints + i] = keyframe->rotation.x;
+			frame[ROTATION_Y * m_numPaddedJoints + i] = keyframe->rotation.y;
+			frame[ROTATION_Z * m_numPaddedJoints + i] = keyframe->rotation.z;
+			frame[ROTATION_W * m_numPaddedJoints + i] = keyframe->rotation.w;
+		}
+	}
+}
+
+JointPoseEvaluator::~JointPoseEvaluator()
+{
+	SAFE_DELETE_ARRAY(m_parentIndices);
+	SAFE_DELETE_ARRAY(m_relative);
+	SAFE_DELETE_ARRAY(m_frames);
+}
+
+void JointPoseEvaluator::SetIdentity(float *soa, uint joint)
+{
+	soa[POSITION_X * m_numPaddedJoints + joint] = 0.0f;
+	soa[POSITION_Y * m_numPaddedJoints + joint] = 0.0f;
+	soa[POSITION_Z * m_numPaddedJoints + joint] = 0.0f;
+	soa[ROTATION_X * m_numPaddedJoints + joint] = 0.0f;
+	soa[ROTATION_Y * m_numPaddedJoints + joint] = 0.0f;
+	soa[ROTATION_Z * m_numPaddedJoints + joint] = 0.0f;
+	soa[ROTATION_W * m_numPaddedJoints + joint] = 1.0f;
+}
+
+void JointPoseEvaluator::Evaluate(uint startFrame, uint endFrame, float interpolation, float *scratch, int fixedJoint, Vector3 *outPositions, Quaternion *outRotations) const
+{
+	ASSERT(startFrame < m_numFrames);
+	ASSERT(endFrame < m_numFrames);
+	ASSERT(scratch != NULL);
+	ASSERT(outPositions != NULL);
+	ASSERT(outRotations != NULL);
+
+	const float *frame1 = GetFrame(startFrame);
+	const float *frame2 = (startFrame != endFrame && interpolation > 0.0f ? GetFrame(endFrame) : NULL);
+	CalculateLocalPose(frame1, frame2, interpolation, scratch);
+
+	// concatenate each joint's local transform onto it's parent's final
+	// transform. this relies on parent joints always coming before any of
+	// their children, same as the joint matrix code always has
+	const uint n = m_numPaddedJoints;
+	for (uint i = 0; i < m_numJoints; ++i)
+	{
+		if ((int)i == fixedJoint)
+			continue;
+
+		Vector3 position(scratch[POSITION_X * n + i], scratch[POSITION_Y * n + i], scratch[POSITION_Z * n + i]);
+		Quaternion rotation(scratch[ROTATION_X * n + i], scratch[ROTATION_Y * n + i], scratch[ROTATION_Z * n + i], scratch[ROTATION_W * n + i]);
+
+		int parentIndex = m_parentIndices[i];
+		if (parentIndex != NO_JOINT)
+		{
+			ASSERT(parentIndex < (int)i);
+			const Quaternion &parentRotation = outRotations[parentIndex];
+			outPositions[i] = outPositions[parentIndex] + (position * parentRotation);
+			outRotations[i] = parentRotation * rotation;
+		}
+		else
+		{
+			outPositions[i] = position;
+			outRotations[i] = rotation;
+		}
+	}
+}
+
+void JointPoseEvaluator::CalculateLocalPose(const float *frame1, const float *frame2, float interpolation, float *out) const
+{
+	const uint n = m_numPaddedJoints;
+	const SimdFloat4 zero = SimdSplat(0.0f);
+	const SimdFloat4 one = SimdSplat(1.0f);
+	const SimdFloat4 two = SimdSplat(2.0f);
+	const SimdFloat4 t = SimdSplat(interpolation);
+
+	for (uint i = 0; i < n; i += 4)
+	{
+		SimdFloat4 px = SimdLoad(&frame1[POSITION_X * n + i]);
+		SimdFloat4 py = SimdLoad(&frame1[POSITION_Y * n + i]);
+		SimdFloat4 pz = SimdLoad(&frame1[POSITION_Z * n + i]);
+		SimdFloat4 qx = SimdLoad(&frame1[ROTATION_X * n + i]);
+		SimdFloat4 qy = SimdLoad(&frame1[ROTATION_Y * n + i]);
+		SimdFloat4 qz = SimdLoad(&frame1[ROTATION_Z * n + i]);
+		SimdFloat4 qw = SimdLoad(&frame1[ROTATION_W * n + i]);
+
+		if (frame2 != NULL)
+		{
+			// lerp translation
+			px = SimdMulAdd(SimdSub(SimdLoad(&frame2[POSITION_X * n + i]), px), t, px);
+			py = SimdMulAdd(SimdSub(SimdLoad(&frame2[POSITION_Y * n + i]), py), t, py);
+			pz = SimdMulAdd(SimdSub(SimdLoad(&frame2[POSITION_Z * n + i]), pz), t, pz);
+
+			// slerp rotation, taking the shortest path (same as Quaternion::Slerp)
+			SimdFloat4 bx = SimdLoad(&frame2[ROTATION_X * n + i]);
+			SimdFloat4 by = SimdLoad(&frame2[ROTATION_Y * n + i]);
+			SimdFloat4 bz = SimdLoad(&frame2[ROTATION_Z * n + i]);
+			SimdFloat4 bw = SimdLoad(&frame2[ROTATION_W * n + i]);
+
+			SimdFloat4 cosHalfAngle = SimdMul(qx, bx);
+			cosHalfAngle = SimdMulAdd(qy, by, cosHalfAngle);
+			cosHalfAngle = SimdMulAdd(qz, bz, cosHalfAngle);
+			cosHalfAngle = SimdMulAdd(qw, bw, cosHalfAngle);
+
+			SimdFloat4 sign = SimdNegMulAdd(two, SimdLessThanAsFloat(cosHalfAngle, zero), one);
+			bx = SimdMul(bx, sign);
+			by = SimdMul(by, sign);
+			bz = SimdMul(bz, sign);
+			bw = SimdMul(bw, sign);
+			cosHalfAngle = SimdMul(cosHalfAngle, sign);
+
+			// the blend weights need trig functions which aren't available as
+			// SIMD instructions, so these are done one joint at a time
+			float cosHalfAngles[4];
+			float blendA[4];
+			float blendB[4];
+			SimdStore(cosHalfAngles, cosHalfAngle);
+			for (uint j = 0; j < 4; ++j)
+			{
+				float c = cosHalfAngles[j];
+				if (c >= 1.0f)
+				{
+					blendA[j] = 1.0f;
+					blendB[j] = 0.0f;
+				}
+				else if (c < 0.99f)
+				{
+					float halfAngle = acosf(c);
+					float oneOverSinHalfAngle = 1.0f / sinf(halfAngle);
+					blendA[j] = sinf(halfAngle * (1.0f - interpolation)) * oneOverSinHalfAngle;
+					blendB[j] = sinf(halfAngle * interpolation) * oneOverSinHalfAngle;
+				}
+				else
+				{
+					blendA[j] = 1.0f - interpolation;
+					blendB[j] = interpolation;
+				}
+			}
+			SimdFloat4 wa = SimdLoad(blendA);
+			SimdFloat4 wb = SimdLoad(blendB);
+
+			qx = SimdMulAdd(qx, wa, SimdMul(bx, wb));
+			qy = SimdMulAdd(qy, wa, SimdMul(by, wb));
+			qz = SimdMulAdd(qz, wa, SimdMul(bz, wb));
+			qw = SimdMulAdd(qw, wa, SimdMul(bw, wb));
+
+			SimdFloat4 lengthSquared = SimdMul(qx, qx);
+			lengthSquared = SimdMulAdd(qy, qy, lengthSquared);
+			lengthSquared = SimdMulAdd(qz, qz, lengthSquared);
+			lengthSquared = SimdMulAdd(qw, qw, lengthSquared);
+			SimdFloat4 invLength = SimdInvSqrt(lengthSquared);
+			qx = SimdMul(qx, invLength);
+			qy = SimdMul(qy, invLength);
+			qz = SimdMul(qz, invLength);
+			qw = SimdMul(qw, invLength);
+		}
+
+		// local transform = relative * translation * rotation
+		// which, as a rotation + translation pair, is:
+		//   rotation = relativeRotation * rotation
+		//   translation = relativePosition + (relativeRotation applied to translation)
+		SimdFloat4 rx = SimdLoad(&m_relative[ROTATION_X * n + i]);
+		SimdFloat4 ry = SimdLoad(&m_relative[ROTATION_Y * n + i]);
+		SimdFloat4 rz = SimdLoad(&m_relative[ROTATION_Z * n + i]);
+		SimdFloat4 rw = SimdLoad(&m_relative[ROTATION_W * n + i]);
+
+		// t = 2 * cross(r.xyz, p)
+		SimdFloat4 tx = SimdMul(two, SimdNegMulAdd(rz, py, SimdMul(ry, pz)));
+		SimdFloat4 ty = SimdMul(two, SimdNegMulAdd(rx, pz, SimdMul(rz, px)));
+		SimdFloat4 tz = SimdMul(two, SimdNegMulAdd(ry, px, SimdMul(rx, py)));
+
+		// p' = p + (r.w * t) + cross(r.xyz, t)
+		SimdFloat4 outX = SimdAdd(SimdMulAdd(rw, tx, px), SimdNegMulAdd(rz, ty, SimdMul(ry, tz)));
+		SimdFloat4 outY = SimdAdd(SimdMulAdd(rw, ty, py), SimdNegMulAdd(rx, tz, SimdMul(rz, tx)));
+		SimdFloat4 outZ = SimdAdd(SimdMulAdd(rw, tz, pz), SimdNegMulAdd(ry, tx, SimdMul(rx, ty)));
+
+		SimdStore(&out[POSITION_X * n + i], SimdAdd(outX, SimdLoad(&m_relative[POSITION_X * n + i])));
+		SimdStore(&out[POSITION_Y * n + i], SimdAdd(outY, SimdLoad(&m_relative[POSITION_Y * n + i])));
+		SimdStore(&out[POSITION_Z * n + i], SimdAdd(outZ, SimdLoad(&m_relative[POSITION_Z * n + i])));
+
+		SimdFloat4 x = SimdMulAdd(rw, qx, SimdMulAdd(rx, qw, SimdNegMulAdd(rz, qy, SimdMul(ry, qz))));
+		SimdFloat4 y = SimdMulAdd(rw, qy, SimdMulAdd(ry, qw, SimdNegMulAdd(rx, qz, SimdMul(rz, qx))));
+		SimdFloat4 z = SimdMulAdd(rw, qz, SimdMulAdd(rz, qw, SimdNegMulAdd(ry, qx, SimdMul(rx, qy))));
+		SimdFloat4 w = SimdNegMulAdd(rz, qz, SimdNegMulAdd(ry, qy, SimdNegMulAdd(rx, qx, SimdMul(rw, qw))));
+
+		SimdStore(&out[ROTATION_X * n + i], x);
+		SimdStore(&out[ROTATION_Y * n + i], y);
+		SimdStore(&out[ROTATION_Z * n + i], z);
+		SimdStore(&out[ROTATION_W * n + i], w);
+	}
+}
@@ -0,0 +1,90 @@
+#ifndef __FRAMEWORK_ASSETS_ANIMATION_JOINTPOSEEVALUATOR_H_INCLUDED__
+#define __FRAMEWORK_ASSETS_ANIMATION_JOINTPOSEEVALUATOR_H_INCLUDED__
+
+#include "../../common.h"
+
+class SkeletalMesh;
+struct Quaternion;
+struct Vector3;
+
+/**
+ * Evaluates the final joint positions and rotations of a skeletal mesh
+ * for any (interpolated) pair of keyframes. Joint transforms are composed
+ * directly as rotation quaternion + translation vector pairs instead of
+ * going through 4x4 matrices. The mesh's keyframes and joint relative
+ * transforms are copied into a SoA (structure of arrays) layout so that
+ * the per-joint interpolation can be done 4 joints at a time with SIMD.
+ *
+ * One of these is shared by all instances of the same skeletal mesh.
+ * Evaluation writes only to caller-provided buffers so a single evaluator
+ * can be used by multiple threads at once.
+ */
+class JointPoseEvaluator
+{
+public:
+	/**
+	 * Creates a pose evaluator for the joints and keyframes of a mesh.
+	 * @param mesh the skeletal mesh to evaluate poses of
+	 */
+	JointPoseEvaluator(const SkeletalMesh *mesh);
+
+	virtual ~JointPoseEvaluator();
+
+	/**
+	 * @return the number of joints being evaluated
+	 */
+	uint GetNumJoints() const                              { return m_numJoints; }
+
+	/**
+	 * @return the number of keyframes available
+	 */
+	uint GetNumFrames() const                              { return m_numFrames; }
+
+	/**
+	 * @return the number of floats needed for the scratch buffer that
+	 *         must be passed to Evaluate
+	 */
+	uint GetScratchBufferSize() const                      { return NUM_COMPONENTS * m_numPaddedJoints; }
+
+	/**
+	 * Evaluates the final positions and rotations of all joints.
+	 * @param startFrame the keyframe to interpolate from
+	 * @param endFrame the keyframe to interpolate to
+	 * @param interpolation the amount to interpolate by between the start
+	 *                      and end keyframes (0.0 to 1.0)
+	 * @param scratch scratch buffer of at least GetScratchBufferSize()
+	 *                floats used to hold the intermediate local pose
+	 * @param fixedJoint index of a joint whose position and rotation in the
+	 *                   output arrays should be left as-is (and used as-is
+	 *                   by child joints), or NO_JOINT
+	 * @param outPositions array of GetNumJoints() positions to write to
+	 * @param outRotations array of GetNumJoints() rotations to write to
+	 */
+	void Evaluate(uint startFrame, uint endFrame, float interpolation, float *scratch, int fixedJoint, Vector3 *outPositions, Quaternion *outRotations) const;
+
+private:
+	enum COMPONENT
+	{
+		POSITION_X = 0,
+		POSITION_Y,
+		POSITION_Z,
+		ROTATION_X,
+		ROTATION_Y,
+		ROTATION_Z,
+		ROTATION_W,
+		NUM_COMPONENTS
+	};
+
+	float* GetFrame(uint frame) const                      { return &m_frames[frame * NUM_COMPONENTS * m_numPaddedJoints]; }
+	void SetIdentity(float *soa, uint joint);
+	void CalculateLocalPose(const float *frame1, const float *frame2, float interpolation, float *out) const;
+
+	uint m_numJoints;
+	uint m_numPaddedJoints;
+	uint m_numFrames;
+	int *m_parentIndices;
+	float *m_relative;
+	float *m_frames;
+};
+
+#endif
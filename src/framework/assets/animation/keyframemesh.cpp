@@ -11,7 +11,7 @@
 
 #include <string.h>
 
-KeyframeMesh::KeyframeMesh(const KeyframeMeshFile *file)
+KeyframeMesh::KeyframeMesh(const KeyframeMeshFile *file, GraphicsDevice *graphicsDevice)
 {
 	m_numFrames = file->GetNumFrames();
 	m_frames = new Keyframe*[m_numFrames];
@@ -52,16 +52,17 @@ KeyframeMesh::KeyframeMesh(const KeyframeMeshFile *file)
 	m_numVerticesPerFrame = file->GetNumVerticesPerFrame();
 
 	VERTEX_ATTRIBS attribs[] = {
-		VERTEX_V3,       // position for frame 1
-		VERTEX_V3,       // position for frame 2
-		VERTEX_V3,       // normal for frame 1
-		VERTEX_V3,       // normal for frame 2
+		VERTEX_POS_3D,
+		VERTEX_NORMAL,
 		VERTEX_TEXCOORD
 	};
 	
+	// every keyframe's vertices are written out once here, so rendering any
+	// pair of frames is just a matter of pointing the shader at them
 	m_vertices = new VertexBuffer();
 	ASSERT(m_vertices != NULL);
-	m_vertices->Initialize(attribs, 5, m_numVerticesPerFrame, BUFFEROBJECT_USAGE_STREAM);
+	m_vertices->Initialize(graphicsDevice, attribs, 3, m_numFrames * m_numVerticesPerFrame, BUFFEROBJECT_USAGE_STATIC);
+	BakeFrameVertices();
 }
 
 KeyframeMesh::~KeyframeMesh()
@@ -74,6 +75,28 @@ KeyframeMesh::~KeyframeMesh()
 	SAFE_DELETE(m_vertices);
 }
 
+void KeyframeMesh::BakeFrameVertices()
+{
+	for (uint i = 0; i < m_numFrames; ++i)
+	{
+		Keyframe *frame = m_frames[i];
+		uint pos = GetFrameBaseVertex(i);
+
+		for (uint j = 0; j < m_numTriangles; ++j)
+		{
+			const KeyframeMeshTriangle *triangle = &m_triangles[j];
+
+			for (uint k = 0; k < 3; ++k)
+			{
+				m_vertices->SetPosition3(pos, frame->GetVertices()[triangle->vertices[k]]);
+				m_vertices->SetNormal(pos, frame->GetNormals()[triangle->vertices[k]]);
+				m_vertices->SetTexCoord(pos, m_texCoords[triangle->textureCoords[k]]);
+				++pos;
+			}
+		}
+	}
+}
+
 const AnimationSequence* KeyframeMesh::GetAnimation(const stl::string &name) const
 {
 	AnimationList::const_iterator itor = m_animations.find(name);
@@ -7,6 +7,7 @@
 #include "../../content/content.h"
 #include "../../util/typesystem.h"
 
+class GraphicsDevice;
 class Keyframe;
 class KeyframeMeshFile;
 struct KeyframeMeshTriangle;
@@ -25,8 +26,10 @@ public:
 	/**
 	 * Creates a keyframe mesh object.
 	 * @param file the keyframe mesh file to load the mesh data from
+	 * @param graphicsDevice the graphics device to create the mesh's vertex
+	 *                       buffer on, or NULL to keep it client-side
 	 */
-	KeyframeMesh(const KeyframeMeshFile *file);
+	KeyframeMesh(const KeyframeMeshFile *file, GraphicsDevice *graphicsDevice = NULL);
 
 	virtual ~KeyframeMesh();
 
@@ -78,11 +81,23 @@ public:
 	const AnimationList* GetAnimations() const             { return &m_animations; }
 
 	/**
-	 * @return the mesh's vertex buffer
+	 * @return the mesh's vertex buffer. This contains the de-indexed 
+	 *         triangle vertices (position, normal, texture coordinate) of 
+	 *         every keyframe, one block of GetNumVerticesPerFrame() vertices
+	 *         after another in keyframe order
 	 */
 	VertexBuffer* GetVertices() const                      { return m_vertices; }
 
+	/**
+	 * @param frame the keyframe to get the vertices of
+	 * @return the index in the mesh's vertex buffer of the first vertex of
+	 *         the given keyframe
+	 */
+	uint GetFrameBaseVertex(uint frame) const              { return frame * m_numVerticesPerFrame; }
+
 private:
+	void BakeFrameVertices();
+
 	uint m_numFrames;
 	Keyframe **m_frames;
 	uint m_numTexCoords;
@@ -2,16 +2,17 @@
 
 #include "keyframemeshrenderer.h"
 
-#include "keyframe.h"
 #include "keyframemesh.h"
 #include "keyframemeshinstance.h"
-#include "keyframemeshtriangle.h"
 #include "../../graphics/graphicsdevice.h"
 #include "../../graphics/renderstate.h"
 #include "../../graphics/texture.h"
 #include "../../graphics/vertexbuffer.h"
 #include "../../graphics/vertexlerpshader.h"
-#include "../../math/vector3.h"
+
+const uint KEYFRAMEMESH_POSITION_ATTRIB = 0;
+const uint KEYFRAMEMESH_NORMAL_ATTRIB = 1;
+const uint KEYFRAMEMESH_TEXCOORD_ATTRIB = 2;
 
 KeyframeMeshRenderer::KeyframeMeshRenderer()
 {
@@ -24,21 +25,21 @@ KeyframeMeshRenderer::~KeyframeMeshRenderer()
 void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMeshInstance *instance, VertexLerpShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	instance->GetRenderState()->Apply();
+	instance->GetRenderState()->Apply(graphicsDevice);
 	Render(graphicsDevice, instance->GetMesh(), instance->GetTexture(), instance->GetCurrentFrame(), instance->GetNextFrame(), instance->GetInterpolation(), shader);
 }
 
 void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMeshInstance *instance, uint frame, VertexLerpShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	instance->GetRenderState()->Apply();
+	instance->GetRenderState()->Apply(graphicsDevice);
 	Render(graphicsDevice, instance->GetMesh(), instance->GetTexture(), frame, shader);
 }
 
 void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMeshInstance *instance, uint startFrame, uint endFrame, float interpolation, VertexLerpShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	instance->GetRenderState()->Apply();
+	instance->GetRenderState()->Apply(graphicsDevice);
 	Render(graphicsDevice, instance->GetMesh(), instance->GetTexture(), instance->GetCurrentFrame(), instance->GetNextFrame(), instance->GetInterpolation(), shader);
 }
 
@@ -51,7 +52,7 @@ void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMesh *
 void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMesh *mesh, const Texture *texture, uint frame, VertexLerpShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	SetFrameVertices(mesh, frame);
+	ASSERT(frame < mesh->GetNumFrames());
 
 	if (texture != NULL)
 		graphicsDevice->BindTexture(texture);
@@ -59,14 +60,16 @@ void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMesh *
 	shader->SetLerp(0.0f);
 
 	graphicsDevice->BindVertexBuffer(mesh->GetVertices());
-	graphicsDevice->RenderTriangles();
+	BindFrames(graphicsDevice, mesh, frame, frame);
+	graphicsDevice->RenderTriangles(0, mesh->GetNumTriangles());
 	graphicsDevice->UnbindVertexBuffer();
 }
 
 void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMesh *mesh, const Texture *texture, uint startFrame, uint endFrame, float interpolation, VertexLerpShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	SetFrameVertices(mesh, startFrame, endFrame);
+	ASSERT(startFrame < mesh->GetNumFrames());
+	ASSERT(endFrame < mesh->GetNumFrames());
 
 	if (texture != NULL)
 		graphicsDevice->BindTexture(texture);
@@ -74,71 +77,23 @@ void KeyframeMeshRenderer::Render(GraphicsDevice *graphicsDevice, KeyframeMesh *
 	shader->SetLerp(interpolation);
 
 	graphicsDevice->BindVertexBuffer(mesh->GetVertices());
-	graphicsDevice->RenderTriangles();
+	BindFrames(graphicsDevice, mesh, startFrame, endFrame);
+	graphicsDevice->RenderTriangles(0, mesh->GetNumTriangles());
 	graphicsDevice->UnbindVertexBuffer();
 }
 
-void KeyframeMeshRenderer::SetFrameVertices(KeyframeMesh *mesh, uint frame)
-{
-	uint pos;
-	Keyframe *keyframe = mesh->GetFrames()[frame];
-	KeyframeMeshTriangle *triangle;
-	VertexBuffer *vertices = mesh->GetVertices();
-
-	for (uint i = 0; i < mesh->GetNumTriangles(); ++i)
-	{
-		pos = i * 3;
-		triangle = &mesh->GetTriangles()[i];
-
-		vertices->Set3f(0, pos, keyframe->GetVertices()[triangle->vertices[0]]);
-		vertices->Set3f(1, pos, ZERO_VECTOR);
-		vertices->Set3f(2, pos, keyframe->GetNormals()[triangle->vertices[0]]);
-		vertices->Set3f(3, pos, ZERO_VECTOR);
-		vertices->Set2f(4, pos, mesh->GetTexCoords()[triangle->textureCoords[0]]);
-
-		vertices->Set3f(0, pos + 1, keyframe->GetVertices()[triangle->vertices[1]]);
-		vertices->Set3f(1, pos + 1, ZERO_VECTOR);
-		vertices->Set3f(2, pos + 1, keyframe->GetNormals()[triangle->vertices[1]]);
-		vertices->Set3f(3, pos + 2, ZERO_VECTOR);
-		vertices->Set2f(4, pos + 1, mesh->GetTexCoords()[triangle->textureCoords[1]]);
-
-		vertices->Set3f(0, pos + 2, keyframe->GetVertices()[triangle->vertices[2]]);
-		vertices->Set3f(1, pos + 2, ZERO_VECTOR);
-		vertices->Set3f(2, pos + 2, keyframe->GetNormals()[triangle->vertices[2]]);
-		vertices->Set3f(3, pos + 2, ZERO_VECTOR);
-		vertices->Set2f(4, pos + 2, mesh->GetTexCoords()[triangle->textureCoords[2]]);
-	}
-}
-
-void KeyframeMeshRenderer::SetFrameVertices(KeyframeMesh *mesh, uint startFrame, uint endFrame)
+void KeyframeMeshRenderer::BindFrames(GraphicsDevice *graphicsDevice, KeyframeMesh *mesh, uint startFrame, uint endFrame)
 {
-	uint pos;
-	Keyframe *frame1 = mesh->GetFrames()[startFrame];
-	Keyframe *frame2 = mesh->GetFrames()[endFrame];
-	KeyframeMeshTriangle *triangle;
-	VertexBuffer *vertices = mesh->GetVertices();
-
-	for (uint i = 0; i < mesh->GetNumTriangles(); ++i)
-	{
-		pos = i * 3;
-		triangle = &mesh->GetTriangles()[i];
-
-		vertices->Set3f(0, pos, frame1->GetVertices()[triangle->vertices[0]]);
-		vertices->Set3f(1, pos, frame2->GetVertices()[triangle->vertices[0]]);
-		vertices->Set3f(2, pos, frame1->GetNormals()[triangle->vertices[0]]);
-		vertices->Set3f(3, pos, frame2->GetNormals()[triangle->vertices[0]]);
-		vertices->Set2f(4, pos, mesh->GetTexCoords()[triangle->textureCoords[0]]);
-
-		vertices->Set3f(0, pos + 1, frame1->GetVertices()[triangle->vertices[1]]);
-		vertices->Set3f(1, pos + 1, frame2->GetVertices()[triangle->vertices[1]]);
-		vertices->Set3f(2, pos + 1, frame1->GetNormals()[triangle->vertices[1]]);
-		vertices->Set3f(3, pos + 1, frame2->GetNormals()[triangle->vertices[1]]);
-		vertices->Set2f(4, pos + 1, mesh->GetTexCoords()[triangle->textureCoords[1]]);
-
-		vertices->Set3f(0, pos + 2, frame1->GetVertices()[triangle->vertices[2]]);
-		vertices->Set3f(1, pos + 2, frame2->GetVertices()[triangle->vertices[2]]);
-		vertices->Set3f(2, pos + 2, frame1->GetNormals()[triangle->vertices[2]]);
-		vertices->Set3f(3, pos + 2, frame2->GetNormals()[triangle->vertices[2]]);
-		vertices->Set2f(4, pos + 2, mesh->GetTexCoords()[triangle->textureCoords[2]]);
-	}
+	// the mesh's vertex buffer already holds every keyframe, so just point
+	// the attributes that vertex lerp shaders expect at the right frames:
+	//   0 = position for frame 1, 1 = position for frame 2,
+	//   2 = normal for frame 1, 3 = normal for frame 2, 4 = texture coords
+	uint start = mesh->GetFrameBaseVertex(startFrame);
+	uint end = mesh->GetFrameBaseVertex(endFrame);
+
+	graphicsDevice->RemapVertexAttribute(0, KEYFRAMEMESH_POSITION_ATTRIB, start);
+	graphicsDevice->RemapVertexAttribute(1, KEYFRAMEMESH_POSITION_ATTRIB, end);
+	graphicsDevice->RemapVertexAttribute(2, KEYFRAMEMESH_NORMAL_ATTRIB, start);
+	graphicsDevice->RemapVertexAttribute(3, KEYFRAMEMESH_NORMAL_ATTRIB, end);
+	graphicsDevice->RemapVertexAttribute(4, KEYFRAMEMESH_TEXCOORD_ATTRIB, start);
 }
@@ -81,8 +81,7 @@ public:
 	void Render(GraphicsDevice *graphicsDevice, KeyframeMesh *mesh, const Texture *texture, uint startFrame, uint endFrame, float interpolation, VertexLerpShader *shader);
 
 private:
-	void SetFrameVertices(KeyframeMesh *mesh, uint frame);
-	void SetFrameVertices(KeyframeMesh *mesh, uint startFrame, uint endFrame);
+	void BindFrames(GraphicsDevice *graphicsDevice, KeyframeMesh *mesh, uint startFrame, uint endFrame);
 };
 
 #endif
@@ -3,6 +3,7 @@
 #include "../../common.h"
 #include "skeletalmesh.h"
 #include "joint.h"
+#include "jointposeevaluator.h"
 #include "jointkeyframe.h"
 #include "jointvertexmapping.h"
 #include "skeletalmeshsubset.h"
@@ -26,10 +27,12 @@ SkeletalMesh::SkeletalMesh()
 	m_joints = NULL;
 	m_rootJointIndex = NO_JOINT;
 	m_vertexBuffer = NULL;
+	m_poseEvaluator = NULL;
 }
 
 SkeletalMesh::~SkeletalMesh()
 {
+	SAFE_DELETE(m_poseEvaluator);
 	SAFE_DELETE_ARRAY(m_joints);
 	SAFE_DELETE_ARRAY(m_jointMappings);
 	SAFE_DELETE_ARRAY(m_vertices);
@@ -7,6 +7,7 @@
 #include "../../util/typesystem.h"
 #include <stl/string.h>
 
+class JointPoseEvaluator;
 class SkeletalMeshFile;
 class SkeletalMeshSubset;
 class VertexBuffer;
@@ -37,6 +38,7 @@ public:
 	uint GetNumFrames() const                              { return m_numFrames; }
 	const AnimationSequence* GetAnimation(const stl::string &name) const;
 	VertexBuffer* GetVertexBuffer() const                  { return m_vertexBuffer; }
+	const JointPoseEvaluator* GetPoseEvaluator() const     { return m_poseEvaluator; }
 
 private:
 	SkeletalMesh();
@@ -53,6 +55,7 @@ private:
 	uint m_numFrames;
 	AnimationList m_animations;
 	VertexBuffer *m_vertexBuffer;
+	JointPoseEvaluator *m_poseEvaluator;
 };
 
 #endif
@@ -4,6 +4,9 @@
 #include "skeletalmeshanimationinstance.h"
 #include "skeletalmeshinstance.h"
 #include "skeletalmesh.h"
+#include "joint.h"
+#include "../../math/quaternion.h"
+#include "../../math/vector3.h"
 #include "../../support/animationsequence.h"
 #include <stl/string.h>
 
@@ -18,15 +21,24 @@ SkeletalMeshAnimationInstance::SkeletalMeshAnimationInstance(SkeletalMesh *mesh)
 	m_interpolation = 0.0f;
 	m_isRunningTempSequence = false;
 	m_oldSequenceLoop = false;
+	m_previousPositions = NULL;
+	m_previousRotations = NULL;
+	m_latestPositions = NULL;
+	m_latestRotations = NULL;
 }
 
 SkeletalMeshAnimationInstance::~SkeletalMeshAnimationInstance()
 {
+	SAFE_DELETE_ARRAY(m_previousPositions);
+	SAFE_DELETE_ARRAY(m_previousRotations);
+	SAFE_DELETE_ARRAY(m_latestPositions);
+	SAFE_DELETE_ARRAY(m_latestRotations);
 }
 
 void SkeletalMeshAnimationInstance::OnUpdate(float delta)
 {
 	SkeletalMeshInstance::OnUpdate(delta);
+	SetPoseCurrent(false);
 	if (m_currentSequenceStart != m_currentSequenceEnd)
 	{
 		m_interpolation += delta * 30;
@@ -78,6 +90,7 @@ void SkeletalMeshAnimationInstance::SetSequence(uint startFrame, uint endFrame,
 		m_nextFrame = m_currentSequenceEnd;
 	
 	m_interpolation = 0.0f;
+	SetPoseCurrent(false);
 }
 
 void SkeletalMeshAnimationInstance::SetSequence(const stl::string &name, bool loop)
@@ -103,6 +116,96 @@ void SkeletalMeshAnimationInstance::RunSequenceOnce(const stl::string &name)
 	SetSequence(name, false);
 }
 
+void SkeletalMeshAnimationInstance::UpdatePose()
+{
+	UpdatePose(m_interpolation);
+}
+
+void SkeletalMeshAnimationInstance::UpdatePose(float interpolation)
+{
+	// a slightly different interpolation amount is allowed to be used so
+	// that poses can be shared between instances (SkeletalMeshPoseCache)
+	CalculateJointTransformations(m_thisFrame, m_nextFrame, interpolation);
+	SetPoseCurrent(true);
+	StorePoseHistory();
+}
+
+void SkeletalMeshAnimationInstance::SetPose(const Vector3 *positions, const Quaternion *rotations)
+{
+	SetJointTransformations(positions, rotations);
+	SetPoseCurrent(true);
+	StorePoseHistory();
+}
+
+void SkeletalMeshAnimationInstance::HoldPose()
+{
+	// whatever was last calculated is good enough for the current frame
+	SetPoseCurrent(true);
+}
+
+void SkeletalMeshAnimationInstance::InterpolateHeldPose(float amount)
+{
+	if (!m_lod.interpolate || !m_lod.hasPoseHistory)
+	{
+		HoldPose();
+		return;
+	}
+
+	int fixedJointIndex = (HasFixedRootJointTransformation() ? GetMesh()->GetRootJointIndex() : NO_JOINT);
+	Vector3 *positions = GetJointPositions();
+	Quaternion *rotations = GetJointRotations();
+
+	for (uint i = 0; i < GetNumJoints(); ++i)
+	{
+		if ((int)i == fixedJointIndex)
+			continue;
+
+		positions[i] = Vector3::Lerp(m_previousPositions[i], m_latestPositions[i], amount);
+
+		// the two poses are never far apart, so a normalized lerp is close
+		// enough to a slerp here
+		Quaternion latest = m_latestRotations[i];
+		if (Quaternion::Dot(m_previousRotations[i], latest) < 0.0f)
+			latest = latest * -1.0f;
+		rotations[i] = Quaternion::Normalize(Quaternion::Lerp(m_previousRotations[i], latest, amount));
+	}
+
+	OnJointPositionsAndRotationsChanged();
+	SetPoseCurrent(true);
+}
+
+void SkeletalMeshAnimationInstance::StorePoseHistory()
+{
+	if (!m_lod.interpolate)
+	{
+		m_lod.hasPoseHistory = false;
+		return;
+	}
+
+	uint numJoints = GetNumJoints();
+	if (m_latestPositions == NULL)
+	{
+		m_previousPositions = new Vector3[numJoints];
+		m_previousRotations = new Quaternion[numJoints];
+		m_latestPositions = new Vector3[numJoints];
+		m_latestRotations = new Quaternion[numJoints];
+	}
+
+	const Vector3 *positions = GetJointPositions();
+	const Quaternion *rotations = GetJointRotations();
+	for (uint i = 0; i < numJoints; ++i)
+	{
+		// without any history (first pose, or coming back into view) there
+		// is nothing sensible to blend from other then the new pose itself
+		m_previousPositions[i] = (m_lod.hasPoseHistory ? m_latestPositions[i] : positions[i]);
+		m_previousRotations[i] = (m_lod.hasPoseHistory ? m_latestRotations[i] : rotations[i]);
+		m_latestPositions[i] = positions[i];
+		m_latestRotations[i] = rotations[i];
+	}
+
+	m_lod.hasPoseHistory = true;
+}
+
 void SkeletalMeshAnimationInstance::RecoverFromTempSequence()
 {
 	m_isRunningTempSequence = false;
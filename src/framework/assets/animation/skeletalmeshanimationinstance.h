@@ -3,9 +3,12 @@
 
 #include "../../common.h"
 #include "skeletalmeshinstance.h"
+#include "animationlod.h"
 #include <stl/string.h>
 
 class SkeletalMesh;
+struct Quaternion;
+struct Vector3;
 
 class SkeletalMeshAnimationInstance : public SkeletalMeshInstance
 {
@@ -17,13 +20,22 @@ public:
 	void SetSequence(uint startFrame, uint endFrame, bool loop);
 	void SetSequence(const stl::string &name, bool loop);
 	void RunSequenceOnce(const stl::string &name);
+	void UpdatePose();
+	void UpdatePose(float interpolation);
+	void SetPose(const Vector3 *positions, const Quaternion *rotations);
+	void HoldPose();
+	void InterpolateHeldPose(float amount);
 	
 	uint GetCurrentFrame() const                           { return m_thisFrame; }
 	uint GetNextFrame() const                              { return m_nextFrame; }
 	float GetInterpolation() const                         { return m_interpolation; }
 	
+	AnimationLod& GetAnimationLod()                        { return m_lod; }
+	const AnimationLod& GetAnimationLod() const            { return m_lod; }
+	
 private:
 	void RecoverFromTempSequence();
+	void StorePoseHistory();
 	
 	stl::string m_currentSequenceName;
 	uint m_currentSequenceStart;
@@ -35,6 +47,12 @@ private:
 	bool m_isRunningTempSequence;
 	stl::string m_oldSequenceName;
 	bool m_oldSequenceLoop;
+	
+	AnimationLod m_lod;
+	Vector3 *m_previousPositions;
+	Quaternion *m_previousRotations;
+	Vector3 *m_latestPositions;
+	Quaternion *m_latestRotations;
 };
 
 #endif
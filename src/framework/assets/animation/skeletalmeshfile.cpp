@@ -3,6 +3,7 @@
 #include "../../common.h"
 #include "joint.h"
 #include "jointkeyframe.h"
+#include "jointposeevaluator.h"
 #include "jointvertexmapping.h"
 #include "skeletalmesh.h"
 #include "skeletalmeshfile.h"
@@ -266,6 +267,7 @@ SkeletalMesh* SkeletalMeshFile::CreateMesh()
 	}
 	
 	mesh->FindAndSetRootJointIndex();
+	mesh->m_poseEvaluator = new JointPoseEvaluator(mesh);
 
 	return mesh;
 }
@@ -5,6 +5,7 @@
 #include "skeletalmesh.h"
 #include "joint.h"
 #include "jointkeyframe.h"
+#include "jointposeevaluator.h"
 #include "../../graphics/blendstate.h"
 #include "../../graphics/renderstate.h"
 #include "../../graphics/texture.h"
@@ -35,9 +36,12 @@ SkeletalMeshInstance::SkeletalMeshInstance(SkeletalMesh *mesh)
 	
 	m_numJoints = mesh->GetNumJoints();
 	m_jointTransformations = new Matrix4x4[m_numJoints];
+	m_jointTransformationsNeedUpdate = false;
 	m_jointPositions = new Vector3[m_numJoints];
 	m_jointRotations = new Quaternion[m_numJoints];
+	m_poseScratch = new float[mesh->GetPoseEvaluator()->GetScratchBufferSize()];
 	m_rootJointHasFixedTransform = false;
+	m_isPoseCurrent = false;
 }
 
 SkeletalMeshInstance::~SkeletalMeshInstance()
@@ -50,117 +54,113 @@ SkeletalMeshInstance::~SkeletalMeshInstance()
 	SAFE_DELETE_ARRAY(m_jointTransformations);
 	SAFE_DELETE_ARRAY(m_jointPositions);
 	SAFE_DELETE_ARRAY(m_jointRotations);
+	SAFE_DELETE_ARRAY(m_poseScratch);
 }
 
 void SkeletalMeshInstance::OnUpdate(float delta)
 {
 }
 
-const Matrix4x4* SkeletalMeshInstance::GetJointTransformation(const stl::string &jointName) const
+Matrix4x4* SkeletalMeshInstance::GetJointTransformations()
+{
+	if (m_jointTransformationsNeedUpdate)
+		UpdateJointTransformations();
+	return m_jointTransformations;
+}
+
+const Matrix4x4* SkeletalMeshInstance::GetJointTransformation(const stl::string &jointName)
 {
 	int jointIndex = GetMesh()->GetIndexOfJoint(jointName);
 	if (jointIndex == NO_JOINT)
 		return NULL;
 	else
-		return &m_jointTransformations[jointIndex];
+		return &GetJointTransformations()[jointIndex];
 }
 
 void SkeletalMeshInstance::SetFixedRootJointTransformation(const Matrix4x4 &transform)
 {
-	ASSERT(GetMesh()->GetRootJointIndex() != NO_JOINT);
+	int rootJointIndex = GetMesh()->GetRootJointIndex();
+	ASSERT(rootJointIndex != NO_JOINT);
 	m_rootJointHasFixedTransform = true;
-	m_jointTransformations[GetMesh()->GetRootJointIndex()] = transform;
+	m_jointTransformations[rootJointIndex] = transform;
+
+	// the root joint's position and rotation get left alone (and are used
+	// as-is for all of it's children) while this is set
+	m_jointPositions[rootJointIndex] = transform.GetTranslation();
+	m_jointRotations[rootJointIndex] = Quaternion::CreateFromRotationMatrix(transform);
+	m_isPoseCurrent = false;
 }
 
 void SkeletalMeshInstance::ClearFixedRootJointTransformation()
 {
 	ASSERT(GetMesh()->GetRootJointIndex() != NO_JOINT);
 	m_rootJointHasFixedTransform = false;
+	m_isPoseCurrent = false;
 }
 
 void SkeletalMeshInstance::CalculateJointTransformations(uint frame)
 {
-	int rootJointIndex = GetMesh()->GetRootJointIndex();
-	
-	for (uint i = 0; i < m_numJoints; ++i)
-	{
-		if (!(m_rootJointHasFixedTransform && i == rootJointIndex))
-		{
-			Joint *joint = &GetMesh()->GetJoints()[i];
-			
-			const Vector3 *translation = &joint->frames[frame].position;
-			const Quaternion *rotation = &joint->frames[frame].rotation;
-			
-			Matrix4x4 transform =
-				joint->relative * 
-				Matrix4x4::CreateTranslation(translation->x, translation->y, translation->z) * 
-				rotation->ToMatrix();
-					
-			if (joint->parent != NULL)
-			{
-				// concatenate this joint's transformation onto the parent's 
-				// transformation
-				m_jointTransformations[i] = m_jointTransformations[joint->parentIndex];
-				m_jointTransformations[i] *= transform;
-			}
-			else
-			{
-				// no parent, just use this joint's relative final transformation
-				// as the final transformation
-				m_jointTransformations[i] = transform;
-			}
-		}
-		
-		BreakDownJointTransformationMatrix(i);
-	}
+	CalculateJointTransformations(frame, frame, 0.0f);
 }
 
 void SkeletalMeshInstance::CalculateJointTransformations(uint startFrame, uint endFrame, float interpolation)
 {
-	int rootJointIndex = GetMesh()->GetRootJointIndex();
+	int fixedJointIndex = (m_rootJointHasFixedTransform ? GetMesh()->GetRootJointIndex() : NO_JOINT);
+
+	GetMesh()->GetPoseEvaluator()->Evaluate(startFrame, endFrame, interpolation, m_poseScratch, fixedJointIndex, m_jointPositions, m_jointRotations);
+
+	// the matrix versions aren't needed for rendering, only build them if 
+	// they're actually asked for
+	m_jointTransformationsNeedUpdate = true;
+
+	// can't know if the frames given are the ones subclasses consider to
+	// be "current". they'll flag it themselves when that is the case
+	m_isPoseCurrent = false;
+}
+
+void SkeletalMeshInstance::SetJointTransformations(const Vector3 *positions, const Quaternion *rotations)
+{
+	ASSERT(positions != NULL);
+	ASSERT(rotations != NULL);
+	int fixedJointIndex = (m_rootJointHasFixedTransform ? GetMesh()->GetRootJointIndex() : NO_JOINT);
 
 	for (uint i = 0; i < m_numJoints; ++i)
 	{
-		if (!(m_rootJointHasFixedTransform && i == rootJointIndex))
-		{
-			Joint *joint = &GetMesh()->GetJoints()[i];
-			const JointKeyFrame *frame1 = &joint->frames[startFrame];
-			const JointKeyFrame *frame2 = &joint->frames[endFrame];
-					
-			// interpolate translation and rotation
-			Vector3 translation = Vector3::Lerp(frame1->position, frame2->position, interpolation);
-			Quaternion rotation = Quaternion::Slerp(frame1->rotation, frame2->rotation, interpolation);
-			
-			Matrix4x4 transform = 
-				joint->relative *
-				Matrix4x4::CreateTranslation(translation.x, translation.y, translation.z) * 
-				rotation.ToMatrix();
-			
-			if (joint->parent != NULL)
-			{
-				// concatenate this joint's transformation onto the parent's 
-				// transformation
-				m_jointTransformations[i] = m_jointTransformations[joint->parentIndex];
-				m_jointTransformations[i] *= transform;
-			}
-			else
-			{
-				// no parent, just use this joint's relative final transformation
-				// as the final transformation
-				m_jointTransformations[i] = transform;
-			}
-		}
-		
-		BreakDownJointTransformationMatrix(i);
+		if ((int)i == fixedJointIndex)
+			continue;
+
+		m_jointPositions[i] = positions[i];
+		m_jointRotations[i] = rotations[i];
 	}
+
+	OnJointPositionsAndRotationsChanged();
 }
 
-void SkeletalMeshInstance::BreakDownJointTransformationMatrix(uint jointMatrixIndex)
+void SkeletalMeshInstance::OnJointPositionsAndRotationsChanged()
 {
-	const Matrix4x4 *jointMatrix = &m_jointTransformations[jointMatrixIndex];
-	
-	m_jointPositions[jointMatrixIndex] = jointMatrix->GetTranslation();
-	m_jointRotations[jointMatrixIndex] = Quaternion::CreateFromRotationMatrix(*jointMatrix);
+	m_jointTransformationsNeedUpdate = true;
+	m_isPoseCurrent = false;
+}
+
+void SkeletalMeshInstance::UpdateJointTransformations()
+{
+	int fixedJointIndex = (m_rootJointHasFixedTransform ? GetMesh()->GetRootJointIndex() : NO_JOINT);
+
+	for (uint i = 0; i < m_numJoints; ++i)
+	{
+		// keep the exact matrix we were given for a fixed root joint
+		if ((int)i == fixedJointIndex)
+			continue;
+
+		const Vector3 &position = m_jointPositions[i];
+		Matrix4x4 *transform = &m_jointTransformations[i];
+		*transform = m_jointRotations[i].ToMatrix();
+		transform->m[_14] = position.x;
+		transform->m[_24] = position.y;
+		transform->m[_34] = position.z;
+	}
+
+	m_jointTransformationsNeedUpdate = false;
 }
 
 void SkeletalMeshInstance::EnableSubset(const stl::string &subset, bool enable)
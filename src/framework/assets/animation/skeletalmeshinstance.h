@@ -21,6 +21,7 @@ public:
 	virtual void OnUpdate(float delta);
 	void CalculateJointTransformations(uint frame);
 	void CalculateJointTransformations(uint startFrame, uint endFrame, float interpolation);
+	void SetJointTransformations(const Vector3 *positions, const Quaternion *rotations);
 
 	uint GetNumSubsets() const                             { return m_numSubsets; }
 	bool IsSubsetEnabled(uint index) const                 { return m_enabledSubsets[index]; }
@@ -32,12 +33,14 @@ public:
 	void SetTexture(const stl::string &subset, Texture *texture);
 	
 	uint GetNumJoints() const                              { return m_numJoints; }
-	Matrix4x4* GetJointTransformations() const             { return m_jointTransformations; }
+	Matrix4x4* GetJointTransformations();
 	Vector3* GetJointPositions() const                     { return m_jointPositions; }
 	Quaternion* GetJointRotations() const                  { return m_jointRotations; }
-	const Matrix4x4* GetJointTransformation(const stl::string &jointName) const;
+	const Matrix4x4* GetJointTransformation(const stl::string &jointName);
 	void SetFixedRootJointTransformation(const Matrix4x4 &transform);
 	void ClearFixedRootJointTransformation();
+	bool HasFixedRootJointTransformation() const           { return m_rootJointHasFixedTransform; }
+	bool IsPoseCurrent() const                             { return m_isPoseCurrent; }
 
 	RenderState* GetRenderState() const                    { return m_renderState; }
 	BlendState* GetBlendState() const                      { return m_blendState; }
@@ -48,8 +51,12 @@ public:
 	
 	SkeletalMesh* GetMesh() const                          { return m_mesh; }
 
+protected:
+	void SetPoseCurrent(bool isCurrent)                    { m_isPoseCurrent = isCurrent; }
+	void OnJointPositionsAndRotationsChanged();
+
 private:
-	void BreakDownJointTransformationMatrix(uint jointMatrixIndex);
+	void UpdateJointTransformations();
 	
 	SkeletalMesh *m_mesh;
 	uint m_numSubsets;
@@ -62,9 +69,12 @@ private:
 	
 	uint m_numJoints;
 	Matrix4x4 *m_jointTransformations;
+	bool m_jointTransformationsNeedUpdate;
 	Vector3 *m_jointPositions;
 	Quaternion *m_jointRotations;
+	float *m_poseScratch;
 	bool m_rootJointHasFixedTransform;
+	bool m_isPoseCurrent;
 };
 
 #endif
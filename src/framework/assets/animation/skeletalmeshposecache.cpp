@@ -0,0 +1,170 @@
+#include "../../debug.h"
+
+#include "skeletalmeshposecache.h"
+
+#include "skeletalmesh.h"
+#include "../../math/quaternion.h"
+#include "../../math/vector3.h"
+
+bool SkeletalMeshPoseCache::Key::operator<(const Key &other) const
+{
+	if (mesh != other.mesh)
+		return mesh < other.mesh;
+	if (startFrame != other.startFrame)
+		return startFrame < other.startFrame;
+	if (endFrame != other.endFrame)
+		return endFrame < other.endFrame;
+	return interpolationStep < other.interpolationStep;
+}
+
+SkeletalMeshPoseCache::SkeletalMeshPoseCache(uint maxPoses, uint interpolationSteps)
+{
+	ASSERT(maxPoses > 0);
+	ASSERT(interpolationSteps > 0);
+	m_maxPoses = maxPoses;
+	m_interpolationSteps = interpolationSteps;
+	m_currentUpdate = 0;
+	m_numHits = 0;
+	m_numMisses = 0;
+	m_numEvictions = 0;
+}
+
+SkeletalMeshPoseCache::~SkeletalMeshPoseCache()
+{
+	Clear();
+}
+
+SkeletalMeshPose* SkeletalMeshPoseCache::Get(const SkeletalMesh *mesh, uint startFrame, uint endFrame, float interpolation, bool *isNew)
+{
+	ASSERT(mesh != NULL);
+	ASSERT(isNew != NULL);
+
+	Key key;
+	key.mesh = mesh;
+	key.startFrame = startFrame;
+	key.endFrame = endFrame;
+	key.interpolationStep = QuantizeInterpolationStep(interpolation);
+
+	EntryMap::iterator found = m_lookup.find(key);
+	if (found != m_lookup.end())
+	{
+		EntryList::iterator entry = found->second;
+		if (entry != m_entries.begin())
+			m_entries.splice(m_entries.begin(), m_entries, entry);
+		entry->lastUsedUpdate = m_currentUpdate;
+
+		++m_numHits;
+		*isNew = false;
+		return &entry->pose;
+	}
+
+	++m_numMisses;
+
+	if (m_entries.size() < m_maxPoses)
+	{
+		m_entries.push_front(Entry());
+		AllocatePose(&m_entries.front().pose, mesh->GetNumJoints());
+	}
+	else
+	{
+		EntryList::iterator leastRecentlyUsed = m_entries.end();
+		--leastRecentlyUsed;
+
+		// it might still be waiting to be filled in, or copied out of, by
+		// the current update. and since it's the least recently used, this
+		// means every other pose is in use this update too
+		if (leastRecentlyUsed->lastUsedUpdate == m_currentUpdate)
+		{
+			*isNew = false;
+			return NULL;
+		}
+
+		m_lookup.erase(leastRecentlyUsed->key);
+		++m_numEvictions;
+
+		if (leastRecentlyUsed->pose.numJoints != mesh->GetNumJoints())
+		{
+			FreePose(&leastRecentlyUsed->pose);
+			AllocatePose(&leastRecentlyUsed->pose, mesh->GetNumJoints());
+		}
+		m_entries.splice(m_entries.begin(), m_entries, leastRecentlyUsed);
+	}
+
+	EntryList::iterator entry = m_entries.begin();
+	entry->key = key;
+	entry->lastUsedUpdate = m_currentUpdate;
+	m_lookup.insert(EntryMap::value_type(key, entry));
+
+	*isNew = true;
+	return &entry->pose;
+}
+
+float SkeletalMeshPoseCache::QuantizeInterpolation(float interpolation) const
+{
+	return (float)QuantizeInterpolationStep(interpolation) / (float)m_interpolationSteps;
+}
+
+uint SkeletalMeshPoseCache::QuantizeInterpolationStep(float interpolation) const
+{
+	if (interpolation <= 0.0f)
+		return 0;
+	else if (interpolation >= 1.0f)
+		return m_interpolationSteps;
+	else
+		return (uint)(interpolation * (float)m_interpolationSteps + 0.5f);
+}
+
+void SkeletalMeshPoseCache::Remove(const SkeletalMesh *mesh)
+{
+	EntryList::iterator i = m_entries.begin();
+	while (i != m_entries.end())
+	{
+		if (i->key.mesh == mesh)
+		{
+			m_lookup.erase(i->key);
+			FreePose(&i->pose);
+			i = m_entries.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+void SkeletalMeshPoseCache::Clear()
+{
+	for (EntryList::iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+		FreePose(&i->pose);
+
+	m_entries.clear();
+	m_lookup.clear();
+}
+
+float SkeletalMeshPoseCache::GetHitRate() const
+{
+	uint numLookups = m_numHits + m_numMisses;
+	if (numLookups == 0)
+		return 0.0f;
+	else
+		return (float)m_numHits / (float)numLookups;
+}
+
+void SkeletalMeshPoseCache::ResetStatistics()
+{
+	m_numHits = 0;
+	m_numMisses = 0;
+	m_numEvictions = 0;
+}
+
+void SkeletalMeshPoseCache::AllocatePose(SkeletalMeshPose *pose, uint numJoints)
+{
+	pose->numJoints = numJoints;
+	pose->positions = new Vector3[numJoints];
+	pose->rotations = new Quaternion[numJoints];
+}
+
+void SkeletalMeshPoseCache::FreePose(SkeletalMeshPose *pose)
+{
+	SAFE_DELETE_ARRAY(pose->positions);
+	SAFE_DELETE_ARRAY(pose->rotations);
+	pose->numJoints = 0;
+}
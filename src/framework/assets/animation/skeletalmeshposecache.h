@@ -0,0 +1,155 @@
+#ifndef __FRAMEWORK_ASSETS_ANIMATION_SKELETALMESHPOSECACHE_H_INCLUDED__
+#define __FRAMEWORK_ASSETS_ANIMATION_SKELETALMESHPOSECACHE_H_INCLUDED__
+
+#include "../../common.h"
+#include <stl/list.h>
+#include <stl/map.h>
+
+class SkeletalMesh;
+struct Quaternion;
+struct Vector3;
+
+/**
+ * Joint positions and rotations of a skeletal mesh for one (interpolated)
+ * animation frame.
+ */
+struct SkeletalMeshPose
+{
+	uint numJoints;
+	Vector3 *positions;
+	Quaternion *rotations;
+};
+
+/**
+ * Holds recently calculated skeletal mesh poses so that multiple instances
+ * of the same mesh that are at the same point in the same animation can
+ * share a single pose instead of each calculating their own. Interpolation
+ * between frames is quantized to a fixed number of steps to make this
+ * happen more often. When full, the least recently used pose is replaced.
+ *
+ * Poses are identified by the mesh's address. Poses of a mesh should be
+ * removed from the cache (or the whole cache cleared) before that mesh is
+ * freed.
+ */
+class SkeletalMeshPoseCache
+{
+public:
+	/**
+	 * Creates a pose cache.
+	 * @param maxPoses the maximum number of poses to hold at once
+	 * @param interpolationSteps the number of distinct poses that can be
+	 *                           cached between each pair of keyframes
+	 */
+	SkeletalMeshPoseCache(uint maxPoses, uint interpolationSteps);
+
+	virtual ~SkeletalMeshPoseCache();
+
+	/**
+	 * Begins a new update. Poses returned by Get during an update will not
+	 * be evicted until the next update has begun.
+	 */
+	void BeginUpdate()                                     { ++m_currentUpdate; }
+
+	/**
+	 * Looks up a pose, adding a new empty one if it's not in the cache.
+	 * @param mesh the mesh the pose is of
+	 * @param startFrame the keyframe being interpolated from
+	 * @param endFrame the keyframe being interpolated to
+	 * @param interpolation the amount to interpolate by between the start
+	 *                      and end frames. this will be quantized
+	 * @param isNew set to true if a new pose was added which needs to be
+	 *              filled in by the caller, false if it was already cached
+	 * @return the pose, or NULL if it wasn't cached and all poses in the
+	 *         cache are still in use by the current update
+	 */
+	SkeletalMeshPose* Get(const SkeletalMesh *mesh, uint startFrame, uint endFrame, float interpolation, bool *isNew);
+
+	/**
+	 * @param interpolation an interpolation amount (0.0 to 1.0)
+	 * @return the interpolation amount that the cache will treat it as
+	 */
+	float QuantizeInterpolation(float interpolation) const;
+
+	/**
+	 * Removes all cached poses of a mesh.
+	 * @param mesh the mesh to remove poses of
+	 */
+	void Remove(const SkeletalMesh *mesh);
+
+	/**
+	 * Removes all cached poses.
+	 */
+	void Clear();
+
+	/**
+	 * @return the number of poses currently held
+	 */
+	uint GetNumPoses() const                               { return m_entries.size(); }
+
+	/**
+	 * @return the maximum number of poses that can be held at once
+	 */
+	uint GetMaxPoses() const                               { return m_maxPoses; }
+
+	/**
+	 * @return the number of lookups that found an already cached pose
+	 */
+	uint GetNumHits() const                                { return m_numHits; }
+
+	/**
+	 * @return the number of lookups that didn't find an already cached pose
+	 */
+	uint GetNumMisses() const                              { return m_numMisses; }
+
+	/**
+	 * @return the number of cached poses that have been replaced by others
+	 */
+	uint GetNumEvictions() const                           { return m_numEvictions; }
+
+	/**
+	 * @return the fraction of lookups that found an already cached pose
+	 */
+	float GetHitRate() const;
+
+	/**
+	 * Resets hit/miss/eviction counts back to zero.
+	 */
+	void ResetStatistics();
+
+private:
+	struct Key
+	{
+		const SkeletalMesh *mesh;
+		uint startFrame;
+		uint endFrame;
+		uint interpolationStep;
+
+		bool operator<(const Key &other) const;
+	};
+
+	struct Entry
+	{
+		Key key;
+		SkeletalMeshPose pose;
+		uint lastUsedUpdate;
+	};
+
+	typedef stl::list<Entry> EntryList;
+	typedef stl::map<Key, EntryList::iterator> EntryMap;
+
+	uint QuantizeInterpolationStep(float interpolation) const;
+	void AllocatePose(SkeletalMeshPose *pose, uint numJoints);
+	void FreePose(SkeletalMeshPose *pose);
+
+	uint m_maxPoses;
+	uint m_interpolationSteps;
+	uint m_currentUpdate;
+	EntryList m_entries;     // most recently used first
+	EntryMap m_lookup;
+
+	uint m_numHits;
+	uint m_numMisses;
+	uint m_numEvictions;
+};
+
+#endif
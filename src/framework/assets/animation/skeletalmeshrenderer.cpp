@@ -47,12 +47,20 @@ void SkeletalMeshRenderer::Render(GraphicsDevice *graphicsDevice, SkeletalMeshIn
 void SkeletalMeshRenderer::Render(GraphicsDevice *graphicsDevice, SkeletalMeshAnimationInstance *instance, VertexSkinningShader *shader)
 {
 	ASSERT(shader->IsBound() == true);
-	Render(graphicsDevice, instance, instance->GetCurrentFrame(), instance->GetNextFrame(), instance->GetInterpolation(), shader);
+
+	// instances updated by an AnimationSystem will already have their pose
+	// calculated for the current frame, leaving only the uniforms to be set
+	if (!instance->IsPoseCurrent())
+		instance->UpdatePose();
+
+	shader->SetJointPositions(instance->GetJointPositions(), instance->GetNumJoints());
+	shader->SetJointRotations(instance->GetJointRotations(), instance->GetNumJoints());
+	RenderAllSubsets(graphicsDevice, instance, shader);
 }
 
 void SkeletalMeshRenderer::RenderAllSubsets(GraphicsDevice *graphicsDevice, SkeletalMeshInstance *instance, VertexSkinningShader *shader)
 {
-	instance->GetRenderState()->Apply();
+	instance->GetRenderState()->Apply(graphicsDevice);
 	graphicsDevice->BindVertexBuffer(instance->GetMesh()->GetVertexBuffer());
 	
 	bool hasAlphaSubsets = false;
@@ -67,7 +75,7 @@ void SkeletalMeshRenderer::RenderAllSubsets(GraphicsDevice *graphicsDevice, Skel
 	else
 	{
 		// render only non-alpha subsets first
-		instance->GetBlendState()->Apply();
+		instance->GetBlendState()->Apply(graphicsDevice);
 		for (uint i = 0; i < instance->GetMesh()->GetNumSubsets(); ++i)
 		{
 			if (!instance->IsSubsetEnabled(i))
@@ -85,7 +93,7 @@ void SkeletalMeshRenderer::RenderAllSubsets(GraphicsDevice *graphicsDevice, Skel
 	// now render only alpha subsets, if we found any
 	if (hasAlphaSubsets)
 	{
-		instance->GetAlphaBlendState()->Apply();
+		instance->GetAlphaBlendState()->Apply(graphicsDevice);
 		for (uint i = 0; i < instance->GetMesh()->GetNumSubsets(); ++i)
 		{
 			if (!instance->IsSubsetEnabled(i))
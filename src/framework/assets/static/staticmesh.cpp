@@ -21,11 +21,13 @@ StaticMesh::StaticMesh(uint numSubsets, StaticMeshSubset **subsets)
 	// object should delete them when we're done, and not the caller
 	m_numSubsets = numSubsets;
 	m_subsets = subsets;
+	m_bvh = NULL;
 }
 
 StaticMesh::StaticMesh(const StaticMeshFile *file, ContentManager *contentManager)
 {
 	m_numSubsets = 0;
+	m_bvh = NULL;
 	CreateSubsets(file, contentManager);
 }
 
@@ -34,6 +36,43 @@ StaticMesh::~StaticMesh()
 	for (uint i = 0; i < m_numSubsets; ++i)
 		SAFE_DELETE(m_subsets[i]);
 	SAFE_DELETE_ARRAY(m_subsets);
+	SAFE_DELETE(m_bvh);
+}
+
+bool StaticMesh::BuildBvh(uint maxTrianglesPerLeaf)
+{
+	uint numVertices = 0;
+	for (uint i = 0; i < m_numSubsets; ++i)
+		numVertices += m_subsets[i]->GetVertices()->GetNumElements();
+
+	stl::vector<Vector3> vertices;
+	vertices.reserve(numVertices);
+	for (uint i = 0; i < m_numSubsets; ++i)
+	{
+		const VertexBuffer *subsetVertices = m_subsets[i]->GetVertices();
+		for (uint j = 0; j < subsetVertices->GetNumElements(); ++j)
+			vertices.push_back(subsetVertices->GetPosition3(j));
+	}
+
+	TriangleBvh *bvh = new TriangleBvh();
+	ASSERT(bvh != NULL);
+	if (!bvh->Build(vertices.data(), numVertices, maxTrianglesPerLeaf))
+	{
+		SAFE_DELETE(bvh);
+		return false;
+	}
+
+	SetBvh(bvh);
+	return true;
+}
+
+void StaticMesh::SetBvh(TriangleBvh *bvh)
+{
+	if (bvh == m_bvh)
+		return;
+
+	SAFE_DELETE(m_bvh);
+	m_bvh = bvh;
 }
 
 void StaticMesh::CreateSubsets(const StaticMeshFile *file, ContentManager *contentManager)
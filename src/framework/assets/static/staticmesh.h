@@ -3,6 +3,7 @@
 
 #include "../../common.h"
 #include "../../content/content.h"
+#include "../../math/trianglebvh.h"
 #include "../../util/typesystem.h"
 
 class ContentManager;
@@ -46,11 +47,37 @@ public:
 	 */
 	StaticMeshSubset* GetSubset(uint index) const          { return m_subsets[index]; }
 
+	/**
+	 * Builds a bounding volume hierarchy over the triangles of all of this
+	 * mesh's subsets, for fast ray and collision tests against the mesh.
+	 * Triangles are numbered in subset order. Replaces any previously
+	 * built or set hierarchy.
+	 * @param maxTrianglesPerLeaf the number of triangles a leaf node can
+	 *                            contain before it will always be split
+	 * @return true if successful
+	 */
+	bool BuildBvh(uint maxTrianglesPerLeaf = BVH_DEFAULT_MAX_LEAF_TRIANGLES);
+
+	/**
+	 * Sets the bounding volume hierarchy to use for this mesh, e.g. one
+	 * that was built offline and read from a file. Replaces any previously
+	 * built or set hierarchy.
+	 * @param bvh the hierarchy, which this mesh takes ownership of
+	 */
+	void SetBvh(TriangleBvh *bvh);
+
+	/**
+	 * @return this mesh's bounding volume hierarchy, or NULL if one hasn't
+	 *         been built or set
+	 */
+	const TriangleBvh* GetBvh() const                      { return m_bvh; }
+
 private:
 	void CreateSubsets(const StaticMeshFile *file, ContentManager *contentManager);
 
 	uint m_numSubsets;
 	StaticMeshSubset **m_subsets;
+	TriangleBvh *m_bvh;
 };
 
 #endif
@@ -301,6 +301,10 @@ void StaticMeshBuilder::SetTriangleInternal(
 	const Vector2 &t1, const Vector2 &t2, const Vector2 &t3
 	)
 {
+	// positions are transformed as each triangle is set, as the transform
+	// can be changed in between calls. deferring it to BuildMesh() so that
+	// whole subsets could be transformed at once with CopyPositions3() would
+	// apply only the last transform set to every triangle
 	buffer->SetPosition3(bufferIndex, v1 * m_transform);
 	buffer->SetNormal(bufferIndex, n1);
 	buffer->SetTexCoord(bufferIndex, t1);
@@ -1,24 +1,62 @@
+#include "../../debug.h"
+
 #include "staticmeshrenderer.h"
 
 #include "staticmesh.h"
 #include "staticmeshinstance.h"
 #include "staticmeshsubset.h"
+#include "../../graphics/color.h"
 #include "../../graphics/graphicsdevice.h"
 #include "../../graphics/texture.h"
+#include "../../graphics/rendercommandqueue.h"
 #include "../../graphics/renderstate.h"
+#include "../../graphics/simpletextureinstancedshader.h"
+#include "../../graphics/simpletextureshader.h"
 #include "../../graphics/vertexbuffer.h"
+#include "../../graphics/viewcontext.h"
+#include "../../math/vector2.h"
+#include "../../math/vector3.h"
+
+const VERTEX_ATTRIBS INSTANCE_BUFFER_ATTRIBS[] = {
+	VERTEX_F4,    // model transform, column 1
+	VERTEX_F4,    // model transform, column 2
+	VERTEX_F4,    // model transform, column 3
+	VERTEX_F4     // model transform, column 4
+};
+
+const VERTEX_ATTRIBS MERGED_BUFFER_ATTRIBS[] = {
+	VERTEX_POS_3D,
+	VERTEX_TEXCOORD
+};
+
+// subsets with more vertices than this aren't worth pre-transforming on the
+// CPU and are drawn one instance at a time instead
+const uint MERGED_MAX_SUBSET_VERTICES = 1024;
+
+// the most vertices that are merged into a single draw call. bigger groups
+// of instances are drawn in chunks of this many vertices (or fewer)
+const uint MERGED_BUFFER_MAX_VERTICES = 16384;
 
 StaticMeshRenderer::StaticMeshRenderer()
 {
+	m_numBatches = 0;
+	m_mergedVertices = NULL;
 }
 
 StaticMeshRenderer::~StaticMeshRenderer()
 {
+	for (uint i = 0; i < m_batches.size(); ++i)
+	{
+		SAFE_DELETE(m_batches[i]->instanceBuffer);
+		SAFE_DELETE(m_batches[i]);
+	}
+	m_batches.clear();
+	SAFE_DELETE(m_mergedVertices);
 }
 
 void StaticMeshRenderer::Render(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance)
 {
-	instance->GetRenderState()->Apply();
+	instance->GetRenderState()->Apply(graphicsDevice);
 
 	if (instance->GetNumTextures() > 0)
 		RenderAllSubsets(graphicsDevice, instance);
@@ -26,6 +64,25 @@ void StaticMeshRenderer::Render(GraphicsDevice *graphicsDevice, StaticMeshInstan
 		RenderAllSubsetsTextureless(graphicsDevice, instance);
 }
 
+void StaticMeshRenderer::Submit(RenderCommandQueue *queue, StaticMeshInstance *instance, StandardShader *shader, const Matrix4x4 &modelView, float depth, uint pass)
+{
+	ASSERT(queue != NULL);
+	ASSERT(instance != NULL);
+
+	RenderCommand command;
+	command.pass = pass;
+	command.depth = depth;
+	command.shader = shader;
+	command.renderState = instance->GetRenderState();
+
+	for (uint i = 0; i < instance->GetMesh()->GetNumSubsets(); ++i)
+	{
+		command.texture = instance->GetTexture(i);
+		command.vertexBuffer = instance->GetMesh()->GetSubset(i)->GetVertices();
+		queue->Submit(command, &modelView);
+	}
+}
+
 void StaticMeshRenderer::RenderAllSubsets(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance)
 {
 	for (uint i = 0; i < instance->GetMesh()->GetNumSubsets(); ++i)
@@ -54,3 +111,255 @@ void StaticMeshRenderer::RenderTexturelessSubset(GraphicsDevice *graphicsDevice,
 	graphicsDevice->UnbindVertexBuffer();
 }
 
+void StaticMeshRenderer::AddInstance(StaticMeshInstance *instance, const Matrix4x4 &transform)
+{
+	ASSERT(instance != NULL);
+
+	StaticMeshInstanceBatch *batch = GetBatchFor(instance);
+	batch->transforms.push_back(transform);
+}
+
+void StaticMeshRenderer::RenderInstances(GraphicsDevice *graphicsDevice)
+{
+	ASSERT(graphicsDevice != NULL);
+	if (m_numBatches == 0)
+		return;
+
+	uint numInstanced = 0;
+	bool isInstancingSupported = graphicsDevice->IsInstancingSupported();
+	for (uint i = 0; i < m_numBatches; ++i)
+	{
+		m_batches[i]->renderInstanced = (isInstancingSupported && CanRenderInstanced(m_batches[i]));
+		if (m_batches[i]->renderInstanced)
+			++numInstanced;
+	}
+
+	if (numInstanced > 0)
+		RenderBatchesInstanced(graphicsDevice);
+	if (numInstanced < m_numBatches)
+		RenderBatchesMerged(graphicsDevice);
+
+	// batch objects (and their instance buffers) are kept around so they can
+	// be reused next time instead of being re-allocated every frame
+	for (uint i = 0; i < m_numBatches; ++i)
+	{
+		m_batches[i]->instance = NULL;
+		m_batches[i]->transforms.clear();
+	}
+	m_numBatches = 0;
+}
+
+StaticMeshInstanceBatch* StaticMeshRenderer::GetBatchFor(StaticMeshInstance *instance)
+{
+	for (uint i = 0; i < m_numBatches; ++i)
+	{
+		StaticMeshInstance *batchInstance = m_batches[i]->instance;
+		if (batchInstance->GetMesh() != instance->GetMesh() || batchInstance->GetRenderState() != instance->GetRenderState())
+			continue;
+
+		bool sameTextures = true;
+		for (uint j = 0; j < instance->GetNumTextures(); ++j)
+		{
+			if (batchInstance->GetTexture(j) != instance->GetTexture(j))
+			{
+				sameTextures = false;
+				break;
+			}
+		}
+
+		if (sameTextures)
+			return m_batches[i];
+	}
+
+	if (m_numBatches == m_batches.size())
+	{
+		StaticMeshInstanceBatch *newBatch = new StaticMeshInstanceBatch();
+		newBatch->instance = NULL;
+		newBatch->instanceBuffer = NULL;
+		newBatch->renderInstanced = false;
+		m_batches.push_back(newBatch);
+	}
+
+	StaticMeshInstanceBatch *batch = m_batches[m_numBatches];
+	batch->instance = instance;
+	++m_numBatches;
+
+	return batch;
+}
+
+void StaticMeshRenderer::RenderBatchesInstanced(GraphicsDevice *graphicsDevice)
+{
+	SimpleTextureInstancedShader *shader = graphicsDevice->GetSimpleTextureInstancedShader();
+	graphicsDevice->BindShader(shader);
+	shader->SetProjectionMatrix(graphicsDevice->GetViewContext()->GetProjectionMatrix());
+	shader->SetModelViewMatrix(graphicsDevice->GetViewContext()->GetModelViewMatrix());
+
+	for (uint i = 0; i < m_numBatches; ++i)
+	{
+		StaticMeshInstanceBatch *batch = m_batches[i];
+		if (!batch->renderInstanced)
+			continue;
+
+		uint numInstances = batch->transforms.size();
+
+		// instance buffers only ever grow so they don't end up being 
+		// resized back and forth as instance counts change between frames
+		if (batch->instanceBuffer == NULL)
+		{
+			batch->instanceBuffer = new VertexBuffer();
+			bool success = batch->instanceBuffer->Initialize(graphicsDevice, INSTANCE_BUFFER_ATTRIBS, 4, numInstances, BUFFEROBJECT_USAGE_DYNAMIC);
+			ASSERT(success == true);
+		}
+		else if (batch->instanceBuffer->GetNumElements() < numInstances)
+			batch->instanceBuffer->Resize(numInstances);
+
+		VertexBuffer *instanceBuffer = batch->instanceBuffer;
+		for (uint j = 0; j < numInstances; ++j)
+		{
+			const float *m = batch->transforms[j].m;
+			instanceBuffer->Set4f(0, j, m[0], m[1], m[2], m[3]);
+			instanceBuffer->Set4f(1, j, m[4], m[5], m[6], m[7]);
+			instanceBuffer->Set4f(2, j, m[8], m[9], m[10], m[11]);
+			instanceBuffer->Set4f(3, j, m[12], m[13], m[14], m[15]);
+		}
+
+		StaticMeshInstance *instance = batch->instance;
+		instance->GetRenderState()->Apply(graphicsDevice);
+		graphicsDevice->BindInstanceBuffer(instanceBuffer);
+
+		for (uint j = 0; j < instance->GetMesh()->GetNumSubsets(); ++j)
+		{
+			graphicsDevice->BindTexture(GetSubsetTexture(graphicsDevice, instance, j));
+			graphicsDevice->BindVertexBuffer(instance->GetMesh()->GetSubset(j)->GetVertices());
+			graphicsDevice->RenderTrianglesInstanced(numInstances);
+			graphicsDevice->UnbindVertexBuffer();
+		}
+
+		graphicsDevice->UnbindInstanceBuffer();
+	}
+
+	graphicsDevice->UnbindShader();
+}
+
+void StaticMeshRenderer::RenderBatchesMerged(GraphicsDevice *graphicsDevice)
+{
+	SimpleTextureShader *shader = graphicsDevice->GetSimpleTextureShader();
+	graphicsDevice->BindShader(shader);
+	shader->SetProjectionMatrix(graphicsDevice->GetViewContext()->GetProjectionMatrix());
+	shader->SetModelViewMatrix(graphicsDevice->GetViewContext()->GetModelViewMatrix());
+
+	for (uint i = 0; i < m_numBatches; ++i)
+	{
+		StaticMeshInstanceBatch *batch = m_batches[i];
+		if (batch->renderInstanced)
+			continue;
+
+		StaticMeshInstance *instance = batch->instance;
+		instance->GetRenderState()->Apply(graphicsDevice);
+
+		for (uint j = 0; j < instance->GetMesh()->GetNumSubsets(); ++j)
+		{
+			VertexBuffer *source = instance->GetMesh()->GetSubset(j)->GetVertices();
+			if (source->GetNumElements() == 0)
+				continue;
+
+			graphicsDevice->BindTexture(GetSubsetTexture(graphicsDevice, instance, j));
+
+			// the shader needs texture coordinates, which only the merged
+			// buffer can fill in for subsets that don't have any
+			if (source->GetNumElements() > MERGED_MAX_SUBSET_VERTICES && source->HasStandardAttrib(VERTEX_STD_TEXCOORD))
+				RenderSubsetPerInstance(graphicsDevice, shader, source, batch);
+			else
+				RenderSubsetMerged(graphicsDevice, source, batch);
+		}
+	}
+
+	graphicsDevice->UnbindShader();
+}
+
+void StaticMeshRenderer::RenderSubsetPerInstance(GraphicsDevice *graphicsDevice, SimpleTextureShader *shader, VertexBuffer *source, const StaticMeshInstanceBatch *batch)
+{
+	const Matrix4x4 &modelView = graphicsDevice->GetViewContext()->GetModelViewMatrix();
+
+	graphicsDevice->BindVertexBuffer(source);
+	for (uint i = 0; i < batch->transforms.size(); ++i)
+	{
+		shader->SetModelViewMatrix(modelView * batch->transforms[i]);
+		graphicsDevice->RenderTriangles();
+	}
+	graphicsDevice->UnbindVertexBuffer();
+
+	shader->SetModelViewMatrix(modelView);
+}
+
+void StaticMeshRenderer::RenderSubsetMerged(GraphicsDevice *graphicsDevice, const VertexBuffer *source, const StaticMeshInstanceBatch *batch)
+{
+	uint numInstances = batch->transforms.size();
+	uint numSourceVertices = source->GetNumElements();
+
+	// a subset without texture coordinates can be bigger than a whole chunk,
+	// in which case its instances are merged one at a time
+	uint instancesPerChunk = Max(MERGED_BUFFER_MAX_VERTICES / numSourceVertices, (uint)1);
+	uint numVertices = Min(numInstances, instancesPerChunk) * numSourceVertices;
+
+	if (m_mergedVertices == NULL)
+	{
+		m_mergedVertices = new VertexBuffer();
+		bool success = m_mergedVertices->Initialize(graphicsDevice, MERGED_BUFFER_ATTRIBS, 2, numVertices, BUFFEROBJECT_USAGE_DYNAMIC);
+		ASSERT(success == true);
+	}
+	else if (m_mergedVertices->GetNumElements() < numVertices)
+		m_mergedVertices->Resize(numVertices);
+
+	bool hasTexCoords = source->HasStandardAttrib(VERTEX_STD_TEXCOORD);
+	for (uint first = 0; first < numInstances; first += instancesPerChunk)
+	{
+		uint numChunkInstances = Min(numInstances - first, instancesPerChunk);
+
+		// pre-transform each instance's copy of the subset's vertices
+		for (uint i = 0; i < numChunkInstances; ++i)
+		{
+			uint n = i * numSourceVertices;
+			m_mergedVertices->CopyPositions3(source, 0, n, numSourceVertices, &batch->transforms[first + i]);
+			if (hasTexCoords)
+				m_mergedVertices->CopyTexCoords(source, 0, n, numSourceVertices);
+			else
+			{
+				for (uint v = 0; v < numSourceVertices; ++v)
+					m_mergedVertices->SetTexCoord(n + v, ZERO_VECTOR2);
+			}
+		}
+
+		graphicsDevice->BindVertexBuffer(m_mergedVertices);
+		graphicsDevice->RenderTriangles(0, numChunkInstances * numSourceVertices / 3);
+		graphicsDevice->UnbindVertexBuffer();
+	}
+}
+
+bool StaticMeshRenderer::CanRenderInstanced(const StaticMeshInstanceBatch *batch) const
+{
+	// SimpleTextureInstancedShader reads texture coordinates straight out of
+	// the mesh's vertex buffers, the merged path fills in zeros for meshes
+	// which don't have any
+	const StaticMesh *mesh = batch->instance->GetMesh();
+	for (uint i = 0; i < mesh->GetNumSubsets(); ++i)
+	{
+		if (!mesh->GetSubset(i)->GetVertices()->HasStandardAttrib(VERTEX_STD_TEXCOORD))
+			return false;
+	}
+
+	return true;
+}
+
+Texture* StaticMeshRenderer::GetSubsetTexture(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance, uint subset) const
+{
+	// the built-in shaders used for batches always sample a texture, so 
+	// textureless subsets just get a plain white one
+	Texture *texture = NULL;
+	if (instance->GetNumTextures() > 0)
+		texture = instance->GetTexture(subset);
+	if (texture == NULL)
+		texture = graphicsDevice->GetSolidColorTexture(COLOR_WHITE);
+
+	return texture;
+}
@@ -2,11 +2,31 @@
 #define __FRAMEWORK_ASSETS_STATIC_STATICMESHRENDERER_H_INCLUDED__
 
 #include "../../common.h"
+#include "../../math/matrix4x4.h"
+#include <stl/vector.h>
 
 class GraphicsDevice;
+class RenderCommandQueue;
+class SimpleTextureShader;
+class StandardShader;
 class StaticMeshInstance;
 class StaticMeshSubset;
 class Texture;
+class VertexBuffer;
+
+/**
+ * A group of static mesh instances which can all be drawn together because
+ * they share the same mesh, textures and render state.
+ */
+struct StaticMeshInstanceBatch
+{
+	StaticMeshInstance *instance;
+	stl::vector<Matrix4x4> transforms;
+	VertexBuffer *instanceBuffer;
+	bool renderInstanced;
+};
+
+typedef stl::vector<StaticMeshInstanceBatch*> StaticMeshInstanceBatchList;
 
 /**
  * Helper object that renders instances of static mesh objects.
@@ -28,12 +48,61 @@ public:
 	 */
 	void Render(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance);
 
+	/**
+	 * Submits the draw calls for an instance of a static mesh to a render
+	 * command queue to be drawn when the queue is next executed.
+	 * @param queue the queue to submit to
+	 * @param instance the static mesh instance to render
+	 * @param shader the shader to render the instance with
+	 * @param modelView the modelview matrix to render the instance with
+	 * @param depth normalized distance of the instance from the camera,
+	 *              0.0 (near) to 1.0 (far)
+	 * @param pass the queue pass to render the instance in
+	 */
+	void Submit(RenderCommandQueue *queue, StaticMeshInstance *instance, StandardShader *shader, const Matrix4x4 &modelView, float depth, uint pass = 0);
+
+	/**
+	 * Queues up an instance of a static mesh to be rendered with the given
+	 * model transform during the next call to RenderInstances. Instances 
+	 * sharing the same mesh, textures and render state are grouped together
+	 * and drawn with a single draw call per mesh subset.
+	 * @param instance the static mesh instance to render
+	 * @param transform the model transform to render the instance with
+	 */
+	void AddInstance(StaticMeshInstance *instance, const Matrix4x4 &transform);
+
+	/**
+	 * Renders all instances queued up with AddInstance and then clears the
+	 * queue. Hardware instancing is used when it's supported, otherwise the
+	 * instances in each group are pre-transformed and merged together in
+	 * chunks, except for large mesh subsets, which are drawn one instance at
+	 * a time. Groups of meshes without texture coordinates are always
+	 * merged, as the instancing shader needs them. Either way, a built-in
+	 * shader is used which is bound and unbound by this method. The
+	 * projection and modelview matrices are taken from the graphics device's
+	 * current view context.
+	 * @param graphicsDevice the graphics device to render with
+	 */
+	void RenderInstances(GraphicsDevice *graphicsDevice);
+
 private:
 	void RenderAllSubsets(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance);
 	void RenderAllSubsetsTextureless(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance);
 
 	void RenderSubset(GraphicsDevice *graphicsDevice, const StaticMeshSubset *subset, const Texture *texture);
 	void RenderTexturelessSubset(GraphicsDevice *graphicsDevice, const StaticMeshSubset *subset);
+
+	StaticMeshInstanceBatch* GetBatchFor(StaticMeshInstance *instance);
+	void RenderBatchesInstanced(GraphicsDevice *graphicsDevice);
+	void RenderBatchesMerged(GraphicsDevice *graphicsDevice);
+	void RenderSubsetPerInstance(GraphicsDevice *graphicsDevice, SimpleTextureShader *shader, VertexBuffer *source, const StaticMeshInstanceBatch *batch);
+	void RenderSubsetMerged(GraphicsDevice *graphicsDevice, const VertexBuffer *source, const StaticMeshInstanceBatch *batch);
+	bool CanRenderInstanced(const StaticMeshInstanceBatch *batch) const;
+	Texture* GetSubsetTexture(GraphicsDevice *graphicsDevice, StaticMeshInstance *instance, uint subset) const;
+
+	StaticMeshInstanceBatchList m_batches;
+	uint m_numBatches;
+	VertexBuffer *m_mergedVertices;
 };
 
 #endif
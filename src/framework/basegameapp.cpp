@@ -12,9 +12,11 @@
 #include "input/keyboard.h"
 #include "input/mouse.h"
 #include "input/touchscreen.h"
+#include "util/workerthreadpool.h"
 
 const uint DEFAULT_UPDATE_FREQUENCY = 60;
 const uint DEFAULT_MAX_FRAMESKIP = 10;
+const uint CONTENT_FRAME_TIME_BUDGET = 4;
 
 BaseGameApp::BaseGameApp()
 {
@@ -35,6 +37,7 @@ BaseGameApp::BaseGameApp()
 	m_window = NULL;
 	m_graphics = NULL;
 	m_content = NULL;
+	m_workerThreads = NULL;
 
 	SetUpdateFrequency(DEFAULT_UPDATE_FREQUENCY);
 	SetMaxFrameSkip(DEFAULT_MAX_FRAMESKIP);
@@ -48,6 +51,7 @@ BaseGameApp::~BaseGameApp()
 	
 	SAFE_DELETE(m_content);
 	SAFE_DELETE(m_graphics);
+	SAFE_DELETE(m_workerThreads);
 }
 
 bool BaseGameApp::Start(OperatingSystem *system)
@@ -90,11 +94,15 @@ bool BaseGameApp::Initialize(GameWindowParams *windowParams)
 
 	m_graphics = new GraphicsDevice();
 	ASSERT(m_graphics != NULL);
-	m_graphics->Initialize(m_window);
+	m_graphics->Initialize(m_window, m_system->GetFileSystem());
 
 	m_content = new ContentManager(this);
 	ASSERT(m_content != NULL);
 
+	// the main thread does work too, so one less worker than there are cores
+	m_workerThreads = new WorkerThreadPool(WorkerThreadPool::GetNumProcessors() - 1);
+	ASSERT(m_workerThreads != NULL);
+
 	LOG_INFO(LOGCAT_GAMEAPP, "Initialization finished.\n");
 
 	return true;
@@ -181,6 +189,11 @@ void BaseGameApp::Loop()
 				m_isDirty = true;
 			}
 
+			// content loaded in the background may still need a GL context
+			// to be finished off with
+			if (m_window->HasGLContext())
+				m_content->OnFrame(CONTENT_FRAME_TIME_BUDGET);
+
 			if (m_isDirty && m_window->IsActive() && m_window->HasGLContext())
 			{
 				uint before = GetTicks();
@@ -12,6 +12,7 @@ class Keyboard;
 class Mouse;
 class OperatingSystem;
 class Touchscreen;
+class WorkerThreadPool;
 struct GameWindowParams;
 
 /**
@@ -66,6 +67,12 @@ public:
 	 */
 	ContentManager* GetContentManager() const              { return m_content; }
 
+	/**
+	 * @return worker thread pool used to spread work out over all
+	 *         processor cores, or NULL if initialization failed
+	 */
+	WorkerThreadPool* GetWorkerThreadPool() const          { return m_workerThreads; }
+
 	/**
 	 * @return the number of frames that were rendered and updated during the last second
 	 *         (this number includes skipped renders/updates in it's count)
@@ -234,6 +241,7 @@ private:
 
 	GraphicsDevice *m_graphics;
 	ContentManager *m_content;
+	WorkerThreadPool *m_workerThreads;
 };
 
 #endif
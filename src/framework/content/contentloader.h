@@ -44,6 +44,14 @@ public:
 	 */
 	virtual void OnLostContext()                           {}
 
+	/**
+	 * Per-frame callback for finishing off any work that must be done on
+	 * the main thread, such as uploading data loaded in the background.
+	 * @param timeBudget number of ticks this loader should try to keep
+	 *                   within this frame
+	 */
+	virtual void OnFrame(uint timeBudget)                  {}
+
 	/**
 	 * Forcefully removes all loaded content.
 	 */
@@ -49,6 +49,15 @@ void ContentManager::OnLostContext()
 	}
 }
 
+void ContentManager::OnFrame(uint timeBudget)
+{
+	for (ContentLoaderMap::iterator itor = m_loaders.begin(); itor != m_loaders.end(); ++itor)
+	{
+		ContentLoaderBase *loader = itor->second;
+		loader->OnFrame(timeBudget);
+	}
+}
+
 void ContentManager::RegisterLoader(ContentLoaderBase *loader)
 {
 	ASSERT(loader != NULL);
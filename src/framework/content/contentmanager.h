@@ -42,6 +42,13 @@ public:
 	 */
 	void OnLostContext();
 
+	/**
+	 * Per-frame callback for loaders to finish off background loading.
+	 * @param timeBudget number of ticks each loader should try to keep
+	 *                   within this frame
+	 */
+	void OnFrame(uint timeBudget);
+
 	/**
 	 * Registers a content loader that will handle loading and freeing of
 	 * content objects that match a specific content type.
@@ -41,7 +41,7 @@ KeyframeMesh* KeyframeMeshLoader::LoadContent(const stl::string &file, const Con
 	ASSERT(meshFile != NULL);
 
 	// convert it into a mesh object
-	KeyframeMesh *mesh = new KeyframeMesh(meshFile);
+	KeyframeMesh *mesh = new KeyframeMesh(meshFile, GetContentManager()->GetGameApp()->GetGraphicsDevice());
 	SAFE_DELETE(meshFile);
 
 	// close the file
@@ -9,82 +9,83 @@
 #include "../operatingsystem.h"
 #include "../file/filesystem.h"
 #include "../file/memoryfile.h"
-#include "../graphics/color.h"
-#include "../graphics/customtextureatlas.h"
 #include "../graphics/graphicsdevice.h"
-#include "../graphics/image.h"
 #include "../graphics/spritefont.h"
-#include "../graphics/texture.h"
-#include "../math/rect.h"
-#include "../math/rectf.h"
-#include "../math/mathhelpers.h"
-#include <math.h>
+#include "../graphics/spritefontglyphcache.h"
 #include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include <crt/snprintf.h>
 
 #define LOGGING_TAG "SpriteFontLoader"
 
+// appended to the names of distance field fonts so they're kept separate
+// from normal fonts loaded from the same file at the same size
+const char *DISTANCE_FIELD_SUFFIX = ":sdf";
+
 SpriteFontLoader::SpriteFontLoader(ContentManager *contentManager)
 	: ContentLoaderMapStoreBase<SpriteFont>(LOGGING_TAG, contentManager, "assets://fonts/")
 {
+	m_glyphCache = NULL;
+	m_distanceFieldGlyphCache = NULL;
+	m_numFonts = 0;
 }
 
 SpriteFontLoader::SpriteFontLoader(ContentManager *contentManager, const stl::string &defaultPath)
 	: ContentLoaderMapStoreBase<SpriteFont>(LOGGING_TAG, contentManager, defaultPath)
 {
+	m_glyphCache = NULL;
+	m_distanceFieldGlyphCache = NULL;
+	m_numFonts = 0;
 }
 
 SpriteFontLoader::~SpriteFontLoader()
 {
+	SAFE_DELETE(m_glyphCache);
+	SAFE_DELETE(m_distanceFieldGlyphCache);
 }
 
 void SpriteFontLoader::OnNewContext()
 {
-	LOG_INFO(LOGCAT_ASSETS, "%s: reloading previous fonts for new OpenGL context.\n", GetLoggingTag());
-
-	for (ContentStoreItor itor = m_content.begin(); itor != m_content.end(); ++itor)
-	{
-		SpriteFont *font = itor->second.content;
-		if (font->GetTexture() == NULL)
-		{
-			stl::string filename;
-			uint size = 0;
-			
-			DecomposeFilename(itor->first, filename, size);
-			
-			File *fontFile = GetContentManager()->GetGameApp()->GetOperatingSystem()->GetFileSystem()->Open(filename, FILEMODE_READ | FILEMODE_BINARY);
-			ASSERT(fontFile != NULL);
-
-			Load(fontFile, size, font);
-
-			SAFE_DELETE(fontFile);
-		}
-	}
+	LOG_INFO(LOGCAT_ASSETS, "%s: recreating font glyph textures for new OpenGL context.\n", GetLoggingTag());
+
+	// glyph metrics are all still valid, only the textures they're on need
+	// to be recreated
+	if (m_glyphCache != NULL)
+		m_glyphCache->OnNewContext();
+	if (m_distanceFieldGlyphCache != NULL)
+		m_distanceFieldGlyphCache->OnNewContext();
 }
 
 void SpriteFontLoader::OnLostContext()
 {
 	LOG_INFO(LOGCAT_ASSETS, "%s: invoking lost OpenGL context event for all loaded fonts.\n", GetLoggingTag());
 
-	for (ContentStoreItor itor = m_content.begin(); itor != m_content.end(); ++itor)
-	{
-		SpriteFont *font = itor->second.content;
-		font->OnLostContext();
-	}
+	if (m_glyphCache != NULL)
+		m_glyphCache->OnLostContext();
+	if (m_distanceFieldGlyphCache != NULL)
+		m_distanceFieldGlyphCache->OnLostContext();
 }
 
 SpriteFont* SpriteFontLoader::LoadContent(const stl::string &file, const ContentParam *params)
 {
 	stl::string filename;
 	uint size = 0;
+	bool distanceField = false;
 	
-	DecomposeFilename(file, filename, size);
+	DecomposeFilename(file, filename, size, distanceField);
 	
 	File *fontFile = GetContentManager()->GetGameApp()->GetOperatingSystem()->GetFileSystem()->Open(filename, FILEMODE_READ | FILEMODE_BINARY);
 	ASSERT(fontFile != NULL);
 	
-	SpriteFont *font = Load(fontFile, size, NULL);
+	SpriteFontGlyphCache *&glyphCache = (distanceField ? m_distanceFieldGlyphCache : m_glyphCache);
+	if (glyphCache == NULL)
+	{
+		glyphCache = new SpriteFontGlyphCache(GetContentManager()->GetGameApp()->GetGraphicsDevice());
+		ASSERT(glyphCache != NULL);
+	}
+
+	SpriteFont *font = Load(fontFile, size, distanceField);
 	
 	SAFE_DELETE(fontFile);
 	
@@ -101,214 +102,73 @@ stl::string SpriteFontLoader::ProcessFilename(const stl::string &filename, const
 	const SpriteFontParam *spriteFontParams = (const SpriteFontParam*)params;
 	ASSERT(spriteFontParams->size > 0);
 
-	snprintf(buffer, 1024, "%s:%d", filename.c_str(), spriteFontParams->size);
+	snprintf(buffer, 1024, "%s:%d%s", filename.c_str(), spriteFontParams->size, (spriteFontParams->distanceField ? DISTANCE_FIELD_SUFFIX : ""));
 	return buffer;
 }
 
-void SpriteFontLoader::DecomposeFilename(const stl::string &filename, stl::string &outFilename, uint &outSize) const
+void SpriteFontLoader::DecomposeFilename(const stl::string &filename, stl::string &outFilename, uint &outSize, bool &outDistanceField) const
 {
 	ASSERT(filename.length() > 0);
+
+	stl::string name = filename;
+	size_t suffixLength = strlen(DISTANCE_FIELD_SUFFIX);
+	outDistanceField = (name.length() > suffixLength && name.compare(name.length() - suffixLength, suffixLength, DISTANCE_FIELD_SUFFIX) == 0);
+	if (outDistanceField)
+		name.erase(name.length() - suffixLength);
 	
-	size_t startOfSize = filename.find_last_of(':');
+	size_t startOfSize = name.find_last_of(':');
 	ASSERT(startOfSize != stl::string::npos);
 	
 	// break it up into filename and font size
-	outFilename = filename.substr(0, startOfSize);
-	outSize = (uint)atoi(filename.substr(startOfSize + 1).c_str());
+	outFilename = name.substr(0, startOfSize);
+	outSize = (uint)atoi(name.substr(startOfSize + 1).c_str());
 }
 
-SpriteFont* SpriteFontLoader::Load(File *file, uint size, SpriteFont *existing) const
+SpriteFont* SpriteFontLoader::Load(File *file, uint size, bool distanceField)
 {
-	LOG_INFO(LOGCAT_ASSETS, "%s: loading \"%s:%d\"\n", GetLoggingTag(), file->GetFilename().c_str(), size);
-
-	// TODO: somehow find a way to base this on the font size requested, as this
-	//       could be really wasteful for tiny fonts
-	const int FONT_BITMAP_WIDTH = 1024;
-	const int FONT_BITMAP_HEIGHT = 1024;
-	const int NUM_GLYPHS = HIGH_GLYPH - LOW_GLYPH;
-
-	uint8_t *fileData = NULL;
-	
+	LOG_INFO(LOGCAT_ASSETS, "%s: loading \"%s:%d\"%s\n", GetLoggingTag(), file->GetFilename().c_str(), size, (distanceField ? " as distance field" : ""));
+
+	// glyphs are rasterized on demand for as long as the font is alive, so
+	// it needs it's own copy of the font file data even if the file is
+	// already in memory
+	size_t fileSize = file->GetFileSize();
+	uint8_t *fileData = new uint8_t[fileSize];
+	ASSERT(fileData != NULL);
 	if (file->GetFileType() == FILETYPE_MEMORY)
 	{
 		MemoryFile *memoryFile = (MemoryFile*)file;
-		fileData = (uint8_t*)memoryFile->GetFileData();
+		memcpy(fileData, memoryFile->GetFileData(), fileSize);
 	}
 	else
-	{
-		size_t fileSize = file->GetFileSize();
-		fileData = new uint8_t[fileSize];
 		file->Read((int8_t*)fileData, fileSize);
-	}
-
-	stbtt_fontinfo fontinfo;
-	int initResult = stbtt_InitFont(&fontinfo, fileData, 0);
-	if (!initResult)
-		return NULL;
-
-	// get glyph metrics for the "maximum size" glyph as an indicator of the
-	// general size of each glyph in this font. Uppercase 'W' seems to be a 
-	// pretty good glyph to represent this "maximum size".
-	SpriteFontGlyphMetrics maxMetrics;
-	bool maxMetricResult = GetGlyphMetrics(&fontinfo, 'W', size, &maxMetrics);
-	ASSERT(maxMetricResult == true);
-
-	// if we can't even get this glyph's metrics then stop now
-	if (!maxMetricResult)
-		return NULL;
-
-	// the raw bitmap that we will be building. using a fixed size which should hopefully be good enough for the limited charset
-	// that we're allowing as long as the font pixel size doesn't get too large
-	// this bitmap is *only* going to contain alpha values (not any kind of rgb colour data)
-	Image *bitmap = new Image();
-	bool bitmapCreateSuccess = bitmap->Create(FONT_BITMAP_WIDTH, FONT_BITMAP_HEIGHT, IMAGE_FORMAT_ALPHA);
-	ASSERT(bitmapCreateSuccess == true);
-	bitmap->Clear();
-
-	// the texture atlas to store the position/texcoords of each glyph
-	CustomTextureAtlas *glyphs = new CustomTextureAtlas(bitmap->GetWidth(), bitmap->GetHeight());
-	ASSERT(glyphs != NULL);
-
-	// NOTE TO SELF: a lot of this feels "hackish" and that some weird font isn't going to play nice with this. clean this up at some point!
-
-	// current position to draw the glyph to on the bitmap
-	int x = 0;
-	int y = 0;
 
-	// total line height for each row of glyphs on the bitmap. this is not really the font height.
-	// it is likely slightly larger then that. this adds the font's descent a second time to make
-	// vertical room for a few of the glyphs (e.g. '{}' or '()', or even '$') which go off the
-	// top/bottom by a slight bit
-	int lineHeight = (maxMetrics.ascent - maxMetrics.descent) + maxMetrics.lineGap - maxMetrics.descent;
-
-	for (int i = 0; i < NUM_GLYPHS; ++i)
+	SpriteFont *result = new SpriteFont();
+	ASSERT(result != NULL);
+	SpriteFontGlyphCache *glyphCache = (distanceField ? m_distanceFieldGlyphCache : m_glyphCache);
+	if (!result->Load(glyphCache, fileData, size, distanceField))
 	{
-		// get metrics for the current glyph
-		char c = (char)(i + LOW_GLYPH);
-		SpriteFontGlyphMetrics glyphMetrics;
-		bool metricResult = GetGlyphMetrics(&fontinfo, c, size, &glyphMetrics);
-		ASSERT(metricResult == true);
-
-		// adjust each glyph's rect so that it has it's own space that doesn't
-		// collide with any of it's neighbour glyphs (neighbour as seen on the 
-		// font bitmap)
-		if (glyphMetrics.dimensions.left < 0)
-		{
-			// bump the glyph over to the right by the same amount it was over to the left
-			glyphMetrics.advance += -glyphMetrics.dimensions.left;
-			glyphMetrics.dimensions.left = 0;
-		}
-
-		// do we need to move to the next row?
-		if ((x + glyphMetrics.advance + glyphMetrics.dimensions.left) >= bitmap->GetWidth())
-		{
-			// yes
-			x = 0;
-			y += lineHeight;
-			ASSERT((y + lineHeight) < bitmap->GetHeight());
-		}
-
-		// the destination bitmap pixel coordinates of this glyph. these are the
-		// pixel coordinates that will be stored in the font's texture atlas
-		// which will be used by the texture atlas to build texture coords
-		Rect position(
-			x, 
-			y, 
-			x + glyphMetrics.advance, 
-			y + lineHeight
-		);
-
-		// top-left coords and dimensions to have stb_truetype draw the glyph at in the font bitmap
-		int drawX = position.left + glyphMetrics.dimensions.left;
-		int drawY = (position.bottom + glyphMetrics.descent) + glyphMetrics.descent - glyphMetrics.dimensions.bottom + maxMetrics.lineGap;
-		int drawWidth = position.GetWidth();
-		int drawHeight = position.GetHeight();
-
-		// use stb_truetype to render the glyph onto the bitmap
-		int pixelsDestOffset = drawX + (drawY * bitmap->GetWidth());
-		stbtt_MakeGlyphBitmap(&fontinfo, bitmap->GetPixels() + pixelsDestOffset, drawWidth, drawHeight, bitmap->GetWidth(), maxMetrics.scale, maxMetrics.scale, glyphMetrics.index);
-
-		// add the glyph position to the texture atlas (which will calc the texture coords for us)
-		int newIndex = glyphs->Add(position);
-		ASSERT(newIndex == ((int)c - LOW_GLYPH));
-
-		// move to the next glyph's position in the bitmap
-		x += maxMetrics.advance;
-	}
-
-	Texture *fontTexture = new Texture();
-	bool textureCreated = fontTexture->Create(GetContentManager()->GetGameApp()->GetGraphicsDevice(), bitmap);
-	ASSERT(textureCreated == true);
-	SAFE_DELETE(bitmap);
-	if (!textureCreated)
-	{
-		// clean up
-		SAFE_DELETE(fontTexture);
-		SAFE_DELETE(glyphs);
-		if (file->GetFileType() != FILETYPE_MEMORY)
-			SAFE_DELETE_ARRAY(fileData);
+		LOG_ERROR(LOGCAT_ASSETS, "%s: failed to read font data for \"%s\"\n", GetLoggingTag(), file->GetFilename().c_str());
+		SAFE_DELETE(result);
 		return NULL;
 	}
 
-	if (file->GetFileType() != FILETYPE_MEMORY)
-		SAFE_DELETE_ARRAY(fileData);
-	
-	// re-loading an existing font object instance, or creating a new one?
-	SpriteFont *result;
-	if (existing != NULL)
-		result = existing;
-	else
-	{
-		result = new SpriteFont();
-		ASSERT(result != NULL);
-	}
-	result->Load(fontTexture, glyphs, size);
+	++m_numFonts;
 	return result;
 }
 
 void SpriteFontLoader::FreeContent(SpriteFont *content)
 {
 	SAFE_DELETE(content);
-}
-
-bool SpriteFontLoader::GetGlyphMetrics(stbtt_fontinfo *fontInfo, char glyph, uint size, SpriteFontGlyphMetrics *metrics) const
-{
-	ASSERT(metrics != NULL);
-
-	// need to properly scale! sizes as returned from most (all?) metric-related functions will be huge
-	// (I will at this point admit that I don't fully understand what units the metric functions are working with
-	// and why this scale value is necessary... I just haven't read enough into this stuff I guess)
-	metrics->scale = stbtt_ScaleForPixelHeight(fontInfo, (float)size);
-
-	metrics->letterHeight = size;
 
-	metrics->index = stbtt_FindGlyphIndex(fontInfo, glyph);
-	if (metrics->index == 0)
-		return false;
-
-	stbtt_GetGlyphBox(fontInfo, metrics->index, &metrics->dimensions.left, &metrics->dimensions.top, &metrics->dimensions.right, &metrics->dimensions.bottom);
-	stbtt_GetFontVMetrics(fontInfo, &metrics->ascent, &metrics->descent, &metrics->lineGap);
-	stbtt_GetGlyphHMetrics(fontInfo, metrics->index, &metrics->advance, NULL);
-
-	// adjust all the metrics we got by the font size scale value
-	// (I guess this puts them from whatever units they were in to pixel units)
-	metrics->dimensions.left = (int)ceil(metrics->dimensions.left * metrics->scale);
-	metrics->dimensions.top = (int)ceil(metrics->dimensions.top * metrics->scale);
-	metrics->dimensions.right = (int)ceil(metrics->dimensions.right * metrics->scale);
-	metrics->dimensions.bottom = (int)ceil(metrics->dimensions.bottom * metrics->scale);
-	metrics->ascent = (int)ceil(metrics->ascent * metrics->scale);
-	metrics->descent = (int)ceil(metrics->descent * metrics->scale);
-	metrics->lineGap = (int)ceil(metrics->lineGap * metrics->scale);
-	metrics->advance = (int)ceil(metrics->advance * metrics->scale);
-	metrics->letterWidth = metrics->dimensions.right - metrics->dimensions.left;
-
-	// seen some pixel/bitmap fonts that have the total ascent/descent calculated height
-	// greater then the pixel height. this just figures out this difference, if present,
-	// and sets an appropriate line gap equal to it (in these cases, linegap was 0)
-	int calculatedHeight = metrics->ascent - metrics->descent;
-	int heightDifference = abs(calculatedHeight - metrics->letterHeight);
-	if (heightDifference != metrics->lineGap && metrics->lineGap == 0)
-		metrics->lineGap = heightDifference;
-
-	return true;
+	// glyphs can't be removed from the cache individually, but once there
+	// are no fonts left none of them are needed anymore
+	ASSERT(m_numFonts > 0);
+	--m_numFonts;
+	if (m_numFonts == 0)
+	{
+		if (m_glyphCache != NULL)
+			m_glyphCache->Clear();
+		if (m_distanceFieldGlyphCache != NULL)
+			m_distanceFieldGlyphCache->Clear();
+	}
 }
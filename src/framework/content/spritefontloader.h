@@ -5,41 +5,16 @@
 #include "contentparam.h"
 #include "contentloadermapstorebase.h"
 #include "../graphics/spritefont.h"
-#include "../math/rect.h"
-#include <stb_truetype.h>
 #include <stl/string.h>
 
 class ContentManager;
 class File;
-
-struct SpriteFontGlyphMetrics
-{
-	int index;
-	float scale;
-	Rect dimensions;
-	int ascent;
-	int descent;
-	int lineGap;
-	int advance;
-	int letterWidth;
-	int letterHeight;
-
-	SpriteFontGlyphMetrics()
-	{
-		index = 0;
-		scale = 0.0f;
-		dimensions = Rect(0, 0, 0, 0);
-		ascent = 0;
-		descent = 0;
-		lineGap = 0;
-		advance = 0;
-		letterWidth = 0;
-		letterHeight = 0;
-	}
-};
+class SpriteFontGlyphCache;
 
 /**
- * Content loader for sprite fonts.
+ * Content loader for sprite fonts. All fonts loaded share the same glyph
+ * cache, so different fonts and sizes can have their glyphs packed into
+ * the same textures. Distance field fonts share a separate glyph cache.
  */
 class SpriteFontLoader : public ContentLoaderMapStoreBase<SpriteFont>
 {
@@ -69,6 +44,18 @@ public:
 	 * Lost OpenGL graphics context callback.
 	 */
 	void OnLostContext();
+
+	/**
+	 * @return the glyph cache shared by all non-distance field fonts loaded
+	 *         by this loader, or NULL if no such fonts have been loaded yet
+	 */
+	SpriteFontGlyphCache* GetGlyphCache() const            { return m_glyphCache; }
+
+	/**
+	 * @return the glyph cache shared by all distance field fonts loaded by
+	 *         this loader, or NULL if no such fonts have been loaded yet
+	 */
+	SpriteFontGlyphCache* GetDistanceFieldGlyphCache() const { return m_distanceFieldGlyphCache; }
 	
 protected:
 	stl::string ProcessFilename(const stl::string &filename, const ContentParam *params) const;
@@ -77,10 +64,12 @@ protected:
 	void FreeContent(SpriteFont *content);
 	
 private:
-	void DecomposeFilename(const stl::string &filename, stl::string &outFilename, uint &outSize) const;
-	SpriteFont* Load(File *file, uint size, SpriteFont *existing) const;
+	void DecomposeFilename(const stl::string &filename, stl::string &outFilename, uint &outSize, bool &outDistanceField) const;
+	SpriteFont* Load(File *file, uint size, bool distanceField);
 
-	bool GetGlyphMetrics(stbtt_fontinfo *fontInfo, char glyph, uint size, SpriteFontGlyphMetrics *glyphMetrics) const;
+	SpriteFontGlyphCache *m_glyphCache;
+	SpriteFontGlyphCache *m_distanceFieldGlyphCache;
+	uint m_numFonts;
 };
 
 #endif
@@ -4,13 +4,19 @@
 #include "../common.h"
 #include "contentparam.h"
 
+// distance field fonts can be rendered at any size, so there's rarely a
+// reason to load them at any size other than this one
+const uint DEFAULT_DISTANCE_FIELD_FONT_SIZE = 32;
+
 struct SpriteFontParam : public ContentParam
 {
 	uint size;
+	bool distanceField;
 
-	SpriteFontParam(uint size)
+	SpriteFontParam(uint size, bool distanceField = false)
 	{
 		this->size = size;
+		this->distanceField = distanceField;
 	}
 };
 
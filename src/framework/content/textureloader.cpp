@@ -6,13 +6,17 @@
 
 #include "contentmanager.h"
 #include "imageloader.h"
+#include "textureparam.h"
 #include "../basegameapp.h"
 #include "../operatingsystem.h"
 #include "../graphics/graphicsdevice.h"
 #include "../graphics/image.h"
 #include "../graphics/texture.h"
+#include "../graphics/texturefileformat.h"
 #include "../file/file.h"
 #include "../file/filesystem.h"
+#include "../file/memoryfile.h"
+#include "../util/workerthreadpool.h"
 #include <stl/string.h>
 
 #define LOGGING_TAG "TextureLoader"
@@ -29,6 +33,13 @@ TextureLoader::TextureLoader(ContentManager *contentManager, const stl::string &
 
 TextureLoader::~TextureLoader()
 {
+	// decode tasks still running will be touching their loads
+	if (!m_asyncLoads.empty())
+		GetContentManager()->GetGameApp()->GetWorkerThreadPool()->WaitForTasks();
+
+	for (AsyncTextureLoads::iterator i = m_asyncLoads.begin(); i != m_asyncLoads.end(); ++i)
+		FreeAsyncLoad(*i);
+	m_asyncLoads.clear();
 }
 
 void TextureLoader::OnNewContext()
@@ -56,13 +67,70 @@ void TextureLoader::OnLostContext()
 		itor->second.content->OnLostContext();
 }
 
+void TextureLoader::OnFrame(uint timeBudget)
+{
+	if (m_asyncLoads.empty())
+		return;
+
+	BaseGameApp *gameApp = GetContentManager()->GetGameApp();
+	uint startTime = gameApp->GetTicks();
+
+	AsyncTextureLoads::iterator i = m_asyncLoads.begin();
+	while (i != m_asyncLoads.end())
+	{
+		// always upload at least one texture so loading can't stall
+		if (i != m_asyncLoads.begin() && (gameApp->GetTicks() - startTime) >= timeBudget)
+			break;
+
+		AsyncTextureLoad *load = *i;
+
+		m_mutex.Lock();
+		bool isDecoded = load->isDecoded;
+		m_mutex.Unlock();
+		if (!isDecoded)
+		{
+			++i;
+			continue;
+		}
+
+		if (load->texture != NULL)
+		{
+			if (load->image == NULL)
+				LOG_ERROR(LOGCAT_ASSETS, "%s: failed to decode \"%s\" in the background.\n", GetLoggingTag(), load->file.c_str());
+			else
+			{
+				load->texture->Release();
+				if (load->texture->Create(gameApp->GetGraphicsDevice(), load->image))
+					gameApp->Invalidate();
+				else
+					LOG_ERROR(LOGCAT_ASSETS, "%s: failed to create texture for \"%s\".\n", GetLoggingTag(), load->file.c_str());
+			}
+		}
+
+		FreeAsyncLoad(load);
+		i = m_asyncLoads.erase(i);
+	}
+}
+
 Texture* TextureLoader::LoadContent(const stl::string &file, const ContentParam *params)
 {
-	return Load(file, NULL);
+	const TextureParam *textureParams = (const TextureParam*)params;
+	if (textureParams != NULL && textureParams->loadAsync)
+		return LoadAsync(file);
+	else
+		return Load(file, NULL);
 }
 
 void TextureLoader::FreeContent(Texture *content)
 {
+	// the load itself can't be freed until it's done decoding
+	for (AsyncTextureLoads::iterator i = m_asyncLoads.begin(); i != m_asyncLoads.end(); ++i)
+	{
+		AsyncTextureLoad *load = *i;
+		if (load->texture == content)
+			load->texture = NULL;
+	}
+
 	SAFE_DELETE(content);
 }
 
@@ -73,6 +141,10 @@ Texture* TextureLoader::Load(const stl::string &file, Texture *existingTexture)
 			 file.c_str()
 			 );
 
+	size_t extensionLength = sizeof(TEXTURE_FILE_EXTENSION) - 1;
+	if (file.length() > extensionLength && file.compare(file.length() - extensionLength, extensionLength, TEXTURE_FILE_EXTENSION) == 0)
+		return LoadConverted(file, existingTexture);
+
 	Image *image = GetContentManager()->Get<Image>(file.c_str());
 	ASSERT(image != NULL);
 	if (image == NULL)
@@ -99,3 +171,121 @@ Texture* TextureLoader::Load(const stl::string &file, Texture *existingTexture)
 
 	return texture;
 }
+
+Texture* TextureLoader::LoadAsync(const stl::string &file)
+{
+	// converted textures are just uploaded as-is, nothing to be gained here.
+	// same goes for when there are no worker threads to decode on
+	size_t extensionLength = sizeof(TEXTURE_FILE_EXTENSION) - 1;
+	bool isConverted = (file.length() > extensionLength && file.compare(file.length() - extensionLength, extensionLength, TEXTURE_FILE_EXTENSION) == 0);
+	WorkerThreadPool *workerThreads = GetContentManager()->GetGameApp()->GetWorkerThreadPool();
+	if (isConverted || workerThreads->GetNumThreads() <= 1)
+		return Load(file, NULL);
+
+	LOG_INFO(LOGCAT_ASSETS, "%s: loading \"%s\" in the background\n",
+			 GetLoggingTag(),
+			 file.c_str()
+			 );
+
+	const uint8_t placeholderPixels[4] = { 0, 0, 0, 0 };
+	const void *placeholderMipLevels[1] = { placeholderPixels };
+
+	Texture *texture = new Texture();
+	bool success = texture->Create(GetContentManager()->GetGameApp()->GetGraphicsDevice(), 1, 1, TEXTURE_FORMAT_RGBA, placeholderMipLevels, 1);
+	if (!success)
+	{
+		SAFE_DELETE(texture);
+		return NULL;
+	}
+
+	AsyncTextureLoad *load = new AsyncTextureLoad();
+	load->loader = this;
+	load->file = file;
+	load->texture = texture;
+	load->image = NULL;
+	load->isDecoded = false;
+	m_asyncLoads.push_back(load);
+
+	workerThreads->QueueTask(DecodeAsync, load);
+
+	return texture;
+}
+
+void TextureLoader::FreeAsyncLoad(AsyncTextureLoad *load)
+{
+	SAFE_DELETE(load->image);
+	SAFE_DELETE(load);
+}
+
+void TextureLoader::DecodeAsync(void *context)
+{
+	// NOTE: runs on a worker thread. only the image and decoded flag can be
+	//       touched here, the load's texture belongs to the main thread
+	AsyncTextureLoad *load = (AsyncTextureLoad*)context;
+	TextureLoader *loader = load->loader;
+
+	Image *image = NULL;
+	File *imageFile = loader->GetContentManager()->GetGameApp()->GetOperatingSystem()->GetFileSystem()->Open(load->file, FILEMODE_READ | FILEMODE_BINARY);
+	if (imageFile != NULL)
+	{
+		image = new Image();
+		if (!image->Create(imageFile))
+			SAFE_DELETE(image);
+		SAFE_DELETE(imageFile);
+	}
+
+	loader->m_mutex.Lock();
+	load->image = image;
+	load->isDecoded = true;
+	loader->m_mutex.Unlock();
+}
+
+Texture* TextureLoader::LoadConverted(const stl::string &file, Texture *existingTexture)
+{
+	File *textureFile = GetContentManager()->GetGameApp()->GetOperatingSystem()->GetFileSystem()->Open(file, FILEMODE_READ | FILEMODE_BINARY | FILEMODE_MAPPED);
+	ASSERT(textureFile != NULL);
+	if (textureFile == NULL)
+		return NULL;
+
+	// mapped files can have their pixel data passed straight through to
+	// OpenGL without being copied anywhere first
+	size_t fileSize = textureFile->GetFileSize();
+	const uint8_t *fileData = NULL;
+	uint8_t *fileBuffer = NULL;
+	if (textureFile->GetFileType() == FILETYPE_MEMORY)
+		fileData = (const uint8_t*)((MemoryFile*)textureFile)->GetFileData();
+	else
+	{
+		fileBuffer = new uint8_t[fileSize];
+		ASSERT(fileBuffer != NULL);
+		textureFile->Read((int8_t*)fileBuffer, fileSize);
+		fileData = fileBuffer;
+	}
+
+	Texture *texture = NULL;
+	if (!IsValidTextureFile(fileData, fileSize))
+		LOG_ERROR(LOGCAT_ASSETS, "%s: \"%s\" is not a valid converted texture file.\n", GetLoggingTag(), file.c_str());
+	else
+	{
+		const TextureFileHeader *header = (const TextureFileHeader*)fileData;
+		const TextureFileMipLevel *levels = (const TextureFileMipLevel*)(header + 1);
+
+		const void *mipLevels[TEXTURE_FILE_MAX_MIP_LEVELS];
+		for (uint i = 0; i < header->numMipLevels; ++i)
+			mipLevels[i] = fileData + levels[i].offset;
+
+		texture = existingTexture;
+		if (texture == NULL)
+			texture = new Texture();
+
+		bool isAlphaPremultiplied = IsBitSet(TEXTURE_FILE_FLAG_PREMULTIPLIED_ALPHA, header->flags);
+		bool success = texture->Create(GetContentManager()->GetGameApp()->GetGraphicsDevice(), header->width, header->height, (TEXTURE_FORMAT)header->format, mipLevels, header->numMipLevels, isAlphaPremultiplied);
+		if (!success && existingTexture == NULL)
+			SAFE_DELETE(texture);
+	}
+
+	SAFE_DELETE_ARRAY(fileBuffer);
+	SAFE_DELETE(textureFile);
+
+	return texture;
+}
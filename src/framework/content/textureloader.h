@@ -5,12 +5,35 @@
 #include "contentparam.h"
 #include "contentloadermapstorebase.h"
 #include "../graphics/texture.h"
+#include "../util/mutex.h"
+#include <stl/list.h>
 #include <stl/string.h>
 
 class ContentManager;
+class Image;
+class TextureLoader;
+
+struct AsyncTextureLoad
+{
+	TextureLoader *loader;
+	stl::string file;
+	// set to NULL if the texture is freed before loading finishes
+	Texture *texture;
+	Image *image;
+	bool isDecoded;
+};
+
+typedef stl::list<AsyncTextureLoad*> AsyncTextureLoads;
 
 /**
- * Content loader for textures.
+ * Content loader for textures. Files ending in ".tex" are loaded as converted
+ * texture files (see texturefileformat.h), which are memory mapped and have
+ * their pixel data uploaded directly. Anything else is loaded as an image.
+ *
+ * Images can be loaded asynchronously by passing a TextureParam with
+ * loadAsync set. The image is then decoded on one of the game app's worker
+ * threads while a placeholder texture is returned, and uploaded in place of
+ * the placeholder during a later frame.
  */
 class TextureLoader : public ContentLoaderMapStoreBase<Texture>
 {
@@ -41,12 +64,33 @@ public:
 	 */
 	void OnLostContext();
 
+	/**
+	 * Uploads textures for images that have finished decoding in the
+	 * background.
+	 * @param timeBudget number of ticks to stop uploading textures after
+	 */
+	void OnFrame(uint timeBudget);
+
+	/**
+	 * @return the number of textures still waiting on their images to be
+	 *         decoded or uploaded
+	 */
+	uint GetNumPendingAsyncLoads() const                   { return m_asyncLoads.size(); }
+
 protected:
 	Texture* LoadContent(const stl::string &file, const ContentParam *params);
 	void FreeContent(Texture *content);
 	
 private:
 	Texture* Load(const stl::string &file, Texture *existingTexture = NULL);
+	Texture* LoadConverted(const stl::string &file, Texture *existingTexture);
+	Texture* LoadAsync(const stl::string &file);
+	void FreeAsyncLoad(AsyncTextureLoad *load);
+
+	static void DecodeAsync(void *context);
+
+	AsyncTextureLoads m_asyncLoads;
+	Mutex m_mutex;
 };
 
 #endif
@@ -0,0 +1,20 @@
+#ifndef __FRAMEWORK_CONTENT_TEXTUREPARAM_H_INCLUDED__
+#define __FRAMEWORK_CONTENT_TEXTUREPARAM_H_INCLUDED__
+
+#include "../common.h"
+#include "contentparam.h"
+
+struct TextureParam : public ContentParam
+{
+	// if true, the texture is returned right away as a 1x1 transparent
+	// placeholder and its image is decoded on a worker thread, with the
+	// real texture being uploaded in place once decoding finishes
+	bool loadAsync;
+
+	TextureParam(bool loadAsync = false)
+	{
+		this->loadAsync = loadAsync;
+	}
+};
+
+#endif
@@ -10,7 +10,8 @@ enum FileMode
 	FILEMODE_WRITE = 2,
 	FILEMODE_BINARY = 4,
 	FILEMODE_APPEND = 8,
-	FILEMODE_MEMORY = 16
+	FILEMODE_MEMORY = 16,
+	FILEMODE_MAPPED = 32
 };
 
 enum FileSeek
@@ -38,6 +38,11 @@ public:
 	 * @return the path to the root of the assets directory
 	 */
 	virtual const stl::string& GetAssetsPath() const = 0;
+
+	/**
+	 * @return the path to the root of the writable storage directory
+	 */
+	virtual const stl::string& GetStoragePath() const = 0;
 };
 
 #endif
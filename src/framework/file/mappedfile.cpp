@@ -0,0 +1,119 @@
+#ifdef SDL
+#include "../debug.h"
+#include "../log.h"
+
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define WIN32_EXTRA_LEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	m_mapping = NULL;
+	m_mappingSize = 0;
+#ifdef _WIN32
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const stl::string &filename)
+{
+	ASSERT(IsOpen() == false);
+	ASSERT(m_mapping == NULL);
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	void *mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (mapping == NULL)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_mappingSize = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat fileInfo;
+	if (fstat(fd, &fileInfo) == -1 || fileInfo.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void *mapping = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after the file descriptor is closed
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	m_mappingSize = (size_t)fileInfo.st_size;
+#endif
+
+	m_mapping = mapping;
+	MemoryFile::Open(m_mapping, m_mappingSize, true, false);
+	SetFilename(filename);
+
+	LOG_INFO(LOGCAT_FILEIO, "Mapped file \"%s\" (%d bytes)\n", filename.c_str(), m_mappingSize);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	MemoryFile::Close();
+
+	if (m_mapping != NULL)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_mapping);
+		CloseHandle((HANDLE)m_mappingHandle);
+		CloseHandle((HANDLE)m_fileHandle);
+		m_mappingHandle = NULL;
+		m_fileHandle = NULL;
+#else
+		munmap(m_mapping, m_mappingSize);
+#endif
+	}
+
+	m_mapping = NULL;
+	m_mappingSize = 0;
+}
+#endif
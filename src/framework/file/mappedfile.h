@@ -0,0 +1,40 @@
+#ifdef SDL
+#ifndef __FRAMEWORK_FILE_MAPPEDFILE_H_INCLUDED__
+#define __FRAMEWORK_FILE_MAPPEDFILE_H_INCLUDED__
+
+#include "../common.h"
+#include "memoryfile.h"
+
+#include <stl/string.h>
+
+/**
+ * Read-only file whose contents are memory mapped by the operating system
+ * instead of being read into memory up front. Pages of the file are only
+ * read from the disk as they are accessed, and GetFileData() can be used
+ * to access the file's contents directly without any copying.
+ */
+class MappedFile : public MemoryFile
+{
+public:
+	MappedFile();
+	virtual ~MappedFile();
+
+	/**
+	 * Memory maps a file for reading.
+	 * @param filename the full path and filename of the file to map
+	 * @return true if successful
+	 */
+	bool Open(const stl::string &filename);
+	void Close();
+
+private:
+	void *m_mapping;
+	size_t m_mappingSize;
+#ifdef _WIN32
+	void *m_fileHandle;
+	void *m_mappingHandle;
+#endif
+};
+
+#endif
+#endif
@@ -15,6 +15,8 @@ MarmaladeFileSystem::MarmaladeFileSystem()
 {
 	m_assetsPath = ::GetAssetsPath();
 	LOG_INFO(LOGCAT_FILEIO, "FileSystem assets path is \"%s\".\n", m_assetsPath.c_str());
+	m_storagePath = ::GetStoragePath();
+	LOG_INFO(LOGCAT_FILEIO, "FileSystem storage path is \"%s\".\n", m_storagePath.c_str());
 }
 
 MarmaladeFileSystem::~MarmaladeFileSystem()
@@ -74,6 +76,8 @@ stl::string MarmaladeFileSystem::TranslateFilePath(const stl::string &filename)
 {
 	if (filename.substr(0, 9) == "assets://")
 		return m_assetsPath + filename.substr(9);
+	else if (filename.substr(0, 10) == "storage://")
+		return m_storagePath + filename.substr(10);
 	else
 		return filename;
 }
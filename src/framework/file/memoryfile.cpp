@@ -70,6 +70,7 @@ void MemoryFile::Close()
 			LOG_INFO(LOGCAT_FILEIO, "Free MemoryFile \"%s\"\n", m_filename.c_str());
 	}
 
+	m_data = NULL;
 	m_ownData = false;
 	m_length = 0;
 	m_position = 0;
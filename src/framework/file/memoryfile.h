@@ -58,6 +58,9 @@ public:
 
 	int8_t* GetFileData() const                            { return m_data; }
 
+protected:
+	void SetFilename(const stl::string &filename)          { m_filename = filename; }
+
 private:
 	int8_t *m_data;
 	bool m_ownData;
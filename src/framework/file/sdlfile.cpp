@@ -70,7 +70,7 @@ void SDLFile::Close()
 	if (IsOpen())
 	{
 		LOG_INFO(LOGCAT_FILEIO, "Closed SDLFIle \"%s\"\n", m_filename.c_str());
-		SDL_FreeRW(m_fp);
+		SDL_RWclose(m_fp);
 	}
 
 	m_fp = NULL;
@@ -8,6 +8,7 @@
 #include "file.h"
 #include "filesystem.h"
 #include "sdlfile.h"
+#include "mappedfile.h"
 #include "memoryfile.h"
 #include "util.h"
 
@@ -15,6 +16,8 @@ SDLFileSystem::SDLFileSystem()
 {
 	m_assetsPath = ::GetAssetsPath();
 	LOG_INFO(LOGCAT_FILEIO, "FileSystem assets path is \"%s\".\n", m_assetsPath.c_str());
+	m_storagePath = ::GetStoragePath();
+	LOG_INFO(LOGCAT_FILEIO, "FileSystem storage path is \"%s\".\n", m_storagePath.c_str());
 }
 
 SDLFileSystem::~SDLFileSystem()
@@ -26,7 +29,15 @@ File* SDLFileSystem::Open(const stl::string &filename, int mode)
 	File *result = NULL;
 	stl::string realFilename = TranslateFilePath(filename);
 
-	if (mode & FILEMODE_MEMORY)
+	if (mode & FILEMODE_MAPPED)
+	{
+		result = OpenMapped(realFilename, mode);
+
+		// mapping can fail in ways that reading the file normally won't
+		if (result == NULL)
+			result = OpenMemory(realFilename, mode);
+	}
+	else if (mode & FILEMODE_MEMORY)
 		result = OpenMemory(realFilename, mode);
 	else
 		result = OpenFile(realFilename, mode);
@@ -70,10 +81,31 @@ File* SDLFileSystem::OpenMemory(const stl::string &filename, int mode)
 	return memoryFile;
 }
 
+File* SDLFileSystem::OpenMapped(const stl::string &filename, int mode)
+{
+	// mapped files are only ever read from
+	ASSERT((mode & FILEMODE_WRITE) == 0 && (mode & FILEMODE_APPEND) == 0);
+	if (mode & FILEMODE_WRITE || mode & FILEMODE_APPEND)
+		return NULL;
+
+	MappedFile *file = new MappedFile();
+	ASSERT(file != NULL);
+
+	if (file->Open(filename))
+		return file;
+	else
+	{
+		SAFE_DELETE(file);
+		return NULL;
+	}
+}
+
 stl::string SDLFileSystem::TranslateFilePath(const stl::string &filename) const
 {
 	if (filename.substr(0, 9) == "assets://")
 		return m_assetsPath + filename.substr(9);
+	else if (filename.substr(0, 10) == "storage://")
+		return m_storagePath + filename.substr(10);
 	else
 		return filename;
 }
@@ -18,12 +18,15 @@ public:
 
 	stl::string TranslateFilePath(const stl::string &filename) const;
 	const stl::string& GetAssetsPath() const                  { return m_assetsPath; }
+	const stl::string& GetStoragePath() const                 { return m_storagePath; }
 
 private:
 	File* OpenFile(const stl::string &filename, int mode);
 	File* OpenMemory(const stl::string &filename, int mode);
+	File* OpenMapped(const stl::string &filename, int mode);
 
 	stl::string m_assetsPath;
+	stl::string m_storagePath;
 };
 
 #endif
@@ -6,8 +6,12 @@
 #define WIN32_LEAN_AND_MEAN
 #define WIN32_EXTRA_LEAN
 #include <windows.h>
+#include <stdlib.h>
 #elif __linux__
 #include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #elif __APPLE__
 #include <stdlib.h>
 #include <mach-o/dyld.h>
@@ -20,6 +24,7 @@
 
 stl::string g_appPath;
 stl::string g_assetsPath;
+stl::string g_storagePath;
 
 const stl::string& GetAppPath()
 {
@@ -149,3 +154,165 @@ const stl::string& GetAssetsPath()
 #endif
 	return g_assetsPath;
 }
+
+#ifndef MOBILE
+static stl::string GetAppName()
+{
+#ifdef _WIN32
+	char pathBuffer[MAX_PATH + 1];
+	DWORD length = GetModuleFileNameA(NULL, pathBuffer, MAX_PATH);
+	if (length == 0 || length >= MAX_PATH)
+		return "app";
+	pathBuffer[length] = '\0';
+
+	stl::string path = pathBuffer;
+	stl::string::size_type start = path.find_last_of("\\/");
+	stl::string name = (start == stl::string::npos ? path : path.substr(start + 1));
+	stl::string::size_type extension = name.find_last_of('.');
+	if (extension != stl::string::npos)
+		name = name.substr(0, extension);
+	return name;
+#elif __linux__
+	char proc[512];
+	int ch = readlink("/proc/self/exe", proc, 511);
+	if (ch == -1)
+		return "app";
+	proc[ch] = 0;
+
+	stl::string path = proc;
+	return path.substr(path.find_last_of("/") + 1);
+#elif __APPLE__
+	// GetAppPath() points inside the bundle when running from one, so use
+	// the bundle's name rather than the executable's
+	stl::string appPath = GetAppPath();
+	if (appPath.length() > 20 && appPath.substr(appPath.length() - 20) == ".app/Contents/MacOS/")
+		appPath = appPath.substr(0, appPath.length() - 20);
+	else
+	{
+		unsigned int size = MAXPATHLEN;
+		char pathBuffer[MAXPATHLEN];
+		if (_NSGetExecutablePath(pathBuffer, &size) != 0)
+			return "app";
+		appPath = pathBuffer;
+	}
+
+	return appPath.substr(appPath.find_last_of('/') + 1);
+#endif
+}
+
+static bool IsPathSeparator(char c)
+{
+	return (c == '/' || c == '\\');
+}
+
+// length of the part of the path that names its root and can't be created,
+// e.g. "/", "C:\" or "\\server\share\". 0 for relative paths
+static stl::string::size_type GetPathRootLength(const stl::string &path)
+{
+#ifdef _WIN32
+	if (path.length() >= 2 && path[1] == ':')
+		return (path.length() >= 3 && IsPathSeparator(path[2])) ? 3 : 2;
+
+	if (path.length() >= 2 && IsPathSeparator(path[0]) && IsPathSeparator(path[1]))
+	{
+		stl::string::size_type serverEnd = path.find_first_of("/\\", 2);
+		if (serverEnd == stl::string::npos)
+			return path.length();
+		stl::string::size_type shareEnd = path.find_first_of("/\\", serverEnd + 1);
+		if (shareEnd == stl::string::npos)
+			return path.length();
+		return shareEnd + 1;
+	}
+#endif
+	if (path.length() >= 1 && IsPathSeparator(path[0]))
+		return 1;
+
+	return 0;
+}
+
+// creates each directory in the path that doesn't already exist
+static bool CreateDirectories(const stl::string &path)
+{
+	for (stl::string::size_type i = GetPathRootLength(path) + 1; i <= path.length(); ++i)
+	{
+		if (i < path.length() && !IsPathSeparator(path[i]))
+			continue;
+
+		stl::string directory = path.substr(0, i);
+#ifdef _WIN32
+		DWORD attributes = GetFileAttributesA(directory.c_str());
+		if (attributes != INVALID_FILE_ATTRIBUTES)
+		{
+			if ((attributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+				return false;
+		}
+		else if (!CreateDirectoryA(directory.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+			return false;
+#else
+		struct stat sb;
+		if (stat(directory.c_str(), &sb) == 0)
+		{
+			if (!S_ISDIR(sb.st_mode))
+				return false;
+		}
+		else if (mkdir(directory.c_str(), 0755) != 0)
+			return false;
+#endif
+	}
+
+	return true;
+}
+#endif
+
+const stl::string& GetStoragePath()
+{
+	if (g_storagePath.length() > 0)
+		return g_storagePath;
+
+#ifndef MOBILE
+	// the platform's usual per-user application data location
+	stl::string basePath;
+#ifdef _WIN32
+	const char *appData = getenv("APPDATA");
+	if (appData != NULL && appData[0] != '\0')
+		basePath = stl::string(appData) + "\\";
+#elif __linux__
+	const char *dataHome = getenv("XDG_DATA_HOME");
+	const char *home = getenv("HOME");
+	if (dataHome != NULL && dataHome[0] == '/')
+		basePath = stl::string(dataHome) + "/";
+	else if (home != NULL && home[0] != '\0')
+		basePath = stl::string(home) + "/.local/share/";
+#elif __APPLE__
+	const char *home = getenv("HOME");
+	if (home != NULL && home[0] != '\0')
+		basePath = stl::string(home) + "/Library/Application Support/";
+#endif
+
+	if (basePath.length() > 0)
+	{
+#ifdef _WIN32
+		g_storagePath = basePath + GetAppName() + "\\";
+#else
+		g_storagePath = basePath + GetAppName() + "/";
+#endif
+		if (!CreateDirectories(g_storagePath))
+			g_storagePath.clear();
+	}
+
+	// fall back to a directory alongside the executable
+	if (g_storagePath.length() == 0)
+	{
+		g_storagePath = GetAppPath() + "storage/";
+		CreateDirectories(g_storagePath);
+	}
+#else
+#ifdef __S3E__
+	// the writable data drive
+	g_storagePath = "ram://";
+#else
+	g_storagePath = GetAppPath() + "storage/";
+#endif
+#endif
+	return g_storagePath;
+}
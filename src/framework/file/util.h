@@ -13,4 +13,11 @@ const stl::string& GetAppPath();
  */
 const stl::string& GetAssetsPath();
 
+/**
+ * @return the path to a directory the current user can write to, for
+ *         saving files that should persist between runs. The directory
+ *         is created if it doesn't already exist.
+ */
+const stl::string& GetStoragePath();
+
 #endif
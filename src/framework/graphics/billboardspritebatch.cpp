@@ -6,6 +6,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include "billboardspriteshader.h"
 #include "blendstate.h"
 #include "graphicsdevice.h"
 #include "renderstate.h"
@@ -20,16 +21,23 @@
 #include "../math/camera.h"
 #include "../math/matrix4x4.h"
 #include "../math/vector3.h"
+#include "../util/utf8.h"
 
 const uint VERTICES_PER_SPRITE = 6;
 
+// vertex buffer attribute holding each vertex's corner offset and billboard
+// type when billboards are being oriented by the shader. must match what
+// BillboardSpriteShader maps it's "a_corner" attribute to
+const uint CORNER_ATTRIB_INDEX = 3;
+
 const size_t PRINTF_BUFFER_SIZE = 8096;
 char __billboardSpriteBatch_PrintfBuffer[PRINTF_BUFFER_SIZE + 1];
 
-BillboardSpriteBatch::BillboardSpriteBatch(GraphicsDevice *graphicsDevice)
+BillboardSpriteBatch::BillboardSpriteBatch(GraphicsDevice *graphicsDevice, bool expandOnGpu)
 {
 	m_graphicsDevice = graphicsDevice;
 	m_shader = NULL;
+	m_expandOnGpu = expandOnGpu;
 
 	// TODO: default size of 1 is best?
 	m_currentSpriteCapacity = 1;
@@ -38,15 +46,19 @@ BillboardSpriteBatch::BillboardSpriteBatch(GraphicsDevice *graphicsDevice)
 	VERTEX_ATTRIBS attribs[] = {
 		VERTEX_POS_3D,
 		VERTEX_COLOR,
-		VERTEX_TEXCOORD
+		VERTEX_TEXCOORD,
+		VERTEX_F3
 	};
+	// the corner attribute is only needed when the shader is orienting
+	uint numAttribs = (m_expandOnGpu ? 4 : 3);
 
 	// size vertices and texture storage to match m_currentSpriteCapacity
 	m_vertices = new VertexBuffer();
 	ASSERT(m_vertices != NULL);
-	m_vertices->Initialize(attribs, 3, m_currentSpriteCapacity * VERTICES_PER_SPRITE, BUFFEROBJECT_USAGE_STREAM);
+	m_vertices->Initialize(attribs, numAttribs, m_currentSpriteCapacity * VERTICES_PER_SPRITE, BUFFEROBJECT_USAGE_STREAM);
 
 	m_textures.resize(m_currentSpriteCapacity);
+	m_textureIsDistanceField.resize(m_currentSpriteCapacity);
 
 	m_renderState = new RENDERSTATE_DEFAULT;
 	ASSERT(m_renderState != NULL);
@@ -75,7 +87,12 @@ void BillboardSpriteBatch::InternalBegin(const RenderState *renderState, const B
 	m_cameraForward = m_graphicsDevice->GetViewContext()->GetCamera()->GetForward();
 
 	if (shader == NULL)
-		m_shader = m_graphicsDevice->GetSprite3DShader();
+	{
+		if (m_expandOnGpu)
+			m_shader = m_graphicsDevice->GetBillboardSpriteShader();
+		else
+			m_shader = m_graphicsDevice->GetSprite3DShader();
+	}
 	else
 	{
 		ASSERT(shader->IsReadyForUse() == true);
@@ -155,8 +172,6 @@ void BillboardSpriteBatch::Render(const SpriteFont *font, float x, float y, floa
 
 void BillboardSpriteBatch::Render(const SpriteFont *font, const Vector3 &position, BILLBOARDSPRITE_TYPE type, const Color &color, float pixelScale, const char *text)
 {
-	size_t textLength = strlen(text);
-
 	uint textWidth = 0;
 	uint textHeight = 0;
 	font->MeasureString(&textWidth, &textHeight, text);
@@ -170,11 +185,15 @@ void BillboardSpriteBatch::Render(const SpriteFont *font, const Vector3 &positio
 	float drawY = startY;
 	float lineHeight = (float)(font->GetLetterHeight() * pixelScale);
 
-	Matrix4x4 transform = GetTransformFor(type, position);
+	// when oriented by the shader, each glyph only needs the text's center
+	// position and it's own offset from it
+	Matrix4x4 transform;
+	if (!m_expandOnGpu)
+		transform = GetTransformFor(type, position);
 
-	for (size_t i = 0; i < textLength; ++i)
+	while (*text != '\0')
 	{
-		char c = text[i];
+		uint32_t c = DecodeUtf8(text);
 		if (c == '\n')
 		{
 			// new line
@@ -183,21 +202,30 @@ void BillboardSpriteBatch::Render(const SpriteFont *font, const Vector3 &positio
 		}
 		else
 		{
-			const TextureAtlasTile &glyph = font->GetGlyph(c);
-			float glyphWidth = (float)(glyph.dimensions.GetWidth() * pixelScale);
-			float glyphHeight = (float)(glyph.dimensions.GetHeight() * pixelScale);
-
-			AddSprite(
-				type,
-				transform,
-				font->GetTexture(), 
-				Vector3(-drawX, -drawY, 0.0f),
-				glyphWidth, glyphHeight,
-				glyph.texCoords.left, glyph.texCoords.top, glyph.texCoords.right, glyph.texCoords.bottom, 
-				color
-				);
-
-			drawX += glyphWidth;
+			const SpriteFontGlyph &glyph = font->GetGlyph(c);
+			if (glyph.page != NULL)
+			{
+				float glyphWidth = (float)glyph.width * pixelScale;
+				float glyphHeight = (float)glyph.height * pixelScale;
+
+				// billboard sprites are positioned by their center
+				float glyphCenterX = drawX + (float)glyph.offsetX * pixelScale + (glyphWidth / 2.0f);
+				float glyphCenterY = drawY + (float)glyph.offsetY * pixelScale + (glyphHeight / 2.0f);
+
+				AddSprite(
+					type,
+					position,
+					transform,
+					glyph.GetTexture(), 
+					Vector3(-glyphCenterX, -glyphCenterY, 0.0f),
+					glyphWidth, glyphHeight,
+					glyph.texCoords.left, glyph.texCoords.top, glyph.texCoords.right, glyph.texCoords.bottom, 
+					color,
+					font->IsDistanceField()
+					);
+			}
+
+			drawX += (float)glyph.advance * pixelScale;
 		}
 	}
 }
@@ -225,24 +253,28 @@ void BillboardSpriteBatch::Printf(const SpriteFont *font, const Vector3 &positio
 void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Texture *texture, const Vector3 &position, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color)
 {
 	ASSERT(m_begunRendering == true);
-	Matrix4x4 transform = GetTransformFor(type, position);
+	Matrix4x4 transform;
+	if (!m_expandOnGpu)
+		transform = GetTransformFor(type, position);
 
 	// zero vector offset as the transform will translate the billboard to
 	// the specified position
-	AddSprite(type, transform, texture, ZERO_VECTOR, width, height, sourceLeft, sourceTop, sourceRight, sourceBottom, color);
+	AddSprite(type, position, transform, texture, ZERO_VECTOR, width, height, sourceLeft, sourceTop, sourceRight, sourceBottom, color);
 }
 
 void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Texture *texture, const Vector3 &position, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color)
 {
 	ASSERT(m_begunRendering == true);
-	Matrix4x4 transform = GetTransformFor(type, position);
+	Matrix4x4 transform;
+	if (!m_expandOnGpu)
+		transform = GetTransformFor(type, position);
 
 	// zero vector offset as the transform will translate the billboard to
 	// the specified position
-	AddSprite(type, transform, texture, ZERO_VECTOR, width, height, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom, color);
+	AddSprite(type, position, transform, texture, ZERO_VECTOR, width, height, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom, color);
 }
 
-void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color)
+void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color)
 {
 	ASSERT(m_begunRendering == true);
 
@@ -256,19 +288,19 @@ void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Matrix4x4
 	float texBottom = sourceBottom / (float)sourceHeight;
 
 	CheckForNewSpriteSpace();
-	SetSpriteInfo(m_currentSpritePointer, type, transform, texture, offset, width, height, texLeft, texTop, texRight, texBottom, color);
+	SetSpriteInfo(m_currentSpritePointer, type, position, transform, texture, offset, width, height, texLeft, texTop, texRight, texBottom, color, false);
 	++m_currentSpritePointer;
 }
 
-void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color)
+void BillboardSpriteBatch::AddSprite(BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField)
 {
 	ASSERT(m_begunRendering == true);
 	CheckForNewSpriteSpace();
-	SetSpriteInfo(m_currentSpritePointer, type, transform, texture, offset, width, height, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom, color);
+	SetSpriteInfo(m_currentSpritePointer, type, position, transform, texture, offset, width, height, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom, color, isDistanceField);
 	++m_currentSpritePointer;
 }
 
-void BillboardSpriteBatch::SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color)
+void BillboardSpriteBatch::SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField)
 {
 	uint base = spriteIndex * VERTICES_PER_SPRITE;
 
@@ -282,22 +314,27 @@ void BillboardSpriteBatch::SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE
 	float right = -halfWidth;
 	float bottom = halfHeight;
 
-	// HACK: I don't like this at all. I'm also not sure how this is
-	//       performance-wise (haven't tested as I write this). Ideally in the
-	//       future this will be done by a custom shader using OpenGL/ES 2...
-	Vector3 v1 = (Vector3(left, top, 0.0f) + offset) * transform;
-	Vector3 v2 = (Vector3(right, top, 0.0f) + offset) * transform;
-	Vector3 v3 = (Vector3(right, bottom, 0.0f) + offset) * transform;
-	Vector3 v4 = (Vector3(left, top, 0.0f) + offset) * transform;
-	Vector3 v5 = (Vector3(right, bottom, 0.0f) + offset) * transform;
-	Vector3 v6 = (Vector3(left, bottom, 0.0f) + offset) * transform;
-
-	m_vertices->SetPosition3(base, v1);
-	m_vertices->SetPosition3(base + 1, v2);
-	m_vertices->SetPosition3(base + 2, v3);
-	m_vertices->SetPosition3(base + 3, v4);
-	m_vertices->SetPosition3(base + 4, v5);
-	m_vertices->SetPosition3(base + 5, v6);
+	if (m_expandOnGpu)
+		SetSpriteCorners(base, type, position, left + offset.x, top + offset.y, right + offset.x, bottom + offset.y);
+	else
+	{
+		// HACK: I don't like this at all. I'm also not sure how this is
+		//       performance-wise (haven't tested as I write this). Ideally in the
+		//       future this will be done by a custom shader using OpenGL/ES 2...
+		Vector3 v1 = (Vector3(left, top, 0.0f) + offset) * transform;
+		Vector3 v2 = (Vector3(right, top, 0.0f) + offset) * transform;
+		Vector3 v3 = (Vector3(right, bottom, 0.0f) + offset) * transform;
+		Vector3 v4 = (Vector3(left, top, 0.0f) + offset) * transform;
+		Vector3 v5 = (Vector3(right, bottom, 0.0f) + offset) * transform;
+		Vector3 v6 = (Vector3(left, bottom, 0.0f) + offset) * transform;
+
+		m_vertices->SetPosition3(base, v1);
+		m_vertices->SetPosition3(base + 1, v2);
+		m_vertices->SetPosition3(base + 2, v3);
+		m_vertices->SetPosition3(base + 3, v4);
+		m_vertices->SetPosition3(base + 4, v5);
+		m_vertices->SetPosition3(base + 5, v6);
+	}
 
 	m_vertices->SetTexCoord(base, texCoordLeft, texCoordBottom);
 	m_vertices->SetTexCoord(base + 1, texCoordRight, texCoordBottom);
@@ -314,6 +351,28 @@ void BillboardSpriteBatch::SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE
 	m_vertices->SetColor(base + 5, color);
 
 	m_textures[spriteIndex] = texture;
+	m_textureIsDistanceField[spriteIndex] = isDistanceField;
+}
+
+void BillboardSpriteBatch::SetSpriteCorners(uint base, BILLBOARDSPRITE_TYPE type, const Vector3 &position, float left, float top, float right, float bottom)
+{
+	// every vertex sits at the billboard's center. the shader moves each one
+	// out to it's corner along the billboard's axes, which depend on the type
+	float typeValue = (float)type;
+
+	m_vertices->SetPosition3(base, position);
+	m_vertices->SetPosition3(base + 1, position);
+	m_vertices->SetPosition3(base + 2, position);
+	m_vertices->SetPosition3(base + 3, position);
+	m_vertices->SetPosition3(base + 4, position);
+	m_vertices->SetPosition3(base + 5, position);
+
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base, left, top, typeValue);
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base + 1, right, top, typeValue);
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base + 2, right, bottom, typeValue);
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base + 3, left, top, typeValue);
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base + 4, right, bottom, typeValue);
+	m_vertices->Set3f(CORNER_ATTRIB_INDEX, base + 5, left, bottom, typeValue);
 }
 
 void BillboardSpriteBatch::End()
@@ -321,17 +380,19 @@ void BillboardSpriteBatch::End()
 	ASSERT(m_begunRendering == true);
 
 	if (m_isRenderStateOverridden)
-		m_overrideRenderState.Apply();
+		m_overrideRenderState.Apply(m_graphicsDevice);
 	else
-		m_renderState->Apply();
+		m_renderState->Apply(m_graphicsDevice);
 	if (m_isBlendStateOverridden)
-		m_overrideBlendState.Apply();
+		m_overrideBlendState.Apply(m_graphicsDevice);
 	else
-		m_blendState->Apply();
+		m_blendState->Apply(m_graphicsDevice);
 
 	m_graphicsDevice->BindShader(m_shader);
 	m_shader->SetModelViewMatrix(m_graphicsDevice->GetViewContext()->GetModelViewMatrix());
 	m_shader->SetProjectionMatrix(m_graphicsDevice->GetViewContext()->GetProjectionMatrix());
+	if (m_expandOnGpu)
+		m_shader->SetCamera(m_cameraPosition, m_cameraForward);
 	RenderQueue();
 	m_graphicsDevice->UnbindShader();
 
@@ -377,6 +438,7 @@ void BillboardSpriteBatch::RenderQueueRange(const Texture *texture, uint firstSp
 
 	m_graphicsDevice->BindTexture(texture);
 	m_shader->SetTextureHasAlphaOnly(texture->GetFormat() == TEXTURE_FORMAT_ALPHA);
+	m_shader->SetTextureIsDistanceField(m_textureIsDistanceField[firstSprite]);
 	m_graphicsDevice->RenderTriangles(vertexOffset, numTriangles);
 }
 
@@ -413,6 +475,7 @@ void BillboardSpriteBatch::CheckForNewSpriteSpace()
 		++m_currentSpriteCapacity;
 		m_vertices->Extend(VERTICES_PER_SPRITE);
 		m_textures.resize(m_currentSpriteCapacity);
+		m_textureIsDistanceField.resize(m_currentSpriteCapacity);
 	}
 }
 
@@ -26,6 +26,12 @@ enum BILLBOARDSPRITE_TYPE
 
 /**
  * Wrapper for 3D sprite and text rendering as billboards.
+ *
+ * Billboards can either be oriented towards the camera on the CPU as they
+ * are added (the default), or have their center and corner offsets stored
+ * and be oriented by the vertex shader instead. The latter avoids building
+ * a transformation matrix and transforming every vertex per billboard, and
+ * only requires a GLES 2-level shader (no instancing).
  */
 class BillboardSpriteBatch
 {
@@ -33,8 +39,13 @@ public:
 	/**
 	 * Creates a billboard sprite batch object.
 	 * @param graphicsDevice the graphics device to perform rendering with
+	 * @param expandOnGpu true to orient billboards in the vertex shader
+	 *                    instead of on the CPU. custom shaders passed to
+	 *                    Begin() must then orient billboards using the
+	 *                    camera passed to SpriteShader::SetCamera(), like
+	 *                    BillboardSpriteShader does
 	 */
-	BillboardSpriteBatch(GraphicsDevice *graphicsDevice);
+	BillboardSpriteBatch(GraphicsDevice *graphicsDevice, bool expandOnGpu = false);
 
 	virtual ~BillboardSpriteBatch();
 
@@ -182,14 +193,20 @@ public:
 	 */
 	void End();
 
+	/**
+	 * @return true if billboards are being oriented in the vertex shader
+	 */
+	bool IsExpandingOnGpu() const                          { return m_expandOnGpu; }
+
 private:
 	void Initialize(GraphicsDevice *graphicsDevice, uint maxSprites);
 	void InternalBegin(const RenderState *renderState, const BlendState *blendState, SpriteShader *shader);
 	void AddSprite(BILLBOARDSPRITE_TYPE type, const Texture *texture, const Vector3 &position, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color);
 	void AddSprite(BILLBOARDSPRITE_TYPE type, const Texture *texture, const Vector3 &position, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
-	void AddSprite(BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color);
-	void AddSprite(BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
-	void SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE type, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
+	void AddSprite(BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, uint sourceLeft, uint sourceTop, uint sourceRight, uint sourceBottom, const Color &color);
+	void AddSprite(BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField = false);
+	void SetSpriteInfo(uint spriteIndex, BILLBOARDSPRITE_TYPE type, const Vector3 &position, const Matrix4x4 &transform, const Texture *texture, const Vector3 &offset, float width, float height, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField);
+	void SetSpriteCorners(uint base, BILLBOARDSPRITE_TYPE type, const Vector3 &position, float left, float top, float right, float bottom);
 	void RenderQueue();
 	void RenderQueueRange(const Texture *texture, uint firstSprite, uint lastSprite);
 
@@ -207,11 +224,13 @@ private:
 	BlendState m_overrideBlendState;
 	VertexBuffer *m_vertices;
 	stl::vector<const Texture*> m_textures;
+	stl::vector<bool> m_textureIsDistanceField;
 	uint m_currentSpritePointer;
 
 	Vector3 m_cameraPosition;
 	Vector3 m_cameraForward;
 
+	bool m_expandOnGpu;
 	bool m_begunRendering;
 };
 
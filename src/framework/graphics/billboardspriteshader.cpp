@@ -0,0 +1,186 @@
+#include "../debug.h"
+
+#include "billboardspriteshader.h"
+
+#include "../math/matrix4x4.h"
+#include "../math/vector3.h"
+
+const char* BillboardSpriteShader::m_vertexShaderSource = 
+	"attribute vec4 a_position;\n"
+	"attribute vec4 a_color;\n"
+	"attribute vec2 a_texcoord0;\n"
+	"attribute vec3 a_corner;\n"
+	"uniform mat4 u_modelViewMatrix;\n"
+	"uniform mat4 u_projectionMatrix;\n"
+	"uniform vec3 u_cameraPosition;\n"
+	"uniform vec3 u_cameraForward;\n"
+	"uniform vec3 u_screenAlignedLeft;\n"
+	"uniform vec3 u_screenAlignedUp;\n"
+	"uniform vec3 u_axisAlignedLeft;\n"
+	"varying vec4 v_color;\n"
+	"varying vec2 v_texCoords;\n"
+	"\n"
+	"const vec3 AXIS = vec3(0.0, 1.0, 0.0);\n"
+	"// what Matrix4x4::CreateCylindricalBillboard falls back to when looking along the axis\n"
+	"const vec3 AXIS_PARALLEL_LEFT = vec3(-1.0, 0.0, 0.0);\n"
+	"\n"
+	"vec3 DirectionFromCamera(vec3 center)\n"
+	"{\n"
+	"	vec3 direction = center - u_cameraPosition;\n"
+	"	float lengthSquared = dot(direction, direction);\n"
+	"	if (lengthSquared < 0.0001)\n"
+	"		return -u_cameraForward;\n"
+	"	else\n"
+	"		return direction * inversesqrt(lengthSquared);\n"
+	"}\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec3 center = a_position.xyz;\n"
+	"	vec3 left;\n"
+	"	vec3 up;\n"
+	"	if (a_corner.z < 0.5)\n"
+	"	{\n"
+	"		// spherical\n"
+	"		vec3 forward = DirectionFromCamera(center);\n"
+	"		left = normalize(cross(AXIS, forward));\n"
+	"		up = cross(forward, left);\n"
+	"	}\n"
+	"	else if (a_corner.z < 1.5)\n"
+	"	{\n"
+	"		// cylindrical\n"
+	"		vec3 forward = DirectionFromCamera(center);\n"
+	"		up = AXIS;\n"
+	"		if (abs(dot(AXIS, forward)) > 0.9982547)\n"
+	"			left = AXIS_PARALLEL_LEFT;\n"
+	"		else\n"
+	"			left = normalize(cross(AXIS, forward));\n"
+	"	}\n"
+	"	else if (a_corner.z < 2.5)\n"
+	"	{\n"
+	"		// screen aligned\n"
+	"		left = u_screenAlignedLeft;\n"
+	"		up = u_screenAlignedUp;\n"
+	"	}\n"
+	"	else\n"
+	"	{\n"
+	"		// screen and axis aligned\n"
+	"		left = u_axisAlignedLeft;\n"
+	"		up = AXIS;\n"
+	"	}\n"
+	"\n"
+	"	vec4 position = vec4(center + (left * a_corner.x) + (up * a_corner.y), 1.0);\n"
+	"	v_color = a_color;\n"
+	"	v_texCoords = a_texcoord0;\n"
+	"	gl_Position =  u_projectionMatrix * u_modelViewMatrix * position;\n"
+	"}\n";
+
+const char* BillboardSpriteShader::m_fragmentShaderSource = 
+	"#ifdef GL_ES\n"
+	"	#ifdef GL_OES_standard_derivatives\n"
+	"		#extension GL_OES_standard_derivatives : enable\n"
+	"	#endif\n"
+	"	#define LOWP lowp\n"
+	"	precision mediump float;\n"
+	"#else\n"
+	"	#define LOWP\n"
+	"#endif\n"
+	"varying LOWP vec4 v_color;\n"
+	"varying vec2 v_texCoords;\n"
+	"uniform sampler2D u_texture;\n"
+	"uniform bool u_textureHasAlphaOnly;\n"
+	"uniform bool u_textureIsDistanceField;\n"
+	"\n"
+	"float distanceFieldAlpha(float distance)\n"
+	"{\n"
+	"#if defined(GL_ES) && !defined(GL_OES_standard_derivatives)\n"
+	"	float smoothing = 0.0625;\n"
+	"#else\n"
+	"	float smoothing = 0.7 * fwidth(distance);\n"
+	"#endif\n"
+	"	return smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+	"}\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	vec4 texColor = texture2D(u_texture, v_texCoords);\n"
+	"	if (u_textureIsDistanceField)\n"
+	"		texColor.a = distanceFieldAlpha(texColor.a);\n"
+	"	if (texColor.a > 0.0)\n"
+	"	{\n"
+	"		vec4 finalColor;\n"
+	"		if (u_textureHasAlphaOnly)\n"
+	"			finalColor = vec4(v_color.xyz, (v_color.a * texColor.a));\n"
+	"		else\n"
+	"			finalColor = v_color * texColor;\n"
+	"		gl_FragColor = finalColor;\n"
+	"	}\n"
+	"	else\n"
+	"		discard;\n"
+	"}\n";
+
+BillboardSpriteShader::BillboardSpriteShader()
+{
+	m_cameraPositionHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_cameraForwardHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_screenAlignedLeftHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_screenAlignedUpHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_axisAlignedLeftHandle = INVALID_SHADER_UNIFORM_HANDLE;
+}
+
+BillboardSpriteShader::~BillboardSpriteShader()
+{
+}
+
+bool BillboardSpriteShader::Initialize(GraphicsDevice *graphicsDevice)
+{
+	if (!SpriteShader::Initialize(graphicsDevice))
+		return false;
+	
+	bool result = LoadCompileAndLinkInlineSources(m_vertexShaderSource, m_fragmentShaderSource);
+	ASSERT(result == true);
+
+	MapAttributeToStandardAttribType("a_position", VERTEX_STD_POS_3D);
+	MapAttributeToStandardAttribType("a_color", VERTEX_STD_COLOR);
+	MapAttributeToStandardAttribType("a_texcoord0", VERTEX_STD_TEXCOORD);
+	MapAttributeToVboAttribIndex("a_corner", 3);
+	
+	return true;
+}
+
+void BillboardSpriteShader::Release()
+{
+	m_cameraPositionHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_cameraForwardHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_screenAlignedLeftHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_screenAlignedUpHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_axisAlignedLeftHandle = INVALID_SHADER_UNIFORM_HANDLE;
+
+	SpriteShader::Release();
+}
+
+void BillboardSpriteShader::SetCamera(const Vector3 &position, const Vector3 &forward)
+{
+	ASSERT(IsReadyForUse() == true);
+	if (m_cameraPositionHandle == INVALID_SHADER_UNIFORM_HANDLE)
+	{
+		m_cameraPositionHandle = GetUniformHandle("u_cameraPosition");
+		m_cameraForwardHandle = GetUniformHandle("u_cameraForward");
+		m_screenAlignedLeftHandle = GetUniformHandle("u_screenAlignedLeft");
+		m_screenAlignedUpHandle = GetUniformHandle("u_screenAlignedUp");
+		m_axisAlignedLeftHandle = GetUniformHandle("u_axisAlignedLeft");
+	}
+
+	// the screen aligned billboard types have the same orientation for every
+	// billboard, so only the position dependant types need to be worked out
+	// per vertex. taking the axes from the same matrices that CPU-side
+	// billboarding uses keeps both ways consistent
+	Matrix4x4 screenAligned = Matrix4x4::CreateScreenAlignedBillboard(ZERO_VECTOR, UP, forward);
+	Matrix4x4 axisAligned = Matrix4x4::CreateScreenAndAxisAlignedBillboard(ZERO_VECTOR, forward, Y_AXIS);
+
+	SetUniform(m_cameraPositionHandle, position);
+	SetUniform(m_cameraForwardHandle, forward);
+	SetUniform(m_screenAlignedLeftHandle, screenAligned.m[_11], screenAligned.m[_21], screenAligned.m[_31]);
+	SetUniform(m_screenAlignedUpHandle, screenAligned.m[_12], screenAligned.m[_22], screenAligned.m[_32]);
+	SetUniform(m_axisAlignedLeftHandle, axisAligned.m[_11], axisAligned.m[_21], axisAligned.m[_31]);
+}
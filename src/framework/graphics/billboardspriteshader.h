@@ -0,0 +1,47 @@
+#ifndef __FRAMEWORK_GRAPHICS_BILLBOARDSPRITESHADER_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_BILLBOARDSPRITESHADER_H_INCLUDED__
+
+#include "spriteshader.h"
+
+class GraphicsDevice;
+struct Vector3;
+
+/**
+ * Shader for rendering 3D billboard sprites where the billboard's corners
+ * are positioned by the shader instead of on the CPU. Each vertex provides
+ * the billboard's center position, and a "corner" attribute holding the
+ * vertex's offset from the center along the billboard's left and up axes
+ * and the billboard's type (BILLBOARDSPRITE_TYPE). The billboard's axes
+ * are calculated from the camera uniforms. The corner attribute is read
+ * from vertex buffer attribute index 3.
+ *
+ * Color modulation and alpha testing is done the same as Sprite3DShader.
+ */
+class BillboardSpriteShader : public SpriteShader
+{
+public:
+	BillboardSpriteShader();
+	virtual ~BillboardSpriteShader();
+
+	bool Initialize(GraphicsDevice *graphicsDevice);
+	void Release();
+
+	/**
+	 * Sets the camera that billboards will face.
+	 * @param position the camera's position
+	 * @param forward the camera's forward direction
+	 */
+	virtual void SetCamera(const Vector3 &position, const Vector3 &forward);
+
+private:
+	static const char *m_vertexShaderSource;
+	static const char *m_fragmentShaderSource;
+
+	ShaderUniformHandle m_cameraPositionHandle;
+	ShaderUniformHandle m_cameraForwardHandle;
+	ShaderUniformHandle m_screenAlignedLeftHandle;
+	ShaderUniformHandle m_screenAlignedUpHandle;
+	ShaderUniformHandle m_axisAlignedLeftHandle;
+};
+
+#endif
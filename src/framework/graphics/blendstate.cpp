@@ -1,5 +1,9 @@
+#include "../debug.h"
+
 #include "blendstate.h"
 
+#include "graphicsdevice.h"
+
 #include "glincludes.h"
 #include "glutils.h"
 
@@ -28,17 +32,48 @@ void BlendState::Initialize()
 	m_destBlendFactor = ZERO;
 }
 
-void BlendState::Apply() const
+void BlendState::Apply(GraphicsDevice *graphicsDevice) const
 {
-	if (m_blending)
+	ASSERT(graphicsDevice != NULL);
+
+	// NULL if the state of the OpenGL context is not known (e.g. a new
+	// context), in which case everything gets set
+	const BlendState *current = graphicsDevice->GetAppliedBlendState();
+	BlendState applied = *this;
+	uint numIssued = 0;
+	uint numSkipped = 0;
+
+	if (current == NULL || current->m_blending != m_blending)
+	{
+		if (m_blending)
+			GL_CALL(glEnable(GL_BLEND));
+		else
+			GL_CALL(glDisable(GL_BLEND));
+		++numIssued;
+	}
+	else
+		++numSkipped;
+
+	if (current == NULL || (m_blending && (current->m_sourceBlendFactor != m_sourceBlendFactor || current->m_destBlendFactor != m_destBlendFactor)))
 	{
-		GL_CALL(glEnable(GL_BLEND));
 		int source = FindBlendFactorValue(m_sourceBlendFactor);
 		int dest = FindBlendFactorValue(m_destBlendFactor);
 		GL_CALL(glBlendFunc(source, dest));
+		++numIssued;
 	}
+	else if (m_blending)
+		++numSkipped;
 	else
-		GL_CALL(glDisable(GL_BLEND));
+	{
+		applied.m_sourceBlendFactor = current->m_sourceBlendFactor;
+		applied.m_destBlendFactor = current->m_destBlendFactor;
+	}
+
+	graphicsDevice->SetAppliedBlendState(applied);
+
+	GraphicsDeviceStats *stats = graphicsDevice->GetFrameStats();
+	stats->numStateCallsIssued += numIssued;
+	stats->numStateCallsSkipped += numSkipped;
 }
 
 int BlendState::FindBlendFactorValue(BLEND_FACTOR factor) const
@@ -3,6 +3,8 @@
 
 #include "../common.h"
 
+class GraphicsDevice;
+
 enum BLEND_FACTOR
 {
 	ZERO,
@@ -42,9 +44,12 @@ public:
 	virtual ~BlendState();
 
 	/**
-	 * Applies blend states to the current OpenGL context.
+	 * Applies blend states to the current OpenGL context. Only the states
+	 * that differ from those last applied through the graphics device are
+	 * actually set.
+	 * @param graphicsDevice the graphics device tracking the current state
 	 */
-	void Apply() const;
+	void Apply(GraphicsDevice *graphicsDevice) const;
 
 	/**
 	 * @return true if blending is enabled
@@ -1,6 +1,7 @@
 #include "../debug.h"
 
 #include "bufferobject.h"
+#include "graphicsdevice.h"
 #include "glincludes.h"
 #include "glutils.h"
 
@@ -10,6 +11,8 @@ BufferObject::BufferObject()
 	m_usage = BUFFEROBJECT_USAGE_STATIC;
 	m_bufferId = 0;
 	m_isDirty = false;
+	m_dirtyStart = 0;
+	m_dirtyEnd = 0;
 	m_sizeInBytes = 0;
 }
 
@@ -22,6 +25,8 @@ void BufferObject::Release()
 	m_usage = BUFFEROBJECT_USAGE_STATIC;
 	m_bufferId = 0;
 	m_isDirty = false;
+	m_dirtyStart = 0;
+	m_dirtyEnd = 0;
 	m_sizeInBytes = 0;
 	
 	GraphicsContextResource::Release();
@@ -65,7 +70,7 @@ void BufferObject::CreateBufferObject()
 	GL_CALL(glGenBuffers(1, &m_bufferId));
 	SizeBufferObject();
 
-	m_isDirty = true;
+	SetDirty();
 }
 
 void BufferObject::FreeBufferObject()
@@ -75,6 +80,8 @@ void BufferObject::FreeBufferObject()
 
 	m_bufferId = 0;
 	m_isDirty = false;
+	m_dirtyStart = 0;
+	m_dirtyEnd = 0;
 	m_sizeInBytes = 0;
 }
 
@@ -105,6 +112,7 @@ void BufferObject::Update()
 
 	GL_CALL(glBindBuffer(target, m_bufferId));
 
+	size_t numBytesUploaded = 0;
 	if (m_sizeInBytes != currentSizeInBytes)
 	{
 		// means that the buffer object hasn't been allocated. So let's allocate and update at the same time
@@ -113,22 +121,48 @@ void BufferObject::Update()
 
 		// and then allocate + update
 		GL_CALL(glBufferData(target, m_sizeInBytes, GetBuffer(), usage));
+		numBytesUploaded = m_sizeInBytes;
 	}
 	else
 	{
-		// possible performance enhancement? passing a NULL pointer to
-		// glBufferData tells the driver that we don't care about the buffer's
-		// previous contents allowing it to do some extra optimizations which is
-		// fine since our glBufferSubData call is going to completely replace 
-		// the contents anyway
-		GL_CALL(glBufferData(target, m_sizeInBytes, NULL, usage));
-
-		GL_CALL(glBufferSubData(target, 0, m_sizeInBytes, GetBuffer()));
+		size_t dirtyStart = m_dirtyStart;
+		size_t dirtyEnd = Min(m_dirtyEnd, m_sizeInBytes);
+		ASSERT(dirtyStart < dirtyEnd);
+
+		if (dirtyStart == 0 && dirtyEnd == m_sizeInBytes)
+		{
+			// possible performance enhancement? passing a NULL pointer to
+			// glBufferData tells the driver that we don't care about the buffer's
+			// previous contents allowing it to do some extra optimizations which is
+			// fine since our glBufferSubData call is going to completely replace 
+			// the contents anyway
+			GL_CALL(glBufferData(target, m_sizeInBytes, NULL, usage));
+
+			GL_CALL(glBufferSubData(target, 0, m_sizeInBytes, GetBuffer()));
+			numBytesUploaded = m_sizeInBytes;
+		}
+		else if (dirtyStart < dirtyEnd)
+		{
+			// only part of the buffer has changed, leave the rest of the
+			// existing contents in video memory alone
+			const int8_t *data = (const int8_t*)GetBuffer() + dirtyStart;
+			GL_CALL(glBufferSubData(target, dirtyStart, dirtyEnd - dirtyStart, data));
+			numBytesUploaded = dirtyEnd - dirtyStart;
+		}
 	}
 
 	GL_CALL(glBindBuffer(target, 0));
 
 	m_isDirty = false;
+	m_dirtyStart = 0;
+	m_dirtyEnd = 0;
+
+	if (GetGraphicsDevice() != NULL)
+	{
+		GraphicsDeviceStats *stats = GetGraphicsDevice()->GetFrameStats();
+		++stats->numBufferUploads;
+		stats->bufferBytesUploaded += numBytesUploaded;
+	}
 }
 
 void BufferObject::SizeBufferObject()
@@ -160,7 +194,7 @@ void BufferObject::SizeBufferObject()
 	GL_CALL(glBufferData(target, m_sizeInBytes, NULL, usage));
 	GL_CALL(glBindBuffer(target, 0));
 
-	m_isDirty = true;
+	SetDirty();
 }
 
 void BufferObject::OnNewContext()
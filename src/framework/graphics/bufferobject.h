@@ -69,7 +69,23 @@ public:
 	bool IsDirty() const                                                        { return m_isDirty; }
 
 	/**
-	 * Uploads the current buffer data to video memory.
+	 * @return the offset in bytes of the first byte of buffer data that has
+	 *         been changed since the last Update() call
+	 */
+	size_t GetDirtyStartInBytes() const                                         { return m_dirtyStart; }
+
+	/**
+	 * @return the offset in bytes just past the last byte of buffer data that
+	 *         has been changed since the last Update() call. This may be
+	 *         greater then the size of the buffer if the entire buffer has
+	 *         been marked dirty.
+	 */
+	size_t GetDirtyEndInBytes() const                                           { return m_dirtyEnd; }
+
+	/**
+	 * Uploads the current buffer data to video memory. Only the range of the
+	 * buffer that has been changed since the last Update() call will be
+	 * uploaded unless the buffer's size has changed.
 	 */
 	void Update();
 
@@ -118,7 +134,21 @@ protected:
 	void CreateBufferObject();
 	void FreeBufferObject();
 	void SizeBufferObject();
-	void SetDirty()                                                             { m_isDirty = true; }
+
+	/**
+	 * Marks the entire buffer as needing to be uploaded on the next Update().
+	 */
+	void SetDirty();
+
+	/**
+	 * Marks a range of the buffer as needing to be uploaded on the next
+	 * Update(). This is merged with any other ranges already marked dirty.
+	 * An empty range is ignored and leaves the buffer's dirty state as-is.
+	 * @param offsetInBytes offset from the start of the buffer data to the
+	 *                      first byte that was changed
+	 * @param lengthInBytes the number of bytes that were changed
+	 */
+	void SetDirty(size_t offsetInBytes, size_t lengthInBytes);
 
 private:
 
@@ -126,7 +156,37 @@ private:
 	BUFFEROBJECT_USAGE m_usage;
 	uint m_bufferId;
 	bool m_isDirty;
+	size_t m_dirtyStart;
+	size_t m_dirtyEnd;
 	size_t m_sizeInBytes;
 };
 
+inline void BufferObject::SetDirty()
+{
+	m_isDirty = true;
+	m_dirtyStart = 0;
+	m_dirtyEnd = (size_t)-1;
+}
+
+inline void BufferObject::SetDirty(size_t offsetInBytes, size_t lengthInBytes)
+{
+	if (lengthInBytes == 0)
+		return;
+
+	size_t end = offsetInBytes + lengthInBytes;
+	if (m_isDirty)
+	{
+		if (offsetInBytes < m_dirtyStart)
+			m_dirtyStart = offsetInBytes;
+		if (end > m_dirtyEnd)
+			m_dirtyEnd = end;
+	}
+	else
+	{
+		m_isDirty = true;
+		m_dirtyStart = offsetInBytes;
+		m_dirtyEnd = end;
+	}
+}
+
 #endif
@@ -0,0 +1,158 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "dynamictextureatlas.h"
+
+#include "graphicsdevice.h"
+#include "image.h"
+#include "texture.h"
+#include "../math/rect.h"
+
+DynamicTextureAtlas::DynamicTextureAtlas(GraphicsDevice *graphicsDevice, uint width, uint height, uint padding, IMAGE_FORMAT format)
+	: TextureAtlas(width, height),
+	  m_packer(width, height)
+{
+	ASSERT(graphicsDevice != NULL);
+	ASSERT(format == IMAGE_FORMAT_RGBA || format == IMAGE_FORMAT_ALPHA);
+
+	m_graphicsDevice = graphicsDevice;
+	m_padding = padding;
+	m_format = format;
+	m_texture = NULL;
+
+	m_pixels = new Image();
+	bool imageCreateSuccess = m_pixels->Create(width, height, m_format);
+	ASSERT(imageCreateSuccess == true);
+	m_pixels->Clear();
+
+	CreateTexture();
+}
+
+DynamicTextureAtlas::~DynamicTextureAtlas()
+{
+	SetTexture(NULL);
+	SAFE_DELETE(m_texture);
+	SAFE_DELETE(m_pixels);
+}
+
+bool DynamicTextureAtlas::Add(const Image *image, uint &index)
+{
+	ASSERT(image != NULL);
+	ASSERT(image->GetPixels() != NULL);
+	ASSERT(m_format == IMAGE_FORMAT_RGBA || image->GetFormat() == IMAGE_FORMAT_ALPHA);
+
+	// reserve room for the padding on the right/bottom edges of this image.
+	// the left/top edges are covered by the padding of whatever was packed
+	// before it, or by the edge of the atlas itself
+	Rect position;
+	if (!m_packer.Insert(image->GetWidth() + m_padding, image->GetHeight() + m_padding, position))
+		return false;
+
+	uint left = (uint)position.left;
+	uint top = (uint)position.top;
+	uint right = left + image->GetWidth();
+	uint bottom = top + image->GetHeight();
+
+	if (m_format == IMAGE_FORMAT_ALPHA)
+		m_pixels->Copy(image, left, top);
+	else
+		CopyAsRGBA(image, left, top);
+
+	if (m_texture != NULL && !m_texture->IsInvalidated())
+	{
+		// upload only the part of the atlas that was just filled in. alpha
+		// rows are only 1 byte per pixel, so the region is widened out to
+		// 4 pixel boundaries to keep it's rows at the default 4 byte unpack
+		// alignment. the extra pixels are already uploaded anyway
+		uint uploadLeft = left;
+		uint uploadRight = right;
+		if (m_format == IMAGE_FORMAT_ALPHA)
+		{
+			uploadLeft = left & ~3;
+			uploadRight = Min((right + 3) & ~3, GetWidth());
+		}
+
+		Image region;
+		region.Create(m_pixels, uploadLeft, top, uploadRight - uploadLeft, image->GetHeight());
+		m_texture->Update(&region, uploadLeft, top);
+	}
+
+	TextureAtlasTile tile;
+	tile.dimensions.Set(left, top, right, bottom);
+	tile.texCoords.left = ((float)left + GetTexCoordEdgeOffset()) / (float)GetWidth();
+	tile.texCoords.top = ((float)top + GetTexCoordEdgeOffset()) / (float)GetHeight();
+	tile.texCoords.right = ((float)right - GetTexCoordEdgeOffset()) / (float)GetWidth();
+	tile.texCoords.bottom = ((float)bottom - GetTexCoordEdgeOffset()) / (float)GetHeight();
+	m_tiles.push_back(tile);
+
+	index = m_tiles.size() - 1;
+	return true;
+}
+
+void DynamicTextureAtlas::OnNewContext()
+{
+	CreateTexture();
+}
+
+void DynamicTextureAtlas::OnLostContext()
+{
+	if (m_texture != NULL)
+		m_texture->OnLostContext();
+}
+
+bool DynamicTextureAtlas::CreateTexture()
+{
+	if (m_texture == NULL)
+		m_texture = new Texture();
+	else
+		m_texture->Release();
+
+	bool success = m_texture->Create(m_graphicsDevice, m_pixels);
+	ASSERT(success == true);
+	if (!success)
+	{
+		LOG_ERROR(LOGCAT_GRAPHICS, "DynamicTextureAtlas: failed creating %d x %d atlas texture.\n", GetWidth(), GetHeight());
+		SAFE_DELETE(m_texture);
+	}
+
+	SetTexture(m_texture);
+	return success;
+}
+
+void DynamicTextureAtlas::CopyAsRGBA(const Image *image, uint destX, uint destY)
+{
+	if (image->GetFormat() == IMAGE_FORMAT_RGBA)
+	{
+		m_pixels->Copy(image, destX, destY);
+		return;
+	}
+
+	for (uint y = 0; y < image->GetHeight(); ++y)
+	{
+		const uint8_t *src = image->Get(0, y);
+		uint8_t *dest = m_pixels->Get(destX, destY + y);
+
+		for (uint x = 0; x < image->GetWidth(); ++x)
+		{
+			if (image->GetFormat() == IMAGE_FORMAT_ALPHA)
+			{
+				// white, so that the sprite color tint passes through unchanged
+				// exactly as it would when rendering an alpha-only texture
+				dest[0] = 255;
+				dest[1] = 255;
+				dest[2] = 255;
+				dest[3] = src[0];
+				src += 1;
+			}
+			else
+			{
+				dest[0] = src[0];
+				dest[1] = src[1];
+				dest[2] = src[2];
+				dest[3] = 255;
+				src += 3;
+			}
+			dest += 4;
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef __FRAMEWORK_GRAPHICS_DYNAMICTEXTUREATLAS_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_DYNAMICTEXTUREATLAS_H_INCLUDED__
+
+#include "../common.h"
+#include "imageformats.h"
+#include "skylinepacker.h"
+#include "textureatlas.h"
+
+class GraphicsDevice;
+class Image;
+class Texture;
+
+/**
+ * Texture atlas which is filled at runtime by packing arbitrary images into
+ * it as they are added. The atlas owns it's texture, which is either RGBA
+ * or alpha-only. A copy of the packed pixel data is kept so the texture can be recreated
+ * after the OpenGL context is lost.
+ */
+class DynamicTextureAtlas : public TextureAtlas
+{
+public:
+	/**
+	 * Creates an empty atlas, allocating it's texture.
+	 * @param graphicsDevice the graphics device to create the texture with
+	 * @param width the width in pixels of the atlas texture
+	 * @param height the height in pixels of the atlas texture
+	 * @param padding the number of empty pixels to leave around each image
+	 *                packed into the atlas
+	 * @param format the pixel format of the atlas texture. either
+	 *               IMAGE_FORMAT_RGBA or IMAGE_FORMAT_ALPHA. the width of
+	 *               alpha-only atlases must be a multiple of 4
+	 */
+	DynamicTextureAtlas(GraphicsDevice *graphicsDevice, uint width, uint height, uint padding = 1, IMAGE_FORMAT format = IMAGE_FORMAT_RGBA);
+
+	virtual ~DynamicTextureAtlas();
+
+	/**
+	 * Packs an image into the atlas and uploads it to the atlas texture.
+	 * For RGBA atlases, alpha-only and RGB images are converted to RGBA.
+	 * Alpha-only atlases can only have alpha-only images added.
+	 * @param image the image to add
+	 * @param index receives the index of the new sub-texture if successful
+	 * @return true if the image was added, false if there was not enough
+	 *              free space left in the atlas for it
+	 */
+	bool Add(const Image *image, uint &index);
+
+	/**
+	 * @return the fraction (0.0 to 1.0) of the atlas area in use
+	 */
+	float GetOccupancy() const                             { return m_packer.GetOccupancy(); }
+
+	/**
+	 * @return the pixel format of the atlas texture
+	 */
+	IMAGE_FORMAT GetFormat() const                         { return m_format; }
+
+	/**
+	 * New OpenGL graphics context creation callback.
+	 */
+	void OnNewContext();
+
+	/**
+	 * Lost OpenGL graphics context callback.
+	 */
+	void OnLostContext();
+
+private:
+	bool CreateTexture();
+	void CopyAsRGBA(const Image *image, uint destX, uint destY);
+
+	GraphicsDevice *m_graphicsDevice;
+	SkylinePacker m_packer;
+	uint m_padding;
+	IMAGE_FORMAT m_format;
+	Image *m_pixels;
+	Texture *m_texture;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "dynamictextureatlasmanager.h"
+
+#include "dynamictextureatlas.h"
+#include "graphicsdevice.h"
+#include "image.h"
+
+DynamicTextureAtlasManager::DynamicTextureAtlasManager(GraphicsDevice *graphicsDevice, uint pageWidth, uint pageHeight, uint padding)
+{
+	ASSERT(graphicsDevice != NULL);
+	ASSERT(pageWidth > 0);
+	ASSERT(pageHeight > 0);
+
+	m_graphicsDevice = graphicsDevice;
+	m_pageWidth = pageWidth;
+	m_pageHeight = pageHeight;
+	m_padding = padding;
+}
+
+DynamicTextureAtlasManager::~DynamicTextureAtlasManager()
+{
+	Clear();
+}
+
+DynamicTextureAtlasTile DynamicTextureAtlasManager::Add(const Image *image)
+{
+	ASSERT(image != NULL);
+
+	DynamicTextureAtlasTile tile;
+	if (image->GetWidth() + m_padding > m_pageWidth || image->GetHeight() + m_padding > m_pageHeight)
+	{
+		LOG_WARN(LOGCAT_GRAPHICS, "DynamicTextureAtlasManager: %d x %d image does not fit in a %d x %d atlas page.\n", image->GetWidth(), image->GetHeight(), m_pageWidth, m_pageHeight);
+		return tile;
+	}
+
+	// most recently allocated pages are the most likely to still have room
+	for (int i = (int)m_pages.size() - 1; i >= 0; --i)
+	{
+		if (m_pages[i]->Add(image, tile.index))
+		{
+			tile.atlas = m_pages[i];
+			return tile;
+		}
+	}
+
+	LOG_INFO(LOGCAT_GRAPHICS, "DynamicTextureAtlasManager: allocating atlas page %d (%d x %d).\n", m_pages.size(), m_pageWidth, m_pageHeight);
+	DynamicTextureAtlas *page = new DynamicTextureAtlas(m_graphicsDevice, m_pageWidth, m_pageHeight, m_padding);
+	m_pages.push_back(page);
+
+	if (page->Add(image, tile.index))
+		tile.atlas = page;
+
+	return tile;
+}
+
+DynamicTextureAtlasTile DynamicTextureAtlasManager::Add(const stl::string &name, const Image *image)
+{
+	DynamicTextureAtlasTileMap::iterator itor = m_namedTiles.find(name);
+	if (itor != m_namedTiles.end())
+		return itor->second;
+
+	DynamicTextureAtlasTile tile = Add(image);
+	if (tile.IsValid())
+		m_namedTiles[name] = tile;
+
+	return tile;
+}
+
+DynamicTextureAtlasTile DynamicTextureAtlasManager::Get(const stl::string &name) const
+{
+	DynamicTextureAtlasTileMap::const_iterator itor = m_namedTiles.find(name);
+	if (itor != m_namedTiles.end())
+		return itor->second;
+	else
+		return DynamicTextureAtlasTile();
+}
+
+void DynamicTextureAtlasManager::Clear()
+{
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+	{
+		DynamicTextureAtlas *page = *i;
+		SAFE_DELETE(page);
+	}
+	m_pages.clear();
+	m_namedTiles.clear();
+}
+
+void DynamicTextureAtlasManager::OnNewContext()
+{
+	LOG_INFO(LOGCAT_GRAPHICS, "DynamicTextureAtlasManager: recreating %d atlas page textures for new OpenGL context.\n", m_pages.size());
+
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+		(*i)->OnNewContext();
+}
+
+void DynamicTextureAtlasManager::OnLostContext()
+{
+	LOG_INFO(LOGCAT_GRAPHICS, "DynamicTextureAtlasManager: resetting atlas page textures due to lost OpenGL context.\n");
+
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+		(*i)->OnLostContext();
+}
@@ -0,0 +1,119 @@
+#ifndef __FRAMEWORK_GRAPHICS_DYNAMICTEXTUREATLASMANAGER_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_DYNAMICTEXTUREATLASMANAGER_H_INCLUDED__
+
+#include "../common.h"
+#include <stl/map.h>
+#include <stl/string.h>
+#include <stl/vector.h>
+
+class DynamicTextureAtlas;
+class GraphicsDevice;
+class Image;
+
+/**
+ * Identifies an image that was packed into one of the pages of a
+ * DynamicTextureAtlasManager.
+ */
+struct DynamicTextureAtlasTile
+{
+	DynamicTextureAtlas *atlas;
+	uint index;
+
+	DynamicTextureAtlasTile()
+	{
+		atlas = NULL;
+		index = 0;
+	}
+
+	/**
+	 * @return true if this refers to an image that was successfully packed
+	 */
+	bool IsValid() const                                   { return atlas != NULL; }
+};
+
+typedef stl::vector<DynamicTextureAtlas*> DynamicTextureAtlasPages;
+typedef stl::map<stl::string, DynamicTextureAtlasTile> DynamicTextureAtlasTileMap;
+
+/**
+ * Packs small images (sprites, UI elements, etc.) into a set of shared
+ * atlas textures at runtime so that they can be rendered together in a
+ * single batch. New atlas pages are allocated as existing ones fill up.
+ */
+class DynamicTextureAtlasManager
+{
+public:
+	/**
+	 * Creates an empty atlas manager. No pages are allocated until the
+	 * first image is added.
+	 * @param graphicsDevice the graphics device used to create textures with
+	 * @param pageWidth the width in pixels of each atlas page texture
+	 * @param pageHeight the height in pixels of each atlas page texture
+	 * @param padding the number of empty pixels to leave between packed images
+	 */
+	DynamicTextureAtlasManager(GraphicsDevice *graphicsDevice, uint pageWidth = 1024, uint pageHeight = 1024, uint padding = 1);
+
+	virtual ~DynamicTextureAtlasManager();
+
+	/**
+	 * Packs an image into the first atlas page that has room for it,
+	 * allocating a new page if none do.
+	 * @param image the image to add
+	 * @return the location of the packed image, or an invalid tile if the
+	 *         image is larger than an atlas page
+	 */
+	DynamicTextureAtlasTile Add(const Image *image);
+
+	/**
+	 * Packs an image and remembers it's location by name. If an image
+	 * was already added under the same name, that one is returned instead
+	 * and the new image is not packed.
+	 * @param name the unique name to identify the image with
+	 * @param image the image to add
+	 * @return the location of the packed image, or an invalid tile if the
+	 *         image is larger than an atlas page
+	 */
+	DynamicTextureAtlasTile Add(const stl::string &name, const Image *image);
+
+	/**
+	 * Looks up an image previously added by name.
+	 * @param name the name the image was added with
+	 * @return the location of the packed image, or an invalid tile if no
+	 *         image was added with the given name
+	 */
+	DynamicTextureAtlasTile Get(const stl::string &name) const;
+
+	/**
+	 * Frees all atlas pages and forgets all named images.
+	 */
+	void Clear();
+
+	/**
+	 * @return the number of atlas pages currently allocated
+	 */
+	uint GetNumPages() const                               { return m_pages.size(); }
+
+	/**
+	 * @return the atlas page at the given index
+	 */
+	DynamicTextureAtlas* GetPage(uint index) const         { return m_pages[index]; }
+
+	/**
+	 * New OpenGL graphics context creation callback.
+	 */
+	void OnNewContext();
+
+	/**
+	 * Lost OpenGL graphics context callback.
+	 */
+	void OnLostContext();
+
+private:
+	GraphicsDevice *m_graphicsDevice;
+	uint m_pageWidth;
+	uint m_pageHeight;
+	uint m_padding;
+	DynamicTextureAtlasPages m_pages;
+	DynamicTextureAtlasTileMap m_namedTiles;
+};
+
+#endif
@@ -238,7 +238,7 @@ void GeometryDebugRenderer::End()
 		m_graphicsDevice->GetDebugShader()->SetModelViewMatrix(modelView);
 		m_graphicsDevice->GetDebugShader()->SetProjectionMatrix(projection);
 
-		m_renderState->Apply();
+		m_renderState->Apply(m_graphicsDevice);
 		m_graphicsDevice->BindVertexBuffer(m_vertices);
 		m_graphicsDevice->RenderLines(0, m_currentVertex / 2);
 		m_graphicsDevice->RenderPoints(0, m_currentVertex);
@@ -1,7 +1,12 @@
  #ifndef __FRAMEWORK_GRAPHICS_GLINCLUDES_H_INCLUDED__
 #define __FRAMEWORK_GRAPHICS_GLINCLUDES_H_INCLUDED__
 
-#ifdef DESKTOP
+#ifdef NULL_GRAPHICS
+
+// recording no-op implementation, for running without a GPU
+#include "nullgl.h"
+
+#elif DESKTOP
 
 // GLEW will include all necessary GL headers (e.g. gl.h, glu.h ... )
 #include <glew.h>
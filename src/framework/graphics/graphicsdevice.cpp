@@ -3,10 +3,12 @@
 
 #include "graphicsdevice.h"
 
+#include "billboardspriteshader.h"
 #include "blendstate.h"
 #include "bufferobject.h"
 #include "color.h"
 #include "debugshader.h"
+#include "dynamictextureatlasmanager.h"
 #include "framebuffer.h"
 #include "framebufferdatatypes.h"
 #include "geometrydebugrenderer.h"
@@ -19,9 +21,11 @@
 #include "renderbuffer.h"
 #include "renderstate.h"
 #include "shader.h"
+#include "shaderprogramcache.h"
 #include "simplecolorshader.h"
 #include "simplecolortextureshader.h"
 #include "simpletextureshader.h"
+#include "simpletextureinstancedshader.h"
 #include "simpletexturevertexlerpshader.h"
 #include "simpletexturevertexskinningshader.h"
 #include "standardshader.h"
@@ -46,9 +50,11 @@ GraphicsDevice::GraphicsDevice()
 {
 	m_hasNewContextRunYet = false;
 	m_boundVertexBuffer = NULL;
+	m_boundInstanceBuffer = NULL;
 	m_boundIndexBuffer = NULL;
 	m_boundShader = NULL;
 	m_shaderVertexAttribsSet = false;
+	m_hasVertexAttribRemaps = false;
 	m_boundTextures = NULL;
 	m_boundFramebuffer = NULL;
 	m_boundRenderbuffer = NULL;
@@ -56,20 +62,27 @@ GraphicsDevice::GraphicsDevice()
 	m_defaultViewContext = NULL;
 	m_debugRenderer = NULL;
 	m_solidColorTextures = NULL;
+	m_dynamicTextureAtlas = NULL;
+	m_shaderProgramCache = NULL;
 	m_simpleColorShader = NULL;
 	m_simpleColorTextureShader = NULL;
 	m_simpleTextureShader = NULL;
+	m_simpleTextureInstancedShader = NULL;
 	m_simpleTextureVertexLerpShader = NULL;
 	m_simpleTextureVertexSkinningShader = NULL;
 	m_sprite2dShader = NULL;
 	m_sprite3dShader = NULL;
+	m_billboardSpriteShader = NULL;
 	m_debugShader = NULL;
+	m_isRenderStateKnown = false;
+	m_isBlendStateKnown = false;
 	m_isDepthTextureSupported = false;
 	m_isNonPowerOfTwoTextureSupported = false;
+	m_isInstancingSupported = false;
 	m_window = NULL;
 }
 
-bool GraphicsDevice::Initialize(GameWindow *window)
+bool GraphicsDevice::Initialize(GameWindow *window, FileSystem *fileSystem)
 {
 	ASSERT(m_window == NULL);
 	if (m_window != NULL)
@@ -82,19 +95,28 @@ bool GraphicsDevice::Initialize(GameWindow *window)
 	m_hasNewContextRunYet = false;
 	m_boundTextures = new const Texture*[MAX_BOUND_TEXTURES];
 	m_enabledVertexAttribIndices.reserve(MAX_GPU_ATTRIB_SLOTS);
+	m_enabledInstanceAttribIndices.reserve(MAX_GPU_ATTRIB_SLOTS);
+	m_vertexAttribRemaps.resize(MAX_GPU_ATTRIB_SLOTS);
+	ClearVertexAttributeRemaps();
 
 #ifdef MOBILE
 	m_isDepthTextureSupported = IsGLExtensionPresent("OES_depth_texture");
 	m_isNonPowerOfTwoTextureSupported = IsGLExtensionPresent("OES_texture_npot");
+	
+	// instancing isn't part of core OpenGL ES 2.0
+	m_isInstancingSupported = false;
 #else
 	// TODO: Is this a good enough "catch-all" check for desktops?
 	m_isDepthTextureSupported = IsGLExtensionPresent("ARB_depth_texture");
 	
 	m_isNonPowerOfTwoTextureSupported = IsGLExtensionPresent("ARB_texture_non_power_of_two");
+	
+	m_isInstancingSupported = IsGLExtensionPresent("ARB_instanced_arrays") && IsGLExtensionPresent("ARB_draw_instanced");
 #endif
 	
 	LOG_INFO(LOGCAT_GRAPHICS, "Support for depth textures was %s.\n", m_isDepthTextureSupported ? "found" : "not found");
 	LOG_INFO(LOGCAT_GRAPHICS, "Support for NPOT textures was %s.\n", m_isNonPowerOfTwoTextureSupported ? "found" : "not found");
+	LOG_INFO(LOGCAT_GRAPHICS, "Support for instanced rendering was %s.\n", m_isInstancingSupported ? "found" : "not found");
 	
 	m_window = window;
 
@@ -105,6 +127,14 @@ bool GraphicsDevice::Initialize(GameWindow *window)
 	m_currentTextureParams = TEXPARAM_DEFAULT;
 	
 	m_solidColorTextures = new SolidColorTextureCache(this);
+	m_dynamicTextureAtlas = new DynamicTextureAtlasManager(this);
+
+	if (fileSystem != NULL)
+	{
+		m_shaderProgramCache = new ShaderProgramCache(fileSystem);
+		if (!m_shaderProgramCache->IsSupported())
+			SAFE_DELETE(m_shaderProgramCache);
+	}
 	
 	return true;
 }
@@ -114,20 +144,28 @@ void GraphicsDevice::Release()
 	SAFE_DELETE(m_defaultViewContext);
 	SAFE_DELETE(m_debugRenderer);
 	SAFE_DELETE(m_solidColorTextures);
+	SAFE_DELETE(m_dynamicTextureAtlas);
+	SAFE_DELETE(m_shaderProgramCache);
 	SAFE_DELETE(m_simpleColorShader);
 	SAFE_DELETE(m_simpleColorTextureShader);
 	SAFE_DELETE(m_simpleTextureShader);
+	SAFE_DELETE(m_simpleTextureInstancedShader);
 	SAFE_DELETE(m_simpleTextureVertexLerpShader);
 	SAFE_DELETE(m_simpleTextureVertexSkinningShader);
 	SAFE_DELETE(m_sprite2dShader);
 	SAFE_DELETE(m_sprite3dShader);
+	SAFE_DELETE(m_billboardSpriteShader);
 	SAFE_DELETE(m_debugShader);
 	SAFE_DELETE_ARRAY(m_boundTextures);
 	m_enabledVertexAttribIndices.clear();
+	m_enabledInstanceAttribIndices.clear();
+	m_vertexAttribRemaps.clear();
+	m_hasVertexAttribRemaps = false;
 	m_managedResources.clear();
 	
 	m_hasNewContextRunYet = false;
 	m_boundVertexBuffer = NULL;
+	m_boundInstanceBuffer = NULL;
 	m_boundIndexBuffer = NULL;
 	m_boundShader = NULL;
 	m_shaderVertexAttribsSet = false;
@@ -136,7 +174,10 @@ void GraphicsDevice::Release()
 	m_activeViewContext = NULL;
 	m_isDepthTextureSupported = false;
 	m_isNonPowerOfTwoTextureSupported = false;
+	m_isInstancingSupported = false;
 	m_window = NULL;
+	m_frameStats.Reset();
+	m_lastFrameStats.Reset();
 }
 
 SimpleColorShader* GraphicsDevice::GetSimpleColorShader()
@@ -172,6 +213,17 @@ SimpleTextureShader* GraphicsDevice::GetSimpleTextureShader()
 	return m_simpleTextureShader;
 }
 
+SimpleTextureInstancedShader* GraphicsDevice::GetSimpleTextureInstancedShader()
+{
+	if (m_simpleTextureInstancedShader == NULL)
+	{
+		m_simpleTextureInstancedShader = new SimpleTextureInstancedShader();
+		m_simpleTextureInstancedShader->Initialize(this);
+	}
+	
+	return m_simpleTextureInstancedShader;
+}
+
 Sprite2DShader* GraphicsDevice::GetSprite2DShader()
 {
 	if (m_sprite2dShader == NULL)
@@ -194,6 +246,17 @@ Sprite3DShader* GraphicsDevice::GetSprite3DShader()
 	return m_sprite3dShader;
 }
 
+BillboardSpriteShader* GraphicsDevice::GetBillboardSpriteShader()
+{
+	if (m_billboardSpriteShader == NULL)
+	{
+		m_billboardSpriteShader = new BillboardSpriteShader();
+		m_billboardSpriteShader->Initialize(this);
+	}
+	
+	return m_billboardSpriteShader;
+}
+
 SimpleTextureVertexLerpShader* GraphicsDevice::GetSimpleTextureVertexLerpShader()
 {
 	if (m_simpleTextureVertexLerpShader == NULL)
@@ -233,8 +296,11 @@ void GraphicsDevice::OnNewContext()
 
 	m_activeViewContext->OnNewContext();
 
-	RENDERSTATE_DEFAULT.Apply();
-	BLENDSTATE_DEFAULT.Apply();
+	// nothing is known about the state of a new context, so these will be
+	// applied in full
+	InvalidateAppliedStates();
+	RENDERSTATE_DEFAULT.Apply(this);
+	BLENDSTATE_DEFAULT.Apply(this);
 
 	UnbindVertexBuffer();
 	UnbindIndexBuffer();
@@ -251,6 +317,7 @@ void GraphicsDevice::OnNewContext()
 	if (m_hasNewContextRunYet)
 	{
 		m_solidColorTextures->OnNewContext();
+		m_dynamicTextureAtlas->OnNewContext();
 		
 		for (ManagedResourceList::iterator i = m_managedResources.begin(); i != m_managedResources.end(); ++i)
 			(*i)->OnNewContext();
@@ -267,7 +334,10 @@ void GraphicsDevice::OnLostContext()
 
 	SAFE_DELETE(m_debugRenderer);
 
+	InvalidateAppliedStates();
+
 	m_solidColorTextures->OnLostContext();
+	m_dynamicTextureAtlas->OnLostContext();
 
 	for (ManagedResourceList::iterator i = m_managedResources.begin(); i != m_managedResources.end(); ++i)
 		(*i)->OnLostContext();
@@ -295,6 +365,11 @@ void GraphicsDevice::OnRender()
 	}
 	
 	m_activeViewContext->OnRender();
+
+	// everything counted since the previous render belongs to the frame that
+	// is now complete
+	m_lastFrameStats = m_frameStats;
+	m_frameStats.Reset();
 }
 
 void GraphicsDevice::Clear(float r, float g, float b, float a)
@@ -465,6 +540,8 @@ void GraphicsDevice::BindVertexBuffer(VertexBuffer *buffer)
 		BindClientBuffer(buffer);
 
 	m_boundVertexBuffer = buffer;
+	if (m_hasVertexAttribRemaps)
+		ClearVertexAttributeRemaps();
 	if (m_shaderVertexAttribsSet)
 		ClearSetShaderVertexAttributes();
 }
@@ -474,6 +551,70 @@ void GraphicsDevice::UnbindVertexBuffer()
 	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
 	m_boundVertexBuffer = NULL;
+	if (m_hasVertexAttribRemaps)
+		ClearVertexAttributeRemaps();
+	if (m_shaderVertexAttribsSet)
+		ClearSetShaderVertexAttributes();
+}
+
+void GraphicsDevice::RemapVertexAttribute(uint attribIndex, uint sourceAttribIndex, uint baseVertex)
+{
+	ASSERT(m_boundVertexBuffer != NULL);
+	ASSERT(attribIndex < m_vertexAttribRemaps.size());
+	ASSERT(sourceAttribIndex < m_boundVertexBuffer->GetNumAttributes());
+	ASSERT(baseVertex < m_boundVertexBuffer->GetNumElements());
+	if (attribIndex >= m_vertexAttribRemaps.size())
+		return;
+
+	VertexAttribRemap &remap = m_vertexAttribRemaps[attribIndex];
+	remap.isRemapped = true;
+	remap.sourceAttribIndex = sourceAttribIndex;
+	remap.baseVertex = baseVertex;
+	m_hasVertexAttribRemaps = true;
+
+	if (m_shaderVertexAttribsSet)
+		ClearSetShaderVertexAttributes();
+}
+
+void GraphicsDevice::ClearVertexAttributeRemaps()
+{
+	for (uint i = 0; i < m_vertexAttribRemaps.size(); ++i)
+	{
+		m_vertexAttribRemaps[i].isRemapped = false;
+		m_vertexAttribRemaps[i].sourceAttribIndex = 0;
+		m_vertexAttribRemaps[i].baseVertex = 0;
+	}
+	m_hasVertexAttribRemaps = false;
+
+	if (m_shaderVertexAttribsSet)
+		ClearSetShaderVertexAttributes();
+}
+
+void GraphicsDevice::BindInstanceBuffer(VertexBuffer *buffer)
+{
+	ASSERT(buffer != NULL);
+	ASSERT(buffer->GetNumElements() > 0);
+	ASSERT(buffer->IsClientSideBuffer() == false);
+	ASSERT(m_isInstancingSupported == true);
+
+	// don't bind this buffer if it's already bound!
+	if (m_boundInstanceBuffer == buffer)
+		return;
+
+	// the buffer only gets bound to GL_ARRAY_BUFFER while the per-instance
+	// attribute pointers are being set, but it's contents need to be in video
+	// memory before then
+	if (buffer->IsDirty())
+		buffer->Update();
+
+	m_boundInstanceBuffer = buffer;
+	if (m_shaderVertexAttribsSet)
+		ClearSetShaderVertexAttributes();
+}
+
+void GraphicsDevice::UnbindInstanceBuffer()
+{
+	m_boundInstanceBuffer = NULL;
 	if (m_shaderVertexAttribsSet)
 		ClearSetShaderVertexAttributes();
 }
@@ -558,12 +699,21 @@ void GraphicsDevice::SetShaderVertexAttributes()
 	ASSERT(m_boundVertexBuffer != NULL);
 	ASSERT(m_boundShader != NULL);
 	ASSERT(m_enabledVertexAttribIndices.empty() == true);
-	ASSERT(m_boundVertexBuffer->GetNumAttributes() >= m_boundShader->GetNumAttributes());
+	ASSERT(m_enabledInstanceAttribIndices.empty() == true);
 
+	bool hasInstanceAttributes = false;
 	uint numAttributes = m_boundShader->GetNumAttributes();
 	for (uint i = 0; i < numAttributes; ++i)
 	{
+		// per-instance attributes are sourced from a different buffer, handled below
+		if (m_boundShader->IsAttributeMappedToInstanceBuffer(i))
+		{
+			hasInstanceAttributes = true;
+			continue;
+		}
+
 		int bufferAttribIndex = 0;
+		uint baseVertex = 0;
 		if (m_boundShader->IsAttributeMappedToStandardType(i))
 		{
 			VERTEX_STANDARD_ATTRIBS standardType = m_boundShader->GetAttributeMappedStandardType(i);
@@ -573,14 +723,22 @@ void GraphicsDevice::SetShaderVertexAttributes()
 				continue;
 		}
 		else
+		{
 			bufferAttribIndex = m_boundShader->GetAttributeMappedBufferIndex(i);
+			if (m_hasVertexAttribRemaps && (uint)bufferAttribIndex < m_vertexAttribRemaps.size() && m_vertexAttribRemaps[bufferAttribIndex].isRemapped)
+			{
+				baseVertex = m_vertexAttribRemaps[bufferAttribIndex].baseVertex;
+				bufferAttribIndex = m_vertexAttribRemaps[bufferAttribIndex].sourceAttribIndex;
+			}
+		}
+		ASSERT((uint)bufferAttribIndex < m_boundVertexBuffer->GetNumAttributes());
 
 		uint offset = 0;
 		GLint size = 0;
 
 		const VertexBufferAttribute *bufferAttribInfo = m_boundVertexBuffer->GetAttributeInfo((uint)bufferAttribIndex);
 		size = bufferAttribInfo->size;
-		offset = bufferAttribInfo->offset;
+		offset = bufferAttribInfo->offset + (baseVertex * (m_boundVertexBuffer->GetElementWidthInBytes() / sizeof(float)));
 		ASSERT(size != 0);
 
 		// convert the offset into a pointer
@@ -598,11 +756,66 @@ void GraphicsDevice::SetShaderVertexAttributes()
 		m_enabledVertexAttribIndices.push_back(i);
 	}
 
+	if (hasInstanceAttributes)
+		SetShaderInstanceAttributes();
+
 	m_shaderVertexAttribsSet = true;
 }
 
+void GraphicsDevice::SetShaderInstanceAttributes()
+{
+	ASSERT(m_boundInstanceBuffer != NULL);
+	if (m_boundInstanceBuffer == NULL)
+		return;
+
+#ifdef MOBILE
+	ASSERT(!"Instanced rendering is not supported.");
+#else
+	// glVertexAttribPointer captures whatever is bound to GL_ARRAY_BUFFER at
+	// the time it's called, so the instance buffer only needs to be bound
+	// while these pointers are being set
+	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_boundInstanceBuffer->GetBufferId()));
+
+	uint numAttributes = m_boundShader->GetNumAttributes();
+	for (uint i = 0; i < numAttributes; ++i)
+	{
+		if (!m_boundShader->IsAttributeMappedToInstanceBuffer(i))
+			continue;
+
+		uint bufferAttribIndex = m_boundShader->GetAttributeMappedBufferIndex(i);
+		ASSERT(bufferAttribIndex < m_boundInstanceBuffer->GetNumAttributes());
+
+		const VertexBufferAttribute *bufferAttribInfo = m_boundInstanceBuffer->GetAttributeInfo(bufferAttribIndex);
+		ASSERT(bufferAttribInfo->size != 0 && bufferAttribInfo->size <= 4);
+		const void *buffer = (int8_t*)NULL + (bufferAttribInfo->offset * sizeof(float));
+
+		GL_CALL(glEnableVertexAttribArray(i));
+		GL_CALL(glVertexAttribPointer(i, bufferAttribInfo->size, GL_FLOAT, false, m_boundInstanceBuffer->GetElementWidthInBytes(), buffer));
+		GL_CALL(glVertexAttribDivisorARB(i, 1));
+
+		m_enabledVertexAttribIndices.push_back(i);
+		m_enabledInstanceAttribIndices.push_back(i);
+	}
+
+	// restore the normal vertex buffer binding
+	uint vertexBufferId = (m_boundVertexBuffer->IsClientSideBuffer() ? 0 : m_boundVertexBuffer->GetBufferId());
+	GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId));
+#endif
+}
+
 void GraphicsDevice::ClearSetShaderVertexAttributes()
 {
+#ifndef MOBILE
+	// the divisor is per attribute slot and not per buffer, so it needs to be
+	// reset or the next non-instanced use of this slot would be affected
+	while (!m_enabledInstanceAttribIndices.empty())
+	{
+		uint index = m_enabledInstanceAttribIndices.back();
+		m_enabledInstanceAttribIndices.pop_back();
+		GL_CALL(glVertexAttribDivisorARB(index, 0));
+	}
+#endif
+
 	while (!m_enabledVertexAttribIndices.empty())
 	{
 		uint index = m_enabledVertexAttribIndices.back();
@@ -689,6 +902,41 @@ void GraphicsDevice::RenderTriangles(uint startVertex, uint numTriangles)
 	}
 }
 
+void GraphicsDevice::RenderTrianglesInstanced(uint numInstances)
+{
+	ASSERT(m_boundVertexBuffer != NULL);
+	ASSERT(m_boundInstanceBuffer != NULL);
+	ASSERT(numInstances <= m_boundInstanceBuffer->GetNumElements());
+	ASSERT(m_isInstancingSupported == true);
+	if (!m_shaderVertexAttribsSet)
+		SetShaderVertexAttributes();
+
+#ifdef MOBILE
+	ASSERT(!"Instanced rendering is not supported.");
+#else
+	if (m_boundIndexBuffer != NULL)
+	{
+		// using bound index buffer
+		int numIndices = m_boundIndexBuffer->GetNumElements();
+		ASSERT(numIndices % 3 == 0);
+
+		const void *offset;
+		if (m_boundIndexBuffer->IsClientSideBuffer())
+			offset = m_boundIndexBuffer->GetBuffer();
+		else
+			offset = NULL;
+
+		GL_CALL(glDrawElementsInstancedARB(GL_TRIANGLES, numIndices, GL_UNSIGNED_SHORT, offset, numInstances));
+	}
+	else
+	{
+		// no index buffer, just render the whole vertex buffer
+		ASSERT(m_boundVertexBuffer->GetNumElements() % 3 == 0);
+		GL_CALL(glDrawArraysInstancedARB(GL_TRIANGLES, 0, m_boundVertexBuffer->GetNumElements(), numInstances));
+	}
+#endif
+}
+
 void GraphicsDevice::RenderLines(const IndexBuffer *buffer)
 {
 	ASSERT(buffer != NULL);
@@ -3,7 +3,10 @@
 
 #include "../common.h"
 
+#include "blendstate.h"
 #include "framebufferdatatypes.h"
+#include "graphicsdevicestats.h"
+#include "renderstate.h"
 #include "textureformats.h"
 #include "textureparameters.h"
 #include "../math/rect.h"
@@ -11,8 +14,11 @@
 #include <stl/list.h>
 #include <stl/vector.h>
 
+class BillboardSpriteShader;
 class BufferObject;
 class DebugShader;
+class DynamicTextureAtlasManager;
+class FileSystem;
 class Framebuffer;
 class GameWindow;
 class GeometryDebugRenderer;
@@ -21,9 +27,11 @@ class Image;
 class IndexBuffer;
 class Renderbuffer;
 class Shader;
+class ShaderProgramCache;
 class SimpleColorShader;
 class SimpleColorTextureShader;
 class SimpleTextureShader;
+class SimpleTextureInstancedShader;
 class SimpleTextureVertexLerpShader;
 class SimpleTextureVertexSkinningShader;
 class SolidColorTextureCache;
@@ -37,6 +45,15 @@ struct Color;
 typedef stl::list<GraphicsContextResource*> ManagedResourceList;
 typedef stl::vector<uint> EnabledVertexAttribList;
 
+struct VertexAttribRemap
+{
+	bool isRemapped;
+	uint sourceAttribIndex;
+	uint baseVertex;
+};
+
+typedef stl::vector<VertexAttribRemap> VertexAttribRemapList;
+
 /**
  * Provides an abstraction over the underlying OpenGL context.
  */
@@ -55,9 +72,11 @@ public:
 	 * Initializes the graphics device object based on a parent window that is
 	 * hosting the OpenGL context.
 	 * @param window a window with an active OpenGL context associated with it
+	 * @param fileSystem file system used to cache compiled shader programs
+	 *                   with, or NULL to always compile shaders from source
 	 * @return true if successful, false if not
 	 */
-	bool Initialize(GameWindow *window);
+	bool Initialize(GameWindow *window, FileSystem *fileSystem = NULL);
 
 	/**
 	 * New OpenGL graphics context creation callback.
@@ -102,6 +121,18 @@ public:
 	 */
 	Texture* GetSolidColorTexture(const Color &color);
 
+	/**
+	 * @return the shared runtime texture atlas that small sprite and UI
+	 *         images can be packed into so they can be batched together
+	 */
+	DynamicTextureAtlasManager* GetDynamicTextureAtlas() const { return m_dynamicTextureAtlas; }
+
+	/**
+	 * @return the cache of compiled shader program binaries, or NULL if
+	 *         shader programs are not being cached
+	 */
+	ShaderProgramCache* GetShaderProgramCache() const      { return m_shaderProgramCache; }
+
 	/**
 	 * Binds a texture for rendering.
 	 * @param texture the texture to bind
@@ -140,6 +171,39 @@ public:
 	 * @return the currently applied texture parameters
 	 */
 	const TextureParameters* GetTextureParameters() const                       { return &m_currentTextureParams; }
+
+	/**
+	 * @return the render state last applied to the current OpenGL context,
+	 *         or NULL if it is not known
+	 */
+	const RenderState* GetAppliedRenderState() const                           { return m_isRenderStateKnown ? &m_appliedRenderState : NULL; }
+
+	/**
+	 * Records the render state that is now set in the OpenGL context. Called
+	 * by RenderState::Apply().
+	 * @param state the render state that was applied
+	 */
+	void SetAppliedRenderState(const RenderState &state);
+
+	/**
+	 * @return the blend state last applied to the current OpenGL context,
+	 *         or NULL if it is not known
+	 */
+	const BlendState* GetAppliedBlendState() const                             { return m_isBlendStateKnown ? &m_appliedBlendState : NULL; }
+
+	/**
+	 * Records the blend state that is now set in the OpenGL context. Called
+	 * by BlendState::Apply().
+	 * @param state the blend state that was applied
+	 */
+	void SetAppliedBlendState(const BlendState &state);
+
+	/**
+	 * Forgets the last applied render and blend states so that the next
+	 * time each is applied, all of it's settings are set again. Should be
+	 * called if these states are changed in OpenGL directly.
+	 */
+	void InvalidateAppliedStates();
 		
 	/**
 	 * Binds a renderbuffer.
@@ -223,6 +287,41 @@ public:
 	 */
 	void UnbindVertexBuffer();
 
+	/**
+	 * Redirects a vertex buffer attribute index, as referenced by shader
+	 * attributes mapped with Shader::MapAttributeToVboAttribIndex, so that
+	 * it is instead read from another attribute of the currently bound 
+	 * vertex buffer starting at the given vertex. This lets several shader
+	 * attributes read from different blocks of vertices within the same
+	 * buffer (e.g. two different keyframes of an animation). Remappings 
+	 * are cleared whenever the vertex buffer is unbound or replaced.
+	 * @param attribIndex the vertex buffer attribute index to redirect
+	 * @param sourceAttribIndex the attribute of the bound vertex buffer to
+	 *                          read from instead
+	 * @param baseVertex the vertex to start reading the attribute from
+	 */
+	void RemapVertexAttribute(uint attribIndex, uint sourceAttribIndex, uint baseVertex);
+
+	/**
+	 * Removes all vertex attribute remappings.
+	 */
+	void ClearVertexAttributeRemaps();
+
+	/**
+	 * Binds a vertex buffer containing per-instance data for instanced
+	 * rendering. Any attributes of the bound shader that have been mapped
+	 * to the instance buffer will be sourced from this buffer, advancing
+	 * once per instance instead of once per vertex. Requires instancing
+	 * support and a VBO-backed buffer.
+	 * @param buffer the per-instance vertex buffer to bind
+	 */
+	void BindInstanceBuffer(VertexBuffer *buffer);
+
+	/**
+	 * Unbinds a per-instance vertex buffer.
+	 */
+	void UnbindInstanceBuffer();
+
 	/**
 	 * Binds an index buffer for rendering. If the buffer has an associated
 	 * IBO it's contents will be uploaded to video memory if necessary.
@@ -264,6 +363,14 @@ public:
 	 */
 	void RenderTriangles(uint startVertex, uint numTriangles);
 
+	/**
+	 * Renders the currently bound vertex buffer (and index buffer, if one
+	 * is bound) as triangles multiple times in a single draw call, using
+	 * the currently bound instance buffer for per-instance attributes.
+	 * @param numInstances the number of instances to be rendered
+	 */
+	void RenderTrianglesInstanced(uint numInstances);
+
 	/**
 	 * Renders the currently bound vertex buffer as lines.
 	 * @param buffer index buffer containing indices of the vertices to be rendered
@@ -319,6 +426,11 @@ public:
 	 */
 	SimpleTextureShader* GetSimpleTextureShader();
 
+	/**
+	 * @return built-in shader
+	 */
+	SimpleTextureInstancedShader* GetSimpleTextureInstancedShader();
+
 	/**
 	 * @return built-in shader
 	 */
@@ -329,6 +441,11 @@ public:
 	 */
 	Sprite3DShader* GetSprite3DShader();
 
+	/**
+	 * @return built-in shader
+	 */
+	BillboardSpriteShader* GetBillboardSpriteShader();
+
 	/**
 	 * @return built-in shader
 	 */
@@ -354,12 +471,29 @@ public:
 	 *         are supported
 	 */
 	bool IsNonPowerOfTwoTextureSupported() const                                { return m_isNonPowerOfTwoTextureSupported; }
+
+	/**
+	 * @return true if instanced rendering with per-instance vertex
+	 *         attributes is supported
+	 */
+	bool IsInstancingSupported() const                                          { return m_isInstancingSupported; }
 	
 	/**
 	 * @return the parent window object that this graphics device is for
 	 */
 	GameWindow* GetWindow() const                                               { return m_window; }
 
+	/**
+	 * @return counters collected so far during the frame currently being
+	 *         processed
+	 */
+	GraphicsDeviceStats* GetFrameStats()                                        { return &m_frameStats; }
+
+	/**
+	 * @return counters that were collected during the last complete frame
+	 */
+	const GraphicsDeviceStats* GetLastFrameStats() const                        { return &m_lastFrameStats; }
+
 private:
 	void BindVBO(VertexBuffer *buffer);
 	void BindClientBuffer(VertexBuffer *buffer);
@@ -369,6 +503,7 @@ private:
 	bool IsReadyToRender() const;
 
 	void SetShaderVertexAttributes();
+	void SetShaderInstanceAttributes();
 	void ClearSetShaderVertexAttributes();
 
 	ManagedResourceList m_managedResources;
@@ -376,29 +511,45 @@ private:
 	Framebuffer *m_boundFramebuffer;
 	const Renderbuffer *m_boundRenderbuffer;
 	const VertexBuffer *m_boundVertexBuffer;
+	const VertexBuffer *m_boundInstanceBuffer;
 	const IndexBuffer *m_boundIndexBuffer;
 	const Texture **m_boundTextures;
 	Shader *m_boundShader;
 	bool m_shaderVertexAttribsSet;
 	EnabledVertexAttribList m_enabledVertexAttribIndices;
+	EnabledVertexAttribList m_enabledInstanceAttribIndices;
+	VertexAttribRemapList m_vertexAttribRemaps;
+	bool m_hasVertexAttribRemaps;
 	bool m_isDepthTextureSupported;
 	bool m_isNonPowerOfTwoTextureSupported;
+	bool m_isInstancingSupported;
 
 	GameWindow *m_window;
 	ViewContext *m_defaultViewContext;
 	ViewContext *m_activeViewContext;
 	TextureParameters m_currentTextureParams;
+	RenderState m_appliedRenderState;
+	BlendState m_appliedBlendState;
+	bool m_isRenderStateKnown;
+	bool m_isBlendStateKnown;
 
 	GeometryDebugRenderer *m_debugRenderer;
 	SolidColorTextureCache *m_solidColorTextures;
+	DynamicTextureAtlasManager *m_dynamicTextureAtlas;
+	ShaderProgramCache *m_shaderProgramCache;
+
+	GraphicsDeviceStats m_frameStats;
+	GraphicsDeviceStats m_lastFrameStats;
 
 	SimpleColorShader *m_simpleColorShader;
 	SimpleColorTextureShader *m_simpleColorTextureShader;
 	SimpleTextureShader *m_simpleTextureShader;
+	SimpleTextureInstancedShader *m_simpleTextureInstancedShader;
 	SimpleTextureVertexLerpShader *m_simpleTextureVertexLerpShader;
 	SimpleTextureVertexSkinningShader *m_simpleTextureVertexSkinningShader;
 	Sprite2DShader *m_sprite2dShader;
 	Sprite3DShader *m_sprite3dShader;
+	BillboardSpriteShader *m_billboardSpriteShader;
 	DebugShader *m_debugShader;
 	
 	bool m_hasNewContextRunYet;
@@ -409,6 +560,24 @@ inline void GraphicsDevice::SetTextureParameters(const TextureParameters &params
 	m_currentTextureParams = params;
 }
 
+inline void GraphicsDevice::SetAppliedRenderState(const RenderState &state)
+{
+	m_appliedRenderState = state;
+	m_isRenderStateKnown = true;
+}
+
+inline void GraphicsDevice::SetAppliedBlendState(const BlendState &state)
+{
+	m_appliedBlendState = state;
+	m_isBlendStateKnown = true;
+}
+
+inline void GraphicsDevice::InvalidateAppliedStates()
+{
+	m_isRenderStateKnown = false;
+	m_isBlendStateKnown = false;
+}
+
 inline bool GraphicsDevice::IsReadyToRender() const
 {
 	if (m_boundShader != NULL && m_boundVertexBuffer != NULL && m_shaderVertexAttribsSet)
@@ -0,0 +1,50 @@
+#ifndef __FRAMEWORK_GRAPHICS_GRAPHICSDEVICESTATS_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_GRAPHICSDEVICESTATS_H_INCLUDED__
+
+#include "../common.h"
+
+/**
+ * Counters for work submitted to the underlying OpenGL context. These are
+ * collected by GraphicsDevice over the course of a single frame.
+ */
+struct GraphicsDeviceStats
+{
+	/**
+	 * The number of buffer object uploads to video memory.
+	 */
+	uint numBufferUploads;
+
+	/**
+	 * The total number of bytes of buffer object data uploaded to video memory.
+	 */
+	size_t bufferBytesUploaded;
+
+	/**
+	 * The number of render/blend state OpenGL calls that were issued.
+	 */
+	uint numStateCallsIssued;
+
+	/**
+	 * The number of render/blend state OpenGL calls that were skipped because
+	 * the state being set was already current.
+	 */
+	uint numStateCallsSkipped;
+
+	GraphicsDeviceStats()
+	{
+		Reset();
+	}
+
+	/**
+	 * Sets all counters back to zero.
+	 */
+	void Reset()
+	{
+		numBufferUploads = 0;
+		bufferBytesUploaded = 0;
+		numStateCallsIssued = 0;
+		numStateCallsSkipped = 0;
+	}
+};
+
+#endif
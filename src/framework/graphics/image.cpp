@@ -6,11 +6,77 @@
 #include "../file/file.h"
 #include "../file/memoryfile.h"
 
+#include <math.h>
 #include <string.h>
 
 #define STBI_NO_STDIO
 #include <stb_image.h>
 
+// offset from a pixel to the nearest seed pixel, as used by 8SSEDT
+struct DistanceFieldOffset
+{
+	int dx;
+	int dy;
+
+	int GetLengthSquared() const                                                { return dx * dx + dy * dy; }
+};
+
+// further away than anything in any image that would ever be used
+const int DISTANCE_FIELD_FAR = 9999;
+
+static inline void CompareDistanceFieldOffset(const DistanceFieldOffset *grid, int width, int height, DistanceFieldOffset &current, int x, int y, int offsetX, int offsetY)
+{
+	int otherX = x + offsetX;
+	int otherY = y + offsetY;
+
+	DistanceFieldOffset other;
+	if (otherX >= 0 && otherY >= 0 && otherX < width && otherY < height)
+		other = grid[otherY * width + otherX];
+	else
+	{
+		other.dx = DISTANCE_FIELD_FAR;
+		other.dy = DISTANCE_FIELD_FAR;
+	}
+	other.dx += offsetX;
+	other.dy += offsetY;
+
+	if (other.GetLengthSquared() < current.GetLengthSquared())
+		current = other;
+}
+
+static void ComputeDistanceFieldOffsets(DistanceFieldOffset *grid, int width, int height)
+{
+	// 8-point sequential signed euclidean distance transform. one pass
+	// propagates offsets down the image and the other back up it
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			DistanceFieldOffset &p = grid[y * width + x];
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, -1, 0);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, 0, -1);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, -1, -1);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, 1, -1);
+		}
+		for (int x = width - 1; x >= 0; --x)
+			CompareDistanceFieldOffset(grid, width, height, grid[y * width + x], x, y, 1, 0);
+	}
+
+	for (int y = height - 1; y >= 0; --y)
+	{
+		for (int x = width - 1; x >= 0; --x)
+		{
+			DistanceFieldOffset &p = grid[y * width + x];
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, 1, 0);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, 0, 1);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, -1, 1);
+			CompareDistanceFieldOffset(grid, width, height, p, x, y, 1, 1);
+		}
+		for (int x = 0; x < width; ++x)
+			CompareDistanceFieldOffset(grid, width, height, grid[y * width + x], x, y, -1, 0);
+	}
+}
+
 Image::Image()
 {
 	m_pixels = NULL;
@@ -21,6 +87,90 @@ Image::Image()
 	m_pitch = 0;
 }
 
+bool Image::CreateDistanceField(const Image *source, uint spread, uint downscale)
+{
+	ASSERT(m_pixels == NULL);
+	if (m_pixels != NULL)
+		return false;
+
+	ASSERT(source != NULL);
+	if (source == NULL)
+		return false;
+
+	ASSERT(source->GetPixels() != NULL);
+	if (source->GetPixels() == NULL)
+		return false;
+
+	ASSERT(source->GetFormat() == IMAGE_FORMAT_ALPHA);
+	if (source->GetFormat() != IMAGE_FORMAT_ALPHA)
+		return false;
+
+	ASSERT(spread > 0);
+	ASSERT(downscale > 0);
+	uint width = source->GetWidth() / downscale;
+	uint height = source->GetHeight() / downscale;
+
+	bool baseCreateSuccess = Create(width, height, IMAGE_FORMAT_ALPHA);
+	if (!baseCreateSuccess)
+		return false;
+
+	int sourceWidth = (int)source->GetWidth();
+	int sourceHeight = (int)source->GetHeight();
+	uint numSourcePixels = source->GetWidth() * source->GetHeight();
+
+	// one grid finds each pixel's distance to the nearest pixel inside the
+	// shape, and the other to the nearest pixel outside of it
+	DistanceFieldOffset *toInside = new DistanceFieldOffset[numSourcePixels];
+	DistanceFieldOffset *toOutside = new DistanceFieldOffset[numSourcePixels];
+	DistanceFieldOffset zero = { 0, 0 };
+	DistanceFieldOffset farAway = { DISTANCE_FIELD_FAR, DISTANCE_FIELD_FAR };
+
+	for (int y = 0; y < sourceHeight; ++y)
+	{
+		const uint8_t *line = source->Get(0, y);
+		for (int x = 0; x < sourceWidth; ++x)
+		{
+			bool isInside = line[x] >= 128;
+			toInside[y * sourceWidth + x] = (isInside ? zero : farAway);
+			toOutside[y * sourceWidth + x] = (isInside ? farAway : zero);
+		}
+	}
+
+	ComputeDistanceFieldOffsets(toInside, sourceWidth, sourceHeight);
+	ComputeDistanceFieldOffsets(toOutside, sourceWidth, sourceHeight);
+
+	float maxDistance = (float)(spread * downscale);
+	for (uint y = 0; y < height; ++y)
+	{
+		uint8_t *line = Get(0, y);
+		for (uint x = 0; x < width; ++x)
+		{
+			// sample from the center of the block of source pixels
+			uint index = (y * downscale + downscale / 2) * source->GetWidth() + (x * downscale + downscale / 2);
+
+			// the edge is halfway between an inside and an outside pixel
+			float distance = sqrtf((float)toInside[index].GetLengthSquared()) - sqrtf((float)toOutside[index].GetLengthSquared());
+			if (distance > 0.0f)
+				distance -= 0.5f;
+			else
+				distance += 0.5f;
+
+			float value = 0.5f - (distance / (2.0f * maxDistance));
+			if (value < 0.0f)
+				value = 0.0f;
+			else if (value > 1.0f)
+				value = 1.0f;
+
+			line[x] = (uint8_t)(value * 255.0f);
+		}
+	}
+
+	SAFE_DELETE_ARRAY(toInside);
+	SAFE_DELETE_ARRAY(toOutside);
+
+	return true;
+}
+
 void Image::Release()
 {
 	SAFE_DELETE(m_pixels);
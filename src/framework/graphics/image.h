@@ -54,6 +54,22 @@ public:
 	 * @return true if successful
 	 */
 	bool Create(File *file);
+
+	/**
+	 * Creates a signed distance field from an alpha-only image. Each pixel
+	 * holds the distance to the nearest edge of the source image's shape,
+	 * with 128 on the edge itself, higher values inside the shape and lower
+	 * values outside of it.
+	 * @param source the alpha-only image to create the distance field from.
+	 *               pixels with an alpha of 128 or more are inside the shape
+	 * @param spread the distance in pixels of the created image over which
+	 *               values go from 0 to 255
+	 * @param downscale the number of source pixels along each axis making
+	 *                  up each created pixel. higher resolution sources
+	 *                  give more accurate distances
+	 * @return true if successful
+	 */
+	bool CreateDistanceField(const Image *source, uint spread, uint downscale = 1);
 	
 	/**
 	 * Frees all image resources.
@@ -78,7 +78,9 @@ bool IndexBuffer::Initialize(GraphicsDevice *graphicsDevice, const IndexBuffer *
 
 void IndexBuffer::Set(const uint16_t *indices, uint numIndices)
 {
-	memcpy(&m_buffer[0], indices, GetNumElements() * GetElementWidthInBytes());
+	ASSERT(numIndices <= GetNumElements());
+	memcpy(&m_buffer[0], indices, numIndices * GetElementWidthInBytes());
+	SetDirty(0, numIndices * GetElementWidthInBytes());
 }
 
 void IndexBuffer::Resize(uint numIndices)
@@ -166,6 +166,7 @@ private:
 inline void IndexBuffer::SetIndex(uint index, uint16_t value)
 {
 	m_buffer[index] = value;
+	SetDirty(index * sizeof(uint16_t), sizeof(uint16_t));
 }
 
 inline bool IndexBuffer::MoveNext()
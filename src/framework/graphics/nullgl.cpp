@@ -0,0 +1,634 @@
+#ifdef NULL_GRAPHICS
+#include "../debug.h"
+
+#include "nullgl.h"
+
+#include <stl/map.h>
+#include <stl/string.h>
+#include <stl/vector.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct NullGLShaderVariable
+{
+	stl::string name;
+	GLint size;
+};
+
+typedef stl::vector<NullGLShaderVariable> NullGLShaderVariableList;
+typedef stl::vector<GLuint> NullGLShaderIdList;
+
+struct NullGLProgram
+{
+	NullGLShaderIdList shaders;
+	NullGLShaderVariableList uniforms;
+	NullGLShaderVariableList attributes;
+	bool isLinked;
+};
+
+typedef stl::map<GLuint, stl::string> NullGLShaderSourceMap;
+typedef stl::map<GLuint, NullGLProgram> NullGLProgramMap;
+typedef stl::map<stl::string, GLint> NullGLDefineMap;
+
+NullGLStats g_nullGLStats;
+GLuint g_nullGLNextObjectName = 1;
+NullGLShaderSourceMap g_nullGLShaders;
+NullGLProgramMap g_nullGLPrograms;
+
+const NullGLStats& GetNullGLStats()
+{
+	return g_nullGLStats;
+}
+
+void ResetNullGLStats()
+{
+	g_nullGLStats.Reset();
+}
+
+static void GenerateNames(GLsizei n, GLuint *names)
+{
+	for (GLsizei i = 0; i < n; ++i)
+		names[i] = g_nullGLNextObjectName++;
+}
+
+static size_t GetPixelSize(GLenum format, GLenum type)
+{
+	size_t numComponents;
+	switch (format)
+	{
+	case GL_RGBA: numComponents = 4; break;
+	case GL_RGB: numComponents = 3; break;
+	default: numComponents = 1; break;
+	}
+
+	size_t componentSize;
+	switch (type)
+	{
+	case GL_UNSIGNED_SHORT: componentSize = 2; break;
+	case GL_FLOAT: componentSize = 4; break;
+	default: componentSize = 1; break;
+	}
+
+	return numComponents * componentSize;
+}
+
+static void CountDraw(GLenum mode, GLsizei count, GLsizei numInstances = 1)
+{
+	++g_nullGLStats.numDrawCalls;
+	if (mode == GL_TRIANGLES)
+		g_nullGLStats.numTriangles += ((uint)count / 3) * (uint)numInstances;
+}
+
+static bool IsIdentifierChar(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static void SplitIdentifiers(const stl::string &text, stl::vector<stl::string> &tokens)
+{
+	tokens.clear();
+
+	size_t i = 0;
+	while (i < text.length())
+	{
+		if (!IsIdentifierChar(text[i]))
+		{
+			// keep commas and array subscripts, they delimit declarators
+			if (text[i] == ',' || text[i] == '[')
+				tokens.push_back(stl::string(1, text[i]));
+			++i;
+			continue;
+		}
+
+		size_t start = i;
+		while (i < text.length() && IsIdentifierChar(text[i]))
+			++i;
+		tokens.push_back(text.substr(start, i - start));
+	}
+}
+
+static GLint GetArraySize(const stl::string &token, const NullGLDefineMap &defines)
+{
+	if (token.length() > 0 && token[0] >= '0' && token[0] <= '9')
+		return (GLint)atoi(token.c_str());
+
+	NullGLDefineMap::const_iterator i = defines.find(token);
+	if (i != defines.end())
+		return i->second;
+
+	return 1;
+}
+
+static void AddVariable(NullGLShaderVariableList &list, const stl::string &name, GLint size)
+{
+	// uniforms can be declared in both the vertex and fragment shaders
+	for (uint i = 0; i < list.size(); ++i)
+	{
+		if (list[i].name == name)
+			return;
+	}
+
+	NullGLShaderVariable variable;
+	variable.name = name;
+	variable.size = size;
+	list.push_back(variable);
+}
+
+static void ParseDeclarations(const stl::string &source, NullGLProgram &program)
+{
+	// not a GLSL parser by any stretch, just enough to pick out simple
+	// "uniform"/"attribute" declarations and integer #define's used as
+	// array sizes, which is all the framework's shaders need
+	NullGLDefineMap defines;
+	stl::vector<stl::string> tokens;
+	stl::string statement;
+
+	size_t lineStart = 0;
+	while (lineStart < source.length())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == stl::string::npos)
+			lineEnd = source.length();
+
+		stl::string line = source.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		size_t commentStart = line.find("//");
+		if (commentStart != stl::string::npos)
+			line = line.substr(0, commentStart);
+
+		if (line.find('#') != stl::string::npos)
+		{
+			SplitIdentifiers(line, tokens);
+			if (tokens.size() == 3 && tokens[0] == "define" && tokens[2][0] >= '0' && tokens[2][0] <= '9')
+				defines[tokens[1]] = (GLint)atoi(tokens[2].c_str());
+			continue;
+		}
+
+		statement += line;
+		statement += " ";
+
+		size_t statementEnd;
+		while ((statementEnd = statement.find(';')) != stl::string::npos)
+		{
+			SplitIdentifiers(statement.substr(0, statementEnd), tokens);
+			statement = statement.substr(statementEnd + 1);
+
+			if (tokens.empty() || (tokens[0] != "uniform" && tokens[0] != "attribute"))
+				continue;
+
+			NullGLShaderVariableList &list = (tokens[0] == "uniform" ? program.uniforms : program.attributes);
+
+			// skip the precision qualifier (if any) and the type
+			uint i = 1;
+			if (i < tokens.size() && (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp"))
+				++i;
+			++i;
+
+			while (i < tokens.size())
+			{
+				stl::string name = tokens[i++];
+				GLint size = 1;
+				if (i + 1 < tokens.size() && tokens[i] == "[")
+				{
+					size = GetArraySize(tokens[i + 1], defines);
+					i += 2;
+				}
+				AddVariable(list, name, size);
+
+				// skip ahead to the next declarator
+				while (i < tokens.size() && tokens[i] != ",")
+					++i;
+				++i;
+			}
+		}
+	}
+}
+
+static GLint GetMaxNameLength(const NullGLShaderVariableList &list)
+{
+	GLint maxLength = 0;
+	for (uint i = 0; i < list.size(); ++i)
+		maxLength = Max(maxLength, (GLint)list[i].name.length() + 1);
+	return maxLength;
+}
+
+static void GetActiveVariable(const NullGLShaderVariableList &list, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	ASSERT(index < list.size());
+	const NullGLShaderVariable &variable = list[index];
+
+	GLsizei nameLength = Min((GLsizei)variable.name.length(), bufSize - 1);
+	if (nameLength >= 0)
+	{
+		memcpy(name, variable.name.c_str(), nameLength);
+		name[nameLength] = '\0';
+	}
+	if (length != NULL)
+		*length = nameLength;
+
+	// the framework doesn't make use of the type, so everything is a float
+	*size = variable.size;
+	*type = GL_FLOAT;
+}
+
+static GLint GetVariableLocation(const NullGLShaderVariableList &list, const GLchar *name)
+{
+	for (uint i = 0; i < list.size(); ++i)
+	{
+		if (list[i].name == name)
+			return (GLint)i;
+	}
+
+	return -1;
+}
+
+void glActiveTexture(GLenum texture)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+	g_nullGLPrograms[program].shaders.push_back(shader);
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage)
+{
+	// a NULL data pointer only (re)allocates storage
+	if (data != NULL)
+		g_nullGLStats.bufferBytesUploaded += (size_t)size;
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data)
+{
+	g_nullGLStats.bufferBytesUploaded += (size_t)size;
+}
+
+void glClear(GLbitfield mask)
+{
+}
+
+void glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+}
+
+void glCompileShader(GLuint shader)
+{
+}
+
+GLuint glCreateProgram()
+{
+	GLuint name = g_nullGLNextObjectName++;
+	g_nullGLPrograms[name].isLinked = false;
+	return name;
+}
+
+GLuint glCreateShader(GLenum type)
+{
+	GLuint name = g_nullGLNextObjectName++;
+	g_nullGLShaders[name] = "";
+	return name;
+}
+
+void glCullFace(GLenum mode)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+}
+
+void glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+{
+}
+
+void glDeleteProgram(GLuint program)
+{
+	g_nullGLPrograms.erase(program);
+}
+
+void glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers)
+{
+}
+
+void glDeleteShader(GLuint shader)
+{
+	g_nullGLShaders.erase(shader);
+}
+
+void glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+}
+
+void glDepthFunc(GLenum func)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glDisable(GLenum cap)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glDisableVertexAttribArray(GLuint index)
+{
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	CountDraw(mode, count);
+}
+
+void glDrawArraysInstancedARB(GLenum mode, GLint first, GLsizei count, GLsizei primcount)
+{
+	CountDraw(mode, count, primcount);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+	CountDraw(mode, count);
+}
+
+void glDrawElementsInstancedARB(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei primcount)
+{
+	CountDraw(mode, count, primcount);
+}
+
+void glEnable(GLenum cap)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+}
+
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+}
+
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+}
+
+void glGenBuffers(GLsizei n, GLuint *buffers)
+{
+	GenerateNames(n, buffers);
+}
+
+void glGenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+	GenerateNames(n, framebuffers);
+}
+
+void glGenRenderbuffers(GLsizei n, GLuint *renderbuffers)
+{
+	GenerateNames(n, renderbuffers);
+}
+
+void glGenTextures(GLsizei n, GLuint *textures)
+{
+	GenerateNames(n, textures);
+}
+
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	GetActiveVariable(g_nullGLPrograms[program].attributes, index, bufSize, length, size, type, name);
+}
+
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	GetActiveVariable(g_nullGLPrograms[program].uniforms, index, bufSize, length, size, type, name);
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar *name)
+{
+	return GetVariableLocation(g_nullGLPrograms[program].attributes, name);
+}
+
+GLenum glGetError()
+{
+	return GL_NO_ERROR;
+}
+
+void glGetIntegerv(GLenum pname, GLint *params)
+{
+	*params = 0;
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+	if (length != NULL)
+		*length = 0;
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+	const NullGLProgram &p = g_nullGLPrograms[program];
+	switch (pname)
+	{
+	case GL_LINK_STATUS: *params = (p.isLinked ? GL_TRUE : GL_FALSE); break;
+	case GL_ACTIVE_UNIFORMS: *params = (GLint)p.uniforms.size(); break;
+	case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = GetMaxNameLength(p.uniforms); break;
+	case GL_ACTIVE_ATTRIBUTES: *params = (GLint)p.attributes.size(); break;
+	case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH: *params = GetMaxNameLength(p.attributes); break;
+	default: *params = 0; break;
+	}
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+	if (length != NULL)
+		*length = 0;
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+	if (pname == GL_COMPILE_STATUS)
+		*params = GL_TRUE;
+	else
+		*params = 0;
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+	switch (name)
+	{
+	case GL_VENDOR: return (const GLubyte*)"MyGameFramework";
+	case GL_RENDERER: return (const GLubyte*)"Null Recording Renderer";
+	case GL_VERSION: return (const GLubyte*)"2.0 NullGL";
+	case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"1.10";
+	case GL_EXTENSIONS: return (const GLubyte*)"GL_ARB_depth_texture GL_ARB_texture_non_power_of_two GL_ARB_instanced_arrays GL_ARB_draw_instanced";
+	}
+
+	return (const GLubyte*)"";
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar *name)
+{
+	return GetVariableLocation(g_nullGLPrograms[program].uniforms, name);
+}
+
+void glLineWidth(GLfloat width)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glLinkProgram(GLuint program)
+{
+	NullGLProgram &p = g_nullGLPrograms[program];
+	p.uniforms.clear();
+	p.attributes.clear();
+
+	for (uint i = 0; i < p.shaders.size(); ++i)
+	{
+		NullGLShaderSourceMap::const_iterator source = g_nullGLShaders.find(p.shaders[i]);
+		if (source != g_nullGLShaders.end())
+			ParseDeclarations(source->second, p);
+	}
+
+	p.isLinked = true;
+}
+
+void glPixelStorei(GLenum pname, GLint param)
+{
+}
+
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar **strings, const GLint *lengths)
+{
+	stl::string &source = g_nullGLShaders[shader];
+	source.clear();
+
+	for (GLsizei i = 0; i < count; ++i)
+	{
+		if (lengths != NULL && lengths[i] >= 0)
+			source.append(strings[i], (size_t)lengths[i]);
+		else
+			source.append(strings[i]);
+	}
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	// a NULL pixels pointer only allocates storage
+	if (pixels != NULL)
+		g_nullGLStats.textureBytesUploaded += (size_t)width * (size_t)height * GetPixelSize(format, type);
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	g_nullGLStats.textureBytesUploaded += (size_t)width * (size_t)height * GetPixelSize(format, type);
+}
+
+void glUniform1f(GLint location, GLfloat x)
+{
+}
+
+void glUniform1fv(GLint location, GLsizei count, const GLfloat *v)
+{
+}
+
+void glUniform1i(GLint location, GLint x)
+{
+}
+
+void glUniform2f(GLint location, GLfloat x, GLfloat y)
+{
+}
+
+void glUniform2fv(GLint location, GLsizei count, const GLfloat *v)
+{
+}
+
+void glUniform2i(GLint location, GLint x, GLint y)
+{
+}
+
+void glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
+{
+}
+
+void glUniform3fv(GLint location, GLsizei count, const GLfloat *v)
+{
+}
+
+void glUniform3i(GLint location, GLint x, GLint y, GLint z)
+{
+}
+
+void glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+}
+
+void glUniform4fv(GLint location, GLsizei count, const GLfloat *v)
+{
+}
+
+void glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
+{
+}
+
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+{
+}
+
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+{
+}
+
+void glUseProgram(GLuint program)
+{
+	++g_nullGLStats.numStateChanges;
+}
+
+void glVertexAttribDivisorARB(GLuint index, GLuint divisor)
+{
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer)
+{
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+}
+
+#endif
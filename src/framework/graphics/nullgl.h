@@ -0,0 +1,281 @@
+#ifdef NULL_GRAPHICS
+#ifndef __FRAMEWORK_GRAPHICS_NULLGL_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_NULLGL_H_INCLUDED__
+
+#include "../common.h"
+#include <stddef.h>
+
+/**
+ * "Null" OpenGL implementation. Provides the subset of the OpenGL API used
+ * by the framework as functions which do nothing except record what would
+ * have been sent to a real OpenGL implementation. This allows the rendering
+ * code to be run (and it's CPU cost measured) without any window or GPU.
+ *
+ * Enabled by defining NULL_GRAPHICS, in which case this is included by
+ * glincludes.h instead of the platform's real OpenGL headers.
+ *
+ * Object names are handed out as with a real implementation, and shader
+ * programs report the uniforms and attributes declared in their source as
+ * active so that Shader can be used as normal.
+ */
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef void GLvoid;
+typedef signed char GLbyte;
+typedef short GLshort;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned short GLushort;
+typedef unsigned int GLuint;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef double GLdouble;
+typedef char GLchar;
+typedef ptrdiff_t GLintptr;
+typedef ptrdiff_t GLsizeiptr;
+
+#define GL_FALSE                          0
+#define GL_TRUE                           1
+#define GL_ZERO                           0
+#define GL_ONE                            1
+#define GL_NO_ERROR                       0
+
+#define GL_POINTS                         0x0000
+#define GL_LINES                          0x0001
+#define GL_TRIANGLES                      0x0004
+
+#define GL_NEVER                          0x0200
+#define GL_LESS                           0x0201
+#define GL_EQUAL                          0x0202
+#define GL_LEQUAL                         0x0203
+#define GL_GREATER                        0x0204
+#define GL_NOTEQUAL                       0x0205
+#define GL_GEQUAL                         0x0206
+#define GL_ALWAYS                         0x0207
+
+#define GL_SRC_COLOR                      0x0300
+#define GL_ONE_MINUS_SRC_COLOR            0x0301
+#define GL_SRC_ALPHA                      0x0302
+#define GL_ONE_MINUS_SRC_ALPHA            0x0303
+#define GL_DST_ALPHA                      0x0304
+#define GL_ONE_MINUS_DST_ALPHA            0x0305
+#define GL_DST_COLOR                      0x0306
+#define GL_ONE_MINUS_DST_COLOR            0x0307
+#define GL_SRC_ALPHA_SATURATE             0x0308
+
+#define GL_FRONT                          0x0404
+#define GL_BACK                           0x0405
+#define GL_FRONT_AND_BACK                 0x0408
+
+#define GL_INVALID_ENUM                   0x0500
+#define GL_INVALID_VALUE                  0x0501
+#define GL_INVALID_OPERATION              0x0502
+#define GL_STACK_OVERFLOW                 0x0503
+#define GL_STACK_UNDERFLOW                0x0504
+#define GL_OUT_OF_MEMORY                  0x0505
+#define GL_INVALID_FRAMEBUFFER_OPERATION  0x0506
+
+#define GL_CULL_FACE                      0x0B44
+#define GL_DEPTH_TEST                     0x0B71
+#define GL_BLEND                          0x0BE2
+#define GL_UNPACK_ALIGNMENT               0x0CF5
+#define GL_TEXTURE_2D                     0x0DE1
+
+#define GL_UNSIGNED_BYTE                  0x1401
+#define GL_UNSIGNED_SHORT                 0x1403
+#define GL_FLOAT                          0x1406
+
+#define GL_STENCIL_INDEX                  0x1901
+#define GL_DEPTH_COMPONENT                0x1902
+#define GL_ALPHA                          0x1906
+#define GL_RGB                            0x1907
+#define GL_RGBA                           0x1908
+#define GL_RGBA4                          0x8056
+#define GL_RGB565                         0x8D62
+#define GL_DEPTH_COMPONENT16              0x81A5
+#define GL_STENCIL_INDEX8                 0x8D48
+
+#define GL_VENDOR                         0x1F00
+#define GL_RENDERER                       0x1F01
+#define GL_VERSION                        0x1F02
+#define GL_EXTENSIONS                     0x1F03
+#define GL_SHADING_LANGUAGE_VERSION       0x8B8C
+
+#define GL_NEAREST                        0x2600
+#define GL_LINEAR                         0x2601
+#define GL_NEAREST_MIPMAP_NEAREST         0x2700
+#define GL_LINEAR_MIPMAP_NEAREST          0x2701
+#define GL_NEAREST_MIPMAP_LINEAR          0x2702
+#define GL_LINEAR_MIPMAP_LINEAR           0x2703
+#define GL_TEXTURE_MAG_FILTER             0x2800
+#define GL_TEXTURE_MIN_FILTER             0x2801
+#define GL_TEXTURE_WRAP_S                 0x2802
+#define GL_TEXTURE_WRAP_T                 0x2803
+#define GL_REPEAT                         0x2901
+#define GL_CLAMP_TO_EDGE                  0x812F
+#define GL_TEXTURE0                       0x84C0
+
+#define GL_DEPTH_BUFFER_BIT               0x00000100
+#define GL_COLOR_BUFFER_BIT               0x00004000
+
+#define GL_ARRAY_BUFFER                   0x8892
+#define GL_ELEMENT_ARRAY_BUFFER           0x8893
+#define GL_STREAM_DRAW                    0x88E0
+#define GL_STATIC_DRAW                    0x88E4
+#define GL_DYNAMIC_DRAW                   0x88E8
+
+#define GL_FRAGMENT_SHADER                0x8B30
+#define GL_VERTEX_SHADER                  0x8B31
+#define GL_COMPILE_STATUS                 0x8B81
+#define GL_LINK_STATUS                    0x8B82
+#define GL_INFO_LOG_LENGTH                0x8B84
+#define GL_ACTIVE_UNIFORMS                0x8B86
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH      0x8B87
+#define GL_ACTIVE_ATTRIBUTES              0x8B89
+#define GL_ACTIVE_ATTRIBUTE_MAX_LENGTH    0x8B8A
+
+#define GL_COLOR_ATTACHMENT0              0x8CE0
+#define GL_DEPTH_ATTACHMENT               0x8D00
+#define GL_STENCIL_ATTACHMENT             0x8D20
+#define GL_FRAMEBUFFER                    0x8D40
+#define GL_RENDERBUFFER                   0x8D41
+
+/**
+ * Counters for everything recorded by the null OpenGL implementation since
+ * they were last reset.
+ */
+struct NullGLStats
+{
+	/**
+	 * The number of glDrawArrays / glDrawElements calls.
+	 */
+	uint numDrawCalls;
+
+	/**
+	 * The number of triangles drawn by all GL_TRIANGLES draw calls.
+	 */
+	uint numTriangles;
+
+	/**
+	 * The number of calls which change render state (capabilities, blend,
+	 * depth and cull functions, and object bindings).
+	 */
+	uint numStateChanges;
+
+	/**
+	 * The total number of bytes passed to glBufferData / glBufferSubData.
+	 */
+	size_t bufferBytesUploaded;
+
+	/**
+	 * The total number of bytes passed to glTexImage2D / glTexSubImage2D.
+	 */
+	size_t textureBytesUploaded;
+
+	NullGLStats()
+	{
+		Reset();
+	}
+
+	/**
+	 * Sets all counters back to zero.
+	 */
+	void Reset()
+	{
+		numDrawCalls = 0;
+		numTriangles = 0;
+		numStateChanges = 0;
+		bufferBytesUploaded = 0;
+		textureBytesUploaded = 0;
+	}
+};
+
+/**
+ * @return the counters recorded by the null OpenGL implementation
+ */
+const NullGLStats& GetNullGLStats();
+
+/**
+ * Sets the counters recorded by the null OpenGL implementation back to zero.
+ */
+void ResetNullGLStats();
+
+void glActiveTexture(GLenum texture);
+void glAttachShader(GLuint program, GLuint shader);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBindFramebuffer(GLenum target, GLuint framebuffer);
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void glBindTexture(GLenum target, GLuint texture);
+void glBlendFunc(GLenum sfactor, GLenum dfactor);
+void glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data);
+void glClear(GLbitfield mask);
+void glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+void glCompileShader(GLuint shader);
+GLuint glCreateProgram();
+GLuint glCreateShader(GLenum type);
+void glCullFace(GLenum mode);
+void glDeleteBuffers(GLsizei n, const GLuint *buffers);
+void glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+void glDeleteProgram(GLuint program);
+void glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers);
+void glDeleteShader(GLuint shader);
+void glDeleteTextures(GLsizei n, const GLuint *textures);
+void glDepthFunc(GLenum func);
+void glDisable(GLenum cap);
+void glDisableVertexAttribArray(GLuint index);
+void glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glDrawArraysInstancedARB(GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices);
+void glDrawElementsInstancedARB(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei primcount);
+void glEnable(GLenum cap);
+void glEnableVertexAttribArray(GLuint index);
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+void glGenBuffers(GLsizei n, GLuint *buffers);
+void glGenFramebuffers(GLsizei n, GLuint *framebuffers);
+void glGenRenderbuffers(GLsizei n, GLuint *renderbuffers);
+void glGenTextures(GLsizei n, GLuint *textures);
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name);
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name);
+GLint glGetAttribLocation(GLuint program, const GLchar *name);
+GLenum glGetError();
+void glGetIntegerv(GLenum pname, GLint *params);
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void glGetProgramiv(GLuint program, GLenum pname, GLint *params);
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint *params);
+const GLubyte* glGetString(GLenum name);
+GLint glGetUniformLocation(GLuint program, const GLchar *name);
+void glLineWidth(GLfloat width);
+void glLinkProgram(GLuint program);
+void glPixelStorei(GLenum pname, GLint param);
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+void glShaderSource(GLuint shader, GLsizei count, const GLchar **strings, const GLint *lengths);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels);
+void glUniform1f(GLint location, GLfloat x);
+void glUniform1fv(GLint location, GLsizei count, const GLfloat *v);
+void glUniform1i(GLint location, GLint x);
+void glUniform2f(GLint location, GLfloat x, GLfloat y);
+void glUniform2fv(GLint location, GLsizei count, const GLfloat *v);
+void glUniform2i(GLint location, GLint x, GLint y);
+void glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z);
+void glUniform3fv(GLint location, GLsizei count, const GLfloat *v);
+void glUniform3i(GLint location, GLint x, GLint y, GLint z);
+void glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+void glUniform4fv(GLint location, GLsizei count, const GLfloat *v);
+void glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w);
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+void glUseProgram(GLuint program);
+void glVertexAttribDivisorARB(GLuint index, GLuint divisor);
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+#endif
+#endif
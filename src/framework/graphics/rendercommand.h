@@ -0,0 +1,90 @@
+#ifndef __FRAMEWORK_GRAPHICS_RENDERCOMMAND_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_RENDERCOMMAND_H_INCLUDED__
+
+#include "../common.h"
+
+class BlendState;
+class IndexBuffer;
+class RenderState;
+class StandardShader;
+class Texture;
+class VertexBuffer;
+
+/**
+ * Type of primitive drawn by a render command.
+ */
+enum RENDER_COMMAND_PRIMITIVE
+{
+	RENDER_COMMAND_TRIANGLES,
+	RENDER_COMMAND_LINES,
+	RENDER_COMMAND_POINTS
+};
+
+const uint RENDER_COMMAND_NO_TRANSFORM = (uint)-1;
+
+/**
+ * A single draw call to be submitted to a RenderCommandQueue. None of the
+ * objects referred to are owned by the command and must remain valid until
+ * the queue is executed.
+ */
+struct RenderCommand
+{
+	/**
+	 * Key that commands are ordered by before execution. Filled in by the
+	 * queue when the command is submitted.
+	 */
+	uint64_t sortKey;
+
+	/**
+	 * The pass (0 to RENDER_COMMAND_MAX_PASSES - 1) to draw this command in.
+	 * All commands in lower passes are drawn before any in higher passes.
+	 */
+	uint pass;
+
+	/**
+	 * Distance of the object being drawn from the camera, normalized to
+	 * 0.0 (near) to 1.0 (far).
+	 */
+	float depth;
+
+	StandardShader *shader;
+	const Texture *texture;
+	const RenderState *renderState;
+	const BlendState *blendState;
+	VertexBuffer *vertexBuffer;
+	IndexBuffer *indexBuffer;
+
+	/**
+	 * What is drawn, passed as-is to the matching GraphicsDevice render
+	 * method (e.g. RenderTriangles()). A count of 0 draws the entire buffer.
+	 */
+	RENDER_COMMAND_PRIMITIVE primitive;
+	uint start;
+	uint count;
+
+	/**
+	 * Index of the modelview matrix in the queue to set for this command, or
+	 * RENDER_COMMAND_NO_TRANSFORM to use the view context's current one.
+	 * Filled in by the queue when the command is submitted.
+	 */
+	uint transformIndex;
+
+	RenderCommand()
+	{
+		sortKey = 0;
+		pass = 0;
+		depth = 0.0f;
+		shader = NULL;
+		texture = NULL;
+		renderState = NULL;
+		blendState = NULL;
+		vertexBuffer = NULL;
+		indexBuffer = NULL;
+		primitive = RENDER_COMMAND_TRIANGLES;
+		start = 0;
+		count = 0;
+		transformIndex = RENDER_COMMAND_NO_TRANSFORM;
+	}
+};
+
+#endif
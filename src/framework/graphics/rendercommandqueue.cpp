@@ -0,0 +1,292 @@
+#include "../debug.h"
+
+#include "rendercommandqueue.h"
+
+#include "blendstate.h"
+#include "graphicsdevice.h"
+#include "indexbuffer.h"
+#include "renderstate.h"
+#include "standardshader.h"
+#include "texture.h"
+#include "vertexbuffer.h"
+#include "viewcontext.h"
+#include <string.h>
+
+const uint SORTKEY_PASS_BITS = 4;
+const uint SORTKEY_SHADER_BITS = 10;
+const uint SORTKEY_TEXTURE_BITS = 12;
+const uint SORTKEY_STATES_BITS = 10;
+const uint SORTKEY_DEPTH_BITS = 24;
+
+// the render/blend state ids share the "states" bits equally
+const uint SORTKEY_STATE_OBJECT_BITS = SORTKEY_STATES_BITS / 2;
+const uint MAX_STATE_OBJECT_ID = (1 << SORTKEY_STATE_OBJECT_BITS) - 1;
+
+RenderCommandQueue::RenderCommandQueue()
+{
+	m_isSorted = true;
+	m_numShaderChanges = 0;
+	m_numTextureChanges = 0;
+}
+
+RenderCommandQueue::~RenderCommandQueue()
+{
+}
+
+uint64_t RenderCommandQueue::MakeSortKey(uint pass, bool translucent, uint shaderId, uint textureId, uint statesId, float depth)
+{
+	uint64_t passBits = (uint64_t)(pass & ((1 << SORTKEY_PASS_BITS) - 1));
+	uint64_t shaderBits = (uint64_t)(shaderId & ((1 << SORTKEY_SHADER_BITS) - 1));
+	uint64_t textureBits = (uint64_t)(textureId & ((1 << SORTKEY_TEXTURE_BITS) - 1));
+	uint64_t statesBits = (uint64_t)(statesId & ((1 << SORTKEY_STATES_BITS) - 1));
+
+	const uint maxDepth = (1 << SORTKEY_DEPTH_BITS) - 1;
+	if (depth < 0.0f)
+		depth = 0.0f;
+	if (depth > 1.0f)
+		depth = 1.0f;
+	uint64_t depthBits = (uint64_t)(depth * (float)maxDepth);
+
+	uint64_t key = passBits << 60;
+	if (translucent)
+	{
+		// back-to-front, so further away needs to sort first
+		key |= (uint64_t)1 << 59;
+		key |= ((uint64_t)maxDepth - depthBits) << 35;
+		key |= shaderBits << 25;
+		key |= textureBits << 13;
+		key |= statesBits << 3;
+	}
+	else
+	{
+		key |= shaderBits << 49;
+		key |= textureBits << 37;
+		key |= statesBits << 27;
+		key |= depthBits << 3;
+	}
+
+	return key;
+}
+
+void RenderCommandQueue::Submit(const RenderCommand &command, const Matrix4x4 *modelView)
+{
+	ASSERT(command.shader != NULL);
+	ASSERT(command.vertexBuffer != NULL);
+	ASSERT(command.pass < RENDER_COMMAND_MAX_PASSES);
+
+	RenderCommand queued = command;
+
+	if (modelView != NULL)
+	{
+		queued.transformIndex = m_transforms.size();
+		m_transforms.push_back(*modelView);
+	}
+	else
+		queued.transformIndex = RENDER_COMMAND_NO_TRANSFORM;
+
+	// OpenGL object names are small sequential integers with most drivers,
+	// so they make reasonable ids here even after being truncated
+	uint shaderId = queued.shader->GetProgramId();
+	uint textureId = (queued.texture != NULL ? queued.texture->GetTextureName() : 0);
+	uint renderStateId = GetStateObjectId(m_renderStates, queued.renderState);
+	uint blendStateId = GetStateObjectId(m_blendStates, queued.blendState);
+	uint statesId = (renderStateId << SORTKEY_STATE_OBJECT_BITS) | blendStateId;
+
+	bool translucent = (queued.blendState != NULL && queued.blendState->GetBlending());
+
+	queued.sortKey = MakeSortKey(queued.pass, translucent, shaderId, textureId, statesId, queued.depth);
+
+	m_commands.push_back(queued);
+	m_isSorted = false;
+}
+
+void RenderCommandQueue::Sort()
+{
+	if (m_isSorted)
+		return;
+
+	m_sortEntries.resize(m_commands.size());
+	for (uint i = 0; i < m_commands.size(); ++i)
+	{
+		m_sortEntries[i].key = m_commands[i].sortKey;
+		m_sortEntries[i].index = i;
+	}
+
+	RadixSort();
+	m_isSorted = true;
+}
+
+void RenderCommandQueue::RadixSort()
+{
+	uint numEntries = m_sortEntries.size();
+	if (numEntries < 2)
+		return;
+
+	m_sortScratch.resize(numEntries);
+	SortEntry *source = &m_sortEntries[0];
+	SortEntry *dest = &m_sortScratch[0];
+
+	// LSD radix sort, one byte of the key at a time. this is stable so each
+	// pass keeps the ordering established by the less significant bytes
+	for (uint shift = 0; shift < 64; shift += 8)
+	{
+		uint counts[256];
+		memset(counts, 0, sizeof(uint) * 256);
+
+		for (uint i = 0; i < numEntries; ++i)
+			++counts[(source[i].key >> shift) & 0xff];
+
+		// all keys have the same value for this byte (quite common as only
+		// a few passes / shaders tend to be used), nothing to reorder
+		if (counts[(source[0].key >> shift) & 0xff] == numEntries)
+			continue;
+
+		uint offset = 0;
+		for (uint i = 0; i < 256; ++i)
+		{
+			uint count = counts[i];
+			counts[i] = offset;
+			offset += count;
+		}
+
+		for (uint i = 0; i < numEntries; ++i)
+		{
+			uint bucket = (uint)((source[i].key >> shift) & 0xff);
+			dest[counts[bucket]++] = source[i];
+		}
+
+		SortEntry *temp = source;
+		source = dest;
+		dest = temp;
+	}
+
+	// the sorted result may have ended up in the scratch buffer
+	if (source != &m_sortEntries[0])
+		memcpy(&m_sortEntries[0], source, sizeof(SortEntry) * numEntries);
+}
+
+void RenderCommandQueue::Execute(GraphicsDevice *graphicsDevice)
+{
+	ASSERT(graphicsDevice != NULL);
+
+	m_numShaderChanges = 0;
+	m_numTextureChanges = 0;
+
+	if (m_commands.empty())
+		return;
+
+	Sort();
+
+	StandardShader *currentShader = NULL;
+	const Texture *currentTexture = NULL;
+	IndexBuffer *currentIndexBuffer = NULL;
+
+	// start from a known state, otherwise an index buffer left bound by
+	// whatever rendered before us would be used by non-indexed commands
+	graphicsDevice->UnbindIndexBuffer();
+
+	for (uint i = 0; i < m_sortEntries.size(); ++i)
+	{
+		const RenderCommand &command = m_commands[m_sortEntries[i].index];
+
+		if (command.shader != currentShader)
+		{
+			if (currentShader != NULL)
+				graphicsDevice->UnbindShader();
+			graphicsDevice->BindShader(command.shader);
+			currentShader = command.shader;
+			currentShader->SetProjectionMatrix(graphicsDevice->GetViewContext()->GetProjectionMatrix());
+			++m_numShaderChanges;
+		}
+
+		if (command.transformIndex != RENDER_COMMAND_NO_TRANSFORM)
+			currentShader->SetModelViewMatrix(m_transforms[command.transformIndex]);
+		else
+			currentShader->SetModelViewMatrix(graphicsDevice->GetViewContext()->GetModelViewMatrix());
+
+		if (command.renderState != NULL)
+			command.renderState->Apply(graphicsDevice);
+		if (command.blendState != NULL)
+			command.blendState->Apply(graphicsDevice);
+
+		if (command.texture != NULL && command.texture != currentTexture)
+		{
+			graphicsDevice->BindTexture(command.texture);
+			currentTexture = command.texture;
+			++m_numTextureChanges;
+		}
+
+		graphicsDevice->BindVertexBuffer(command.vertexBuffer);
+
+		if (command.indexBuffer != currentIndexBuffer)
+		{
+			if (command.indexBuffer != NULL)
+				graphicsDevice->BindIndexBuffer(command.indexBuffer);
+			else
+				graphicsDevice->UnbindIndexBuffer();
+			currentIndexBuffer = command.indexBuffer;
+		}
+
+		// a count of zero means draw everything in the bound buffer
+		switch (command.primitive)
+		{
+		case RENDER_COMMAND_LINES:
+			if (command.count == 0)
+				graphicsDevice->RenderLines();
+			else
+				graphicsDevice->RenderLines(command.start, command.count);
+			break;
+		case RENDER_COMMAND_POINTS:
+			if (command.count == 0)
+				graphicsDevice->RenderPoints();
+			else
+				graphicsDevice->RenderPoints(command.start, command.count);
+			break;
+		default:
+			if (command.count == 0)
+				graphicsDevice->RenderTriangles();
+			else
+				graphicsDevice->RenderTriangles(command.start, command.count);
+			break;
+		}
+	}
+
+	if (currentIndexBuffer != NULL)
+		graphicsDevice->UnbindIndexBuffer();
+	graphicsDevice->UnbindVertexBuffer();
+	graphicsDevice->UnbindShader();
+}
+
+void RenderCommandQueue::Clear()
+{
+	m_commands.clear();
+	m_transforms.clear();
+	m_sortEntries.clear();
+	m_renderStates.clear();
+	m_blendStates.clear();
+	m_isSorted = true;
+}
+
+const RenderCommand& RenderCommandQueue::GetSortedCommand(uint index) const
+{
+	ASSERT(m_isSorted == true);
+	ASSERT(index < m_sortEntries.size());
+	return m_commands[m_sortEntries[index].index];
+}
+
+uint RenderCommandQueue::GetStateObjectId(StateObjectList &list, const void *state)
+{
+	if (state == NULL)
+		return 0;
+
+	// typically only a handful of distinct state objects are used per frame,
+	// so a linear search is fine. id 0 is reserved for "none"
+	for (uint i = 0; i < list.size(); ++i)
+	{
+		if (list[i] == state)
+			return Min(i + 1, MAX_STATE_OBJECT_ID);
+	}
+
+	list.push_back(state);
+	return Min((uint)list.size(), MAX_STATE_OBJECT_ID);
+}
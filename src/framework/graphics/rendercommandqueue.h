@@ -0,0 +1,134 @@
+#ifndef __FRAMEWORK_GRAPHICS_RENDERCOMMANDQUEUE_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_RENDERCOMMANDQUEUE_H_INCLUDED__
+
+#include "../common.h"
+#include "rendercommand.h"
+#include "../math/matrix4x4.h"
+#include <stl/vector.h>
+
+class GraphicsDevice;
+
+const uint RENDER_COMMAND_MAX_PASSES = 16;
+
+/**
+ * Collects draw calls from any number of renderers over the course of a
+ * frame and then draws them all at once, ordered to minimize the amount of
+ * state changes required between them.
+ *
+ * Each command is given a 64-bit sort key, laid out from most to least
+ * significant as:
+ *
+ *   opaque:       pass (4) | 0 (1) | shader (10) | texture (12) | states (10) | depth (24) | unused (3)
+ *   translucent:  pass (4) | 1 (1) | inverted depth (24) | shader (10) | texture (12) | states (10) | unused (3)
+ *
+ * So within a pass, opaque commands are drawn first grouped by shader and
+ * then texture (and front-to-back within each group), followed by
+ * translucent commands drawn back-to-front.
+ */
+class RenderCommandQueue
+{
+public:
+	RenderCommandQueue();
+	virtual ~RenderCommandQueue();
+
+	/**
+	 * Adds a command to the queue.
+	 * @param command the command to add. It's sortKey and transformIndex
+	 *                are set by the queue.
+	 * @param modelView the modelview matrix to set before drawing the command,
+	 *                  or NULL to use the view context's current modelview
+	 *                  matrix at the time Execute() is called. This is
+	 *                  copied so it does not need to remain valid.
+	 */
+	void Submit(const RenderCommand &command, const Matrix4x4 *modelView = NULL);
+
+	/**
+	 * Orders all submitted commands by their sort key. This is done
+	 * automatically by Execute() if needed.
+	 */
+	void Sort();
+
+	/**
+	 * Draws all submitted commands in sorted order. No shader should be
+	 * bound when this is called. Each shader is given the view context's
+	 * current projection matrix when it is bound. Afterwards, the shader, vertex buffer and
+	 * index buffer are left unbound. The queue is not cleared.
+	 * @param graphicsDevice the graphics device to draw with
+	 */
+	void Execute(GraphicsDevice *graphicsDevice);
+
+	/**
+	 * Removes all submitted commands.
+	 */
+	void Clear();
+
+	/**
+	 * @return the number of submitted commands
+	 */
+	uint GetNumCommands() const                            { return m_commands.size(); }
+
+	/**
+	 * @return true if the commands have been sorted since the last one was
+	 *         submitted
+	 */
+	bool IsSorted() const                                  { return m_isSorted; }
+
+	/**
+	 * Returns a submitted command in sorted order. Sort() must have been
+	 * called first.
+	 * @param index the position of the command in the sorted order
+	 * @return the command
+	 */
+	const RenderCommand& GetSortedCommand(uint index) const;
+
+	/**
+	 * @return the number of shader changes made during the last Execute()
+	 */
+	uint GetNumShaderChanges() const                       { return m_numShaderChanges; }
+
+	/**
+	 * @return the number of texture changes made during the last Execute()
+	 */
+	uint GetNumTextureChanges() const                      { return m_numTextureChanges; }
+
+	/**
+	 * Builds a sort key from it's individual components. Values larger than
+	 * the number of bits available for them are truncated.
+	 * @param pass the pass the command is drawn in
+	 * @param translucent true if the command is drawn with blending enabled
+	 * @param shaderId identifies the shader used
+	 * @param textureId identifies the texture used
+	 * @param statesId identifies the combination of render and blend states
+	 * @param depth normalized depth, 0.0 (near) to 1.0 (far)
+	 * @return the sort key
+	 */
+	static uint64_t MakeSortKey(uint pass, bool translucent, uint shaderId, uint textureId, uint statesId, float depth);
+
+private:
+	struct SortEntry
+	{
+		uint64_t key;
+		uint index;
+	};
+
+	typedef stl::vector<RenderCommand> RenderCommandList;
+	typedef stl::vector<SortEntry> SortEntryList;
+	typedef stl::vector<Matrix4x4> TransformList;
+	typedef stl::vector<const void*> StateObjectList;
+
+	uint GetStateObjectId(StateObjectList &list, const void *state);
+	void RadixSort();
+
+	RenderCommandList m_commands;
+	TransformList m_transforms;
+	SortEntryList m_sortEntries;
+	SortEntryList m_sortScratch;
+	StateObjectList m_renderStates;
+	StateObjectList m_blendStates;
+	bool m_isSorted;
+
+	uint m_numShaderChanges;
+	uint m_numTextureChanges;
+};
+
+#endif
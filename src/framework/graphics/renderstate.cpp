@@ -1,5 +1,9 @@
+#include "../debug.h"
+
 #include "renderstate.h"
 
+#include "graphicsdevice.h"
+
 #include "glincludes.h"
 #include "glutils.h"
 
@@ -21,43 +25,82 @@ void RenderState::Initialize()
 	m_lineWidth = 1.0f;
 }
 
-void RenderState::Apply() const
+void RenderState::Apply(GraphicsDevice *graphicsDevice) const
 {
-	if (m_depthTesting)
+	ASSERT(graphicsDevice != NULL);
+
+	// NULL if the state of the OpenGL context is not known (e.g. a new
+	// context), in which case everything gets set
+	const RenderState *current = graphicsDevice->GetAppliedRenderState();
+	RenderState applied = *this;
+	uint numIssued = 0;
+	uint numSkipped = 0;
+
+	if (current == NULL || current->m_depthTesting != m_depthTesting)
+	{
+		if (m_depthTesting)
+			GL_CALL(glEnable(GL_DEPTH_TEST));
+		else
+			GL_CALL(glDisable(GL_DEPTH_TEST));
+		++numIssued;
+	}
+	else
+		++numSkipped;
+
+	if (current == NULL || (m_depthTesting && current->m_depthFunction != m_depthFunction))
 	{
-		GL_CALL(glEnable(GL_DEPTH_TEST));
 		GL_CALL(glDepthFunc(FindDepthFunctionValue(m_depthFunction)));
+		++numIssued;
 	}
+	else if (m_depthTesting)
+		++numSkipped;
 	else
+		applied.m_depthFunction = current->m_depthFunction;
+
+	if (current == NULL || current->m_faceCulling != m_faceCulling)
 	{
-		GL_CALL(glDisable(GL_DEPTH_TEST));
+		if (m_faceCulling)
+			GL_CALL(glEnable(GL_CULL_FACE));
+		else
+			GL_CALL(glDisable(GL_CULL_FACE));
+		++numIssued;
 	}
+	else
+		++numSkipped;
 
-	SetFaceCulling();
+	if (current == NULL || (m_faceCulling && current->m_faceCullingMode != m_faceCullingMode))
+	{
+		GL_CALL(glCullFace(FindCullModeValue(m_faceCullingMode)));
+		++numIssued;
+	}
+	else if (m_faceCulling)
+		++numSkipped;
+	else
+		applied.m_faceCullingMode = current->m_faceCullingMode;
 
-	GL_CALL(glLineWidth(m_lineWidth));
+	if (current == NULL || current->m_lineWidth != m_lineWidth)
+	{
+		GL_CALL(glLineWidth(m_lineWidth));
+		++numIssued;
+	}
+	else
+		++numSkipped;
+
+	graphicsDevice->SetAppliedRenderState(applied);
+
+	GraphicsDeviceStats *stats = graphicsDevice->GetFrameStats();
+	stats->numStateCallsIssued += numIssued;
+	stats->numStateCallsSkipped += numSkipped;
 }
 
-void RenderState::SetFaceCulling() const
+int RenderState::FindCullModeValue(CULL_MODE mode) const
 {
-	if (m_faceCulling)
+	switch (mode)
 	{
-		GL_CALL(glEnable(GL_CULL_FACE));
-		switch (m_faceCullingMode)
-		{
-		case FRONT_AND_BACK:
-			GL_CALL(glCullFace(GL_FRONT_AND_BACK));
-			break;
-		case FRONT:
-			GL_CALL(glCullFace(GL_FRONT));
-			break;
-		default:
-			GL_CALL(glCullFace(GL_BACK));
-			break;
-		}
+	case FRONT_AND_BACK: return GL_FRONT_AND_BACK;
+	case FRONT: return GL_FRONT;
+	default: return GL_BACK;
 	}
-	else
-		GL_CALL(glDisable(GL_CULL_FACE));
 }
 
 int RenderState::FindDepthFunctionValue(DEPTH_FUNCTION function) const
@@ -3,6 +3,8 @@
 
 #include "../common.h"
 
+class GraphicsDevice;
+
 enum CULL_MODE
 {
 	BACK,
@@ -38,9 +40,12 @@ public:
 	virtual ~RenderState();
 
 	/**
-	 * Applies render states to the current OpenGL context.
+	 * Applies render states to the current OpenGL context. Only the states
+	 * that differ from those last applied through the graphics device are
+	 * actually set.
+	 * @param graphicsDevice the graphics device tracking the current state
 	 */
-	void Apply() const;
+	void Apply(GraphicsDevice *graphicsDevice) const;
 
 	/**
 	 * @return true if depth testing is enabled
@@ -94,7 +99,7 @@ public:
 
 private:
 	void Initialize();
-	void SetFaceCulling() const;
+	int FindCullModeValue(CULL_MODE mode) const;
 	int FindDepthFunctionValue(DEPTH_FUNCTION function) const;
 
 	bool m_depthTesting;
@@ -5,6 +5,8 @@
 #include "color.h"
 #include "glincludes.h"
 #include "glutils.h"
+#include "graphicsdevice.h"
+#include "shaderprogramcache.h"
 #include "../math/matrix3x3.h"
 #include "../math/matrix4x4.h"
 #include "../math/point2.h"
@@ -130,8 +132,10 @@ void Shader::Release()
 	m_numAttributes = 0;
 	
 	m_uniforms.clear();
+	m_uniformHandles.clear();
 	m_attributes.clear();
 	m_cachedUniforms.clear();
+	m_pendingUniforms.clear();
 	
 	GraphicsContextResource::Release();
 }
@@ -151,11 +155,28 @@ bool Shader::LoadCompileAndLink(const char *vertexShaderSource, const char *frag
 	ASSERT(vertexShaderToLoad != NULL);
 	ASSERT(fragmentShaderToLoad != NULL);
 
-	if (!Compile(vertexShaderToLoad, fragmentShaderToLoad))
-		return false;
+	ShaderProgramCache *programCache = GetGraphicsDevice()->GetShaderProgramCache();
+	if (programCache != NULL)
+		m_programId = programCache->Load(vertexShaderToLoad, fragmentShaderToLoad);
 
-	if (!Link())
-		return false;
+	if (m_programId != 0)
+	{
+		// no separate vertex/fragment shader objects when loaded from a binary
+		m_vertexShaderCompileStatus = GL_TRUE;
+		m_fragmentShaderCompileStatus = GL_TRUE;
+		m_linkStatus = GL_TRUE;
+	}
+	else
+	{
+		if (!Compile(vertexShaderToLoad, fragmentShaderToLoad))
+			return false;
+
+		if (!Link())
+			return false;
+
+		if (programCache != NULL)
+			programCache->Save(m_programId, vertexShaderToLoad, fragmentShaderToLoad);
+	}
 
 	LoadUniformInfo();
 	LoadAttributeInfo();
@@ -173,9 +194,8 @@ bool Shader::ReloadCompileAndLink(const char *vertexShaderSource, const char *fr
 	m_vertexShaderId = 0;
 	m_fragmentShaderId = 0;
 	m_programId = 0;
-	m_uniforms.clear();
 	m_attributes.clear();
-	m_cachedUniforms.clear();
+	ClearCachedUniforms();
 
 	// TODO: leaving the attribute type mappings intact. This could maybe be a problem?
 	//       I think only if the attribute ID's can be assigned randomly by OpenGL even if
@@ -309,6 +329,10 @@ bool Shader::Link()
 	GL_CALL(glAttachShader(m_programId, m_vertexShaderId));
 	GL_CALL(glAttachShader(m_programId, m_fragmentShaderId));
 
+	ShaderProgramCache *programCache = GetGraphicsDevice()->GetShaderProgramCache();
+	if (programCache != NULL)
+		programCache->PrepareForLink(m_programId);
+
 	GL_CALL(glLinkProgram(m_programId));
 	GL_CALL(glGetProgramiv(m_programId, GL_LINK_STATUS, &m_linkStatus));
 
@@ -336,7 +360,8 @@ void Shader::LoadUniformInfo()
 {
 	ASSERT(m_programId != 0);
 
-	m_uniforms.clear();
+	// NOTE: existing uniforms are not cleared out first so that any handles
+	//       given out before the shader was reloaded remain valid
 
 	GLint numUniforms = 0;
 	GL_CALL(glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &numUniforms));
@@ -377,10 +402,22 @@ void Shader::LoadUniformInfo()
 		if (arraySubscriptPos != stl::string::npos)
 			name = name.substr(0, arraySubscriptPos);
 
-		m_uniforms[name] = uniform;
+		ShaderUniformHandleMap::iterator existing = m_uniformHandles.find(name);
+		if (existing != m_uniformHandles.end())
+			m_uniforms[existing->second] = uniform;
+		else
+		{
+			m_uniformHandles[name] = (ShaderUniformHandle)m_uniforms.size();
+			m_uniforms.push_back(uniform);
+		}
 	}
 
 	SAFE_DELETE_ARRAY(uniformName);
+
+	// one pending value slot per uniform. sized up front so that caching
+	// values while the shader is not bound never needs to allocate
+	m_cachedUniforms.resize(m_uniforms.size());
+	m_pendingUniforms.reserve(m_uniforms.size());
 }
 
 void Shader::LoadAttributeInfo()
@@ -445,29 +482,38 @@ void Shader::LoadAttributeInfo()
 
 bool Shader::HasUniform(const stl::string &name) const
 {
-	ShaderUniformMap::const_iterator i = m_uniforms.find(name);
-	if (i == m_uniforms.end())
+	ShaderUniformHandleMap::const_iterator i = m_uniformHandles.find(name);
+	if (i == m_uniformHandles.end())
 		return false;
 	else
 		return true;
 }
 
+ShaderUniformHandle Shader::GetUniformHandle(const stl::string &name) const
+{
+	ShaderUniformHandleMap::const_iterator i = m_uniformHandles.find(name);
+	if (i == m_uniformHandles.end())
+		return INVALID_SHADER_UNIFORM_HANDLE;
+	else
+		return i->second;
+}
+
 const ShaderUniform* Shader::GetUniform(const stl::string &name) const
 {
-	ShaderUniformMap::const_iterator i = m_uniforms.find(name);
-	if (i == m_uniforms.end())
+	ShaderUniformHandle handle = GetUniformHandle(name);
+	if (handle == INVALID_SHADER_UNIFORM_HANDLE)
 		return NULL;
 	else
-		return &i->second;
+		return &m_uniforms[handle];
 }
 
 ShaderUniform* Shader::GetUniform(const stl::string &name)
 {
-	ShaderUniformMap::iterator i = m_uniforms.find(name);
-	if (i == m_uniforms.end())
+	ShaderUniformHandle handle = GetUniformHandle(name);
+	if (handle == INVALID_SHADER_UNIFORM_HANDLE)
 		return NULL;
 	else
-		return &i->second;
+		return &m_uniforms[handle];
 }
 
 bool Shader::HasAttribute(const stl::string &name) const
@@ -497,395 +543,499 @@ ShaderAttribute* Shader::GetAttribute(const stl::string &name)
 		return &i->second;
 }
 
-void Shader::CacheUniform(const stl::string &name, CachedShaderUniform uniform)
+const ShaderUniform* Shader::GetUniform(ShaderUniformHandle handle) const
 {
-	m_cachedUniforms[name] = uniform;
+	ASSERT(handle >= 0 && handle < (ShaderUniformHandle)m_uniforms.size());
+	return &m_uniforms[handle];
 }
 
-CachedShaderUniform* Shader::GetCachedUniform(const stl::string &name)
+CachedShaderUniform* Shader::GetCachedUniform(ShaderUniformHandle handle)
 {
-	CachedShaderUniformMap::iterator i = m_cachedUniforms.find(name);
-	if (i == m_cachedUniforms.end())
-	{
-		m_cachedUniforms[name] = CachedShaderUniform();
-		i = m_cachedUniforms.find(name);
-	}
+	ASSERT(handle >= 0 && handle < (ShaderUniformHandle)m_cachedUniforms.size());
+	CachedShaderUniform *uniform = &m_cachedUniforms[handle];
+
+	// only need to remember the handle the first time a value is cached
+	// for it, otherwise we'd just be overwriting a value that is pending
+	if (uniform->type == CACHED_UNIFORM_NONE)
+		m_pendingUniforms.push_back(handle);
 
-	return &i->second;
+	return uniform;
 }
 
 void Shader::FlushCachedUniforms()
 {
 	ASSERT(m_isBound == true);
-	if (m_cachedUniforms.empty())
+	if (m_pendingUniforms.empty())
 		return;
 
-	for (CachedShaderUniformMap::iterator i = m_cachedUniforms.begin(); i != m_cachedUniforms.end(); ++i)
+	for (ShaderUniformHandleList::iterator i = m_pendingUniforms.begin(); i != m_pendingUniforms.end(); ++i)
 	{
-		const stl::string &name = i->first;
-		CachedShaderUniform &uniform = i->second;
+		ShaderUniformHandle handle = *i;
+		CachedShaderUniform &uniform = m_cachedUniforms[handle];
 
 		switch (uniform.type)
 		{
-		case CACHED_UNIFORM_1F:   SetUniform(name, uniform.f1.x); break;
-		case CACHED_UNIFORM_1I:   SetUniform(name, uniform.i1.x); break;
-		case CACHED_UNIFORM_2F:   SetUniform(name, uniform.f2.x, uniform.f2.y); break;
-		case CACHED_UNIFORM_2I:   SetUniform(name, uniform.i2.x, uniform.i2.y); break;
-		case CACHED_UNIFORM_3F:   SetUniform(name, uniform.f3.x, uniform.f3.y, uniform.f3.z); break;
-		case CACHED_UNIFORM_3I:   SetUniform(name, uniform.i3.x, uniform.i3.y, uniform.i3.z); break;
-		case CACHED_UNIFORM_4F:   SetUniform(name, uniform.f4.x, uniform.f4.y, uniform.f4.z, uniform.f4.w); break;
-		case CACHED_UNIFORM_4I:   SetUniform(name, uniform.i4.x, uniform.i4.y, uniform.i4.z, uniform.i4.w); break;
+		case CACHED_UNIFORM_1F:   SetUniform(handle, uniform.f1.x); break;
+		case CACHED_UNIFORM_1I:   SetUniform(handle, uniform.i1.x); break;
+		case CACHED_UNIFORM_2F:   SetUniform(handle, uniform.f2.x, uniform.f2.y); break;
+		case CACHED_UNIFORM_2I:   SetUniform(handle, uniform.i2.x, uniform.i2.y); break;
+		case CACHED_UNIFORM_3F:   SetUniform(handle, uniform.f3.x, uniform.f3.y, uniform.f3.z); break;
+		case CACHED_UNIFORM_3I:   SetUniform(handle, uniform.i3.x, uniform.i3.y, uniform.i3.z); break;
+		case CACHED_UNIFORM_4F:   SetUniform(handle, uniform.f4.x, uniform.f4.y, uniform.f4.z, uniform.f4.w); break;
+		case CACHED_UNIFORM_4I:   SetUniform(handle, uniform.i4.x, uniform.i4.y, uniform.i4.z, uniform.i4.w); break;
 		case CACHED_UNIFORM_9F:
-			SetUniform(name, Matrix3x3(uniform.f9.m));
+			SetUniform(handle, Matrix3x3(uniform.f9.m));
 			break;
 		case CACHED_UNIFORM_16F:
-			SetUniform(name, Matrix4x4(uniform.f16.m));
+			SetUniform(handle, Matrix4x4(uniform.f16.m));
+			break;
+		default:
 			break;
 		}
+
+		uniform.type = CACHED_UNIFORM_NONE;
 	}
 
-	m_cachedUniforms.clear();
+	m_pendingUniforms.clear();
+}
+
+void Shader::ClearCachedUniforms()
+{
+	for (ShaderUniformHandleList::iterator i = m_pendingUniforms.begin(); i != m_pendingUniforms.end(); ++i)
+		m_cachedUniforms[*i].type = CACHED_UNIFORM_NONE;
+
+	m_pendingUniforms.clear();
 }
 
 void Shader::SetUniform(const stl::string &name, float x)
+{
+	SetUniform(GetUniformHandle(name), x);
+}
+
+void Shader::SetUniform(const stl::string &name, int x)
+{
+	SetUniform(GetUniformHandle(name), x);
+}
+
+void Shader::SetUniform(const stl::string &name, float x, float y)
+{
+	SetUniform(GetUniformHandle(name), x, y);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector2 &v)
+{
+	SetUniform(GetUniformHandle(name), v);
+}
+
+void Shader::SetUniform(const stl::string &name, int x, int y)
+{
+	SetUniform(GetUniformHandle(name), x, y);
+}
+
+void Shader::SetUniform(const stl::string &name, const Point2 &p)
+{
+	SetUniform(GetUniformHandle(name), p);
+}
+
+void Shader::SetUniform(const stl::string &name, float x, float y, float z)
+{
+	SetUniform(GetUniformHandle(name), x, y, z);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector3 &v)
+{
+	SetUniform(GetUniformHandle(name), v);
+}
+
+void Shader::SetUniform(const stl::string &name, int x, int y, int z)
+{
+	SetUniform(GetUniformHandle(name), x, y, z);
+}
+
+void Shader::SetUniform(const stl::string &name, const Point3 &p)
+{
+	SetUniform(GetUniformHandle(name), p);
+}
+
+void Shader::SetUniform(const stl::string &name, float x, float y, float z, float w)
+{
+	SetUniform(GetUniformHandle(name), x, y, z, w);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector4 &v)
+{
+	SetUniform(GetUniformHandle(name), v);
+}
+
+void Shader::SetUniform(const stl::string &name, const Quaternion &q)
+{
+	SetUniform(GetUniformHandle(name), q);
+}
+
+void Shader::SetUniform(const stl::string &name, const Color &c)
+{
+	SetUniform(GetUniformHandle(name), c);
+}
+
+void Shader::SetUniform(const stl::string &name, int x, int y, int z, int w)
+{
+	SetUniform(GetUniformHandle(name), x, y, z, w);
+}
+
+void Shader::SetUniform(const stl::string &name, const Matrix3x3 &m)
+{
+	SetUniform(GetUniformHandle(name), m);
+}
+
+void Shader::SetUniform(const stl::string &name, const Matrix4x4 &m)
+{
+	SetUniform(GetUniformHandle(name), m);
+}
+
+void Shader::SetUniform(const stl::string &name, const float *x, uint count)
+{
+	SetUniform(GetUniformHandle(name), x, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector2 *v, uint count)
+{
+	SetUniform(GetUniformHandle(name), v, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector3 *v, uint count)
+{
+	SetUniform(GetUniformHandle(name), v, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Vector4 *v, uint count)
+{
+	SetUniform(GetUniformHandle(name), v, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Quaternion *q, uint count)
+{
+	SetUniform(GetUniformHandle(name), q, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Color *c, uint count)
+{
+	SetUniform(GetUniformHandle(name), c, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Matrix3x3 *m, uint count)
+{
+	SetUniform(GetUniformHandle(name), m, count);
+}
+
+void Shader::SetUniform(const stl::string &name, const Matrix4x4 *m, uint count)
+{
+	SetUniform(GetUniformHandle(name), m, count);
+}
+
+void Shader::SetUniform(ShaderUniformHandle handle, float x)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform1f(uniform->location, x));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_1F;
-		uniform.f1.x = x;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_1F;
+		uniform->f1.x = x;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, int x)
+void Shader::SetUniform(ShaderUniformHandle handle, int x)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform1i(uniform->location, x));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_1I;
-		uniform.i1.x = x;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_1I;
+		uniform->i1.x = x;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, float x, float y)
+void Shader::SetUniform(ShaderUniformHandle handle, float x, float y)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform2f(uniform->location, x, y));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_2F;
-		uniform.f2.x = x;
-		uniform.f2.y = y;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_2F;
+		uniform->f2.x = x;
+		uniform->f2.y = y;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector2 &v)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector2 &v)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform2f(uniform->location, v.x, v.y));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_2F;
-		uniform.f2.x = v.x;
-		uniform.f2.y = v.y;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_2F;
+		uniform->f2.x = v.x;
+		uniform->f2.y = v.y;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, int x, int y)
+void Shader::SetUniform(ShaderUniformHandle handle, int x, int y)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform2i(uniform->location, x, y));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_2I;
-		uniform.i2.x = x;
-		uniform.i2.y = y;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_2I;
+		uniform->i2.x = x;
+		uniform->i2.y = y;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Point2 &p)
+void Shader::SetUniform(ShaderUniformHandle handle, const Point2 &p)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform2i(uniform->location, p.x, p.y));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_2I;
-		uniform.i2.x = p.x;
-		uniform.i2.y = p.y;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_2I;
+		uniform->i2.x = p.x;
+		uniform->i2.y = p.y;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, float x, float y, float z)
+void Shader::SetUniform(ShaderUniformHandle handle, float x, float y, float z)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform3f(uniform->location, x, y, z));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_3F;
-		uniform.f3.x = x;
-		uniform.f3.y = y;
-		uniform.f3.z = z;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_3F;
+		uniform->f3.x = x;
+		uniform->f3.y = y;
+		uniform->f3.z = z;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector3 &v)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector3 &v)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform3f(uniform->location, v.x, v.y, v.z));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_3F;
-		uniform.f3.x = v.x;
-		uniform.f3.y = v.y;
-		uniform.f3.z = v.z;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_3F;
+		uniform->f3.x = v.x;
+		uniform->f3.y = v.y;
+		uniform->f3.z = v.z;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, int x, int y, int z)
+void Shader::SetUniform(ShaderUniformHandle handle, int x, int y, int z)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform3i(uniform->location, x, y, z));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_3I;
-		uniform.i3.x = x;
-		uniform.i3.y = y;
-		uniform.i3.z = z;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_3I;
+		uniform->i3.x = x;
+		uniform->i3.y = y;
+		uniform->i3.z = z;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Point3 &p)
+void Shader::SetUniform(ShaderUniformHandle handle, const Point3 &p)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform3i(uniform->location, p.x, p.y, p.z));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_3I;
-		uniform.i3.x = p.x;
-		uniform.i3.y = p.y;
-		uniform.i3.z = p.z;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_3I;
+		uniform->i3.x = p.x;
+		uniform->i3.y = p.y;
+		uniform->i3.z = p.z;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, float x, float y, float z, float w)
+void Shader::SetUniform(ShaderUniformHandle handle, float x, float y, float z, float w)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform4f(uniform->location, x, y, z, w));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_4F;
-		uniform.f4.x = x;
-		uniform.f4.y = y;
-		uniform.f4.z = z;
-		uniform.f4.w = w;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_4F;
+		uniform->f4.x = x;
+		uniform->f4.y = y;
+		uniform->f4.z = z;
+		uniform->f4.w = w;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector4 &v)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector4 &v)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform4f(uniform->location, v.x, v.y, v.z, v.w));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_4F;
-		uniform.f4.x = v.x;
-		uniform.f4.y = v.y;
-		uniform.f4.z = v.z;
-		uniform.f4.w = v.w;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_4F;
+		uniform->f4.x = v.x;
+		uniform->f4.y = v.y;
+		uniform->f4.z = v.z;
+		uniform->f4.w = v.w;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Quaternion &q)
+void Shader::SetUniform(ShaderUniformHandle handle, const Quaternion &q)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform4f(uniform->location, q.x, q.y, q.z, q.w));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_4F;
-		uniform.f4.x = q.x;
-		uniform.f4.y = q.y;
-		uniform.f4.z = q.z;
-		uniform.f4.w = q.w;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_4F;
+		uniform->f4.x = q.x;
+		uniform->f4.y = q.y;
+		uniform->f4.z = q.z;
+		uniform->f4.w = q.w;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Color &c)
+void Shader::SetUniform(ShaderUniformHandle handle, const Color &c)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform4f(uniform->location, c.r, c.g, c.b, c.a));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_4F;
-		uniform.f4.x = c.r;
-		uniform.f4.y = c.g;
-		uniform.f4.z = c.b;
-		uniform.f4.w = c.a;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_4F;
+		uniform->f4.x = c.r;
+		uniform->f4.y = c.g;
+		uniform->f4.z = c.b;
+		uniform->f4.w = c.a;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, int x, int y, int z, int w)
+void Shader::SetUniform(ShaderUniformHandle handle, int x, int y, int z, int w)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniform4i(uniform->location, x, y, z, w));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_4I;
-		uniform.i4.x = x;
-		uniform.i4.y = y;
-		uniform.i4.z = z;
-		uniform.i4.w = w;
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_4I;
+		uniform->i4.x = x;
+		uniform->i4.y = y;
+		uniform->i4.z = z;
+		uniform->i4.w = w;
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Matrix3x3 &m)
+void Shader::SetUniform(ShaderUniformHandle handle, const Matrix3x3 &m)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniformMatrix3fv(uniform->location, 1, false, m.m));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_9F;
-		memcpy(uniform.f9.m, m.m, sizeof(float) * 9);
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_9F;
+		memcpy(uniform->f9.m, m.m, sizeof(float) * 9);
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Matrix4x4 &m)
+void Shader::SetUniform(ShaderUniformHandle handle, const Matrix4x4 &m)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size == 1);
 		GL_CALL(glUniformMatrix4fv(uniform->location, 1, false, m.m));
 	}
 	else
 	{
-		CachedShaderUniform uniform;
-		uniform.type = CACHED_UNIFORM_16F;
-		memcpy(uniform.f16.m, m.m, sizeof(float) * 16);
-		CacheUniform(name, uniform);
+		CachedShaderUniform *uniform = GetCachedUniform(handle);
+		uniform->type = CACHED_UNIFORM_16F;
+		memcpy(uniform->f16.m, m.m, sizeof(float) * 16);
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const float *x, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const float *x, uint count)
 {
 	if (m_isBound)
 	{
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
 		GL_CALL(glUniform1fv(uniform->location, count, x));
 	}
@@ -895,15 +1045,14 @@ void Shader::SetUniform(const stl::string &name, const float *x, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector2 *v, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector2 *v, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)v;
-		
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
 		GL_CALL(glUniform2fv(uniform->location, count, values));
 	}
@@ -913,15 +1062,14 @@ void Shader::SetUniform(const stl::string &name, const Vector2 *v, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector3 *v, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector3 *v, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)v;
 
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
 		GL_CALL(glUniform3fv(uniform->location, count, values));
 	}
@@ -931,15 +1079,14 @@ void Shader::SetUniform(const stl::string &name, const Vector3 *v, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Vector4 *v, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Vector4 *v, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)v;
-		
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
 		GL_CALL(glUniform4fv(uniform->location, count, values));
 	}
@@ -949,17 +1096,15 @@ void Shader::SetUniform(const stl::string &name, const Vector4 *v, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Quaternion *q, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Quaternion *q, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)q;
 
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
-
 		GL_CALL(glUniform4fv(uniform->location, count, values));
 	}
 	else
@@ -968,17 +1113,15 @@ void Shader::SetUniform(const stl::string &name, const Quaternion *q, uint count
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Color *c, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Color *c, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)c;
-		
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
-		ASSERT(uniform->size >= count);
 
+		const ShaderUniform *uniform = GetUniform(handle);
+		ASSERT(uniform->size >= count);
 		GL_CALL(glUniform4fv(uniform->location, count, values));
 	}
 	else
@@ -987,17 +1130,15 @@ void Shader::SetUniform(const stl::string &name, const Color *c, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Matrix3x3 *m, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Matrix3x3 *m, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)m;
 
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
-		
 		GL_CALL(glUniformMatrix3fv(uniform->location, count, false, values));
 	}
 	else
@@ -1006,17 +1147,15 @@ void Shader::SetUniform(const stl::string &name, const Matrix3x3 *m, uint count)
 	}
 }
 
-void Shader::SetUniform(const stl::string &name, const Matrix4x4 *m, uint count)
+void Shader::SetUniform(ShaderUniformHandle handle, const Matrix4x4 *m, uint count)
 {
 	if (m_isBound)
 	{
 		// TODO: erm... this _seems_ unnecessarily ugly... even for me
 		const float *values = (const float*)m;
-		
-		const ShaderUniform *uniform = GetUniform(name);
-		ASSERT(uniform != NULL);
+
+		const ShaderUniform *uniform = GetUniform(handle);
 		ASSERT(uniform->size >= count);
-		
 		GL_CALL(glUniformMatrix4fv(uniform->location, count, false, values));
 	}
 	else
@@ -1033,6 +1172,7 @@ void Shader::MapAttributeToVboAttribIndex(const stl::string &name, uint vboAttri
 
 	ShaderAttributeMapInfo *mappingInfo = &m_attributeMapping[attribute->location];
 	mappingInfo->usesStandardType = false;
+	mappingInfo->usesInstanceBuffer = false;
 	mappingInfo->attribIndex = vboAttribIndex;
 
 	attribute->isTypeBound = true;
@@ -1046,11 +1186,26 @@ void Shader::MapAttributeToStandardAttribType(const stl::string &name, VERTEX_ST
 
 	ShaderAttributeMapInfo *mappingInfo = &m_attributeMapping[attribute->location];
 	mappingInfo->usesStandardType = true;
+	mappingInfo->usesInstanceBuffer = false;
 	mappingInfo->standardType = standardAttribType;
 
 	attribute->isTypeBound = true;
 }
 
+void Shader::MapAttributeToInstanceBufferAttribIndex(const stl::string &name, uint instanceAttribIndex)
+{
+	ShaderAttribute *attribute = GetAttribute(name);
+	ASSERT(attribute != NULL);
+	ASSERT(attribute->location < m_numAttributes);
+
+	ShaderAttributeMapInfo *mappingInfo = &m_attributeMapping[attribute->location];
+	mappingInfo->usesStandardType = false;
+	mappingInfo->usesInstanceBuffer = true;
+	mappingInfo->attribIndex = instanceAttribIndex;
+
+	attribute->isTypeBound = true;
+}
+
 void Shader::OnNewContext()
 {
 	ReloadCompileAndLink(NULL, NULL);
@@ -1071,5 +1226,5 @@ void Shader::OnUnbind()
 {
 	ASSERT(m_isBound == true);
 	m_isBound = false;
-	m_cachedUniforms.clear();
+	ClearCachedUniforms();
 }
@@ -95,6 +95,16 @@ public:
 	 */
 	bool HasUniform(const stl::string &name) const;
 
+	/**
+	 * Looks up a handle that can be used to set a uniform's value without
+	 * a lookup by name each time. Handles remain valid if the shader is
+	 * reloaded due to a new OpenGL context, until Release() is called.
+	 * @param name the name of the uniform to get a handle for
+	 * @return the uniform's handle or INVALID_SHADER_UNIFORM_HANDLE if the
+	 *         shader does not contain the uniform
+	 */
+	ShaderUniformHandle GetUniformHandle(const stl::string &name) const;
+
 	/**
 	 * Checks if this shader contains an attribute. Note that the GLSL
 	 * compiler could optimize out attributes if they aren't used in the
@@ -214,6 +224,117 @@ public:
 	void SetUniform(const stl::string &name, const Color *c, uint count);
 	void SetUniform(const stl::string &name, const Matrix3x3 *m, uint count);
 	void SetUniform(const stl::string &name, const Matrix4x4 *m, uint count);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, float x);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, int x);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, float x, float y);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Vector2 &v);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, int x, int y);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Point2 &p);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, float x, float y, float z);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Vector3 &v);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, int x, int y, int z);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Point3 &p);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, float x, float y, float z, float w);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Vector4 &v);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Quaternion &q);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Color &c);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, int x, int y, int z, int w);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Matrix3x3 &m);
+
+	/**
+	 * Sets the value of a uniform.
+	 * @param handle the handle of the uniform to set
+	 */
+	void SetUniform(ShaderUniformHandle handle, const Matrix4x4 &m);
+
+	void SetUniform(ShaderUniformHandle handle, const float *x, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Vector2 *v, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Vector3 *v, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Vector4 *v, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Quaternion *q, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Color *c, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Matrix3x3 *m, uint count);
+	void SetUniform(ShaderUniformHandle handle, const Matrix4x4 *m, uint count);
 	
 	/**
 	 * @return the number of attributes used in this shader
@@ -230,6 +351,16 @@ public:
 	 */
 	bool IsAttributeMappedToStandardType(uint attribIndex) const;
 
+	/**
+	 * Returns whether the given shader attribute has been mapped to an
+	 * attribute in the bound instance buffer or not.
+	 * @param attribIndex the index of the shader attribute to check the 
+	 *                    mapping of
+	 * @return true if this shader attribute was mapped to an instance buffer
+	 *         attribute or false if it wasn't
+	 */
+	bool IsAttributeMappedToInstanceBuffer(uint attribIndex) const;
+
 	/**
 	 * Gets a vertex buffer object attribute index that corresponds to the
 	 * specified shader attribute.
@@ -273,6 +404,19 @@ public:
 	 */
 	void MapAttributeToStandardAttribType(const stl::string &name, VERTEX_STANDARD_ATTRIBS standardAttribType);
 
+	/**
+	 * Maps the given shader attribute to an index that will be used to refer
+	 * to an attribute in the bound instance buffer (see 
+	 * GraphicsDevice::BindInstanceBuffer). The attribute will advance once
+	 * per instance instead of once per vertex when rendering with
+	 * GraphicsDevice::RenderTrianglesInstanced.
+	 * @param name the name of the attribute to map
+	 * @param instanceAttribIndex the index value to map that will be used to
+	 *                            refer to an attribute in the bound instance
+	 *                            buffer
+	 */
+	void MapAttributeToInstanceBufferAttribIndex(const stl::string &name, uint instanceAttribIndex);
+
 	/**
 	 * New OpenGL graphics context creation callback.
 	 */
@@ -358,9 +502,10 @@ private:
 	void LoadUniformInfo();
 	void LoadAttributeInfo();
 
-	void CacheUniform(const stl::string &name, CachedShaderUniform uniform);
-	CachedShaderUniform* GetCachedUniform(const stl::string &name);
+	const ShaderUniform* GetUniform(ShaderUniformHandle handle) const;
+	CachedShaderUniform* GetCachedUniform(ShaderUniformHandle handle);
 	void FlushCachedUniforms();
+	void ClearCachedUniforms();
 
 	void OnBind();
 	void OnUnbind();
@@ -375,12 +520,14 @@ private:
 	uint m_programId;
 	bool m_isBound;
 
-	ShaderUniformMap m_uniforms;
+	ShaderUniformList m_uniforms;
+	ShaderUniformHandleMap m_uniformHandles;
 	ShaderAttributeMap m_attributes;
 	ShaderAttributeMapInfo *m_attributeMapping;
 	uint m_numAttributes;
 
-	CachedShaderUniformMap m_cachedUniforms;
+	CachedShaderUniformList m_cachedUniforms;
+	ShaderUniformHandleList m_pendingUniforms;
 };
 
 inline bool Shader::IsReadyForUse() const
@@ -396,6 +543,11 @@ inline bool Shader::IsAttributeMappedToStandardType(uint attribIndex) const
 	return m_attributeMapping[attribIndex].usesStandardType;
 }
 
+inline bool Shader::IsAttributeMappedToInstanceBuffer(uint attribIndex) const
+{
+	return m_attributeMapping[attribIndex].usesInstanceBuffer;
+}
+
 inline uint Shader::GetAttributeMappedBufferIndex(uint attribIndex) const
 {
 	return m_attributeMapping[attribIndex].attribIndex;
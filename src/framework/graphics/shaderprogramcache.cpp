@@ -0,0 +1,203 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "shaderprogramcache.h"
+
+#include "glincludes.h"
+#include "glutils.h"
+#include "../file/file.h"
+#include "../file/filesystem.h"
+#include <crt/snprintf.h>
+
+const uint32_t SHADER_PROGRAM_CACHE_MAGIC = 0x43505348;   // "HSPC"
+const uint32_t SHADER_PROGRAM_CACHE_VERSION = 1;
+
+const uint64_t FNV1A_64_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+const uint64_t FNV1A_64_PRIME = 0x100000001b3ULL;
+
+static uint64_t HashBytes(uint64_t hash, const char *str)
+{
+	if (str == NULL)
+		return hash;
+
+	for (const uint8_t *p = (const uint8_t*)str; *p != '\0'; ++p)
+	{
+		hash ^= *p;
+		hash *= FNV1A_64_PRIME;
+	}
+
+	// so that e.g. ("ab", "c") and ("a", "bc") don't hash the same
+	hash ^= 0xff;
+	hash *= FNV1A_64_PRIME;
+
+	return hash;
+}
+
+ShaderProgramCache::ShaderProgramCache(FileSystem *fileSystem, const stl::string &path)
+{
+	ASSERT(fileSystem != NULL);
+
+	m_fileSystem = fileSystem;
+	m_path = path;
+	m_isSupported = false;
+
+#if defined(DESKTOP) && !defined(NULL_GRAPHICS)
+	if (GLEW_ARB_get_program_binary)
+	{
+		// drivers can advertise the extension and still not provide any
+		// binary formats (older versions of Mesa for example)
+		GLint numFormats = 0;
+		GL_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats));
+		m_isSupported = (numFormats > 0);
+	}
+#endif
+
+	if (m_isSupported)
+	{
+		const char *vendor = (const char*)glGetString(GL_VENDOR);
+		const char *renderer = (const char*)glGetString(GL_RENDERER);
+		const char *version = (const char*)glGetString(GL_VERSION);
+		m_driverString = (vendor != NULL ? vendor : "");
+		m_driverString += "|";
+		m_driverString += (renderer != NULL ? renderer : "");
+		m_driverString += "|";
+		m_driverString += (version != NULL ? version : "");
+	}
+
+	LOG_INFO(LOGCAT_GRAPHICS, "Support for shader program binary caching was %s.\n", m_isSupported ? "found" : "not found");
+}
+
+ShaderProgramCache::~ShaderProgramCache()
+{
+}
+
+uint ShaderProgramCache::Load(const char *vertexShaderSource, const char *fragmentShaderSource)
+{
+	if (!m_isSupported)
+		return 0;
+
+#if defined(DESKTOP) && !defined(NULL_GRAPHICS)
+	uint64_t key = GetKey(vertexShaderSource, fragmentShaderSource);
+	File *file = m_fileSystem->Open(GetFilenameFor(key), FILEMODE_READ | FILEMODE_BINARY);
+	if (file == NULL)
+		return 0;
+
+	uint32_t magic = file->ReadUnsignedInt();
+	uint32_t version = file->ReadUnsignedInt();
+	uint64_t fileKey = file->ReadUnsignedLong();
+	uint32_t binaryFormat = file->ReadUnsignedInt();
+	uint32_t binaryLength = file->ReadUnsignedInt();
+
+	if (magic != SHADER_PROGRAM_CACHE_MAGIC || version != SHADER_PROGRAM_CACHE_VERSION || fileKey != key || binaryLength == 0)
+	{
+		SAFE_DELETE(file);
+		return 0;
+	}
+
+	int8_t *binary = new int8_t[binaryLength];
+	size_t bytesRead = file->Read(binary, binaryLength);
+	SAFE_DELETE(file);
+	if (bytesRead != binaryLength)
+	{
+		SAFE_DELETE_ARRAY(binary);
+		return 0;
+	}
+
+	GLuint programId;
+	GL_CALL(programId = glCreateProgram());
+	ASSERT(programId != 0);
+
+	// the driver is free to reject a binary it previously gave us (e.g. after
+	// a driver update that didn't change the version string). that isn't an
+	// OpenGL error, it just shows up as the program not being linked
+	GL_CALL(glProgramBinary(programId, (GLenum)binaryFormat, binary, (GLsizei)binaryLength));
+	SAFE_DELETE_ARRAY(binary);
+
+	GLint linkStatus = 0;
+	GL_CALL(glGetProgramiv(programId, GL_LINK_STATUS, &linkStatus));
+	if (!linkStatus)
+	{
+		LOG_WARN(LOGCAT_GRAPHICS, "Cached shader program binary was rejected by the driver, will recompile.\n");
+		GL_CALL(glDeleteProgram(programId));
+		return 0;
+	}
+
+	return programId;
+#else
+	return 0;
+#endif
+}
+
+void ShaderProgramCache::PrepareForLink(uint programId)
+{
+	ASSERT(programId != 0);
+	if (!m_isSupported)
+		return;
+
+#if defined(DESKTOP) && !defined(NULL_GRAPHICS)
+	GL_CALL(glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+#endif
+}
+
+bool ShaderProgramCache::Save(uint programId, const char *vertexShaderSource, const char *fragmentShaderSource)
+{
+	ASSERT(programId != 0);
+	if (!m_isSupported)
+		return false;
+
+#if defined(DESKTOP) && !defined(NULL_GRAPHICS)
+	GLint binaryLength = 0;
+	GL_CALL(glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength));
+	if (binaryLength <= 0)
+		return false;
+
+	int8_t *binary = new int8_t[binaryLength];
+	GLenum binaryFormat = 0;
+	GLsizei length = 0;
+	GL_CALL(glGetProgramBinary(programId, binaryLength, &length, &binaryFormat, binary));
+	if (length <= 0)
+	{
+		SAFE_DELETE_ARRAY(binary);
+		return false;
+	}
+
+	uint64_t key = GetKey(vertexShaderSource, fragmentShaderSource);
+	File *file = m_fileSystem->Open(GetFilenameFor(key), FILEMODE_WRITE | FILEMODE_BINARY);
+	if (file == NULL)
+	{
+		LOG_WARN(LOGCAT_GRAPHICS, "Unable to write shader program binary to the cache.\n");
+		SAFE_DELETE_ARRAY(binary);
+		return false;
+	}
+
+	file->WriteUnsignedInt(SHADER_PROGRAM_CACHE_MAGIC);
+	file->WriteUnsignedInt(SHADER_PROGRAM_CACHE_VERSION);
+	file->WriteUnsignedLong(key);
+	file->WriteUnsignedInt((uint32_t)binaryFormat);
+	file->WriteUnsignedInt((uint32_t)length);
+	size_t bytesWritten = file->Write(binary, (size_t)length);
+
+	SAFE_DELETE(file);
+	SAFE_DELETE_ARRAY(binary);
+
+	return (bytesWritten == (size_t)length);
+#else
+	return false;
+#endif
+}
+
+uint64_t ShaderProgramCache::GetKey(const char *vertexShaderSource, const char *fragmentShaderSource) const
+{
+	uint64_t hash = FNV1A_64_OFFSET_BASIS;
+	hash = HashBytes(hash, m_driverString.c_str());
+	hash = HashBytes(hash, vertexShaderSource);
+	hash = HashBytes(hash, fragmentShaderSource);
+	return hash;
+}
+
+stl::string ShaderProgramCache::GetFilenameFor(uint64_t key) const
+{
+	char filename[32];
+	snprintf(filename, 32, "shader_%08x%08x.bin", (uint32_t)(key >> 32), (uint32_t)(key & 0xffffffff));
+	return m_path + filename;
+}
@@ -0,0 +1,72 @@
+#ifndef __FRAMEWORK_GRAPHICS_SHADERPROGRAMCACHE_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_SHADERPROGRAMCACHE_H_INCLUDED__
+
+#include "../common.h"
+#include <stl/string.h>
+
+class FileSystem;
+
+/**
+ * Stores linked shader program binaries on disk so that shaders can be
+ * loaded directly on subsequent runs (and after a lost OpenGL context is
+ * recreated) instead of being compiled and linked from source each time.
+ * Cached binaries are keyed by a hash of the shader source and the OpenGL
+ * driver identification strings, so a driver update will simply result in
+ * cache misses.
+ */
+class ShaderProgramCache
+{
+public:
+	/**
+	 * Creates a shader program cache. The current OpenGL context is checked
+	 * for support of retrieving program binaries.
+	 * @param fileSystem the file system to read and write cached binaries with
+	 * @param path the location to store cached binaries in
+	 */
+	ShaderProgramCache(FileSystem *fileSystem, const stl::string &path = "storage://");
+
+	virtual ~ShaderProgramCache();
+
+	/**
+	 * @return true if the OpenGL context supports retrieving and loading
+	 *         program binaries. If not, the cache will never load anything.
+	 */
+	bool IsSupported() const                               { return m_isSupported; }
+
+	/**
+	 * Attempts to create a program object from a previously cached binary
+	 * of the given shader sources.
+	 * @param vertexShaderSource the vertex shader source the program was built from
+	 * @param fragmentShaderSource the fragment shader source the program was built from
+	 * @return the linked OpenGL program ID or 0 if there was no cached binary
+	 *         for these sources or if the driver rejected it
+	 */
+	uint Load(const char *vertexShaderSource, const char *fragmentShaderSource);
+
+	/**
+	 * Marks a program object so that it's binary can be retrieved for caching
+	 * after linking. Must be called before the program is linked.
+	 * @param programId the OpenGL program ID
+	 */
+	void PrepareForLink(uint programId);
+
+	/**
+	 * Writes the binary for a successfully linked program to the cache.
+	 * @param programId the linked OpenGL program ID
+	 * @param vertexShaderSource the vertex shader source the program was built from
+	 * @param fragmentShaderSource the fragment shader source the program was built from
+	 * @return true if the binary was written to the cache
+	 */
+	bool Save(uint programId, const char *vertexShaderSource, const char *fragmentShaderSource);
+
+private:
+	uint64_t GetKey(const char *vertexShaderSource, const char *fragmentShaderSource) const;
+	stl::string GetFilenameFor(uint64_t key) const;
+
+	FileSystem *m_fileSystem;
+	stl::string m_path;
+	stl::string m_driverString;
+	bool m_isSupported;
+};
+
+#endif
@@ -6,6 +6,16 @@
 
 #include <stl/map.h>
 #include <stl/string.h>
+#include <stl/vector.h>
+
+/**
+ * Pre-resolved reference to a shader uniform. These can be obtained once
+ * after a shader is linked and used to set uniform values without needing
+ * to look the uniform up by name each time.
+ */
+typedef int ShaderUniformHandle;
+
+const ShaderUniformHandle INVALID_SHADER_UNIFORM_HANDLE = -1;
 
 /**
  * Metadata about a shader uniform.
@@ -34,6 +44,7 @@ struct ShaderAttribute
 struct ShaderAttributeMapInfo
 {
 	bool usesStandardType;
+	bool usesInstanceBuffer;
 	VERTEX_STANDARD_ATTRIBS standardType;
 	uint attribIndex;
 };
@@ -43,6 +54,7 @@ struct ShaderAttributeMapInfo
  */
 enum CACHED_SHADER_UNIFORM_TYPE
 {
+	CACHED_UNIFORM_NONE,
 	CACHED_UNIFORM_1F,
 	CACHED_UNIFORM_1I,
 	CACHED_UNIFORM_2F,
@@ -116,6 +128,11 @@ struct CachedShaderUniform
 			float m[16];
 		} f16;
 	};
+
+	CachedShaderUniform()
+	{
+		type = CACHED_UNIFORM_NONE;
+	}
 };
 
 struct CachedShaderArrayUniform
@@ -135,8 +152,10 @@ struct CachedShaderArrayUniform
 	}
 };
 
-typedef stl::map<stl::string, ShaderUniform> ShaderUniformMap;
+typedef stl::vector<ShaderUniform> ShaderUniformList;
+typedef stl::map<stl::string, ShaderUniformHandle> ShaderUniformHandleMap;
+typedef stl::vector<ShaderUniformHandle> ShaderUniformHandleList;
 typedef stl::map<stl::string, ShaderAttribute> ShaderAttributeMap;
-typedef stl::map<stl::string, CachedShaderUniform> CachedShaderUniformMap;
+typedef stl::vector<CachedShaderUniform> CachedShaderUniformList;
 
 #endif
@@ -0,0 +1,60 @@
+#include "../debug.h"
+
+#include "simpletextureinstancedshader.h"
+
+const char* SimpleTextureInstancedShader::m_vertexShaderSource = 
+	"attribute vec4 a_position;\n"
+	"attribute vec2 a_texcoord0;\n"
+	"attribute vec4 a_instanceTransform0;\n"
+	"attribute vec4 a_instanceTransform1;\n"
+	"attribute vec4 a_instanceTransform2;\n"
+	"attribute vec4 a_instanceTransform3;\n"
+	"uniform mat4 u_modelViewMatrix;\n"
+	"uniform mat4 u_projectionMatrix;\n"
+	"varying vec2 v_texCoords;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	mat4 instanceTransform = mat4(a_instanceTransform0, a_instanceTransform1, a_instanceTransform2, a_instanceTransform3);\n"
+	"	v_texCoords = a_texcoord0;\n"
+	"	gl_Position =  u_projectionMatrix * u_modelViewMatrix * instanceTransform * a_position;\n"
+	"}\n";
+
+const char* SimpleTextureInstancedShader::m_fragmentShaderSource = 
+	"#ifdef GL_ES\n"
+	"	precision mediump float;\n"
+	"#endif\n"
+	"varying vec2 v_texCoords;\n"
+	"uniform sampler2D u_texture;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	gl_FragColor = texture2D(u_texture, v_texCoords);\n"
+	"}\n";
+
+
+SimpleTextureInstancedShader::SimpleTextureInstancedShader()
+{
+}
+
+SimpleTextureInstancedShader::~SimpleTextureInstancedShader()
+{
+}
+
+bool SimpleTextureInstancedShader::Initialize(GraphicsDevice *graphicsDevice)
+{
+	if (!StandardShader::Initialize(graphicsDevice))
+		return false;
+	
+	bool result = LoadCompileAndLinkInlineSources(m_vertexShaderSource, m_fragmentShaderSource);
+	ASSERT(result == true);
+
+	MapAttributeToStandardAttribType("a_position", VERTEX_STD_POS_3D);
+	MapAttributeToStandardAttribType("a_texcoord0", VERTEX_STD_TEXCOORD);
+	MapAttributeToInstanceBufferAttribIndex("a_instanceTransform0", 0);
+	MapAttributeToInstanceBufferAttribIndex("a_instanceTransform1", 1);
+	MapAttributeToInstanceBufferAttribIndex("a_instanceTransform2", 2);
+	MapAttributeToInstanceBufferAttribIndex("a_instanceTransform3", 3);
+	
+	return true;
+}
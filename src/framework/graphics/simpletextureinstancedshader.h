@@ -0,0 +1,27 @@
+#ifndef __FRAMEWORK_GRAPHICS_SIMPLETEXTUREINSTANCEDSHADER_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_SIMPLETEXTUREINSTANCEDSHADER_H_INCLUDED__
+
+#include "standardshader.h"
+
+class GraphicsDevice;
+
+/**
+ * Shader which renders instanced geometry with texturing but no vertex 
+ * colors. Each instance's model transform is read from 4 consecutive
+ * per-instance attributes (one for each column of the matrix) which are
+ * mapped to attributes 0-3 of the bound instance buffer.
+ */
+class SimpleTextureInstancedShader : public StandardShader
+{
+public:
+	SimpleTextureInstancedShader();
+	virtual ~SimpleTextureInstancedShader();
+	
+	bool Initialize(GraphicsDevice *graphicsDevice);
+
+private:
+	static const char *m_vertexShaderSource;
+	static const char *m_fragmentShaderSource;
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "../debug.h"
+
+#include "skylinepacker.h"
+
+SkylinePacker::SkylinePacker(uint width, uint height)
+{
+	ASSERT(width > 0);
+	ASSERT(height > 0);
+
+	m_width = width;
+	m_height = height;
+	Reset();
+}
+
+SkylinePacker::~SkylinePacker()
+{
+}
+
+void SkylinePacker::Reset()
+{
+	m_usedArea = 0;
+	m_skyline.clear();
+
+	// start with a single level spanning the whole width along the top edge
+	SkylineNode node;
+	node.x = 0;
+	node.y = 0;
+	node.width = m_width;
+	m_skyline.push_back(node);
+}
+
+bool SkylinePacker::Insert(uint width, uint height, Rect &position)
+{
+	ASSERT(width > 0);
+	ASSERT(height > 0);
+	if (width > m_width || height > m_height)
+		return false;
+
+	int bestIndex = -1;
+	uint bestBottom = m_height + 1;
+	uint bestWidth = m_width + 1;
+	uint bestX = 0;
+	uint bestY = 0;
+
+	// pick the spot which keeps the bottom edge of the new rect as high as
+	// possible, preferring narrower levels when there is a tie (which leaves
+	// the wider levels available for wider rects later on)
+	for (uint i = 0; i < m_skyline.size(); ++i)
+	{
+		uint y;
+		if (Fit(i, width, height, y))
+		{
+			uint bottom = y + height;
+			if (bottom < bestBottom || (bottom == bestBottom && m_skyline[i].width < bestWidth))
+			{
+				bestIndex = (int)i;
+				bestBottom = bottom;
+				bestWidth = m_skyline[i].width;
+				bestX = m_skyline[i].x;
+				bestY = y;
+			}
+		}
+	}
+
+	if (bestIndex == -1)
+		return false;
+
+	position.Set(bestX, bestY, bestX + width, bestY + height);
+	AddLevel((uint)bestIndex, position);
+	m_usedArea += width * height;
+
+	return true;
+}
+
+bool SkylinePacker::Fit(uint nodeIndex, uint width, uint height, uint &y) const
+{
+	uint x = m_skyline[nodeIndex].x;
+	if (x + width > m_width)
+		return false;
+
+	// the rect will rest on the highest level it spans across
+	int widthLeft = (int)width;
+	uint i = nodeIndex;
+	y = m_skyline[nodeIndex].y;
+	while (widthLeft > 0)
+	{
+		ASSERT(i < m_skyline.size());
+		y = Max(y, m_skyline[i].y);
+		if (y + height > m_height)
+			return false;
+
+		widthLeft -= (int)m_skyline[i].width;
+		++i;
+	}
+
+	return true;
+}
+
+void SkylinePacker::AddLevel(uint nodeIndex, const Rect &position)
+{
+	SkylineNode newNode;
+	newNode.x = position.left;
+	newNode.y = position.bottom;
+	newNode.width = position.GetWidth();
+	m_skyline.insert(m_skyline.begin() + nodeIndex, newNode);
+
+	// shrink or remove the levels that are now covered by the new one
+	for (uint i = nodeIndex + 1; i < m_skyline.size(); ++i)
+	{
+		SkylineNode &previous = m_skyline[i - 1];
+		SkylineNode &current = m_skyline[i];
+
+		uint previousRight = previous.x + previous.width;
+		if (current.x >= previousRight)
+			break;
+
+		uint overlap = previousRight - current.x;
+		if (overlap >= current.width)
+		{
+			m_skyline.erase(m_skyline.begin() + i);
+			--i;
+		}
+		else
+		{
+			current.x += overlap;
+			current.width -= overlap;
+			break;
+		}
+	}
+
+	MergeLevels();
+}
+
+void SkylinePacker::MergeLevels()
+{
+	for (uint i = 0; i + 1 < m_skyline.size(); ++i)
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + (i + 1));
+			--i;
+		}
+	}
+}
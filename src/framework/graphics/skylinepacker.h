@@ -0,0 +1,81 @@
+#ifndef __FRAMEWORK_GRAPHICS_SKYLINEPACKER_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_SKYLINEPACKER_H_INCLUDED__
+
+#include "../common.h"
+#include "../math/rect.h"
+
+#include <stl/vector.h>
+
+/**
+ * Packs rectangles into a fixed size 2D area using the "skyline bottom-left"
+ * heuristic. Only the top edge (the "skyline") of everything packed so far
+ * is tracked, so space underneath overhanging rectangles is never reused.
+ * This trades a small amount of packing efficiency for very fast insertion.
+ */
+class SkylinePacker
+{
+public:
+	/**
+	 * Creates a packer for an empty area of the given size.
+	 * @param width the width of the area to pack rectangles into
+	 * @param height the height of the area to pack rectangles into
+	 */
+	SkylinePacker(uint width, uint height);
+
+	virtual ~SkylinePacker();
+
+	/**
+	 * Finds and reserves space for a rectangle of the given size.
+	 * @param width the width of the rectangle to be packed
+	 * @param height the height of the rectangle to be packed
+	 * @param position receives the position that the rectangle was placed
+	 *                 at if successful
+	 * @return true if there was space for the rectangle, false if not
+	 */
+	bool Insert(uint width, uint height, Rect &position);
+
+	/**
+	 * Clears all packed rectangles, making the entire area available again.
+	 */
+	void Reset();
+
+	/**
+	 * @return the width of the area being packed into
+	 */
+	uint GetWidth() const                                  { return m_width; }
+
+	/**
+	 * @return the height of the area being packed into
+	 */
+	uint GetHeight() const                                 { return m_height; }
+
+	/**
+	 * @return the total area occupied by packed rectangles
+	 */
+	uint GetUsedArea() const                               { return m_usedArea; }
+
+	/**
+	 * @return the fraction (0.0 to 1.0) of the area occupied by packed
+	 *         rectangles
+	 */
+	float GetOccupancy() const                             { return (float)m_usedArea / (float)(m_width * m_height); }
+
+private:
+	struct SkylineNode
+	{
+		uint x;
+		uint y;
+		uint width;
+	};
+
+	bool Fit(uint nodeIndex, uint width, uint height, uint &y) const;
+	void AddLevel(uint nodeIndex, const Rect &position);
+	void MergeLevels();
+
+	uint m_width;
+	uint m_height;
+	uint m_usedArea;
+	stl::vector<SkylineNode> m_skyline;
+};
+
+#endif
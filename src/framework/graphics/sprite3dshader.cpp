@@ -20,6 +20,9 @@ const char* Sprite3DShader::m_vertexShaderSource =
 
 const char* Sprite3DShader::m_fragmentShaderSource = 
 	"#ifdef GL_ES\n"
+	"	#ifdef GL_OES_standard_derivatives\n"
+	"		#extension GL_OES_standard_derivatives : enable\n"
+	"	#endif\n"
 	"	#define LOWP lowp\n"
 	"	precision mediump float;\n"
 	"#else\n"
@@ -29,10 +32,23 @@ const char* Sprite3DShader::m_fragmentShaderSource =
 	"varying vec2 v_texCoords;\n"
 	"uniform sampler2D u_texture;\n"
 	"uniform bool u_textureHasAlphaOnly;\n"
+	"uniform bool u_textureIsDistanceField;\n"
+	"\n"
+	"float distanceFieldAlpha(float distance)\n"
+	"{\n"
+	"#if defined(GL_ES) && !defined(GL_OES_standard_derivatives)\n"
+	"	float smoothing = 0.0625;\n"
+	"#else\n"
+	"	float smoothing = 0.7 * fwidth(distance);\n"
+	"#endif\n"
+	"	return smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+	"}\n"
 	"\n"
 	"void main()\n"
 	"{\n"
 	"	vec4 texColor = texture2D(u_texture, v_texCoords);\n"
+	"	if (u_textureIsDistanceField)\n"
+	"		texColor.a = distanceFieldAlpha(texColor.a);\n"
 	"	if (texColor.a > 0.0)\n"
 	"	{\n"
 	"		vec4 finalColor;\n"
@@ -7,11 +7,14 @@
 #include <stdarg.h>
 
 #include "blendstate.h"
+#include "dynamictextureatlas.h"
+#include "dynamictextureatlasmanager.h"
 #include "graphicsdevice.h"
 #include "indexbuffer.h"
 #include "renderstate.h"
 #include "shader.h"
 #include "spritefont.h"
+#include "textlayout.h"
 #include "spriteshader.h"
 #include "sprite2dshader.h"
 #include "texture.h"
@@ -57,6 +60,7 @@ SpriteBatch::SpriteBatch(GraphicsDevice *graphicsDevice)
 	m_indices->Initialize(m_graphicsDevice, numSprites * INDICES_PER_SPRITE, BUFFEROBJECT_USAGE_STREAM);
 
 	m_textures.resize(numSprites, NULL);
+	m_textureIsDistanceField.resize(numSprites, false);
 	
 	FillSpriteIndicesFor(0, numSprites - 1);
 
@@ -64,10 +68,14 @@ SpriteBatch::SpriteBatch(GraphicsDevice *graphicsDevice)
 	m_renderState->SetDepthTesting(false);
 
 	m_blendState = new BLENDSTATE_ALPHABLEND;
+
+	// text passed directly to Render()/Printf() is laid out into this
+	m_textLayout = new TextLayout();
 }
 
 SpriteBatch::~SpriteBatch()
 {
+	SAFE_DELETE(m_textLayout);
 	SAFE_DELETE(m_vertices);
 	SAFE_DELETE(m_renderState);
 	SAFE_DELETE(m_blendState);
@@ -234,105 +242,85 @@ void SpriteBatch::Render(const TextureAtlas *atlas, uint index, const Vector3 &w
 	Render(atlas, index, screenCoordinates.x, screenCoordinates.y, width, height, color);
 }
 
-void SpriteBatch::Render(const SpriteFont *font, int x, int y, const Color &color, const char *text)
+void SpriteBatch::Render(const DynamicTextureAtlasTile &tile, int x, int y, const Color &color)
 {
-	size_t textLength = strlen(text);
-
-	y = FixYCoord(y, (uint)font->GetLetterHeight());
+	ASSERT(tile.IsValid());
+	Render(tile.atlas, tile.index, x, y, color);
+}
 
-	int drawX = x;
-	int drawY = y;
+void SpriteBatch::Render(const DynamicTextureAtlasTile &tile, int x, int y, uint width, uint height, const Color &color)
+{
+	ASSERT(tile.IsValid());
+	Render(tile.atlas, tile.index, x, y, width, height, color);
+}
 
-	for (size_t i = 0; i < textLength; ++i)
-	{
-		char c = text[i];
-		if (c == '\n')
-		{
-			// new line
-			drawX = x;
-			drawY -= font->GetLetterHeight();
-		}
-		else
-		{
-			const TextureAtlasTile &glyph = font->GetGlyph(c);
+void SpriteBatch::Render(const SpriteFont *font, int x, int y, const Color &color, const char *text)
+{
+	Render(LayOutText(font, text, 1.0f), x, y, color);
+}
 
-			AddSprite(
-				font->GetTexture(), 
-				drawX, drawY, drawX + glyph.dimensions.GetWidth(), drawY + glyph.dimensions.GetHeight(), 
-				glyph.texCoords.left, glyph.texCoords.top, glyph.texCoords.right, glyph.texCoords.bottom, 
-				color
-				);
+void SpriteBatch::Render(const SpriteFont *font, int x, int y, const Color &color, float scale, const char *text)
+{
+	Render(LayOutText(font, text, scale), x, y, color);
+}
 
-			drawX += glyph.dimensions.GetWidth();
-		}
-	}
+void SpriteBatch::Render(const SpriteFont *font, const Vector3 &worldPosition, const Color &color, const char *text)
+{
+	Render(LayOutText(font, text, 1.0f), worldPosition, color);
 }
 
-void SpriteBatch::Render(const SpriteFont *font, int x, int y, const Color &color, float scale, const char *text)
+void SpriteBatch::Render(const SpriteFont *font, const Vector3 &worldPosition, const Color &color, float scale, const char *text)
 {
-	size_t textLength = strlen(text);
+	Render(LayOutText(font, text, scale), worldPosition, color);
+}
 
-	float scaledLetterHeight = (float)font->GetLetterHeight() * scale;
+void SpriteBatch::Render(const TextLayout *layout, int x, int y, const Color &color)
+{
+	ASSERT(m_begunRendering == true);
 
-	y = (int)FixYCoord(y, scaledLetterHeight);
+	uint numQuads = layout->GetNumQuads();
+	uint remainingSpaces = GetRemainingSpriteSpaces();
+	if (remainingSpaces < numQuads)
+		AddMoreSpriteSpace(numQuads - remainingSpaces);
 
-	float drawX = (float)x;
-	float drawY = (float)y;
+	// layouts have Y increasing downwards from the top of the text, which
+	// just needs to be flipped here
+	float originX = (float)x;
+	float originY = (float)(m_graphicsDevice->GetViewContext()->GetViewportHeight() - y);
+	bool isDistanceField = (layout->GetFont() != NULL && layout->GetFont()->IsDistanceField());
 
-	for (size_t i = 0; i < textLength; ++i)
+	for (uint i = 0; i < numQuads; ++i)
 	{
-		char c = text[i];
-		if (c == '\n')
+		const TextLayoutQuad &quad = layout->GetQuad(i);
+
+		float destLeft = originX + quad.position.left;
+		float destTop = originY - quad.position.bottom;
+		float destRight = originX + quad.position.right;
+		float destBottom = originY - quad.position.top;
+		float texCoordLeft = quad.texCoords.left;
+		float texCoordTop = quad.texCoords.top;
+		float texCoordRight = quad.texCoords.right;
+		float texCoordBottom = quad.texCoords.bottom;
+
+		if (m_isClipping)
 		{
-			// new line
-			drawX = x;
-			drawY -= scaledLetterHeight;
+			if (!ClipSpriteCoords(destLeft, destTop, destRight, destBottom, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom))
+				continue;
 		}
-		else
-		{
-			const TextureAtlasTile &glyph = font->GetGlyph(c);
-
-			float scaledGlyphWidth = (float)glyph.dimensions.GetWidth() * scale;
-			float scaledGlyphHeight = (float)glyph.dimensions.GetHeight() * scale;
 
-			AddSprite(
-				font->GetTexture(), 
-				drawX, drawY, drawX + scaledGlyphWidth, drawY + scaledGlyphHeight, 
-				glyph.texCoords.left, glyph.texCoords.top, glyph.texCoords.right, glyph.texCoords.bottom, 
-				color
-				);
-
-			drawX += scaledGlyphWidth;
-		}
+		SetSpriteInfo(m_currentSpritePointer, quad.page->GetTexture(), destLeft, destTop, destRight, destBottom, texCoordLeft, texCoordTop, texCoordRight, texCoordBottom, color, isDistanceField);
+		++m_currentSpritePointer;
 	}
 }
 
-void SpriteBatch::Render(const SpriteFont *font, const Vector3 &worldPosition, const Color &color, const char *text)
+void SpriteBatch::Render(const TextLayout *layout, const Vector3 &worldPosition, const Color &color)
 {
 	Point2 screenCoordinates = m_graphicsDevice->GetViewContext()->GetCamera()->Project(worldPosition, m_previousModelview, m_previousProjection);
 
-	uint textWidth = 0;
-	uint textHeight = 0;
-	font->MeasureString(&textWidth, &textHeight, text);
+	screenCoordinates.x -= layout->GetWidth() / 2;
+	screenCoordinates.y -= layout->GetHeight() / 2;
 
-	screenCoordinates.x -= textWidth / 2;
-	screenCoordinates.y -= textHeight / 2;
-
-	Render(font, screenCoordinates.x, screenCoordinates.y, color, text);
-}
-
-void SpriteBatch::Render(const SpriteFont *font, const Vector3 &worldPosition, const Color &color, float scale, const char *text)
-{
-	Point2 screenCoordinates = m_graphicsDevice->GetViewContext()->GetCamera()->Project(worldPosition, m_previousModelview, m_previousProjection);
-
-	uint textWidth = 0;
-	uint textHeight = 0;
-	font->MeasureString(&textWidth, &textHeight, scale, text);
-
-	screenCoordinates.x -= textWidth / 2;
-	screenCoordinates.y -= textHeight / 2;
-
-	Render(font, screenCoordinates.x, screenCoordinates.y, color, scale, text);
+	Render(layout, screenCoordinates.x, screenCoordinates.y, color);
 }
 
 void SpriteBatch::Printf(const SpriteFont *font, int x, int y, const Color &color, const char *format, ...)
@@ -502,7 +490,7 @@ bool SpriteBatch::ClipSpriteCoords(float &left, float &top, float &right, float
 	return true;
 }
 
-void SpriteBatch::SetSpriteInfo(uint spriteIndex, const Texture *texture, float destLeft, float destTop, float destRight, float destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color)
+void SpriteBatch::SetSpriteInfo(uint spriteIndex, const Texture *texture, float destLeft, float destTop, float destRight, float destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField)
 {
 	uint base = spriteIndex * VERTICES_PER_SPRITE;
 
@@ -522,6 +510,7 @@ void SpriteBatch::SetSpriteInfo(uint spriteIndex, const Texture *texture, float
 	m_vertices->SetColor(base + 3, color);
 	
 	m_textures[spriteIndex] = texture;
+	m_textureIsDistanceField[spriteIndex] = isDistanceField;
 }
 
 void SpriteBatch::End()
@@ -538,13 +527,13 @@ void SpriteBatch::End()
 	}
 
 	if (m_isRenderStateOverridden)
-		m_overrideRenderState.Apply();
+		m_overrideRenderState.Apply(m_graphicsDevice);
 	else
-		m_renderState->Apply();
+		m_renderState->Apply(m_graphicsDevice);
 	if (m_isBlendStateOverridden)
-		m_overrideBlendState.Apply();
+		m_overrideBlendState.Apply(m_graphicsDevice);
 	else
-		m_blendState->Apply();
+		m_blendState->Apply(m_graphicsDevice);
 
 	m_graphicsDevice->BindShader(m_shader);
 	m_shader->SetModelViewMatrix(IDENTITY_MATRIX);
@@ -600,6 +589,7 @@ void SpriteBatch::RenderQueueRange(uint firstSpriteIndex, uint lastSpriteIndex)
 	
 	m_graphicsDevice->BindTexture(texture);
 	m_shader->SetTextureHasAlphaOnly(hasAlphaOnly);
+	m_shader->SetTextureIsDistanceField(m_textureIsDistanceField[firstSpriteIndex]);
 	m_graphicsDevice->RenderTriangles(startVertexIndex, (lastVertexIndex - startVertexIndex) / 3);
 }
 
@@ -620,6 +610,7 @@ void SpriteBatch::AddMoreSpriteSpace(uint numSprites)
 	m_vertices->Extend(numVerticesToAdd);
 	m_indices->Extend(numIndicesToAdd);
 	m_textures.resize(newTextureArraySize, NULL);
+	m_textureIsDistanceField.resize(newTextureArraySize, false);
 
 	uint newSpriteCount = m_vertices->GetNumElements() / VERTICES_PER_SPRITE;
 	
@@ -642,6 +633,15 @@ void SpriteBatch::FillSpriteIndicesFor(uint firstSprite, uint lastSprite)
 	}
 }
 
+const TextLayout* SpriteBatch::LayOutText(const SpriteFont *font, const char *text, float scale)
+{
+	// always laid out from scratch. the layout would otherwise keep it's
+	// quads if the font pointer happened to be reused by a newly loaded font
+	m_textLayout->Clear();
+	m_textLayout->Set(font, text, scale);
+	return m_textLayout;
+}
+
 inline int SpriteBatch::FixYCoord(int y, uint sourceHeight) const
 {
 	return m_graphicsDevice->GetViewContext()->GetViewportHeight() - y - sourceHeight;
@@ -9,10 +9,12 @@
 #include "../math/rectf.h"
 #include <stl/vector.h>
 
+struct DynamicTextureAtlasTile;
 class GraphicsDevice;
 class IndexBuffer;
 class SpriteFont;
 class SpriteShader;
+class TextLayout;
 class Texture;
 class TextureAtlas;
 class VertexBuffer;
@@ -199,6 +201,26 @@ public:
 	 */
 	void Render(const TextureAtlas *atlas, uint index, const Vector3 &worldPosition, uint width, uint height, const Color &color = COLOR_WHITE);
 
+	/**
+	 * Renders an image packed into a dynamic texture atlas as a sprite.
+	 * @param tile the packed image to render
+	 * @param x X coordinate to render at
+	 * @param y Y coordinate to render at
+	 * @param color color to tint the texture with
+	 */
+	void Render(const DynamicTextureAtlasTile &tile, int x, int y, const Color &color = COLOR_WHITE);
+
+	/**
+	 * Renders an image packed into a dynamic texture atlas as a sprite.
+	 * @param tile the packed image to render
+	 * @param x X coordinate to render at
+	 * @param y Y coordinate to render at
+	 * @param width custom width to scale the texture to during rendering
+	 * @param height custom height to scale the texture to during rendering
+	 * @param color color to tint the texture with
+	 */
+	void Render(const DynamicTextureAtlasTile &tile, int x, int y, uint width, uint height, const Color &color = COLOR_WHITE);
+
 	/**
 	 * Renders text as series of sprites.
 	 * @param font the font to render with
@@ -243,6 +265,26 @@ public:
 	 */
 	void Render(const SpriteFont *font, const Vector3 &worldPosition, const Color &color, float scale, const char *text);
 
+	/**
+	 * Renders previously laid out text as a series of sprites. This is the
+	 * cheapest way to render text that doesn't change every frame.
+	 * @param layout the laid out text to render
+	 * @param x X coordinate to begin rendering at
+	 * @param y Y coordinate to begin rendering at
+	 * @param color the color to render the text in
+	 */
+	void Render(const TextLayout *layout, int x, int y, const Color &color);
+
+	/**
+	 * Renders previously laid out text as a series of sprites. The given
+	 * world position will be projected to 2D screen coordinates where the
+	 * text will be centered on and rendered at.
+	 * @param layout the laid out text to render
+	 * @param worldPosition 3D world position to render at
+	 * @param color the color to render the text in
+	 */
+	void Render(const TextLayout *layout, const Vector3 &worldPosition, const Color &color);
+
 	/**
 	 * Renders formatted text as series of sprites.
 	 * @param font the font to render with
@@ -323,7 +365,7 @@ private:
 	void AddSprite(const Texture *texture, int destLeft, int destTop, int destRight, int destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
 	void AddSprite(const Texture *texture, float destLeft, float destTop, float destRight, float destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
 	bool ClipSpriteCoords(float &left, float &top, float &right, float &bottom, float &texCoordLeft, float &texCoordTop, float &texCoordRight, float &texCoordBottom);
-	void SetSpriteInfo(uint spriteIndex, const Texture *texture, float destLeft, float destTop, float destRight, float destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color);
+	void SetSpriteInfo(uint spriteIndex, const Texture *texture, float destLeft, float destTop, float destRight, float destBottom, float texCoordLeft, float texCoordTop, float texCoordRight, float texCoordBottom, const Color &color, bool isDistanceField = false);
 
 	void RenderQueue();
 	void RenderQueueRange(uint firstSpriteIndex, uint lastSpriteIndex);
@@ -332,6 +374,8 @@ private:
 	void AddMoreSpriteSpace(uint numSprites);
 	void FillSpriteIndicesFor(uint firstSprite, uint lastSprite);
 
+	const TextLayout* LayOutText(const SpriteFont *font, const char *text, float scale);
+
 	int FixYCoord(int y, uint sourceHeight) const;
 	float FixYCoord(int y, float sourceHeight) const;
 
@@ -346,11 +390,13 @@ private:
 	VertexBuffer *m_vertices;
 	IndexBuffer *m_indices;
 	stl::vector<const Texture*> m_textures;
+	stl::vector<bool> m_textureIsDistanceField;
 	uint m_currentSpritePointer;
 	Matrix4x4 m_previousProjection;
 	Matrix4x4 m_previousModelview;
 	bool m_isClipping;
 	RectF m_clipRegion;
+	TextLayout *m_textLayout;
 
 	bool m_begunRendering;
 };
@@ -1,49 +1,210 @@
+#include "../debug.h"
+#include "../log.h"
+
 #include "spritefont.h"
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 
+#include "dynamictextureatlas.h"
 #include "graphicsdevice.h"
+#include "image.h"
+#include "spritefontglyphcache.h"
+#include "textlayout.h"
 #include "texture.h"
 #include "textureatlas.h"
 
+// distance field glyphs are rasterized at this many times their size so
+// that the distances to their edges can be worked out more accurately
+const uint DISTANCE_FIELD_GLYPH_OVERSAMPLING = 4;
+
+const Texture* SpriteFontGlyph::GetTexture() const
+{
+	if (page == NULL)
+		return NULL;
+	else
+		return page->GetTexture();
+}
+
 SpriteFont::SpriteFont()
 {
 	m_size = 0;
-	m_texture = NULL;
-	m_glyphs = NULL;
 	m_letterHeight = 0;
+	m_isDistanceField = false;
+	m_glyphCache = NULL;
+	m_fontData = NULL;
+	memset(&m_fontInfo, 0, sizeof(stbtt_fontinfo));
+	m_scale = 0.0f;
+	m_ascent = 0;
+	m_pageSize = 0;
+
+	for (uint i = 0; i < NUM_ASCII_GLYPHS; ++i)
+		m_asciiGlyphs[i] = NULL;
 }
 
 SpriteFont::~SpriteFont()
 {
-	SAFE_DELETE(m_glyphs);
-	SAFE_DELETE(m_texture);
+	SAFE_DELETE_ARRAY(m_fontData);
 }
 
-void SpriteFont::Load(Texture *texture, TextureAtlas *glyphs, uint size)
+bool SpriteFont::Load(SpriteFontGlyphCache *glyphCache, uint8_t *fontData, uint size, bool distanceField)
 {
-	m_texture = texture;
-	m_glyphs = glyphs;
+	ASSERT(glyphCache != NULL);
+	ASSERT(fontData != NULL);
+	ASSERT(size > 0);
+
+	SAFE_DELETE_ARRAY(m_fontData);
+	m_glyphs.clear();
+	for (uint i = 0; i < NUM_ASCII_GLYPHS; ++i)
+		m_asciiGlyphs[i] = NULL;
+
+	m_glyphCache = glyphCache;
+	m_fontData = fontData;
 	m_size = size;
-	m_letterHeight = GetGlyph(' ').dimensions.GetHeight();
+	m_isDistanceField = distanceField;
+
+	if (!stbtt_InitFont(&m_fontInfo, m_fontData, 0))
+		return false;
+
+	// need to properly scale! sizes as returned from most (all?) metric-related
+	// functions are in the font's own units, this converts them to pixels
+	m_scale = stbtt_ScaleForPixelHeight(&m_fontInfo, (float)size);
+
+	int ascent = 0;
+	int descent = 0;
+	int lineGap = 0;
+	stbtt_GetFontVMetrics(&m_fontInfo, &ascent, &descent, &lineGap);
+	m_ascent = (int)ceil(ascent * m_scale);
+	descent = (int)ceil(descent * m_scale);
+	lineGap = (int)ceil(lineGap * m_scale);
+
+	// seen some pixel/bitmap fonts that have the total ascent/descent calculated height
+	// greater then the pixel height. this just figures out this difference, if present,
+	// and sets an appropriate line gap equal to it (in these cases, linegap was 0)
+	int calculatedHeight = m_ascent - descent;
+	int heightDifference = abs(calculatedHeight - (int)size);
+	if (heightDifference != lineGap && lineGap == 0)
+		lineGap = heightDifference;
+
+	m_letterHeight = (uint)(calculatedHeight + lineGap);
+
+	// uppercase 'W' seems to be a pretty good glyph to represent the
+	// "maximum size" of glyphs in most fonts
+	int maxGlyphWidth = (int)size;
+	int wIndex = stbtt_FindGlyphIndex(&m_fontInfo, 'W');
+	if (wIndex != 0)
+	{
+		int x0, y0, x1, y1;
+		stbtt_GetGlyphBitmapBox(&m_fontInfo, wIndex, m_scale, m_scale, &x0, &y0, &x1, &y1);
+		maxGlyphWidth = x1 - x0;
+	}
+	int maxGlyphHeight = calculatedHeight;
+	if (m_isDistanceField)
+	{
+		maxGlyphWidth += DISTANCE_FIELD_GLYPH_SPREAD * 2;
+		maxGlyphHeight += DISTANCE_FIELD_GLYPH_SPREAD * 2;
+	}
+	m_pageSize = m_glyphCache->GetPageSizeFor((uint)maxGlyphWidth, (uint)maxGlyphHeight);
+
+	return true;
 }
 
-void SpriteFont::OnLostContext()
+const SpriteFontGlyph& SpriteFont::GetGlyph(uint32_t c) const
 {
-	SAFE_DELETE(m_glyphs);
-	m_letterHeight = 0;
-	SAFE_DELETE(m_texture);
+	if (c < NUM_ASCII_GLYPHS)
+	{
+		if (m_asciiGlyphs[c] == NULL)
+			m_asciiGlyphs[c] = &RasterizeGlyph(c);
+		return *m_asciiGlyphs[c];
+	}
+
+	SpriteFontGlyphMap::const_iterator itor = m_glyphs.find(c);
+	if (itor != m_glyphs.end())
+		return itor->second;
+	else
+		return RasterizeGlyph(c);
 }
 
-const TextureAtlasTile& SpriteFont::GetGlyph(unsigned char c) const
+const SpriteFontGlyph& SpriteFont::RasterizeGlyph(uint32_t c) const
 {
-	if (c < LOW_GLYPH || c > HIGH_GLYPH)
-		return m_glyphs->GetTile(HIGH_GLYPH - LOW_GLYPH);
+	ASSERT(m_fontData != NULL);
+
+	// characters not in the font get glyph index 0, which is the font's
+	// "missing glyph" glyph
+	int index = stbtt_FindGlyphIndex(&m_fontInfo, (int)c);
+
+	SpriteFontGlyph &glyph = m_glyphs[c];
+
+	int advance = 0;
+	stbtt_GetGlyphHMetrics(&m_fontInfo, index, &advance, NULL);
+	glyph.advance = (uint)ceil(advance * m_scale);
+
+	int x0, y0, x1, y1;
+	stbtt_GetGlyphBitmapBox(&m_fontInfo, index, m_scale, m_scale, &x0, &y0, &x1, &y1);
+	glyph.offsetX = x0;
+	glyph.offsetY = m_ascent + y0;
+	glyph.width = (uint)(x1 - x0);
+	glyph.height = (uint)(y1 - y0);
+
+	if (glyph.width == 0 || glyph.height == 0)
+		return glyph;
+
+	// only the glyph's own bounding box is rasterized and packed, not a
+	// full cell of the font's line height
+	Image bitmap;
+	if (m_isDistanceField)
+		RasterizeDistanceFieldGlyph(index, x0, y0, &bitmap, glyph);
+	else
+	{
+		bool bitmapCreateSuccess = bitmap.Create(glyph.width, glyph.height, IMAGE_FORMAT_ALPHA);
+		ASSERT(bitmapCreateSuccess == true);
+		bitmap.Clear();
+		stbtt_MakeGlyphBitmap(&m_fontInfo, bitmap.GetPixels(), glyph.width, glyph.height, bitmap.GetPitch(), m_scale, m_scale, index);
+	}
+
+	DynamicTextureAtlasTile tile = m_glyphCache->Add(&bitmap, m_pageSize);
+	if (tile.IsValid())
+	{
+		glyph.page = tile.atlas;
+		glyph.texCoords = tile.atlas->GetTile(tile.index).texCoords;
+	}
 	else
-		return m_glyphs->GetTile((int)c - LOW_GLYPH);
+		LOG_WARN(LOGCAT_GRAPHICS, "SpriteFont: no room in glyph cache for character %d at size %d.\n", c, m_size);
+
+	return glyph;
+}
+
+void SpriteFont::RasterizeDistanceFieldGlyph(int index, int x0, int y0, Image *bitmap, SpriteFontGlyph &glyph) const
+{
+	const int spread = (int)DISTANCE_FIELD_GLYPH_SPREAD;
+	const int oversampling = (int)DISTANCE_FIELD_GLYPH_OVERSAMPLING;
+
+	// the distance field extends out past the glyph's edges, so the glyph
+	// needs to be rendered bigger to include all of it
+	glyph.offsetX -= spread;
+	glyph.offsetY -= spread;
+	glyph.width += spread * 2;
+	glyph.height += spread * 2;
+
+	Image oversampled;
+	bool oversampledCreateSuccess = oversampled.Create(glyph.width * oversampling, glyph.height * oversampling, IMAGE_FORMAT_ALPHA);
+	ASSERT(oversampledCreateSuccess == true);
+	oversampled.Clear();
+
+	// the oversampled glyph's bounding box always fits inside the normal
+	// sized one scaled up, as both are rounded outwards
+	float oversampledScale = m_scale * (float)oversampling;
+	int ox0, oy0, ox1, oy1;
+	stbtt_GetGlyphBitmapBox(&m_fontInfo, index, oversampledScale, oversampledScale, &ox0, &oy0, &ox1, &oy1);
+	uint destX = (uint)(ox0 - (x0 - spread) * oversampling);
+	uint destY = (uint)(oy0 - (y0 - spread) * oversampling);
+	stbtt_MakeGlyphBitmap(&m_fontInfo, oversampled.Get(destX, destY), ox1 - ox0, oy1 - oy0, oversampled.GetPitch(), oversampledScale, oversampledScale, index);
+
+	bool bitmapCreateSuccess = bitmap->CreateDistanceField(&oversampled, DISTANCE_FIELD_GLYPH_SPREAD, DISTANCE_FIELD_GLYPH_OVERSAMPLING);
+	ASSERT(bitmapCreateSuccess == true);
 }
 
 void SpriteFont::MeasureString(uint *width, uint *height, const char *format, ...) const
@@ -58,34 +219,7 @@ void SpriteFont::MeasureString(uint *width, uint *height, const char *format, ..
 	vsnprintf(buffer, 8095, format, args);
 	va_end(args);
 
-	size_t textLength = strlen(buffer);
-
-	uint currentMaxWidth = 0;
-	uint left = 0;
-	int numLines = 1;
-
-	for (size_t i = 0; i < textLength; ++i)
-	{
-		char c = buffer[i];
-		if (c == '\n')
-		{
-			// new line
-			left = 0;
-			++numLines;
-		}
-		else
-		{
-			const TextureAtlasTile &glyph = GetGlyph(c);
-			left += glyph.dimensions.GetWidth();
-		}
-
-		currentMaxWidth = Max(left, currentMaxWidth);
-	}
-
-	if (width != NULL)
-		*width = currentMaxWidth;
-	if (height != NULL)
-		*height = (uint)(numLines * GetLetterHeight());
+	TextLayout::Measure(this, buffer, 1.0f, width, height);
 }
 
 void SpriteFont::MeasureString(uint *width, uint *height, float scale, const char *format, ...) const
@@ -100,35 +234,5 @@ void SpriteFont::MeasureString(uint *width, uint *height, float scale, const cha
 	vsnprintf(buffer, 8095, format, args);
 	va_end(args);
 
-	size_t textLength = strlen(buffer);
-
-	float scaledLetterHeight = (float)GetLetterHeight() * scale;
-
-	float currentMaxWidth = 0;
-	float x = 0;
-	int numLines = 1;
-
-	for (size_t i = 0; i < textLength; ++i)
-	{
-		char c = buffer[i];
-		if (c == '\n')
-		{
-			// new line
-			x = 0.0f;
-			++numLines;
-		}
-		else
-		{
-			const TextureAtlasTile &glyph = GetGlyph(c);
-			x += ((float)glyph.dimensions.GetWidth() * scale);
-		}
-
-		currentMaxWidth = Max(x, currentMaxWidth);
-	}
-
-	if (width != NULL)
-		*width = (uint)ceil(currentMaxWidth);
-	if (height != NULL)
-		*height = (uint)(numLines * scaledLetterHeight);
+	TextLayout::Measure(this, buffer, scale, width, height);
 }
-
@@ -3,18 +3,74 @@
 
 #include "../common.h"
 #include "../content/content.h"
+#include "../math/rectf.h"
 #include "../util/typesystem.h"
+#include <stb_truetype.h>
+#include <stl/map.h>
 
+class Image;
+class SpriteFontGlyphCache;
 class Texture;
 class TextureAtlas;
-struct TextureAtlasTile;
 
-const int LOW_GLYPH = 32;
-const int HIGH_GLYPH = 127;
+const uint NUM_ASCII_GLYPHS = 128;
+
+// distance in pixels around each distance field glyph's edges that the
+// distance field extends out to
+const uint DISTANCE_FIELD_GLYPH_SPREAD = 4;
 
 /**
- * Represents a font that has been pre-rendered at a given size to a 
- * texture atlas so that text can be rendered quickly as sprites.
+ * Information about a single rasterized glyph and where it is located in
+ * the font's glyph cache. Offsets and dimensions are in pixels, relative
+ * to the top-left of the line of text the glyph is on, with Y increasing
+ * downwards.
+ */
+struct SpriteFontGlyph
+{
+	// the glyph cache page the glyph is on, or NULL if the glyph has
+	// nothing visible to render (e.g. whitespace)
+	const TextureAtlas *page;
+	RectF texCoords;
+
+	int offsetX;
+	int offsetY;
+	uint width;
+	uint height;
+
+	// horizontal distance to move to the next glyph after this one
+	uint advance;
+
+	SpriteFontGlyph()
+	{
+		page = NULL;
+		offsetX = 0;
+		offsetY = 0;
+		width = 0;
+		height = 0;
+		advance = 0;
+	}
+
+	/**
+	 * @return the texture to render this glyph with, or NULL if it has
+	 *         nothing visible to render
+	 */
+	const Texture* GetTexture() const;
+};
+
+typedef stl::map<uint32_t, SpriteFontGlyph> SpriteFontGlyphMap;
+
+/**
+ * Represents a TrueType font at a given size which has it's glyphs
+ * rasterized into a SpriteFontGlyphCache so that text can be rendered
+ * quickly as sprites. Glyphs are only rasterized when they are first
+ * used, so any character the font file contains can be rendered. Text
+ * is expected to be UTF-8 encoded.
+ *
+ * Fonts can instead have their glyphs stored as signed distance fields,
+ * which stay sharp when scaled. A single distance field font can then be
+ * used to render text at any size by rendering it with a scale factor
+ * (see GetScaleFor()). Distance field glyphs need to be rendered with a
+ * shader that supports them, which all of the built-in sprite shaders do.
  */
 class SpriteFont : public Content
 {
@@ -28,45 +84,57 @@ public:
 	virtual ~SpriteFont();
 
 	/**
-	 * Populates this sprite font object with texture and glyph data
-	 * necessary for rendering with it.
-	 * @param texture the texture containing the font glyphs. This texture
-	 *                is expected to have been manually created and not
-	 *                loaded through ContentManager.
-	 * @param glyphs texture atlas with pre-defined sub-textures corresponding
-	 *               to the font's individual characters (glyphs)
-	 * @param size the size that the glyphs were rendered at
+	 * Prepares this sprite font object for rendering with. No glyphs are
+	 * rasterized yet.
+	 * @param glyphCache the glyph cache to rasterize glyphs into. this
+	 *                   must stay alive for as long as this font does
+	 * @param fontData the TrueType font file's contents. must have been
+	 *                 allocated with new[] and will be owned and freed by
+	 *                 this font
+	 * @param size the pixel height to rasterize glyphs at
+	 * @param distanceField true to store glyphs as signed distance fields.
+	 *                      the glyph cache should only be used by other
+	 *                      distance field fonts in this case
+	 * @return true if the font data could be read
 	 */
-	void Load(Texture *texture, TextureAtlas *glyphs, uint size);
+	bool Load(SpriteFontGlyphCache *glyphCache, uint8_t *fontData, uint size, bool distanceField = false);
 
 	/**
-	 * Lost OpenGL graphics context callback. This will free the texture
-	 * and texture atlas passed to Load().
+	 * @return the size that the glyphs are rasterized at
 	 */
-	void OnLostContext();
+	uint GetSize() const                                   { return m_size; }
 
 	/**
-	 * @return the size that the glyphs were originally rendered at
+	 * @return the number of pixels that one line of text rendered with this
+	 *         font takes up
 	 */
-	uint GetSize() const                                   { return m_size; }
+	uint GetLetterHeight() const                           { return m_letterHeight; }
 
 	/**
-	 * @return the texture containing the font glyphs
+	 * @return true if glyphs are stored as signed distance fields
 	 */
-	const Texture* GetTexture() const                      { return m_texture; }
+	bool IsDistanceField() const                           { return m_isDistanceField; }
 
 	/**
-	 * @return the number of pixels that one line of text rendered with this
-	 *         font takes up
+	 * @param pixelSize the pixel height that text should be rendered at
+	 * @return the scale factor to render text with for it to be the given
+	 *         size. this should only be far from 1.0 for distance field fonts
 	 */
-	uint GetLetterHeight() const                           { return m_letterHeight; }
+	float GetScaleFor(uint pixelSize) const                { return (float)pixelSize / (float)m_size; }
+
+	/**
+	 * Gets a glyph, rasterizing it into the glyph cache first if this is
+	 * the first time it has been asked for. Characters the font doesn't
+	 * contain get the font's "missing glyph" glyph.
+	 * @param c the character to get the glyph for
+	 * @return the glyph's dimensions and position in the glyph cache
+	 */
+	const SpriteFontGlyph& GetGlyph(uint32_t c) const;
 
 	/**
-	 * @param c the character to get sub-texture dimensions/positioning for
-	 * @return the sub-texture dimensions/position corresponding with
-	 *         the specified character
+	 * @return the number of different glyphs that have been rasterized
 	 */
-	const TextureAtlasTile& GetGlyph(unsigned char c) const;
+	uint GetNumRasterizedGlyphs() const                    { return m_glyphs.size(); }
 
 	/**
 	 * Measures the given string of text and returns the width and height
@@ -88,11 +156,22 @@ public:
 	void MeasureString(uint *width, uint *height, float scale, const char *format, ...) const;
 
 private:
-	uint m_size;
+	const SpriteFontGlyph& RasterizeGlyph(uint32_t c) const;
+	void RasterizeDistanceFieldGlyph(int index, int x0, int y0, Image *bitmap, SpriteFontGlyph &glyph) const;
 
-	Texture *m_texture;
-	TextureAtlas *m_glyphs;
+	uint m_size;
 	uint m_letterHeight;
+	bool m_isDistanceField;
+
+	SpriteFontGlyphCache *m_glyphCache;
+	uint8_t *m_fontData;
+	stbtt_fontinfo m_fontInfo;
+	float m_scale;
+	int m_ascent;
+	uint m_pageSize;
+
+	mutable SpriteFontGlyphMap m_glyphs;
+	mutable const SpriteFontGlyph *m_asciiGlyphs[NUM_ASCII_GLYPHS];
 };
 
 #endif
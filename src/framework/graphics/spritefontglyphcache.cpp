@@ -0,0 +1,120 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "spritefontglyphcache.h"
+
+#include "dynamictextureatlas.h"
+#include "graphicsdevice.h"
+#include "image.h"
+#include "../math/mathhelpers.h"
+#include <math.h>
+
+// printable ASCII, which is what most text will be using most of the time
+const uint PAGE_SIZE_GLYPH_COUNT = 96;
+const uint MIN_PAGE_SIZE = 64;
+
+SpriteFontGlyphCache::SpriteFontGlyphCache(GraphicsDevice *graphicsDevice, uint maxPageSize, uint padding)
+{
+	ASSERT(graphicsDevice != NULL);
+	ASSERT(maxPageSize >= MIN_PAGE_SIZE);
+	ASSERT(IsPowerOf2(maxPageSize));
+
+	m_graphicsDevice = graphicsDevice;
+	m_maxPageSize = maxPageSize;
+	m_padding = padding;
+}
+
+SpriteFontGlyphCache::~SpriteFontGlyphCache()
+{
+	Clear();
+}
+
+uint SpriteFontGlyphCache::GetPageSizeFor(uint maxGlyphWidth, uint maxGlyphHeight) const
+{
+	uint cellWidth = maxGlyphWidth + m_padding;
+	uint cellHeight = maxGlyphHeight + m_padding;
+
+	// glyphs are packed tightly, so most of them will take up quite a bit
+	// less than this. but rounding the area up to the next power of two
+	// page size can also leave quite a bit free, so this is close enough
+	uint area = cellWidth * cellHeight * PAGE_SIZE_GLYPH_COUNT;
+	uint size = GetNextPowerOf2((uint)ceilf(sqrtf((float)area)));
+
+	// the page should always be able to hold the largest glyph at least
+	size = Max(size, GetNextPowerOf2(Max(cellWidth, cellHeight)));
+
+	return Clamp(size, MIN_PAGE_SIZE, m_maxPageSize);
+}
+
+DynamicTextureAtlasTile SpriteFontGlyphCache::Add(const Image *glyph, uint newPageSize)
+{
+	ASSERT(glyph != NULL);
+	ASSERT(glyph->GetFormat() == IMAGE_FORMAT_ALPHA);
+
+	DynamicTextureAtlasTile tile;
+	newPageSize = Clamp(GetNextPowerOf2(newPageSize), MIN_PAGE_SIZE, m_maxPageSize);
+	if (glyph->GetWidth() + m_padding > m_maxPageSize || glyph->GetHeight() + m_padding > m_maxPageSize)
+	{
+		LOG_WARN(LOGCAT_GRAPHICS, "SpriteFontGlyphCache: %d x %d glyph does not fit in a %d x %d page.\n", glyph->GetWidth(), glyph->GetHeight(), m_maxPageSize, m_maxPageSize);
+		return tile;
+	}
+
+	// any page will do, regardless of which font allocated it. most recently
+	// allocated pages are the most likely to still have room
+	for (int i = (int)m_pages.size() - 1; i >= 0; --i)
+	{
+		if (m_pages[i]->Add(glyph, tile.index))
+		{
+			tile.atlas = m_pages[i];
+			return tile;
+		}
+	}
+
+	// the requested size might be too small for an unusually large glyph
+	while (newPageSize < m_maxPageSize && (glyph->GetWidth() + m_padding > newPageSize || glyph->GetHeight() + m_padding > newPageSize))
+		newPageSize *= 2;
+
+	LOG_INFO(LOGCAT_GRAPHICS, "SpriteFontGlyphCache: allocating page %d (%d x %d).\n", m_pages.size(), newPageSize, newPageSize);
+	DynamicTextureAtlas *page = new DynamicTextureAtlas(m_graphicsDevice, newPageSize, newPageSize, m_padding, IMAGE_FORMAT_ALPHA);
+	m_pages.push_back(page);
+
+	if (page->Add(glyph, tile.index))
+		tile.atlas = page;
+
+	return tile;
+}
+
+void SpriteFontGlyphCache::Clear()
+{
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+	{
+		DynamicTextureAtlas *page = *i;
+		SAFE_DELETE(page);
+	}
+	m_pages.clear();
+}
+
+uint SpriteFontGlyphCache::GetTotalPageArea() const
+{
+	uint area = 0;
+	for (DynamicTextureAtlasPages::const_iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+		area += (*i)->GetWidth() * (*i)->GetHeight();
+
+	return area;
+}
+
+void SpriteFontGlyphCache::OnNewContext()
+{
+	LOG_INFO(LOGCAT_GRAPHICS, "SpriteFontGlyphCache: recreating %d page textures for new OpenGL context.\n", m_pages.size());
+
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+		(*i)->OnNewContext();
+}
+
+void SpriteFontGlyphCache::OnLostContext()
+{
+	LOG_INFO(LOGCAT_GRAPHICS, "SpriteFontGlyphCache: resetting page textures due to lost OpenGL context.\n");
+
+	for (DynamicTextureAtlasPages::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+		(*i)->OnLostContext();
+}
@@ -0,0 +1,94 @@
+#ifndef __FRAMEWORK_GRAPHICS_SPRITEFONTGLYPHCACHE_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_SPRITEFONTGLYPHCACHE_H_INCLUDED__
+
+#include "../common.h"
+#include "dynamictextureatlasmanager.h"
+#include <stl/vector.h>
+
+class GraphicsDevice;
+class Image;
+
+/**
+ * Alpha-only atlas pages that rasterized sprite font glyphs are packed
+ * into as they are needed. Pages are shared between all fonts using the
+ * cache, so several fonts (or sizes of the same font) can end up rendering
+ * from the same texture. Each page's size is decided when it is allocated,
+ * based on the glyph dimensions of the font that needed it, so small fonts
+ * don't take up large textures.
+ *
+ * Glyphs are never removed from the pages once added, only when the whole
+ * cache is cleared.
+ */
+class SpriteFontGlyphCache
+{
+public:
+	/**
+	 * Creates an empty glyph cache. No pages are allocated until the first
+	 * glyph is added.
+	 * @param graphicsDevice the graphics device used to create textures with
+	 * @param maxPageSize the maximum width and height in pixels of each page
+	 * @param padding the number of empty pixels to leave between glyphs
+	 */
+	SpriteFontGlyphCache(GraphicsDevice *graphicsDevice, uint maxPageSize = 1024, uint padding = 1);
+
+	virtual ~SpriteFontGlyphCache();
+
+	/**
+	 * Works out the page size to use for new pages allocated for a font,
+	 * such that one page can hold around the printable ASCII character
+	 * set of that font.
+	 * @param maxGlyphWidth the width in pixels of the font's widest glyphs
+	 * @param maxGlyphHeight the height in pixels of the font's tallest glyphs
+	 * @return the width and height in pixels to allocate new pages at
+	 */
+	uint GetPageSizeFor(uint maxGlyphWidth, uint maxGlyphHeight) const;
+
+	/**
+	 * Packs a rasterized glyph into the first page that has room for it,
+	 * allocating a new page if none do.
+	 * @param glyph the glyph's alpha-only image
+	 * @param newPageSize the width and height in pixels to allocate a new
+	 *                    page at, if one is needed
+	 * @return the location of the packed glyph, or an invalid tile if the
+	 *         glyph is larger than the maximum page size
+	 */
+	DynamicTextureAtlasTile Add(const Image *glyph, uint newPageSize);
+
+	/**
+	 * Frees all pages. Any glyphs previously added will be invalid.
+	 */
+	void Clear();
+
+	/**
+	 * @return the number of pages currently allocated
+	 */
+	uint GetNumPages() const                               { return m_pages.size(); }
+
+	/**
+	 * @return the page at the given index
+	 */
+	DynamicTextureAtlas* GetPage(uint index) const         { return m_pages[index]; }
+
+	/**
+	 * @return the total number of pixels taken up by all allocated pages
+	 */
+	uint GetTotalPageArea() const;
+
+	/**
+	 * New OpenGL graphics context creation callback.
+	 */
+	void OnNewContext();
+
+	/**
+	 * Lost OpenGL graphics context callback.
+	 */
+	void OnLostContext();
+
+private:
+	GraphicsDevice *m_graphicsDevice;
+	uint m_maxPageSize;
+	uint m_padding;
+	DynamicTextureAtlasPages m_pages;
+};
+
+#endif
@@ -4,15 +4,45 @@
 
 SpriteShader::SpriteShader()
 {
+	m_textureHasAlphaOnlyHandle = INVALID_SHADER_UNIFORM_HANDLE;
 	SetTextureHasAlphaOnlyUniform("u_textureHasAlphaOnly");
+	m_textureIsDistanceFieldHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	SetTextureIsDistanceFieldUniform("u_textureIsDistanceField");
 }
 
 SpriteShader::~SpriteShader()
 {
 }
 
+void SpriteShader::Release()
+{
+	m_textureHasAlphaOnlyHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_textureIsDistanceFieldHandle = INVALID_SHADER_UNIFORM_HANDLE;
+
+	StandardShader::Release();
+}
+
 void SpriteShader::SetTextureHasAlphaOnly(bool hasAlphaOnly)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_textureHasAlphaOnlyUniform, (int)hasAlphaOnly);
+	if (m_textureHasAlphaOnlyHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_textureHasAlphaOnlyHandle = GetUniformHandle(m_textureHasAlphaOnlyUniform);
+	SetUniform(m_textureHasAlphaOnlyHandle, (int)hasAlphaOnly);
+}
+
+void SpriteShader::SetTextureIsDistanceField(bool isDistanceField)
+{
+	ASSERT(IsReadyForUse() == true);
+	if (m_textureIsDistanceFieldHandle == INVALID_SHADER_UNIFORM_HANDLE)
+	{
+		// custom sprite shaders aren't required to support this
+		if (!HasUniform(m_textureIsDistanceFieldUniform))
+			return;
+		m_textureIsDistanceFieldHandle = GetUniformHandle(m_textureIsDistanceFieldUniform);
+	}
+	SetUniform(m_textureIsDistanceFieldHandle, (int)isDistanceField);
+}
+
+void SpriteShader::SetCamera(const Vector3 &position, const Vector3 &forward)
+{
 }
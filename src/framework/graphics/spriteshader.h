@@ -5,6 +5,8 @@
 #include "standardshader.h"
 #include <stl/string.h>
 
+struct Vector3;
+
 /**
  * Base class for shaders which will be used to render sprites primarily.
  */
@@ -13,6 +15,11 @@ class SpriteShader : public StandardShader
 public:
 	virtual ~SpriteShader();
 
+	/**
+	 * Releases all resources associated with this shader.
+	 */
+	virtual void Release();
+
 	/**
 	 * Sets whether the texture that will be used for rendering consists
 	 * of only an alpha channel (no RGB information). This will affect
@@ -21,6 +28,23 @@ public:
 	 */
 	void SetTextureHasAlphaOnly(bool hasAlphaOnly);
 
+	/**
+	 * Sets whether the texture that will be used for rendering contains
+	 * signed distance fields in it's alpha channel instead of coverage
+	 * values. Shaders which don't support distance field textures will
+	 * ignore this.
+	 * @param isDistanceField whether the texture contains distance fields
+	 */
+	void SetTextureIsDistanceField(bool isDistanceField);
+
+	/**
+	 * Sets the camera that sprites should face, for shaders which orient
+	 * sprites themselves. Shaders which don't will ignore this.
+	 * @param position the camera's position
+	 * @param forward the camera's forward direction
+	 */
+	virtual void SetCamera(const Vector3 &position, const Vector3 &forward);
+
 protected:
 	/**
 	 * Initializes standard uniform information to defaults.
@@ -36,10 +60,24 @@ protected:
 	 * Sets the name of the "texture has only an alpha component" uniform.
 .	 * @param name the name of the uniform
 	 */
-	void SetTextureHasAlphaOnlyUniform(const stl::string &name)    { m_textureHasAlphaOnlyUniform = name; }
+	void SetTextureHasAlphaOnlyUniform(const stl::string &name)    { m_textureHasAlphaOnlyUniform = name; m_textureHasAlphaOnlyHandle = INVALID_SHADER_UNIFORM_HANDLE; }
+
+	/**
+	 * @return the name of the "texture contains distance fields" uniform
+	 */
+	const stl::string& GetTextureIsDistanceFieldUniform() const    { return m_textureIsDistanceFieldUniform; }
+
+	/**
+	 * Sets the name of the "texture contains distance fields" uniform.
+	 * @param name the name of the uniform
+	 */
+	void SetTextureIsDistanceFieldUniform(const stl::string &name) { m_textureIsDistanceFieldUniform = name; m_textureIsDistanceFieldHandle = INVALID_SHADER_UNIFORM_HANDLE; }
 
 private:
 	stl::string m_textureHasAlphaOnlyUniform;
+	ShaderUniformHandle m_textureHasAlphaOnlyHandle;
+	stl::string m_textureIsDistanceFieldUniform;
+	ShaderUniformHandle m_textureIsDistanceFieldHandle;
 };
 
 #endif
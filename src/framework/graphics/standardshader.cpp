@@ -7,6 +7,8 @@ StandardShader::StandardShader()
 {
 	m_inlineVertexShaderSource = NULL;
 	m_inlineFragmentShaderSource = NULL;
+	m_modelViewMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_projectionMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE;
 
 	SetModelViewMatrixUniform("u_modelViewMatrix");
 	SetProjectionMatrixUniform("u_projectionMatrix");
@@ -16,6 +18,14 @@ StandardShader::~StandardShader()
 {
 }
 
+void StandardShader::Release()
+{
+	m_modelViewMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_projectionMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE;
+
+	Shader::Release();
+}
+
 bool StandardShader::LoadCompileAndLinkInlineSources(const char *inlineVertexShaderSource, const char *inlineFragmentShaderSource)
 {
 	ASSERT(inlineVertexShaderSource != NULL);
@@ -36,13 +46,17 @@ bool StandardShader::LoadCompileAndLinkInlineSources(const char *inlineVertexSha
 void StandardShader::SetModelViewMatrix(const Matrix4x4 &matrix)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_modelViewMatrixUniform, matrix);
+	if (m_modelViewMatrixHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_modelViewMatrixHandle = GetUniformHandle(m_modelViewMatrixUniform);
+	SetUniform(m_modelViewMatrixHandle, matrix);
 }
 
 void StandardShader::SetProjectionMatrix(const Matrix4x4 &matrix)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_projectionMatrixUniform, matrix);
+	if (m_projectionMatrixHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_projectionMatrixHandle = GetUniformHandle(m_projectionMatrixUniform);
+	SetUniform(m_projectionMatrixHandle, matrix);
 }
 
 void StandardShader::OnNewContext()
@@ -15,6 +15,11 @@ class StandardShader : public Shader
 public:
 	virtual ~StandardShader();
 
+	/**
+	 * Releases all resources associated with this shader.
+	 */
+	virtual void Release();
+
 	/**
 	 * Sets the modelview matrix uniform.
 	 * @param matrix the matrix to set
@@ -67,17 +72,19 @@ protected:
 	 * Sets the name of the modelview matrix uniform.
 .	 * @param name the name of the uniform
 	 */
-	void SetModelViewMatrixUniform(const stl::string &name)        { m_modelViewMatrixUniform = name; }
+	void SetModelViewMatrixUniform(const stl::string &name)        { m_modelViewMatrixUniform = name; m_modelViewMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE; }
 
 	/**
 	 * Sets the name of the projection matrix uniform.
 	 * @param name the name of the uniform
 	 */
-	void SetProjectionMatrixUniform(const stl::string &name)       { m_projectionMatrixUniform = name; }
+	void SetProjectionMatrixUniform(const stl::string &name)       { m_projectionMatrixUniform = name; m_projectionMatrixHandle = INVALID_SHADER_UNIFORM_HANDLE; }
 
 private:
 	stl::string m_modelViewMatrixUniform;
 	stl::string m_projectionMatrixUniform;
+	ShaderUniformHandle m_modelViewMatrixHandle;
+	ShaderUniformHandle m_projectionMatrixHandle;
 
 	const char *m_inlineVertexShaderSource;
 	const char *m_inlineFragmentShaderSource;
@@ -0,0 +1,115 @@
+#include "../debug.h"
+
+#include "textlayout.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "spritefont.h"
+#include "../util/utf8.h"
+
+const size_t PRINTF_BUFFER_SIZE = 8192;
+char __textLayout_printfBuffer[PRINTF_BUFFER_SIZE + 1];
+
+TextLayout::TextLayout()
+{
+	m_font = NULL;
+	m_scale = 1.0f;
+	m_width = 0;
+	m_height = 0;
+}
+
+TextLayout::~TextLayout()
+{
+}
+
+void TextLayout::Set(const SpriteFont *font, const char *text, float scale)
+{
+	ASSERT(font != NULL);
+	ASSERT(text != NULL);
+
+	if (font == m_font && scale == m_scale && m_text == text)
+		return;
+
+	m_font = font;
+	m_text = text;
+	m_scale = scale;
+
+	// keeps the quad list's storage around for the next layout
+	m_quads.clear();
+	LayOut(m_font, m_text.c_str(), m_scale, &m_quads, &m_width, &m_height);
+}
+
+void TextLayout::Printf(const SpriteFont *font, float scale, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vsnprintf(__textLayout_printfBuffer, PRINTF_BUFFER_SIZE, format, args);
+	va_end(args);
+
+	Set(font, __textLayout_printfBuffer, scale);
+}
+
+void TextLayout::Clear()
+{
+	m_font = NULL;
+	m_text.clear();
+	m_scale = 1.0f;
+	m_width = 0;
+	m_height = 0;
+	m_quads.clear();
+}
+
+void TextLayout::Measure(const SpriteFont *font, const char *text, float scale, uint *width, uint *height)
+{
+	LayOut(font, text, scale, NULL, width, height);
+}
+
+void TextLayout::LayOut(const SpriteFont *font, const char *text, float scale, TextLayoutQuads *quads, uint *width, uint *height)
+{
+	ASSERT(font != NULL);
+	ASSERT(text != NULL);
+
+	float scaledLetterHeight = (float)font->GetLetterHeight() * scale;
+
+	float currentMaxWidth = 0.0f;
+	float drawX = 0.0f;
+	float drawY = 0.0f;
+	int numLines = 1;
+
+	while (*text != '\0')
+	{
+		uint32_t c = DecodeUtf8(text);
+		if (c == '\n')
+		{
+			// new line
+			drawX = 0.0f;
+			drawY += scaledLetterHeight;
+			++numLines;
+		}
+		else
+		{
+			const SpriteFontGlyph &glyph = font->GetGlyph(c);
+			if (quads != NULL && glyph.page != NULL)
+			{
+				TextLayoutQuad quad;
+				quad.page = glyph.page;
+				quad.position.left = drawX + (float)glyph.offsetX * scale;
+				quad.position.top = drawY + (float)glyph.offsetY * scale;
+				quad.position.right = quad.position.left + (float)glyph.width * scale;
+				quad.position.bottom = quad.position.top + (float)glyph.height * scale;
+				quad.texCoords = glyph.texCoords;
+				quads->push_back(quad);
+			}
+
+			drawX += (float)glyph.advance * scale;
+			currentMaxWidth = Max(drawX, currentMaxWidth);
+		}
+	}
+
+	if (width != NULL)
+		*width = (uint)ceil(currentMaxWidth);
+	if (height != NULL)
+		*height = (uint)(numLines * scaledLetterHeight);
+}
@@ -0,0 +1,119 @@
+#ifndef __FRAMEWORK_GRAPHICS_TEXTLAYOUT_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_TEXTLAYOUT_H_INCLUDED__
+
+#include "../common.h"
+#include "../math/rectf.h"
+#include <stl/string.h>
+#include <stl/vector.h>
+
+class SpriteFont;
+class TextureAtlas;
+
+/**
+ * A single glyph's quad within a TextLayout. Positions are in pixels,
+ * relative to the top-left of the text with Y increasing downwards.
+ */
+struct TextLayoutQuad
+{
+	const TextureAtlas *page;
+	RectF position;
+	RectF texCoords;
+};
+
+typedef stl::vector<TextLayoutQuad> TextLayoutQuads;
+
+/**
+ * Pre-computed glyph quads for a string of text rendered with a font at a
+ * given scale. Line breaks and glyph lookups are only worked out when the
+ * text, font or scale changes, so text that stays the same between frames
+ * can be rendered by just copying out the quads at some position.
+ *
+ * Layouts refer to the font's glyph cache, and so become invalid once the
+ * font they were built with is freed.
+ */
+class TextLayout
+{
+public:
+	TextLayout();
+	virtual ~TextLayout();
+
+	/**
+	 * Lays out a string of text. Nothing is done if the same text, font
+	 * and scale are already laid out.
+	 * @param font the font to render the text with
+	 * @param text the text to lay out (UTF-8)
+	 * @param scale scale factor applied to the font's glyph sizes
+	 */
+	void Set(const SpriteFont *font, const char *text, float scale = 1.0f);
+
+	/**
+	 * Lays out a formatted string of text. Nothing is done if the same
+	 * text, font and scale are already laid out.
+	 * @param font the font to render the text with
+	 * @param scale scale factor applied to the font's glyph sizes
+	 * @param format the text to lay out (UTF-8)
+	 */
+	void Printf(const SpriteFont *font, float scale, const char *format, ...);
+
+	/**
+	 * Removes all text, leaving an empty layout.
+	 */
+	void Clear();
+
+	/**
+	 * @return the font the text was laid out with
+	 */
+	const SpriteFont* GetFont() const                      { return m_font; }
+
+	/**
+	 * @return the text that was laid out
+	 */
+	const stl::string& GetText() const                     { return m_text; }
+
+	/**
+	 * @return the scale the text was laid out at
+	 */
+	float GetScale() const                                 { return m_scale; }
+
+	/**
+	 * @return the width in pixels of the widest line of text
+	 */
+	uint GetWidth() const                                  { return m_width; }
+
+	/**
+	 * @return the height in pixels of all lines of text
+	 */
+	uint GetHeight() const                                 { return m_height; }
+
+	/**
+	 * @return the number of glyph quads to be rendered
+	 */
+	uint GetNumQuads() const                               { return m_quads.size(); }
+
+	/**
+	 * @return the glyph quad at the given index
+	 */
+	const TextLayoutQuad& GetQuad(uint index) const        { return m_quads[index]; }
+
+	/**
+	 * Measures a string of text without building any glyph quads.
+	 * @param font the font to measure the text with
+	 * @param text the text to measure (UTF-8)
+	 * @param scale scale factor applied to the font's glyph sizes
+	 * @param width the width in pixels of the text if not NULL
+	 * @param height the height in pixels of the text if not NULL
+	 */
+	static void Measure(const SpriteFont *font, const char *text, float scale, uint *width, uint *height);
+
+private:
+	static void LayOut(const SpriteFont *font, const char *text, float scale, TextLayoutQuads *quads, uint *width, uint *height);
+
+	const SpriteFont *m_font;
+	stl::string m_text;
+	float m_scale;
+	uint m_width;
+	uint m_height;
+	TextLayoutQuads m_quads;
+};
+
+#endif
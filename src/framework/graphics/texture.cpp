@@ -17,6 +17,8 @@ Texture::Texture()
 	m_width = 0;
 	m_height = 0;
 	m_format = TEXTURE_FORMAT_NONE;
+	m_numMipLevels = 0;
+	m_isAlphaPremultiplied = false;
 }
 
 Texture::~Texture()
@@ -66,6 +68,8 @@ bool Texture::Create(GraphicsDevice *graphicsDevice, Image *image)
 	m_width = image->GetWidth();
 	m_height = image->GetHeight();
 	m_format = format;
+	m_numMipLevels = 1;
+	m_isAlphaPremultiplied = false;
 	
 	GL_CALL(glGenTextures(1, &m_textureName));
 	
@@ -108,6 +112,8 @@ bool Texture::Create(GraphicsDevice *graphicsDevice, uint width, uint height, TE
 	m_width = width;
 	m_height = height;
 	m_format = textureFormat;
+	m_numMipLevels = 1;
+	m_isAlphaPremultiplied = false;
 
 	GL_CALL(glGenTextures(1, &m_textureName));
 	
@@ -125,6 +131,78 @@ bool Texture::Create(GraphicsDevice *graphicsDevice, uint width, uint height, TE
 	return true;
 }
 
+bool Texture::Create(GraphicsDevice *graphicsDevice, uint width, uint height, TEXTURE_FORMAT textureFormat, const void * const *mipLevels, uint numMipLevels, bool isAlphaPremultiplied)
+{
+	ASSERT(m_textureName == 0);
+	if (m_textureName != 0)
+		return false;
+
+	ASSERT(graphicsDevice != NULL);
+	if (!graphicsDevice->IsNonPowerOfTwoTextureSupported() || numMipLevels > 1)
+	{
+		ASSERT(IsPowerOf2(width) && IsPowerOf2(height));
+		if (!IsPowerOf2(width) || !IsPowerOf2(height))
+			return false;
+	}
+
+	ASSERT(textureFormat != TEXTURE_FORMAT_DEPTH);
+	ASSERT(mipLevels != NULL);
+	ASSERT(numMipLevels > 0);
+
+	int bpp = 0;
+	uint format = 0;
+	uint type = 0;
+	GetTextureSpecsFromFormat(textureFormat, &bpp, &format, &type);
+	ASSERT(format != 0);
+	if (format == 0)
+		return false;
+	ASSERT(type != 0);
+	if (type == 0)
+		return false;
+
+	m_graphicsDevice = graphicsDevice;
+	m_width = width;
+	m_height = height;
+	m_format = textureFormat;
+	m_numMipLevels = numMipLevels;
+	m_isAlphaPremultiplied = isAlphaPremultiplied;
+
+	GL_CALL(glGenTextures(1, &m_textureName));
+
+	m_graphicsDevice->BindTexture(this, 0);
+	m_graphicsDevice->GetTextureParameters()->Apply();
+
+	// the device's texture parameters are shared by all textures and don't
+	// usually use mipmaps, so they would go to waste here without this
+	if (numMipLevels > 1)
+	{
+		MINIFICATION_FILTER minFilter = m_graphicsDevice->GetTextureParameters()->GetMinFilter();
+		if (minFilter == MIN_NEAREST)
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST));
+		else if (minFilter == MIN_LINEAR)
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+	}
+
+	// rows of smaller mip levels of RGB and alpha textures often aren't a
+	// multiple of 4 bytes long
+	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	uint levelWidth = width;
+	uint levelHeight = height;
+	for (uint i = 0; i < numMipLevels; ++i)
+	{
+		ASSERT(mipLevels[i] != NULL);
+		GL_CALL(glTexImage2D(GL_TEXTURE_2D, i, format, levelWidth, levelHeight, 0, format, type, mipLevels[i]));
+
+		levelWidth = Max(levelWidth / 2, (uint)1);
+		levelHeight = Max(levelHeight / 2, (uint)1);
+	}
+	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+	LOG_INFO(LOGCAT_GRAPHICS, "Created texture from raw pixel data. ID = %d, bpp = %d, size = %d x %d, mip levels = %d\n", m_textureName, bpp, m_width, m_height, m_numMipLevels);
+
+	return true;
+}
+
 void Texture::Release()
 {
 	if (m_textureName != 0)
@@ -140,6 +218,8 @@ void Texture::Release()
 	m_width = 0;
 	m_height = 0;
 	m_format = TEXTURE_FORMAT_NONE;
+	m_numMipLevels = 0;
+	m_isAlphaPremultiplied = false;
 }
 
 bool Texture::Update(Image *image, uint destX, uint destY)
@@ -37,6 +37,24 @@ public:
 	 * @param textureFormat the format of the pixel data this texture contains
 	 */
 	bool Create(GraphicsDevice *graphicsDevice, uint width, uint height, TEXTURE_FORMAT textureFormat);
+
+	/**
+	 * Creates a new texture from raw pixel data for each of it's mipmap
+	 * levels. The pixel data is uploaded as-is, without any conversion.
+	 * @param graphicsDevice the graphics device this texture is associated with
+	 * @param width the width of the texture in pixels
+	 * @param height the height of the texture in pixels
+	 * @param textureFormat the format of the pixel data
+	 * @param mipLevels pixel data for each mipmap level, largest first. each
+	 *                  level is half the size of the previous one (but at
+	 *                  least 1 pixel) with tightly packed rows
+	 * @param numMipLevels the number of mipmap levels. either 1, or enough
+	 *                     to go all the way down to 1x1
+	 * @param isAlphaPremultiplied true if the pixel data's color components
+	 *                             have been multiplied by it's alpha
+	 * @return true if the texture was created successfully
+	 */
+	bool Create(GraphicsDevice *graphicsDevice, uint width, uint height, TEXTURE_FORMAT textureFormat, const void * const *mipLevels, uint numMipLevels, bool isAlphaPremultiplied = false);
 	
 	/**
 	 * Frees the texture resources.
@@ -73,6 +91,17 @@ public:
 	 */
 	TEXTURE_FORMAT GetFormat() const                       { return m_format; }
 
+	/**
+	 * @return the number of mipmap levels this texture has
+	 */
+	uint GetNumMipLevels() const                           { return m_numMipLevels; }
+
+	/**
+	 * @return true if this texture's color components have been multiplied
+	 *         by it's alpha, requiring a matching blend state to render it
+	 */
+	bool IsAlphaPremultiplied() const                      { return m_isAlphaPremultiplied; }
+
 	/**
 	 * @return true if the texture has invalidated and needs to be recreated
 	 */
@@ -93,6 +122,8 @@ private:
 	uint m_width;
 	uint m_height;
 	TEXTURE_FORMAT m_format;
+	uint m_numMipLevels;
+	bool m_isAlphaPremultiplied;
 };
 
 #endif
@@ -0,0 +1,134 @@
+#ifndef __FRAMEWORK_GRAPHICS_TEXTUREFILEFORMAT_H_INCLUDED__
+#define __FRAMEWORK_GRAPHICS_TEXTUREFILEFORMAT_H_INCLUDED__
+
+#include "../common.h"
+#include "textureformats.h"
+
+/**
+ * Converted texture files hold pixel data that is ready to be uploaded
+ * to a texture as-is, optionally along with a full mipmap chain. They are
+ * created ahead of time from normal image files by the texture converter
+ * tool (tools/textureconverter) so that no decoding is needed at load time.
+ *
+ * A file begins with a TextureFileHeader, followed by one TextureFileMipLevel
+ * for each mipmap level (largest first), followed by the pixel data for each
+ * level. Pixel data rows are tightly packed. All values are little endian.
+ */
+
+const char TEXTURE_FILE_ID[4] = { 'T', 'E', 'X', 'F' };
+const uint32_t TEXTURE_FILE_VERSION = 1;
+const char TEXTURE_FILE_EXTENSION[] = ".tex";
+
+// each mip level's pixel data begins at an offset that is a multiple of this
+const uint32_t TEXTURE_FILE_DATA_ALIGNMENT = 4;
+
+const uint32_t TEXTURE_FILE_MAX_MIP_LEVELS = 32;
+
+enum TEXTURE_FILE_FLAGS
+{
+	TEXTURE_FILE_FLAG_PREMULTIPLIED_ALPHA = 1
+};
+
+struct TextureFileHeader
+{
+	char id[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;          // TEXTURE_FORMAT
+	uint32_t numMipLevels;
+	uint32_t flags;           // TEXTURE_FILE_FLAGS
+	uint32_t reserved;
+};
+
+struct TextureFileMipLevel
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t offset;          // from the start of the file
+	uint32_t size;
+};
+
+/**
+ * @param format the texture format of the pixel data
+ * @return the number of bytes each pixel takes up, or 0 if the format
+ *         can't be stored in a converted texture file
+ */
+inline uint GetTextureFileBytesPerPixel(uint32_t format)
+{
+	switch (format)
+	{
+		case TEXTURE_FORMAT_ALPHA: return 1;
+		case TEXTURE_FORMAT_RGB:   return 3;
+		case TEXTURE_FORMAT_RGBA:  return 4;
+		default:                   return 0;
+	}
+}
+
+/**
+ * @param width the width of the largest mip level
+ * @param height the height of the largest mip level
+ * @return the number of mip levels it takes to go from the given size
+ *         down to 1x1
+ */
+inline uint32_t GetTextureFileFullMipLevelCount(uint32_t width, uint32_t height)
+{
+	uint32_t count = 1;
+	uint32_t size = Max(width, height);
+	while (size > 1)
+	{
+		size /= 2;
+		++count;
+	}
+
+	return count;
+}
+
+/**
+ * Checks that a converted texture file's header and mip level table are
+ * valid and consistent with the file's size.
+ * @param data the entire contents of the file
+ * @param size the size of the file in bytes
+ * @return true if the file can be safely read
+ */
+inline bool IsValidTextureFile(const void *data, size_t size)
+{
+	if (data == NULL || size < sizeof(TextureFileHeader))
+		return false;
+
+	const TextureFileHeader *header = (const TextureFileHeader*)data;
+	for (uint i = 0; i < 4; ++i)
+	{
+		if (header->id[i] != TEXTURE_FILE_ID[i])
+			return false;
+	}
+	if (header->version != TEXTURE_FILE_VERSION)
+		return false;
+
+	uint bytesPerPixel = GetTextureFileBytesPerPixel(header->format);
+	if (bytesPerPixel == 0 || header->width == 0 || header->height == 0)
+		return false;
+
+	// partial mipmap chains can't be used everywhere, so only accept either
+	// none at all or a complete one
+	if (header->numMipLevels != 1 && header->numMipLevels != GetTextureFileFullMipLevelCount(header->width, header->height))
+		return false;
+	if (size < sizeof(TextureFileHeader) + header->numMipLevels * sizeof(TextureFileMipLevel))
+		return false;
+
+	const TextureFileMipLevel *levels = (const TextureFileMipLevel*)(header + 1);
+	for (uint32_t i = 0; i < header->numMipLevels; ++i)
+	{
+		const TextureFileMipLevel &level = levels[i];
+		if (level.width != Max(header->width >> i, (uint32_t)1) || level.height != Max(header->height >> i, (uint32_t)1))
+			return false;
+		if (level.size != level.width * level.height * bytesPerPixel)
+			return false;
+		if (level.offset % TEXTURE_FILE_DATA_ALIGNMENT != 0 || level.offset > size || level.size > size - level.offset)
+			return false;
+	}
+
+	return true;
+}
+
+#endif
@@ -7,6 +7,73 @@
 const unsigned int FLOATS_PER_GPU_ATTRIB_SLOT = 4;
 const unsigned int MAX_GPU_ATTRIB_SLOTS = 8;
 
+// transforms "count" 3-float vectors spaced "srcStride" floats apart into
+// "dest" (which can be the same as "src"), spaced "destStride" floats apart.
+// the matrix's columns are only loaded once for the whole run
+static void TransformFloat3s(const float *src, uint srcStride, float *dest, uint destStride, uint count, const Matrix4x4 *transform, bool useTranslation, const Vector3 &translation)
+{
+	if (transform == NULL)
+	{
+		for (uint i = 0; i < count; ++i)
+		{
+			dest[0] = src[0] + translation.x;
+			dest[1] = src[1] + translation.y;
+			dest[2] = src[2] + translation.z;
+			src += srcStride;
+			dest += destStride;
+		}
+		return;
+	}
+
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 c0 = SimdLoad(&transform->m[0]);
+	SimdFloat4 c1 = SimdLoad(&transform->m[4]);
+	SimdFloat4 c2 = SimdLoad(&transform->m[8]);
+	SimdFloat4 c3 = SimdSet(translation.x, translation.y, translation.z, 0.0f);
+	if (useTranslation)
+		c3 = SimdAdd(c3, SimdLoad(&transform->m[12]));
+
+	// only 3 floats can be written per vector, otherwise whatever follows
+	// it in the vertex would be overwritten
+	float out[4];
+	for (uint i = 0; i < count; ++i)
+	{
+		SimdFloat4 r = SimdMulAdd(c0, SimdSplat(src[0]), c3);
+		r = SimdMulAdd(c1, SimdSplat(src[1]), r);
+		r = SimdMulAdd(c2, SimdSplat(src[2]), r);
+		SimdStore(out, r);
+		dest[0] = out[0];
+		dest[1] = out[1];
+		dest[2] = out[2];
+		src += srcStride;
+		dest += destStride;
+	}
+#else
+	const float *m = transform->m;
+	float tx = translation.x;
+	float ty = translation.y;
+	float tz = translation.z;
+	if (useTranslation)
+	{
+		tx += m[_14];
+		ty += m[_24];
+		tz += m[_34];
+	}
+
+	for (uint i = 0; i < count; ++i)
+	{
+		float x = src[0];
+		float y = src[1];
+		float z = src[2];
+		dest[0] = x * m[_11] + y * m[_12] + z * m[_13] + tx;
+		dest[1] = x * m[_21] + y * m[_22] + z * m[_23] + ty;
+		dest[2] = x * m[_31] + y * m[_32] + z * m[_33] + tz;
+		src += srcStride;
+		dest += destStride;
+	}
+#endif
+}
+
 VertexBuffer::VertexBuffer()
 {
 	m_numVertices = 0;
@@ -248,7 +315,89 @@ void VertexBuffer::Copy(const VertexBuffer *source, uint destIndex)
 	ASSERT(destIndex + source->GetNumElements() <= GetNumElements());
 
 	uint destOffset = GetVertexPosition(destIndex);
-	memcpy(&m_buffer[destOffset], source->GetBuffer(), GetNumElements() * GetElementWidthInBytes());
+	uint numFloats = source->GetNumElements() * m_elementWidth;
+	memcpy(&m_buffer[destOffset], source->GetBuffer(), numFloats * sizeof(float));
+
+	MarkDirty(destOffset, numFloats);
+}
+
+void VertexBuffer::CopyPositions3(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Matrix4x4 *transform, const Vector3 &translation)
+{
+	ASSERT(source != NULL);
+	ASSERT(source->HasStandardAttrib(VERTEX_STD_POS_3D));
+	ASSERT(HasStandardAttrib(VERTEX_STD_POS_3D));
+	ASSERT(sourceIndex + count <= source->GetNumElements());
+	ASSERT(destIndex + count <= GetNumElements());
+	if (count == 0)
+		return;
+
+	const float *src = &source->m_buffer[source->GetPosition3BufferPosition(sourceIndex)];
+	float *dest = &m_buffer[GetPosition3BufferPosition(destIndex)];
+	TransformFloat3s(src, source->m_elementWidth, dest, m_elementWidth, count, transform, true, translation);
+
+	MarkDirty(GetPosition3BufferPosition(destIndex), (count - 1) * m_elementWidth + 3);
+}
+
+void VertexBuffer::CopyNormals(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Matrix4x4 *transform)
+{
+	ASSERT(source != NULL);
+	ASSERT(source->HasStandardAttrib(VERTEX_STD_NORMAL));
+	ASSERT(HasStandardAttrib(VERTEX_STD_NORMAL));
+	ASSERT(sourceIndex + count <= source->GetNumElements());
+	ASSERT(destIndex + count <= GetNumElements());
+	if (count == 0)
+		return;
+
+	const float *src = &source->m_buffer[source->GetNormalBufferPosition(sourceIndex)];
+	float *dest = &m_buffer[GetNormalBufferPosition(destIndex)];
+	TransformFloat3s(src, source->m_elementWidth, dest, m_elementWidth, count, transform, false, ZERO_VECTOR);
+
+	MarkDirty(GetNormalBufferPosition(destIndex), (count - 1) * m_elementWidth + 3);
+}
+
+void VertexBuffer::CopyTexCoords(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Vector2 &scale, const Vector2 &offset)
+{
+	ASSERT(source != NULL);
+	ASSERT(source->HasStandardAttrib(VERTEX_STD_TEXCOORD));
+	ASSERT(HasStandardAttrib(VERTEX_STD_TEXCOORD));
+	ASSERT(sourceIndex + count <= source->GetNumElements());
+	ASSERT(destIndex + count <= GetNumElements());
+	if (count == 0)
+		return;
+
+	const float *src = &source->m_buffer[source->GetTexCoordBufferPosition(sourceIndex)];
+	float *dest = &m_buffer[GetTexCoordBufferPosition(destIndex)];
+	uint srcStride = source->m_elementWidth;
+	uint destStride = m_elementWidth;
+
+	for (uint i = 0; i < count; ++i)
+	{
+		dest[0] = src[0] * scale.x + offset.x;
+		dest[1] = src[1] * scale.y + offset.y;
+		src += srcStride;
+		dest += destStride;
+	}
+
+	MarkDirty(GetTexCoordBufferPosition(destIndex), (count - 1) * m_elementWidth + 2);
+}
+
+void VertexBuffer::FillColors(uint index, uint count, const Color &color)
+{
+	ASSERT(HasStandardAttrib(VERTEX_STD_COLOR));
+	ASSERT(index + count <= GetNumElements());
+	if (count == 0)
+		return;
+
+	float *dest = &m_buffer[GetColorBufferPosition(index)];
+	uint stride = m_elementWidth;
+
+	// colors are 4 floats wide so can always be stored whole
+	SimdFloat4 c = SimdLoad(&color.r);
+	for (uint i = 0; i < count; ++i)
+	{
+		SimdStore(dest, c);
+		dest += stride;
+	}
 
-	SetDirty();
+	MarkDirty(GetColorBufferPosition(index), (count - 1) * m_elementWidth + 4);
 }
@@ -99,7 +99,7 @@ public:
 	 * @return true if the vertex data in this buffer contains this standard
 	 *              attribute
 	 */
-	bool HasStandardAttrib(VERTEX_STANDARD_ATTRIBS standardAttrib) const        { return (m_standardTypeAttribs & (uint)standardAttrib) > 0; }
+	bool HasStandardAttrib(VERTEX_STANDARD_ATTRIBS standardAttrib) const        { return (m_standardTypeAttribs & ((uint)standardAttrib >> 8)) > 0; }
 
 	/**
 	 * Returns the index of the specified standard attribute.
@@ -502,6 +502,59 @@ public:
 	 */
 	void Copy(const VertexBuffer *source, uint destIndex);
 
+	/**
+	 * Copies a range of vertex positions from a source buffer to this one,
+	 * transforming each one on the way. Works directly on both buffer's
+	 * vertex data, so is a lot faster then transforming vertices one at a
+	 * time with GetPosition3() / SetPosition3(). The source buffer can be
+	 * this buffer to transform vertices in place.
+	 * @param source the source buffer to copy from
+	 * @param sourceIndex the index of the first source vertex to copy
+	 * @param destIndex the index of the vertex position in this buffer to
+	 *                  start copying the vertices to
+	 * @param count the number of vertices to copy
+	 * @param transform the matrix to transform each position by, or NULL
+	 * @param translation added to each position after it is transformed
+	 */
+	void CopyPositions3(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Matrix4x4 *transform, const Vector3 &translation = ZERO_VECTOR);
+
+	/**
+	 * Copies a range of vertex normals from a source buffer to this one,
+	 * rotating each one by a transformation matrix on the way. Any
+	 * translation in the matrix is ignored. The source buffer can be this
+	 * buffer to transform normals in place.
+	 * @param source the source buffer to copy from
+	 * @param sourceIndex the index of the first source vertex to copy
+	 * @param destIndex the index of the vertex position in this buffer to
+	 *                  start copying the normals to
+	 * @param count the number of vertices to copy
+	 * @param transform the matrix to rotate each normal by, or NULL
+	 */
+	void CopyNormals(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Matrix4x4 *transform);
+
+	/**
+	 * Copies a range of texture coordinates from a source buffer to this
+	 * one, scaling and then offsetting each one on the way (e.g. to remap
+	 * them into a sub-region of a texture atlas). The source buffer can be
+	 * this buffer to remap texture coordinates in place.
+	 * @param source the source buffer to copy from
+	 * @param sourceIndex the index of the first source vertex to copy
+	 * @param destIndex the index of the vertex position in this buffer to
+	 *                  start copying the texture coordinates to
+	 * @param count the number of vertices to copy
+	 * @param scale multiplied with each texture coordinate
+	 * @param offset added to each texture coordinate after it is scaled
+	 */
+	void CopyTexCoords(const VertexBuffer *source, uint sourceIndex, uint destIndex, uint count, const Vector2 &scale = Vector2(1.0f, 1.0f), const Vector2 &offset = ZERO_VECTOR2);
+
+	/**
+	 * Sets the color of a range of vertices to the same value.
+	 * @param index the index of the first vertex to set the color of
+	 * @param count the number of vertices to set the color of
+	 * @param color the color to set
+	 */
+	void FillColors(uint index, uint count, const Color &color);
+
 	/**
 	 * @return the number of vertices contained in this buffer
 	 */
@@ -541,6 +594,8 @@ private:
 	uint GetTexCoordBufferPosition(uint index) const                            { return GetVertexPosition(index) + m_texCoordOffset; }
 	uint GetGenericBufferPosition(uint attrib, uint index) const                { return GetVertexPosition(index) + m_attribs[attrib].offset; }
 
+	void MarkDirty(uint bufferPosition, uint numFloats)                         { SetDirty(bufferPosition * sizeof(float), numFloats * sizeof(float)); }
+
 	uint m_numVertices;
 	uint m_currentVertex;
 	uint m_standardTypeAttribs;
@@ -742,7 +797,7 @@ inline void VertexBuffer::SetColor(uint index, const Color &color)
 	m_buffer[p + 1] = color.g;
 	m_buffer[p + 2] = color.b;
 	m_buffer[p + 3] = color.a;
-	SetDirty();
+	MarkDirty(p, 4);
 }
 
 inline void VertexBuffer::SetColor(uint index, float r, float g, float b)
@@ -752,7 +807,7 @@ inline void VertexBuffer::SetColor(uint index, float r, float g, float b)
 	m_buffer[p + 1] = g;
 	m_buffer[p + 2] = b;
 	m_buffer[p + 3] = COLOR_ALPHA_OPAQUE;
-	SetDirty();
+	MarkDirty(p, 4);
 }
 
 inline void VertexBuffer::SetColor(uint index, float r, float g, float b, float a)
@@ -762,7 +817,7 @@ inline void VertexBuffer::SetColor(uint index, float r, float g, float b, float
 	m_buffer[p + 1] = g;
 	m_buffer[p + 2] = b;
 	m_buffer[p + 3] = a;
-	SetDirty();
+	MarkDirty(p, 4);
 }
 
 inline void VertexBuffer::SetPosition3(uint index, const Vector3 &position)
@@ -771,7 +826,7 @@ inline void VertexBuffer::SetPosition3(uint index, const Vector3 &position)
 	m_buffer[p] = position.x;
 	m_buffer[p + 1] = position.y;
 	m_buffer[p + 2] = position.z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::SetPosition3(uint index, float x, float y, float z)
@@ -780,7 +835,7 @@ inline void VertexBuffer::SetPosition3(uint index, float x, float y, float z)
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
 	m_buffer[p + 2] = z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::SetPosition2(uint index, const Vector2 &position)
@@ -788,7 +843,7 @@ inline void VertexBuffer::SetPosition2(uint index, const Vector2 &position)
 	uint p = GetPosition2BufferPosition(index);
 	m_buffer[p] = position.x;
 	m_buffer[p + 1] = position.y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::SetPosition2(uint index, float x, float y)
@@ -796,7 +851,7 @@ inline void VertexBuffer::SetPosition2(uint index, float x, float y)
 	uint p = GetPosition2BufferPosition(index);
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::SetNormal(uint index, const Vector3 &normal)
@@ -805,7 +860,7 @@ inline void VertexBuffer::SetNormal(uint index, const Vector3 &normal)
 	m_buffer[p] = normal.x;
 	m_buffer[p + 1] = normal.y;
 	m_buffer[p + 2] = normal.z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::SetNormal(uint index, float x, float y, float z)
@@ -814,7 +869,7 @@ inline void VertexBuffer::SetNormal(uint index, float x, float y, float z)
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
 	m_buffer[p + 2] = z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::SetTexCoord(uint index, const Vector2 &texCoord)
@@ -822,7 +877,7 @@ inline void VertexBuffer::SetTexCoord(uint index, const Vector2 &texCoord)
 	uint p = GetTexCoordBufferPosition(index);
 	m_buffer[p] = texCoord.x;
 	m_buffer[p + 1] = texCoord.y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::SetTexCoord(uint index, float x, float y)
@@ -830,14 +885,14 @@ inline void VertexBuffer::SetTexCoord(uint index, float x, float y)
 	uint p = GetTexCoordBufferPosition(index);
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::Set1f(uint attrib, uint index, float x)
 {
 	uint p = GetGenericBufferPosition(attrib, index);
 	m_buffer[p] = x;
-	SetDirty();
+	MarkDirty(p, 1);
 }
 
 inline void VertexBuffer::Set2f(uint attrib, uint index, float x, float y)
@@ -845,7 +900,7 @@ inline void VertexBuffer::Set2f(uint attrib, uint index, float x, float y)
 	uint p = GetGenericBufferPosition(attrib, index);
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::Set2f(uint attrib, uint index, const Vector2 &v)
@@ -853,7 +908,7 @@ inline void VertexBuffer::Set2f(uint attrib, uint index, const Vector2 &v)
 	uint p = GetGenericBufferPosition(attrib, index);
 	m_buffer[p] = v.x;
 	m_buffer[p + 1] = v.y;
-	SetDirty();
+	MarkDirty(p, 2);
 }
 
 inline void VertexBuffer::Set3f(uint attrib, uint index, float x, float y, float z)
@@ -862,7 +917,7 @@ inline void VertexBuffer::Set3f(uint attrib, uint index, float x, float y, float
 	m_buffer[p] = x;
 	m_buffer[p + 1] = y;
 	m_buffer[p + 2] = z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::Set3f(uint attrib, uint index, const Vector3 &v)
@@ -871,7 +926,7 @@ inline void VertexBuffer::Set3f(uint attrib, uint index, const Vector3 &v)
 	m_buffer[p] = v.x;
 	m_buffer[p + 1] = v.y;
 	m_buffer[p + 2] = v.z;
-	SetDirty();
+	MarkDirty(p, 3);
 }
 
 inline void VertexBuffer::Set4f(uint attrib, uint index, float x, float y, float z, float w)
@@ -881,7 +936,7 @@ inline void VertexBuffer::Set4f(uint attrib, uint index, float x, float y, float
 	m_buffer[p + 1] = y;
 	m_buffer[p + 2] = z;
 	m_buffer[p + 3] = w;
-	SetDirty();
+	MarkDirty(p, 4);
 }
 
 inline void VertexBuffer::Set4f(uint attrib, uint index, const Color &c)
@@ -891,7 +946,7 @@ inline void VertexBuffer::Set4f(uint attrib, uint index, const Color &c)
 	m_buffer[p + 1] = c.g;
 	m_buffer[p + 2] = c.b;
 	m_buffer[p + 3] = c.a;
-	SetDirty();
+	MarkDirty(p, 4);
 }
 
 inline void VertexBuffer::Set9f(uint attrib, uint index, const Matrix3x3 &m)
@@ -900,7 +955,7 @@ inline void VertexBuffer::Set9f(uint attrib, uint index, const Matrix3x3 &m)
 	void *dest = &m_buffer[p];
 	const void *src = m.m;
 	memcpy(dest, src, sizeof(float) * 9);
-	SetDirty();
+	MarkDirty(p, 9);
 }
 
 inline void VertexBuffer::Set16f(uint attrib, uint index, const Matrix4x4 &m)
@@ -909,7 +964,7 @@ inline void VertexBuffer::Set16f(uint attrib, uint index, const Matrix4x4 &m)
 	void *dest = &m_buffer[p];
 	const void *src = m.m;
 	memcpy(dest, src, sizeof(float) * 16);
-	SetDirty();
+	MarkDirty(p, 16);
 }
 
 inline bool VertexBuffer::MoveNext()
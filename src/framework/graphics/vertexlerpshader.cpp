@@ -4,6 +4,7 @@
 
 VertexLerpShader::VertexLerpShader()
 {
+	m_lerpHandle = INVALID_SHADER_UNIFORM_HANDLE;
 	SetLerpUniform("u_lerp");
 }
 
@@ -11,8 +12,17 @@ VertexLerpShader::~VertexLerpShader()
 {
 }
 
+void VertexLerpShader::Release()
+{
+	m_lerpHandle = INVALID_SHADER_UNIFORM_HANDLE;
+
+	StandardShader::Release();
+}
+
 void VertexLerpShader::SetLerp(float t)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_lerpUniform, t);
+	if (m_lerpHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_lerpHandle = GetUniformHandle(m_lerpUniform);
+	SetUniform(m_lerpHandle, t);
 }
@@ -10,6 +10,8 @@ class VertexLerpShader : public StandardShader
 public:
 	virtual ~VertexLerpShader();
 
+	virtual void Release();
+
 	void SetLerp(float t);
 
 protected:
@@ -17,10 +19,11 @@ protected:
 
 	const stl::string& GetLerpUniform() const              { return m_lerpUniform; }
 
-	void SetLerpUniform(const stl::string &name)           { m_lerpUniform = name; }
+	void SetLerpUniform(const stl::string &name)           { m_lerpUniform = name; m_lerpHandle = INVALID_SHADER_UNIFORM_HANDLE; }
 
 private:
 	stl::string m_lerpUniform;
+	ShaderUniformHandle m_lerpHandle;
 };
 
 #endif
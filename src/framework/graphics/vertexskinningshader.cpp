@@ -6,6 +6,8 @@
 
 VertexSkinningShader::VertexSkinningShader()
 {
+	m_positionsHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_rotationsHandle = INVALID_SHADER_UNIFORM_HANDLE;
 	SetJointPositionsUniform("u_jointPositions");
 	SetJointRotationsUniform("u_jointRotations");
 }
@@ -14,14 +16,26 @@ VertexSkinningShader::~VertexSkinningShader()
 {
 }
 
+void VertexSkinningShader::Release()
+{
+	m_positionsHandle = INVALID_SHADER_UNIFORM_HANDLE;
+	m_rotationsHandle = INVALID_SHADER_UNIFORM_HANDLE;
+
+	StandardShader::Release();
+}
+
 void VertexSkinningShader::SetJointPositions(const Vector3 *positions, uint count)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_positionsUniform, positions, count);
+	if (m_positionsHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_positionsHandle = GetUniformHandle(m_positionsUniform);
+	SetUniform(m_positionsHandle, positions, count);
 }
 
 void VertexSkinningShader::SetJointRotations(const Quaternion *rotations, uint count)
 {
 	ASSERT(IsReadyForUse() == true);
-	SetUniform(m_rotationsUniform, rotations, count);
+	if (m_rotationsHandle == INVALID_SHADER_UNIFORM_HANDLE)
+		m_rotationsHandle = GetUniformHandle(m_rotationsUniform);
+	SetUniform(m_rotationsHandle, rotations, count);
 }
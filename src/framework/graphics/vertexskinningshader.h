@@ -12,6 +12,8 @@ class VertexSkinningShader : public StandardShader
 {
 public:
 	virtual ~VertexSkinningShader();
+
+	virtual void Release();
 	
 	void SetJointPositions(const Vector3 *positions, uint count);
 	void SetJointRotations(const Quaternion *rotations, uint count);
@@ -22,12 +24,14 @@ protected:
 	const stl::string& GetJointPositionsUniform() const    { return m_positionsUniform; }
 	const stl::string& GetJointRotationsUniform() const    { return m_rotationsUniform; }
 	
-	void SetJointPositionsUniform(const stl::string &name) { m_positionsUniform = name; }
-	void SetJointRotationsUniform(const stl::string &name) { m_rotationsUniform = name; }
+	void SetJointPositionsUniform(const stl::string &name) { m_positionsUniform = name; m_positionsHandle = INVALID_SHADER_UNIFORM_HANDLE; }
+	void SetJointRotationsUniform(const stl::string &name) { m_rotationsUniform = name; m_rotationsHandle = INVALID_SHADER_UNIFORM_HANDLE; }
 	
 private:
 	stl::string m_positionsUniform;
 	stl::string m_rotationsUniform;
+	ShaderUniformHandle m_positionsHandle;
+	ShaderUniformHandle m_rotationsHandle;
 };
 
 #endif
@@ -15,11 +15,16 @@
 #include "../graphics/image.h"
 #include "../graphics/spritebatch.h"
 #include "../graphics/spritefont.h"
+#include "../graphics/textlayout.h"
 #include "../graphics/texture.h"
 #include <stl/string.h>
 
 #define LOGCAT_GWENUI "GWENUI"
 
+// UI text is mostly static labels, but this stops text that changes often
+// from growing the layout cache forever
+const uint MAX_TEXT_LAYOUTS_PER_FONT = 512;
+
 namespace Gwen
 {
 	namespace Renderer
@@ -34,6 +39,8 @@ namespace Gwen
 
 		SpriteBatchRenderer::~SpriteBatchRenderer()
 		{
+			while (!m_textLayouts.empty())
+				FreeTextLayouts(m_textLayouts.begin()->first);
 		}
 
 		void SpriteBatchRenderer::PreRender(SpriteBatch *spriteBatch)
@@ -173,6 +180,7 @@ namespace Gwen
 			SpriteFont *font = (SpriteFont*)pFont->data;
 			ASSERT(font != NULL);
 
+			FreeTextLayouts(font);
 			m_contentManager->Free<SpriteFont>(font);
 		}
 
@@ -184,7 +192,11 @@ namespace Gwen
 
 			::Color renderColor = AdjustColorForAlpha(m_color);
 
-			m_spriteBatch->Render(font, pos.x, pos.y, renderColor, Scale(), text.c_str());
+			// the same strings get rendered every frame, so their layouts are
+			// kept around instead of laying the text out each time
+			TextLayout *layout = GetTextLayout(font, text);
+			layout->Set(font, text.c_str(), Scale());
+			m_spriteBatch->Render(layout, pos.x, pos.y, renderColor);
 		}
 
 		Gwen::Point SpriteBatchRenderer::MeasureText(Gwen::Font *pFont, const Gwen::String &text)
@@ -216,6 +228,38 @@ namespace Gwen
 			result.a *= m_alpha;
 			return result;
 		}
+
+		TextLayout* SpriteBatchRenderer::GetTextLayout(const SpriteFont *font, const Gwen::String &text)
+		{
+			TextLayoutMap &layouts = m_textLayouts[font];
+
+			TextLayoutMap::iterator itor = layouts.find(text);
+			if (itor != layouts.end())
+				return itor->second;
+
+			if (layouts.size() >= MAX_TEXT_LAYOUTS_PER_FONT)
+			{
+				for (TextLayoutMap::iterator i = layouts.begin(); i != layouts.end(); ++i)
+					SAFE_DELETE(i->second);
+				layouts.clear();
+			}
+
+			TextLayout *layout = new TextLayout();
+			layouts.insert(TextLayoutMap::value_type(text, layout));
+			return layout;
+		}
+
+		void SpriteBatchRenderer::FreeTextLayouts(const SpriteFont *font)
+		{
+			FontTextLayoutMap::iterator itor = m_textLayouts.find(font);
+			if (itor == m_textLayouts.end())
+				return;
+
+			TextLayoutMap &layouts = itor->second;
+			for (TextLayoutMap::iterator i = layouts.begin(); i != layouts.end(); ++i)
+				SAFE_DELETE(i->second);
+			m_textLayouts.erase(itor);
+		}
 	}
 }
 
@@ -3,10 +3,14 @@
 
 #include <gwen_baserender.h>
 #include "../graphics/color.h"
+#include <stl/map.h>
+#include <stl/string.h>
 
 class ContentManager;
 class GraphicsDevice;
 class SpriteBatch;
+class SpriteFont;
+class TextLayout;
 
 namespace Gwen
 {
@@ -51,13 +55,19 @@ namespace Gwen
 			void SetAlpha(float alpha)                     { m_alpha = alpha; }
 
 		private:
+			typedef stl::map<stl::string, TextLayout*> TextLayoutMap;
+			typedef stl::map<const SpriteFont*, TextLayoutMap> FontTextLayoutMap;
+
 			::Color AdjustColorForAlpha(const ::Color &color) const;
+			TextLayout* GetTextLayout(const SpriteFont *font, const Gwen::String &text);
+			void FreeTextLayouts(const SpriteFont *font);
 
 			ContentManager *m_contentManager;
 			GraphicsDevice *m_graphicsDevice;
 			SpriteBatch *m_spriteBatch;
 			::Color m_color;
 			float m_alpha;
+			FontTextLayoutMap m_textLayouts;
 		};
 	}
 }
@@ -0,0 +1,107 @@
+#ifndef __FRAMEWORK_MATH_BOUNDINGBOXARRAY_H_INCLUDED__
+#define __FRAMEWORK_MATH_BOUNDINGBOXARRAY_H_INCLUDED__
+
+#include "../common.h"
+#include "boundingbox.h"
+#include <stl/vector.h>
+
+/**
+ * A list of axis-aligned boxes stored in SoA (structure of arrays) layout,
+ * with each min/max coordinate kept in it's own array. This is the layout
+ * that batch tests such as Frustum::TestBoxes() work on.
+ */
+class BoundingBoxArray
+{
+public:
+	BoundingBoxArray()                                     {}
+	virtual ~BoundingBoxArray()                            {}
+
+	/**
+	 * Changes the number of boxes in the list. Any new boxes are left
+	 * uninitialized.
+	 * @param count the new number of boxes
+	 */
+	void Resize(uint count);
+
+	/**
+	 * Removes all boxes from the list.
+	 */
+	void Clear()                                           { Resize(0); }
+
+	/**
+	 * Sets a box in the list.
+	 * @param index the index of the box to set
+	 * @param box the box's new bounds
+	 */
+	void Set(uint index, const BoundingBox &box);
+
+	/**
+	 * Adds a box to the end of the list.
+	 * @param box the bounds of the box to add
+	 */
+	void Add(const BoundingBox &box);
+
+	/**
+	 * @return the box at the given index
+	 */
+	BoundingBox Get(uint index) const;
+
+	/**
+	 * @return the number of boxes in the list
+	 */
+	uint GetCount() const                                  { return m_minX.size(); }
+
+	const float* GetMinX() const                           { return m_minX.data(); }
+	const float* GetMinY() const                           { return m_minY.data(); }
+	const float* GetMinZ() const                           { return m_minZ.data(); }
+	const float* GetMaxX() const                           { return m_maxX.data(); }
+	const float* GetMaxY() const                           { return m_maxY.data(); }
+	const float* GetMaxZ() const                           { return m_maxZ.data(); }
+
+private:
+	stl::vector<float> m_minX;
+	stl::vector<float> m_minY;
+	stl::vector<float> m_minZ;
+	stl::vector<float> m_maxX;
+	stl::vector<float> m_maxY;
+	stl::vector<float> m_maxZ;
+};
+
+inline void BoundingBoxArray::Resize(uint count)
+{
+	m_minX.resize(count);
+	m_minY.resize(count);
+	m_minZ.resize(count);
+	m_maxX.resize(count);
+	m_maxY.resize(count);
+	m_maxZ.resize(count);
+}
+
+inline void BoundingBoxArray::Set(uint index, const BoundingBox &box)
+{
+	ASSERT(index < GetCount());
+	m_minX[index] = box.min.x;
+	m_minY[index] = box.min.y;
+	m_minZ[index] = box.min.z;
+	m_maxX[index] = box.max.x;
+	m_maxY[index] = box.max.y;
+	m_maxZ[index] = box.max.z;
+}
+
+inline void BoundingBoxArray::Add(const BoundingBox &box)
+{
+	m_minX.push_back(box.min.x);
+	m_minY.push_back(box.min.y);
+	m_minZ.push_back(box.min.z);
+	m_maxX.push_back(box.max.x);
+	m_maxY.push_back(box.max.y);
+	m_maxZ.push_back(box.max.z);
+}
+
+inline BoundingBox BoundingBoxArray::Get(uint index) const
+{
+	ASSERT(index < GetCount());
+	return BoundingBox(m_minX[index], m_minY[index], m_minZ[index], m_maxX[index], m_maxY[index], m_maxZ[index]);
+}
+
+#endif
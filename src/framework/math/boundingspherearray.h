@@ -0,0 +1,97 @@
+#ifndef __FRAMEWORK_MATH_BOUNDINGSPHEREARRAY_H_INCLUDED__
+#define __FRAMEWORK_MATH_BOUNDINGSPHEREARRAY_H_INCLUDED__
+
+#include "../common.h"
+#include "boundingsphere.h"
+#include <stl/vector.h>
+
+/**
+ * A list of spheres stored in SoA (structure of arrays) layout, with each
+ * center coordinate and the radius kept in it's own array. This is the
+ * layout that batch tests such as Frustum::TestSpheres() work on.
+ */
+class BoundingSphereArray
+{
+public:
+	BoundingSphereArray()                                  {}
+	virtual ~BoundingSphereArray()                         {}
+
+	/**
+	 * Changes the number of spheres in the list. Any new spheres are left
+	 * uninitialized.
+	 * @param count the new number of spheres
+	 */
+	void Resize(uint count);
+
+	/**
+	 * Removes all spheres from the list.
+	 */
+	void Clear()                                           { Resize(0); }
+
+	/**
+	 * Sets a sphere in the list.
+	 * @param index the index of the sphere to set
+	 * @param sphere the sphere's new bounds
+	 */
+	void Set(uint index, const BoundingSphere &sphere);
+
+	/**
+	 * Adds a sphere to the end of the list.
+	 * @param sphere the bounds of the sphere to add
+	 */
+	void Add(const BoundingSphere &sphere);
+
+	/**
+	 * @return the sphere at the given index
+	 */
+	BoundingSphere Get(uint index) const;
+
+	/**
+	 * @return the number of spheres in the list
+	 */
+	uint GetCount() const                                  { return m_centerX.size(); }
+
+	const float* GetCenterX() const                        { return m_centerX.data(); }
+	const float* GetCenterY() const                        { return m_centerY.data(); }
+	const float* GetCenterZ() const                        { return m_centerZ.data(); }
+	const float* GetRadius() const                         { return m_radius.data(); }
+
+private:
+	stl::vector<float> m_centerX;
+	stl::vector<float> m_centerY;
+	stl::vector<float> m_centerZ;
+	stl::vector<float> m_radius;
+};
+
+inline void BoundingSphereArray::Resize(uint count)
+{
+	m_centerX.resize(count);
+	m_centerY.resize(count);
+	m_centerZ.resize(count);
+	m_radius.resize(count);
+}
+
+inline void BoundingSphereArray::Set(uint index, const BoundingSphere &sphere)
+{
+	ASSERT(index < GetCount());
+	m_centerX[index] = sphere.center.x;
+	m_centerY[index] = sphere.center.y;
+	m_centerZ[index] = sphere.center.z;
+	m_radius[index] = sphere.radius;
+}
+
+inline void BoundingSphereArray::Add(const BoundingSphere &sphere)
+{
+	m_centerX.push_back(sphere.center.x);
+	m_centerY.push_back(sphere.center.y);
+	m_centerZ.push_back(sphere.center.z);
+	m_radius.push_back(sphere.radius);
+}
+
+inline BoundingSphere BoundingSphereArray::Get(uint index) const
+{
+	ASSERT(index < GetCount());
+	return BoundingSphere(m_centerX[index], m_centerY[index], m_centerZ[index], m_radius[index]);
+}
+
+#endif
@@ -3,15 +3,21 @@
 #include "frustum.h"
 
 #include "boundingbox.h"
+#include "boundingboxarray.h"
 #include "boundingsphere.h"
+#include "boundingspherearray.h"
 #include "matrix4x4.h"
+#include "simdfloat4.h"
 #include "../graphics/viewcontext.h"
 #include "../graphics/graphicsdevice.h"
 
+#include <string.h>
+
 Frustum::Frustum(ViewContext *viewContext)
 {
 	m_viewContext = viewContext;
-	Calculate();
+	if (m_viewContext != NULL)
+		Calculate();
 }
 
 Frustum::~Frustum()
@@ -20,9 +26,12 @@ Frustum::~Frustum()
 
 void Frustum::Calculate()
 {
-	Matrix4x4 projection = m_viewContext->GetProjectionMatrix();
-	Matrix4x4 modelview = m_viewContext->GetModelViewMatrix();
+	ASSERT(m_viewContext != NULL);
+	Calculate(m_viewContext->GetProjectionMatrix(), m_viewContext->GetModelViewMatrix());
+}
 
+void Frustum::Calculate(const Matrix4x4 &projection, const Matrix4x4 &modelview)
+{
 	Matrix4x4 combined = projection * modelview;
 
 	// Extract the sides of each of the 6 planes from this to get our viewing frustum
@@ -111,6 +120,168 @@ bool Frustum::Test(const BoundingSphere &sphere) const
 	return true;
 }
 
+// planes laid out for testing 4 objects at a time, with every component
+// copied into all 4 lanes
+struct FrustumSimdPlanes
+{
+	SimdFloat4 normalX[NUM_FRUSTUM_SIDES];
+	SimdFloat4 normalY[NUM_FRUSTUM_SIDES];
+	SimdFloat4 normalZ[NUM_FRUSTUM_SIDES];
+	SimdFloat4 absNormalX[NUM_FRUSTUM_SIDES];
+	SimdFloat4 absNormalY[NUM_FRUSTUM_SIDES];
+	SimdFloat4 absNormalZ[NUM_FRUSTUM_SIDES];
+	SimdFloat4 d[NUM_FRUSTUM_SIDES];
+};
+
+static void SplatPlanes(const Plane *planes, FrustumSimdPlanes &out)
+{
+	for (int p = 0; p < NUM_FRUSTUM_SIDES; ++p)
+	{
+		out.normalX[p] = SimdSplat(planes[p].normal.x);
+		out.normalY[p] = SimdSplat(planes[p].normal.y);
+		out.normalZ[p] = SimdSplat(planes[p].normal.z);
+		out.absNormalX[p] = SimdSplat(fabsf(planes[p].normal.x));
+		out.absNormalY[p] = SimdSplat(fabsf(planes[p].normal.y));
+		out.absNormalZ[p] = SimdSplat(fabsf(planes[p].normal.z));
+		out.d[p] = SimdSplat(planes[p].d);
+	}
+}
+
+// loads the 4 values starting at index, padding past the end of the array
+// by repeating the last value
+static inline SimdFloat4 LoadGroup(const float *values, uint index, uint count)
+{
+	if (index + 4 <= count)
+		return SimdLoad(values + index);
+
+	float padded[4];
+	for (uint i = 0; i < 4; ++i)
+		padded[i] = values[Min(index + i, count - 1)];
+	return SimdLoad(padded);
+}
+
+static inline int GetGroupMask(uint index, uint count)
+{
+	if (index + 4 <= count)
+		return 0xf;
+	else
+		return (1 << (count - index)) - 1;
+}
+
+
+void Frustum::TestBoxes(const BoundingBoxArray &boxes, uint32_t *visibility, uint8_t *lastRejectingPlanes) const
+{
+	ASSERT(visibility != NULL);
+
+	uint count = boxes.GetCount();
+	memset(visibility, 0, sizeof(uint32_t) * ((count + 31) / 32));
+
+	FrustumSimdPlanes planes;
+	SplatPlanes(m_planes, planes);
+
+	const SimdFloat4 half = SimdSplat(0.5f);
+	const SimdFloat4 zero = SimdSplat(0.0f);
+
+	for (uint i = 0; i < count; i += 4)
+	{
+		int groupMask = GetGroupMask(i, count);
+
+		// in center/extents form, the corner of the box furthest in front
+		// of a plane is just the center moved by the extents towards it
+		SimdFloat4 minX = LoadGroup(boxes.GetMinX(), i, count);
+		SimdFloat4 minY = LoadGroup(boxes.GetMinY(), i, count);
+		SimdFloat4 minZ = LoadGroup(boxes.GetMinZ(), i, count);
+		SimdFloat4 maxX = LoadGroup(boxes.GetMaxX(), i, count);
+		SimdFloat4 maxY = LoadGroup(boxes.GetMaxY(), i, count);
+		SimdFloat4 maxZ = LoadGroup(boxes.GetMaxZ(), i, count);
+		SimdFloat4 centerX = SimdMul(SimdAdd(minX, maxX), half);
+		SimdFloat4 centerY = SimdMul(SimdAdd(minY, maxY), half);
+		SimdFloat4 centerZ = SimdMul(SimdAdd(minZ, maxZ), half);
+		SimdFloat4 extentX = SimdMul(SimdSub(maxX, minX), half);
+		SimdFloat4 extentY = SimdMul(SimdSub(maxY, minY), half);
+		SimdFloat4 extentZ = SimdMul(SimdSub(maxZ, minZ), half);
+
+		// start with the plane that last rejected any boxes in this group.
+		// boxes that don't move much tend to be rejected by the same plane
+		// again, letting the rest of the planes be skipped
+		int startPlane = (lastRejectingPlanes != NULL ? lastRejectingPlanes[i / 4] : 0);
+		int firstRejectingPlane = -1;
+		int rejected = 0;
+		for (int n = 0; n < NUM_FRUSTUM_SIDES; ++n)
+		{
+			int p = startPlane + n;
+			if (p >= NUM_FRUSTUM_SIDES)
+				p -= NUM_FRUSTUM_SIDES;
+
+			SimdFloat4 distance = SimdMulAdd(planes.normalX[p], centerX, SimdMulAdd(planes.normalY[p], centerY, SimdMulAdd(planes.normalZ[p], centerZ, planes.d[p])));
+			SimdFloat4 radius = SimdMulAdd(planes.absNormalX[p], extentX, SimdMulAdd(planes.absNormalY[p], extentY, SimdMul(planes.absNormalZ[p], extentZ)));
+
+			// same as every corner being behind the plane
+			int behind = SimdLessThanMask(SimdAdd(distance, radius), zero) & groupMask;
+			if (behind != 0 && firstRejectingPlane == -1)
+				firstRejectingPlane = p;
+			rejected |= behind;
+			if (rejected == groupMask)
+				break;
+		}
+
+		if (lastRejectingPlanes != NULL && firstRejectingPlane != -1)
+			lastRejectingPlanes[i / 4] = (uint8_t)firstRejectingPlane;
+
+		visibility[i / 32] |= (uint32_t)(groupMask & ~rejected) << (i % 32);
+	}
+}
+
+void Frustum::TestSpheres(const BoundingSphereArray &spheres, uint32_t *visibility, uint8_t *lastRejectingPlanes) const
+{
+	ASSERT(visibility != NULL);
+
+	uint count = spheres.GetCount();
+	memset(visibility, 0, sizeof(uint32_t) * ((count + 31) / 32));
+
+	FrustumSimdPlanes planes;
+	SplatPlanes(m_planes, planes);
+
+	const SimdFloat4 zero = SimdSplat(0.0f);
+
+	for (uint i = 0; i < count; i += 4)
+	{
+		int groupMask = GetGroupMask(i, count);
+
+		SimdFloat4 centerX = LoadGroup(spheres.GetCenterX(), i, count);
+		SimdFloat4 centerY = LoadGroup(spheres.GetCenterY(), i, count);
+		SimdFloat4 centerZ = LoadGroup(spheres.GetCenterZ(), i, count);
+		SimdFloat4 radius = LoadGroup(spheres.GetRadius(), i, count);
+
+		// start with the plane that last rejected any spheres in this group
+		int startPlane = (lastRejectingPlanes != NULL ? lastRejectingPlanes[i / 4] : 0);
+		int firstRejectingPlane = -1;
+		int rejected = 0;
+		for (int n = 0; n < NUM_FRUSTUM_SIDES; ++n)
+		{
+			int p = startPlane + n;
+			if (p >= NUM_FRUSTUM_SIDES)
+				p -= NUM_FRUSTUM_SIDES;
+
+			SimdFloat4 distance = SimdMulAdd(planes.normalX[p], centerX, SimdMulAdd(planes.normalY[p], centerY, SimdMulAdd(planes.normalZ[p], centerZ, planes.d[p])));
+
+			// same as distance <= -radius, written so that it can be done
+			// with a single less-than comparison
+			int behind = ~SimdLessThanMask(zero, SimdAdd(distance, radius)) & groupMask;
+			if (behind != 0 && firstRejectingPlane == -1)
+				firstRejectingPlane = p;
+			rejected |= behind;
+			if (rejected == groupMask)
+				break;
+		}
+
+		if (lastRejectingPlanes != NULL && firstRejectingPlane != -1)
+			lastRejectingPlanes[i / 4] = (uint8_t)firstRejectingPlane;
+
+		visibility[i / 32] |= (uint32_t)(groupMask & ~rejected) << (i % 32);
+	}
+}
+
 bool Frustum::TestPlaneAgainstBox(const Plane &plane, float minX, float minY, float minZ, float width, float height, float depth) const
 {
 	if (Plane::ClassifyPoint(plane, Vector3(minX,         minY,          minZ))         != BEHIND)
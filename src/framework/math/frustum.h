@@ -4,9 +4,12 @@
 #include "../common.h"
 #include "plane.h"
 
+class BoundingBoxArray;
+class BoundingSphereArray;
 class ViewContext;
 struct BoundingBox;
 struct BoundingSphere;
+struct Matrix4x4;
 
 enum FRUSTUM_SIDES
 {
@@ -29,7 +32,9 @@ class Frustum
 public:
 	/**
 	 * Creates a frustum object.
-	 * @param viewContext the view context this frustum is associated with
+	 * @param viewContext the view context this frustum is associated with,
+	 *                    or NULL if it will only ever be calculated from
+	 *                    matrices given to Calculate()
 	 */
 	Frustum(ViewContext *viewContext);
 
@@ -40,6 +45,13 @@ public:
 	 */
 	void Calculate();
 
+	/**
+	 * Recalculates the viewing frustum from the given camera matrices.
+	 * @param projection the projection matrix
+	 * @param modelview the modelview matrix
+	 */
+	void Calculate(const Matrix4x4 &projection, const Matrix4x4 &modelview);
+
 	/**
 	 * Tests a point for visibility.
 	 * @param point the point to be tested
@@ -63,6 +75,44 @@ public:
 	 */
 	bool Test(const BoundingSphere &sphere) const;
 
+	/**
+	 * Tests a list of boxes for visibility, 4 at a time. Gives the same
+	 * results as calling Test() for each box individually, apart from
+	 * floating point rounding for boxes touching a plane.
+	 * @param boxes the boxes to be tested
+	 * @param visibility bitmask that bit (i % 32) of element (i / 32) is
+	 *                   set in if box i is at least partially visible.
+	 *                   must have room for (count + 31) / 32 elements
+	 * @param lastRejectingPlanes if not NULL, used to remember the plane
+	 *                            each group of 4 boxes was last rejected by
+	 *                            so that it can be tested first next time.
+	 *                            must have (count + 3) / 4 entries which
+	 *                            start out as zero
+	 */
+	void TestBoxes(const BoundingBoxArray &boxes, uint32_t *visibility, uint8_t *lastRejectingPlanes = NULL) const;
+
+	/**
+	 * Tests a list of spheres for visibility, 4 at a time. Gives the same
+	 * results as calling Test() for each sphere individually, apart from
+	 * floating point rounding for spheres touching a plane.
+	 * @param spheres the spheres to be tested
+	 * @param visibility bitmask that bit (i % 32) of element (i / 32) is
+	 *                   set in if sphere i is at least partially visible.
+	 *                   must have room for (count + 31) / 32 elements
+	 * @param lastRejectingPlanes if not NULL, used to remember the plane
+	 *                            each group of 4 spheres was last rejected by
+	 *                            so that it can be tested first next time.
+	 *                            must have (count + 3) / 4 entries which
+	 *                            start out as zero
+	 */
+	void TestSpheres(const BoundingSphereArray &spheres, uint32_t *visibility, uint8_t *lastRejectingPlanes = NULL) const;
+
+	/**
+	 * @return true if the given object is set as visible in a bitmask
+	 *         filled in by TestBoxes() or TestSpheres()
+	 */
+	static bool IsVisible(const uint32_t *visibility, uint index);
+
 private:
 	bool TestPlaneAgainstBox(const Plane &plane, float minX, float minY, float minZ, float width, float height, float depth) const;
 	bool TestPlaneAgainstSphere(const Plane &plane, const Vector3 &center, float radius) const;
@@ -71,4 +121,9 @@ private:
 	Plane m_planes[NUM_FRUSTUM_SIDES];
 };
 
+inline bool Frustum::IsVisible(const uint32_t *visibility, uint index)
+{
+	return IsBitSet((uint32_t)1 << (index % 32), visibility[index / 32]);
+}
+
 #endif
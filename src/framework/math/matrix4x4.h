@@ -5,6 +5,7 @@
 #include <math.h>
 #include "common.h"
 #include "mathhelpers.h"
+#include "simdfloat4.h"
 #include "vector3.h"
 #include "vector4.h"
 
@@ -1080,6 +1081,59 @@ inline Matrix4x4 Matrix4x4::CreateWorld(const Vector3 &position, const Vector3 &
 
 inline Matrix4x4 Matrix4x4::Inverse(const Matrix4x4 &m)
 {
+#if !defined(SIMD_SCALAR)
+	// same cofactor expansion as below, but worked out one row of the
+	// inverse at a time from the 2x2 determinants of each pair of columns
+	// in the top two and bottom two rows
+	SimdFloat4 c0 = SimdLoad(&m.m[0]);
+	SimdFloat4 c1 = SimdLoad(&m.m[4]);
+	SimdFloat4 c2 = SimdLoad(&m.m[8]);
+	SimdFloat4 c3 = SimdLoad(&m.m[12]);
+	SimdFloat4 s0 = SimdShuffle<1, 0, 3, 2>(c0);
+	SimdFloat4 s1 = SimdShuffle<1, 0, 3, 2>(c1);
+	SimdFloat4 s2 = SimdShuffle<1, 0, 3, 2>(c2);
+	SimdFloat4 s3 = SimdShuffle<1, 0, 3, 2>(c3);
+
+	// each of these has the bottom two rows' determinant for the pair of
+	// columns in the first two components and the top two rows' in the last
+	SimdFloat4 d01 = SimdMul(c0, s1);
+	SimdFloat4 d02 = SimdMul(c0, s2);
+	SimdFloat4 d03 = SimdMul(c0, s3);
+	SimdFloat4 d12 = SimdMul(c1, s2);
+	SimdFloat4 d13 = SimdMul(c1, s3);
+	SimdFloat4 d23 = SimdMul(c2, s3);
+	d01 = SimdShuffle<2, 2, 0, 0>(SimdSub(d01, SimdShuffle<1, 0, 3, 2>(d01)));
+	d02 = SimdShuffle<2, 2, 0, 0>(SimdSub(d02, SimdShuffle<1, 0, 3, 2>(d02)));
+	d03 = SimdShuffle<2, 2, 0, 0>(SimdSub(d03, SimdShuffle<1, 0, 3, 2>(d03)));
+	d12 = SimdShuffle<2, 2, 0, 0>(SimdSub(d12, SimdShuffle<1, 0, 3, 2>(d12)));
+	d13 = SimdShuffle<2, 2, 0, 0>(SimdSub(d13, SimdShuffle<1, 0, 3, 2>(d13)));
+	d23 = SimdShuffle<2, 2, 0, 0>(SimdSub(d23, SimdShuffle<1, 0, 3, 2>(d23)));
+
+	SimdFloat4 sign = SimdSet(1.0f, -1.0f, 1.0f, -1.0f);
+	SimdFloat4 r0 = SimdMul(sign, SimdMulAdd(s3, d12, SimdNegMulAdd(s2, d13, SimdMul(s1, d23))));
+	SimdFloat4 r1 = SimdMul(sign, SimdNegMulAdd(s3, d02, SimdNegMulAdd(s0, d23, SimdMul(s2, d03))));
+	SimdFloat4 r2 = SimdMul(sign, SimdMulAdd(s3, d01, SimdNegMulAdd(s1, d03, SimdMul(s0, d13))));
+	SimdFloat4 r3 = SimdMul(sign, SimdNegMulAdd(s2, d01, SimdNegMulAdd(s0, d12, SimdMul(s1, d02))));
+
+	float d = SimdGetX(SimdDot4(r0, c0));
+	if (IsCloseEnough(d, 0.0f))
+		return IDENTITY_MATRIX;
+
+	SimdFloat4 inverseD = SimdSplat(1.0f / d);
+	r0 = SimdMul(r0, inverseD);
+	r1 = SimdMul(r1, inverseD);
+	r2 = SimdMul(r2, inverseD);
+	r3 = SimdMul(r3, inverseD);
+	SimdTranspose(r0, r1, r2, r3);
+
+	Matrix4x4 out;
+	SimdStore(&out.m[0], r0);
+	SimdStore(&out.m[4], r1);
+	SimdStore(&out.m[8], r2);
+	SimdStore(&out.m[12], r3);
+
+	return out;
+#else
 	float d = m.GetDeterminant();
 	if (IsCloseEnough(d, 0.0f))
 		return IDENTITY_MATRIX;
@@ -1111,6 +1165,7 @@ inline Matrix4x4 Matrix4x4::Inverse(const Matrix4x4 &m)
 		
 		return out;
 	}
+#endif
 }
 
 inline Matrix4x4 Matrix4x4::Transpose(const Matrix4x4 &m)
@@ -1142,6 +1197,16 @@ inline Matrix4x4 Matrix4x4::Transpose(const Matrix4x4 &m)
 
 inline Vector3 Matrix4x4::Transform(const Matrix4x4 &m, const Vector3 &v)
 {
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdMul(SimdLoad(&m.m[0]), SimdSplat(v.x));
+	r = SimdMulAdd(SimdLoad(&m.m[4]), SimdSplat(v.y), r);
+	r = SimdMulAdd(SimdLoad(&m.m[8]), SimdSplat(v.z), r);
+	r = SimdAdd(r, SimdLoad(&m.m[12]));
+
+	float out[4];
+	SimdStore(out, r);
+	return Vector3(out[0], out[1], out[2]);
+#else
 	Vector3 out;
 	
 	out.x = v.x * m.m[_11] + v.y * m.m[_12] + v.z * m.m[_13] + m.m[_14];
@@ -1149,22 +1214,40 @@ inline Vector3 Matrix4x4::Transform(const Matrix4x4 &m, const Vector3 &v)
 	out.z = v.x * m.m[_31] + v.y * m.m[_32] + v.z * m.m[_33] + m.m[_34];
 	
 	return out;
+#endif
 }
 
 inline Vector4 Matrix4x4::Transform(const Matrix4x4 &m, const Vector4 &v)
 {
 	Vector4 out;
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdMul(SimdLoad(&m.m[0]), SimdSplat(v.x));
+	r = SimdMulAdd(SimdLoad(&m.m[4]), SimdSplat(v.y), r);
+	r = SimdMulAdd(SimdLoad(&m.m[8]), SimdSplat(v.z), r);
+	r = SimdMulAdd(SimdLoad(&m.m[12]), SimdSplat(v.w), r);
+	SimdStore(&out.x, r);
+#else
 	
 	out.x = v.x * m.m[_11] + v.y * m.m[_12] + v.z * m.m[_13] + v.w * m.m[_14];
 	out.y = v.x * m.m[_21] + v.y * m.m[_22] + v.z * m.m[_23] + v.w * m.m[_24];
 	out.z = v.x * m.m[_31] + v.y * m.m[_32] + v.z * m.m[_33] + v.w * m.m[_34];
 	out.w = v.x * m.m[_41] + v.y * m.m[_42] + v.z * m.m[_43] + v.w * m.m[_44];
+#endif
 	
 	return out;
 }
 
 inline Vector3 Matrix4x4::TransformUsingRotationOnly(const Matrix4x4 &m, const Vector3 &v)
 {
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdMul(SimdLoad(&m.m[0]), SimdSplat(v.x));
+	r = SimdMulAdd(SimdLoad(&m.m[4]), SimdSplat(v.y), r);
+	r = SimdMulAdd(SimdLoad(&m.m[8]), SimdSplat(v.z), r);
+
+	float out[4];
+	SimdStore(out, r);
+	return Vector3(out[0], out[1], out[2]);
+#else
 	Vector3 out;
 	
 	out.x = v.x * m.m[_11] + v.y * m.m[_12] + v.z * m.m[_13];
@@ -1172,6 +1255,7 @@ inline Vector3 Matrix4x4::TransformUsingRotationOnly(const Matrix4x4 &m, const V
 	out.z = v.x * m.m[_31] + v.y * m.m[_32] + v.z * m.m[_33];
 	
 	return out;
+#endif
 }
 
 inline Matrix4x4 operator+(const Matrix4x4 &left, const Matrix4x4 &right)
@@ -1238,6 +1322,23 @@ inline Matrix4x4 operator*(const Matrix4x4 &left, const Matrix4x4 &right)
 {
 	Matrix4x4 result;
 
+#if !defined(SIMD_SCALAR)
+	// each column of the result is the left matrix's columns weighted by
+	// the elements in the same column of the right matrix
+	SimdFloat4 c0 = SimdLoad(&left.m[0]);
+	SimdFloat4 c1 = SimdLoad(&left.m[4]);
+	SimdFloat4 c2 = SimdLoad(&left.m[8]);
+	SimdFloat4 c3 = SimdLoad(&left.m[12]);
+	for (int i = 0; i < 16; i += 4)
+	{
+		SimdFloat4 r = SimdMul(c0, SimdSplat(right.m[i]));
+		r = SimdMulAdd(c1, SimdSplat(right.m[i + 1]), r);
+		r = SimdMulAdd(c2, SimdSplat(right.m[i + 2]), r);
+		r = SimdMulAdd(c3, SimdSplat(right.m[i + 3]), r);
+		SimdStore(&result.m[i], r);
+	}
+#else
+
 	result.m[_11] = left.m[_11] * right.m[_11] + left.m[_12] * right.m[_21] + left.m[_13] * right.m[_31] + left.m[_14] * right.m[_41];
 	result.m[_12] = left.m[_11] * right.m[_12] + left.m[_12] * right.m[_22] + left.m[_13] * right.m[_32] + left.m[_14] * right.m[_42];
 	result.m[_13] = left.m[_11] * right.m[_13] + left.m[_12] * right.m[_23] + left.m[_13] * right.m[_33] + left.m[_14] * right.m[_43];
@@ -1257,6 +1358,7 @@ inline Matrix4x4 operator*(const Matrix4x4 &left, const Matrix4x4 &right)
 	result.m[_42] = left.m[_41] * right.m[_12] + left.m[_42] * right.m[_22] + left.m[_43] * right.m[_32] + left.m[_44] * right.m[_42];
 	result.m[_43] = left.m[_41] * right.m[_13] + left.m[_42] * right.m[_23] + left.m[_43] * right.m[_33] + left.m[_44] * right.m[_43];
 	result.m[_44] = left.m[_41] * right.m[_14] + left.m[_42] * right.m[_24] + left.m[_43] * right.m[_34] + left.m[_44] * right.m[_44];
+#endif
 
 	return result;
 }
@@ -372,6 +372,14 @@ inline Quaternion Quaternion::Lerp(const Quaternion &a, const Quaternion &b, flo
 
 inline Quaternion Quaternion::Normalize(const Quaternion &q)
 {
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdLoad(&q.x);
+	r = SimdMul(r, SimdInvSqrt(SimdDot4(r, r)));
+
+	Quaternion out;
+	SimdStore(&out.x, r);
+	return out;
+#else
 	float inverseLength = 1.0f / Length(q);
 	return Quaternion(
 		q.x * inverseLength,
@@ -379,6 +387,7 @@ inline Quaternion Quaternion::Normalize(const Quaternion &q)
 		q.z * inverseLength,
 		q.w * inverseLength
 		);
+#endif
 }
 
 inline Quaternion Quaternion::Slerp(const Quaternion &a, const Quaternion &b, float interpolation)
@@ -425,11 +434,24 @@ inline Quaternion Quaternion::Slerp(const Quaternion &a, const Quaternion &b, fl
 		blendB = interpolation;
 	}
 
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdMulAdd(SimdLoad(&q2.x), SimdSplat(blendB), SimdMul(SimdLoad(&q1.x), SimdSplat(blendA)));
+	SimdFloat4 lengthSquared = SimdDot4(r, r);
+	if (SimdGetX(lengthSquared) > 0.0f)
+	{
+		Quaternion result;
+		SimdStore(&result.x, SimdMul(r, SimdInvSqrt(lengthSquared)));
+		return result;
+	}
+	else
+		return IDENTITY_QUATERNION;
+#else
 	Quaternion result(q1.GetVector() * blendA + q2.GetVector() * blendB, q1.w * blendA + q2.w * blendB);
 	if (LengthSquared(result) > 0.0f)
 		return Normalize(result);
 	else
 		return IDENTITY_QUATERNION;
+#endif
 }
 
 inline Quaternion operator+(const Quaternion &left, const Quaternion &right)
@@ -0,0 +1,342 @@
+#ifndef __FRAMEWORK_MATH_SIMDFLOAT4_H_INCLUDED__
+#define __FRAMEWORK_MATH_SIMDFLOAT4_H_INCLUDED__
+
+#include "../common.h"
+#include <math.h>
+
+/**
+ * Thin wrapper over a 4-wide float vector register. Uses SSE on x86/x64,
+ * NEON on ARM and falls back to plain scalar code everywhere else. This
+ * is intended for code that processes data stored in SoA (structure of
+ * arrays) layout, 4 elements at a time, as well as for the math types
+ * which are made up of 4 floats (or 16, for Matrix4x4).
+ *
+ * Defining NO_SIMD forces the scalar code to be used everywhere. The
+ * scalar code is the reference implementation that the others should
+ * match, give or take floating point rounding.
+ */
+
+#if defined(NO_SIMD)
+	#define SIMD_SCALAR
+	struct SimdFloat4
+	{
+		float v[4];
+	};
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define SIMD_SSE
+	#include <xmmintrin.h>
+	typedef __m128 SimdFloat4;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+	#define SIMD_NEON
+	#include <arm_neon.h>
+	typedef float32x4_t SimdFloat4;
+#else
+	#define SIMD_SCALAR
+	struct SimdFloat4
+	{
+		float v[4];
+	};
+#endif
+
+/**
+ * Loads 4 floats. The source does not need to be 16-byte aligned.
+ */
+inline SimdFloat4 SimdLoad(const float *p)
+{
+#if defined(SIMD_SSE)
+	return _mm_loadu_ps(p);
+#elif defined(SIMD_NEON)
+	return vld1q_f32(p);
+#else
+	SimdFloat4 r;
+	r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3];
+	return r;
+#endif
+}
+
+/**
+ * Stores 4 floats. The destination does not need to be 16-byte aligned.
+ */
+inline void SimdStore(float *p, const SimdFloat4 &a)
+{
+#if defined(SIMD_SSE)
+	_mm_storeu_ps(p, a);
+#elif defined(SIMD_NEON)
+	vst1q_f32(p, a);
+#else
+	p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+#endif
+}
+
+/**
+ * @return a vector with the 4 given components
+ */
+inline SimdFloat4 SimdSet(float x, float y, float z, float w)
+{
+#if defined(SIMD_SSE)
+	return _mm_setr_ps(x, y, z, w);
+#elif defined(SIMD_NEON)
+	float v[4] = { x, y, z, w };
+	return vld1q_f32(v);
+#else
+	SimdFloat4 r;
+	r.v[0] = x; r.v[1] = y; r.v[2] = z; r.v[3] = w;
+	return r;
+#endif
+}
+
+/**
+ * @return the first component of a vector
+ */
+inline float SimdGetX(const SimdFloat4 &a)
+{
+#if defined(SIMD_SSE)
+	return _mm_cvtss_f32(a);
+#elif defined(SIMD_NEON)
+	return vgetq_lane_f32(a, 0);
+#else
+	return a.v[0];
+#endif
+}
+
+/**
+ * @return a vector with all 4 components set to the given value
+ */
+inline SimdFloat4 SimdSplat(float f)
+{
+#if defined(SIMD_SSE)
+	return _mm_set1_ps(f);
+#elif defined(SIMD_NEON)
+	return vdupq_n_f32(f);
+#else
+	SimdFloat4 r;
+	r.v[0] = f; r.v[1] = f; r.v[2] = f; r.v[3] = f;
+	return r;
+#endif
+}
+
+inline SimdFloat4 SimdAdd(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_add_ps(a, b);
+#elif defined(SIMD_NEON)
+	return vaddq_f32(a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = a.v[i] + b.v[i];
+	return r;
+#endif
+}
+
+inline SimdFloat4 SimdSub(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_sub_ps(a, b);
+#elif defined(SIMD_NEON)
+	return vsubq_f32(a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = a.v[i] - b.v[i];
+	return r;
+#endif
+}
+
+inline SimdFloat4 SimdMul(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_mul_ps(a, b);
+#elif defined(SIMD_NEON)
+	return vmulq_f32(a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = a.v[i] * b.v[i];
+	return r;
+#endif
+}
+
+/**
+ * @return (a * b) + c
+ */
+inline SimdFloat4 SimdMulAdd(const SimdFloat4 &a, const SimdFloat4 &b, const SimdFloat4 &c)
+{
+#if defined(SIMD_SSE)
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#elif defined(SIMD_NEON)
+	return vmlaq_f32(c, a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = (a.v[i] * b.v[i]) + c.v[i];
+	return r;
+#endif
+}
+
+/**
+ * @return c - (a * b)
+ */
+inline SimdFloat4 SimdNegMulAdd(const SimdFloat4 &a, const SimdFloat4 &b, const SimdFloat4 &c)
+{
+#if defined(SIMD_SSE)
+	return _mm_sub_ps(c, _mm_mul_ps(a, b));
+#elif defined(SIMD_NEON)
+	return vmlsq_f32(c, a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = c.v[i] - (a.v[i] * b.v[i]);
+	return r;
+#endif
+}
+
+inline SimdFloat4 SimdMin(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_min_ps(a, b);
+#elif defined(SIMD_NEON)
+	return vminq_f32(a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = (a.v[i] < b.v[i] ? a.v[i] : b.v[i]);
+	return r;
+#endif
+}
+
+inline SimdFloat4 SimdMax(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_max_ps(a, b);
+#elif defined(SIMD_NEON)
+	return vmaxq_f32(a, b);
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = (a.v[i] > b.v[i] ? a.v[i] : b.v[i]);
+	return r;
+#endif
+}
+
+/**
+ * @return 1.0 / sqrt(a) for each component. Not an approximation, the
+ *         result is as accurate as the scalar equivalent (more or less)
+ */
+inline SimdFloat4 SimdInvSqrt(const SimdFloat4 &a)
+{
+#if defined(SIMD_SSE)
+	return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a));
+#elif defined(SIMD_NEON)
+	// estimate refined with two newton-raphson steps
+	float32x4_t e = vrsqrteq_f32(a);
+	e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+	e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+	return e;
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = 1.0f / sqrtf(a.v[i]);
+	return r;
+#endif
+}
+
+/**
+ * @return for each component, 1.0 if a < b or 0.0 otherwise
+ */
+inline SimdFloat4 SimdLessThanAsFloat(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_and_ps(_mm_cmplt_ps(a, b), _mm_set1_ps(1.0f));
+#elif defined(SIMD_NEON)
+	return vreinterpretq_f32_u32(vandq_u32(vcltq_f32(a, b), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+#else
+	SimdFloat4 r;
+	for (int i = 0; i < 4; ++i)
+		r.v[i] = (a.v[i] < b.v[i] ? 1.0f : 0.0f);
+	return r;
+#endif
+}
+
+/**
+ * @return a 4-bit mask with bit N set if component N of a < b
+ */
+inline int SimdLessThanMask(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+#if defined(SIMD_SSE)
+	return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+#elif defined(SIMD_NEON)
+	uint32x4_t c = vcltq_f32(a, b);
+	return (int)((vgetq_lane_u32(c, 0) & 1) | (vgetq_lane_u32(c, 1) & 2) | (vgetq_lane_u32(c, 2) & 4) | (vgetq_lane_u32(c, 3) & 8));
+#else
+	int r = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (a.v[i] < b.v[i])
+			r |= (1 << i);
+	}
+	return r;
+#endif
+}
+
+/**
+ * Rearranges the components of a vector.
+ * @param <X> index of the component to put in the first component
+ * @param <Y> index of the component to put in the second component
+ * @param <Z> index of the component to put in the third component
+ * @param <W> index of the component to put in the fourth component
+ */
+template <int X, int Y, int Z, int W>
+inline SimdFloat4 SimdShuffle(const SimdFloat4 &a)
+{
+#if defined(SIMD_SSE)
+	return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+#elif defined(SIMD_NEON)
+	float32x4_t r = vdupq_n_f32(vgetq_lane_f32(a, X));
+	r = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+	r = vsetq_lane_f32(vgetq_lane_f32(a, Z), r, 2);
+	r = vsetq_lane_f32(vgetq_lane_f32(a, W), r, 3);
+	return r;
+#else
+	SimdFloat4 r;
+	r.v[0] = a.v[X]; r.v[1] = a.v[Y]; r.v[2] = a.v[Z]; r.v[3] = a.v[W];
+	return r;
+#endif
+}
+
+/**
+ * @return the dot product of a and b in all 4 components
+ */
+inline SimdFloat4 SimdDot4(const SimdFloat4 &a, const SimdFloat4 &b)
+{
+	SimdFloat4 t = SimdMul(a, b);
+	t = SimdAdd(t, SimdShuffle<1, 0, 3, 2>(t));
+	return SimdAdd(t, SimdShuffle<2, 3, 0, 1>(t));
+}
+
+/**
+ * Transposes the 4x4 matrix made up of the 4 given vectors in place.
+ */
+inline void SimdTranspose(SimdFloat4 &r0, SimdFloat4 &r1, SimdFloat4 &r2, SimdFloat4 &r3)
+{
+#if defined(SIMD_SSE)
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#elif defined(SIMD_NEON)
+	float32x4x2_t t01 = vtrnq_f32(r0, r1);
+	float32x4x2_t t23 = vtrnq_f32(r2, r3);
+	r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#else
+	float t;
+	t = r0.v[1]; r0.v[1] = r1.v[0]; r1.v[0] = t;
+	t = r0.v[2]; r0.v[2] = r2.v[0]; r2.v[0] = t;
+	t = r0.v[3]; r0.v[3] = r3.v[0]; r3.v[0] = t;
+	t = r1.v[2]; r1.v[2] = r2.v[1]; r2.v[1] = t;
+	t = r1.v[3]; r1.v[3] = r3.v[1]; r3.v[1] = t;
+	t = r2.v[3]; r2.v[3] = r3.v[2]; r3.v[2] = t;
+#endif
+}
+
+#endif
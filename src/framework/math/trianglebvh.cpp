@@ -0,0 +1,653 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "trianglebvh.h"
+
+#include <float.h>
+#include <limits.h>
+
+#include "collisionpacket.h"
+#include "intersectiontester.h"
+#include "mathhelpers.h"
+#include "ray.h"
+#include "../file/file.h"
+
+const uint BVH_NUM_BINS = 16;
+
+// also the traversal stack size. nodes this deep are always made leaves
+const uint BVH_MAX_DEPTH = 64;
+
+// relative cost of visiting an interior node compared to testing a triangle
+const float BVH_TRAVERSAL_COST = 1.0f;
+
+const uint32_t BVH_FILE_MAGIC = 0x48564254;     // "TBVH"
+const uint32_t BVH_FILE_VERSION = 1;
+
+// sizes of each node (bounds, offset and count) and each triangle (index and
+// 3 vertices) as they are written out to a file
+const size_t BVH_FILE_NODE_SIZE = 6 * sizeof(float) + 2 * sizeof(uint32_t);
+const size_t BVH_FILE_TRIANGLE_SIZE = sizeof(uint32_t) + 9 * sizeof(float);
+
+struct TriangleBvh::BuildTriangle
+{
+	BoundingBox bounds;
+	Vector3 centroid;
+	uint index;
+};
+
+static void Encapsulate(BoundingBox &box, const Vector3 &point)
+{
+	box.min.x = Min(box.min.x, point.x);
+	box.min.y = Min(box.min.y, point.y);
+	box.min.z = Min(box.min.z, point.z);
+	box.max.x = Max(box.max.x, point.x);
+	box.max.y = Max(box.max.y, point.y);
+	box.max.z = Max(box.max.z, point.z);
+}
+
+static void Encapsulate(BoundingBox &box, const BoundingBox &other)
+{
+	// empty boxes (see SetEmpty) would otherwise grow the box to infinity
+	if (other.min.x > other.max.x)
+		return;
+	Encapsulate(box, other.min);
+	Encapsulate(box, other.max);
+}
+
+static void SetEmpty(BoundingBox &box)
+{
+	box.min = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+	box.max = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+}
+
+static float GetSurfaceArea(const BoundingBox &box)
+{
+	Vector3 size = box.max - box.min;
+	if (size.x < 0.0f)
+		return 0.0f;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+static float GetAxis(const Vector3 &v, uint axis)
+{
+	if (axis == 0)
+		return v.x;
+	else if (axis == 1)
+		return v.y;
+	else
+		return v.z;
+}
+
+static bool Overlaps(const BoundingBox &a, const BoundingBox &b)
+{
+	return (a.min.x <= b.max.x && a.max.x >= b.min.x) &&
+	       (a.min.y <= b.max.y && a.max.y >= b.min.y) &&
+	       (a.min.z <= b.max.z && a.max.z >= b.min.z);
+}
+
+// slab test against a box using the ray's precomputed inverse direction.
+// returns the distance along the ray that it enters the box, or a negative
+// value if it misses or enters further away than maxT
+static float GetRayEntry(const BoundingBox &box, const Vector3 &origin, const Vector3 &inverseDirection, float maxT)
+{
+	float t1 = (box.min.x - origin.x) * inverseDirection.x;
+	float t2 = (box.max.x - origin.x) * inverseDirection.x;
+	float tmin = Min(t1, t2);
+	float tmax = Max(t1, t2);
+
+	t1 = (box.min.y - origin.y) * inverseDirection.y;
+	t2 = (box.max.y - origin.y) * inverseDirection.y;
+	tmin = Max(tmin, Min(t1, t2));
+	tmax = Min(tmax, Max(t1, t2));
+
+	t1 = (box.min.z - origin.z) * inverseDirection.z;
+	t2 = (box.max.z - origin.z) * inverseDirection.z;
+	tmin = Max(tmin, Min(t1, t2));
+	tmax = Min(tmax, Max(t1, t2));
+
+	tmin = Max(tmin, 0.0f);
+	if (tmax < tmin || tmin > maxT)
+		return -1.0f;
+	else
+		return tmin;
+}
+
+// inverse of a ray direction component that avoids producing NaNs in the
+// slab test when the direction is axis-aligned
+static float GetSafeInverse(float f)
+{
+	if (fabsf(f) < 1e-20f)
+		return (f < 0.0f) ? -1e20f : 1e20f;
+	else
+		return 1.0f / f;
+}
+
+TriangleBvh::TriangleBvh()
+{
+}
+
+TriangleBvh::~TriangleBvh()
+{
+	Release();
+}
+
+void TriangleBvh::Release()
+{
+	m_nodes.clear();
+	m_vertices.clear();
+	m_triangleIndices.clear();
+	m_triangleOrder.clear();
+}
+
+bool TriangleBvh::Build(const Vector3 *vertices, uint numVertices, uint maxTrianglesPerLeaf)
+{
+	ASSERT(vertices != NULL || numVertices == 0);
+	ASSERT(numVertices % 3 == 0);
+	ASSERT(maxTrianglesPerLeaf > 0);
+	if (numVertices % 3 != 0 || maxTrianglesPerLeaf == 0)
+		return false;
+
+	Release();
+
+	uint numTriangles = numVertices / 3;
+	if (numTriangles == 0)
+		return true;
+
+	stl::vector<BuildTriangle> triangles;
+	triangles.resize(numTriangles);
+	for (uint i = 0; i < numTriangles; ++i)
+	{
+		const Vector3 *v = &vertices[i * 3];
+		BuildTriangle &t = triangles[i];
+		t.bounds.min = v[0];
+		t.bounds.max = v[0];
+		Encapsulate(t.bounds, v[1]);
+		Encapsulate(t.bounds, v[2]);
+		t.centroid = (t.bounds.min + t.bounds.max) * 0.5f;
+		t.index = i;
+	}
+
+	// a balanced tree has slightly less then 2 nodes per leaf
+	m_nodes.reserve((numTriangles / maxTrianglesPerLeaf + 1) * 2);
+	BuildNode(triangles, 0, numTriangles, 0, maxTrianglesPerLeaf);
+
+	// store the triangles in the order the leaves refer to them so that
+	// each leaf's vertices are contiguous
+	m_vertices.resize(numVertices);
+	m_triangleIndices.resize(numTriangles);
+	m_triangleOrder.resize(numTriangles);
+	for (uint i = 0; i < numTriangles; ++i)
+	{
+		uint index = triangles[i].index;
+		m_vertices[i * 3] = vertices[index * 3];
+		m_vertices[i * 3 + 1] = vertices[index * 3 + 1];
+		m_vertices[i * 3 + 2] = vertices[index * 3 + 2];
+		m_triangleIndices[i] = index;
+		m_triangleOrder[index] = i;
+	}
+
+	return true;
+}
+
+uint TriangleBvh::BuildNode(stl::vector<BuildTriangle> &triangles, uint start, uint count, uint depth, uint maxTrianglesPerLeaf)
+{
+	uint nodeIndex = m_nodes.size();
+	m_nodes.push_back(TriangleBvhNode());
+
+	BoundingBox bounds;
+	BoundingBox centroidBounds;
+	SetEmpty(bounds);
+	SetEmpty(centroidBounds);
+	for (uint i = start; i < start + count; ++i)
+	{
+		Encapsulate(bounds, triangles[i].bounds);
+		Encapsulate(centroidBounds, triangles[i].centroid);
+	}
+	m_nodes[nodeIndex].bounds = bounds;
+
+	// split along the axis that the triangle centroids are most spread out
+	// along
+	Vector3 centroidExtents = centroidBounds.max - centroidBounds.min;
+	uint axis = 0;
+	if (centroidExtents.y > centroidExtents.x)
+		axis = 1;
+	if (centroidExtents.z > GetAxis(centroidExtents, axis))
+		axis = 2;
+	float axisMin = GetAxis(centroidBounds.min, axis);
+	float axisExtent = GetAxis(centroidExtents, axis);
+
+	// all centroids in the same spot can't be split up any further
+	if (count <= maxTrianglesPerLeaf || axisExtent <= 0.0f || depth >= BVH_MAX_DEPTH - 2)
+	{
+		m_nodes[nodeIndex].offset = start;
+		m_nodes[nodeIndex].numTriangles = count;
+		return nodeIndex;
+	}
+
+	// sort triangles into evenly spaced bins along the axis
+	uint binCounts[BVH_NUM_BINS];
+	BoundingBox binBounds[BVH_NUM_BINS];
+	for (uint i = 0; i < BVH_NUM_BINS; ++i)
+	{
+		binCounts[i] = 0;
+		SetEmpty(binBounds[i]);
+	}
+
+	float binScale = (float)BVH_NUM_BINS / axisExtent;
+	for (uint i = start; i < start + count; ++i)
+	{
+		uint bin = (uint)((GetAxis(triangles[i].centroid, axis) - axisMin) * binScale);
+		bin = Min(bin, BVH_NUM_BINS - 1);
+		++binCounts[bin];
+		Encapsulate(binBounds[bin], triangles[i].bounds);
+	}
+
+	// sweep from the right to get the area of everything to the right of
+	// each split, then from the left to find the cheapest split
+	float rightAreas[BVH_NUM_BINS];
+	uint rightCounts[BVH_NUM_BINS];
+	BoundingBox accumulated;
+	SetEmpty(accumulated);
+	uint accumulatedCount = 0;
+	for (uint i = BVH_NUM_BINS - 1; i > 0; --i)
+	{
+		Encapsulate(accumulated, binBounds[i]);
+		accumulatedCount += binCounts[i];
+		rightAreas[i] = GetSurfaceArea(accumulated);
+		rightCounts[i] = accumulatedCount;
+	}
+
+	float bestCost = FLT_MAX;
+	uint bestSplit = 0;
+	SetEmpty(accumulated);
+	accumulatedCount = 0;
+	for (uint i = 1; i < BVH_NUM_BINS; ++i)
+	{
+		Encapsulate(accumulated, binBounds[i - 1]);
+		accumulatedCount += binCounts[i - 1];
+		if (accumulatedCount == 0 || rightCounts[i] == 0)
+			continue;
+
+		float cost = GetSurfaceArea(accumulated) * (float)accumulatedCount + rightAreas[i] * (float)rightCounts[i];
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestSplit = i;
+		}
+	}
+
+	// keep this as a leaf if splitting wouldn't make it any cheaper to test,
+	// as long as the leaf won't get too big
+	float area = GetSurfaceArea(bounds);
+	float splitCost = BVH_TRAVERSAL_COST + (area > 0.0f ? bestCost / area : 0.0f);
+	if (bestSplit == 0 || (splitCost >= (float)count && count <= maxTrianglesPerLeaf * 4))
+	{
+		m_nodes[nodeIndex].offset = start;
+		m_nodes[nodeIndex].numTriangles = count;
+		return nodeIndex;
+	}
+
+	// move all triangles on the left side of the split to the front
+	uint middle = start;
+	for (uint i = start; i < start + count; ++i)
+	{
+		uint bin = (uint)((GetAxis(triangles[i].centroid, axis) - axisMin) * binScale);
+		bin = Min(bin, BVH_NUM_BINS - 1);
+		if (bin < bestSplit)
+		{
+			BuildTriangle temp = triangles[i];
+			triangles[i] = triangles[middle];
+			triangles[middle] = temp;
+			++middle;
+		}
+	}
+	ASSERT(middle > start && middle < start + count);
+
+	// m_nodes can be reallocated while building the children, so only
+	// refer to this node by index from here on
+	m_nodes[nodeIndex].numTriangles = 0;
+	BuildNode(triangles, start, middle - start, depth + 1, maxTrianglesPerLeaf);
+	uint secondChild = BuildNode(triangles, middle, start + count - middle, depth + 1, maxTrianglesPerLeaf);
+	m_nodes[nodeIndex].offset = secondChild;
+
+	return nodeIndex;
+}
+
+bool TriangleBvh::Test(const Ray &ray, Vector3 *intersection, uint *triangle) const
+{
+	if (!IsBuilt())
+		return false;
+
+	float directionLengthSq = Vector3::LengthSquared(ray.direction);
+	if (directionLengthSq == 0.0f)
+		return false;
+
+	Vector3 inverseDirection(GetSafeInverse(ray.direction.x), GetSafeInverse(ray.direction.y), GetSafeInverse(ray.direction.z));
+
+	float closestT = FLT_MAX;
+	uint closestTriangle = 0;
+	Vector3 closestPoint = ZERO_VECTOR;
+	bool found = false;
+
+	if (GetRayEntry(m_nodes[0].bounds, ray.position, inverseDirection, closestT) < 0.0f)
+		return false;
+
+	uint stack[BVH_MAX_DEPTH];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		uint nodeIndex = stack[--stackSize];
+		const TriangleBvhNode &node = m_nodes[nodeIndex];
+
+		if (node.IsLeaf())
+		{
+			for (uint i = node.offset; i < node.offset + node.numTriangles; ++i)
+			{
+				const Vector3 *v = &m_vertices[i * 3];
+				Vector3 point;
+				if (IntersectionTester::Test(ray, v[0], v[1], v[2], &point))
+				{
+					float t = Vector3::Dot(point - ray.position, ray.direction) / directionLengthSq;
+					if (t < closestT)
+					{
+						closestT = t;
+						closestPoint = point;
+						closestTriangle = i;
+						found = true;
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the nearest child first so that hits in it can be used
+			// to skip the other one
+			uint first = nodeIndex + 1;
+			uint second = node.offset;
+			float firstT = GetRayEntry(m_nodes[first].bounds, ray.position, inverseDirection, closestT);
+			float secondT = GetRayEntry(m_nodes[second].bounds, ray.position, inverseDirection, closestT);
+
+			if (firstT >= 0.0f && secondT >= 0.0f)
+			{
+				ASSERT(stackSize + 2 <= BVH_MAX_DEPTH);
+				if (firstT <= secondT)
+				{
+					stack[stackSize++] = second;
+					stack[stackSize++] = first;
+				}
+				else
+				{
+					stack[stackSize++] = first;
+					stack[stackSize++] = second;
+				}
+			}
+			else if (firstT >= 0.0f)
+				stack[stackSize++] = first;
+			else if (secondT >= 0.0f)
+				stack[stackSize++] = second;
+		}
+	}
+
+	if (found)
+	{
+		if (intersection != NULL)
+			*intersection = closestPoint;
+		if (triangle != NULL)
+			*triangle = m_triangleIndices[closestTriangle];
+	}
+
+	return found;
+}
+
+bool TriangleBvh::Test(CollisionPacket &packet) const
+{
+	if (!IsBuilt())
+		return false;
+
+	// box around the whole path the ellipsoid moves along, back out of
+	// ellipsoid space
+	Vector3 start = packet.esPosition * packet.ellipsoidRadius;
+	Vector3 end = (packet.esPosition + packet.esVelocity) * packet.ellipsoidRadius;
+	BoundingBox sweptBounds;
+	sweptBounds.min = Vector3(Min(start.x, end.x), Min(start.y, end.y), Min(start.z, end.z)) - packet.ellipsoidRadius;
+	sweptBounds.max = Vector3(Max(start.x, end.x), Max(start.y, end.y), Max(start.z, end.z)) + packet.ellipsoidRadius;
+
+	bool collided = false;
+
+	uint stack[BVH_MAX_DEPTH];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		uint nodeIndex = stack[--stackSize];
+		const TriangleBvhNode &node = m_nodes[nodeIndex];
+		if (!Overlaps(node.bounds, sweptBounds))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			for (uint i = node.offset; i < node.offset + node.numTriangles; ++i)
+			{
+				const Vector3 *v = &m_vertices[i * 3];
+				if (IntersectionTester::Test(packet, v[0], v[1], v[2]))
+					collided = true;
+			}
+		}
+		else
+		{
+			ASSERT(stackSize + 2 <= BVH_MAX_DEPTH);
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+
+	return collided;
+}
+
+uint TriangleBvh::GetOverlappingTriangles(const BoundingBox &box, stl::vector<uint> &triangles) const
+{
+	if (!IsBuilt())
+		return 0;
+
+	uint numAdded = 0;
+
+	uint stack[BVH_MAX_DEPTH];
+	uint stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		uint nodeIndex = stack[--stackSize];
+		const TriangleBvhNode &node = m_nodes[nodeIndex];
+		if (!Overlaps(node.bounds, box))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			for (uint i = node.offset; i < node.offset + node.numTriangles; ++i)
+			{
+				const Vector3 *v = &m_vertices[i * 3];
+				BoundingBox triangleBounds(v[0], v[0]);
+				Encapsulate(triangleBounds, v[1]);
+				Encapsulate(triangleBounds, v[2]);
+				if (Overlaps(triangleBounds, box))
+				{
+					triangles.push_back(m_triangleIndices[i]);
+					++numAdded;
+				}
+			}
+		}
+		else
+		{
+			ASSERT(stackSize + 2 <= BVH_MAX_DEPTH);
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+	}
+
+	return numAdded;
+}
+
+void TriangleBvh::GetTriangle(uint triangle, Vector3 &a, Vector3 &b, Vector3 &c) const
+{
+	ASSERT(triangle < GetNumTriangles());
+	const Vector3 *v = &m_vertices[m_triangleOrder[triangle] * 3];
+	a = v[0];
+	b = v[1];
+	c = v[2];
+}
+
+bool TriangleBvh::Write(File *file) const
+{
+	ASSERT(file != NULL);
+	ASSERT(file->CanWrite());
+	if (!file->CanWrite())
+		return false;
+
+	file->WriteUnsignedInt(BVH_FILE_MAGIC);
+	file->WriteUnsignedInt(BVH_FILE_VERSION);
+	file->WriteUnsignedInt(m_nodes.size());
+	file->WriteUnsignedInt(m_triangleIndices.size());
+
+	for (uint i = 0; i < m_nodes.size(); ++i)
+	{
+		const TriangleBvhNode &node = m_nodes[i];
+		file->WriteFloat(node.bounds.min.x);
+		file->WriteFloat(node.bounds.min.y);
+		file->WriteFloat(node.bounds.min.z);
+		file->WriteFloat(node.bounds.max.x);
+		file->WriteFloat(node.bounds.max.y);
+		file->WriteFloat(node.bounds.max.z);
+		file->WriteUnsignedInt(node.offset);
+		file->WriteUnsignedInt(node.numTriangles);
+	}
+
+	for (uint i = 0; i < m_triangleIndices.size(); ++i)
+	{
+		file->WriteUnsignedInt(m_triangleIndices[i]);
+		for (uint j = i * 3; j < i * 3 + 3; ++j)
+		{
+			file->WriteFloat(m_vertices[j].x);
+			file->WriteFloat(m_vertices[j].y);
+			file->WriteFloat(m_vertices[j].z);
+		}
+	}
+
+	return true;
+}
+
+bool TriangleBvh::Read(File *file)
+{
+	ASSERT(file != NULL);
+	ASSERT(file->CanRead());
+	if (!file->CanRead())
+		return false;
+
+	Release();
+
+	if (file->ReadUnsignedInt() != BVH_FILE_MAGIC)
+	{
+		LOG_ERROR(LOGCAT_ASSETS, "Not a triangle BVH file.\n");
+		return false;
+	}
+	uint32_t version = file->ReadUnsignedInt();
+	if (version != BVH_FILE_VERSION)
+	{
+		LOG_ERROR(LOGCAT_ASSETS, "Unsupported triangle BVH file version %d.\n", version);
+		return false;
+	}
+
+	uint numNodes = file->ReadUnsignedInt();
+	uint numTriangles = file->ReadUnsignedInt();
+
+	// don't allocate anything for nodes and triangles that aren't actually
+	// in the file
+	size_t position = file->Tell();
+	size_t fileSize = file->GetFileSize();
+	size_t remaining = (fileSize > position ? fileSize - position : 0);
+	size_t nodesSize = (size_t)numNodes * BVH_FILE_NODE_SIZE;
+	if ((size_t)numNodes > remaining / BVH_FILE_NODE_SIZE || (size_t)numTriangles > (remaining - nodesSize) / BVH_FILE_TRIANGLE_SIZE)
+	{
+		LOG_ERROR(LOGCAT_ASSETS, "Triangle BVH file is too small for %d nodes and %d triangles.\n", numNodes, numTriangles);
+		return false;
+	}
+
+	// a leaf holds at least 1 triangle, so a binary tree over numTriangles
+	// triangles can't have more than numTriangles * 2 - 1 nodes
+	if (numNodes > 0 && (numTriangles == 0 || numNodes / 2 >= numTriangles))
+	{
+		LOG_ERROR(LOGCAT_ASSETS, "Triangle BVH file has an invalid number of nodes %d.\n", numNodes);
+		return false;
+	}
+
+	// the depth of each node, or UINT_MAX for nodes that no parent node has
+	// referred to yet. the traversals use fixed size stacks, so the tree
+	// must be no deeper than Build() would have made it. every node besides
+	// the root must also be the child of exactly one earlier node
+	stl::vector<uint> depths(numNodes, UINT_MAX);
+	if (numNodes > 0)
+		depths[0] = 0;
+
+	m_nodes.resize(numNodes);
+	for (uint i = 0; i < numNodes; ++i)
+	{
+		TriangleBvhNode &node = m_nodes[i];
+		node.bounds.min.x = file->ReadFloat();
+		node.bounds.min.y = file->ReadFloat();
+		node.bounds.min.z = file->ReadFloat();
+		node.bounds.max.x = file->ReadFloat();
+		node.bounds.max.y = file->ReadFloat();
+		node.bounds.max.z = file->ReadFloat();
+		node.offset = file->ReadUnsignedInt();
+		node.numTriangles = file->ReadUnsignedInt();
+
+		bool isValid;
+		if (depths[i] == UINT_MAX || depths[i] > BVH_MAX_DEPTH - 2)
+			isValid = false;
+		else if (node.IsLeaf())
+			isValid = (node.offset < numTriangles && node.numTriangles <= numTriangles - node.offset);
+		else
+			isValid = (node.offset > i + 1 && node.offset < numNodes && depths[i + 1] == UINT_MAX && depths[node.offset] == UINT_MAX);
+		if (!isValid)
+		{
+			LOG_ERROR(LOGCAT_ASSETS, "Triangle BVH file has an invalid node %d.\n", i);
+			Release();
+			return false;
+		}
+
+		if (!node.IsLeaf())
+		{
+			depths[i + 1] = depths[i] + 1;
+			depths[node.offset] = depths[i] + 1;
+		}
+	}
+
+	m_vertices.resize((size_t)numTriangles * 3);
+	m_triangleIndices.resize(numTriangles);
+	m_triangleOrder.resize(numTriangles, UINT_MAX);
+	for (uint i = 0; i < numTriangles; ++i)
+	{
+		// the indices must be a permutation of 0 to numTriangles - 1
+		uint index = file->ReadUnsignedInt();
+		if (index >= numTriangles || m_triangleOrder[index] != UINT_MAX)
+		{
+			LOG_ERROR(LOGCAT_ASSETS, "Triangle BVH file has an invalid triangle index %d.\n", index);
+			Release();
+			return false;
+		}
+		m_triangleIndices[i] = index;
+		m_triangleOrder[index] = i;
+
+		for (size_t j = (size_t)i * 3; j < (size_t)i * 3 + 3; ++j)
+		{
+			m_vertices[j].x = file->ReadFloat();
+			m_vertices[j].y = file->ReadFloat();
+			m_vertices[j].z = file->ReadFloat();
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,157 @@
+#ifndef __FRAMEWORK_MATH_TRIANGLEBVH_H_INCLUDED__
+#define __FRAMEWORK_MATH_TRIANGLEBVH_H_INCLUDED__
+
+#include "../common.h"
+#include "boundingbox.h"
+#include "vector3.h"
+#include <stl/vector.h>
+
+class File;
+struct CollisionPacket;
+struct Ray;
+
+// the default maximum number of triangles placed in a single leaf node
+const uint BVH_DEFAULT_MAX_LEAF_TRIANGLES = 4;
+
+/**
+ * A single node in a TriangleBvh. Nodes are stored depth-first, so an
+ * interior node's first child always directly follows it.
+ */
+struct TriangleBvhNode
+{
+	BoundingBox bounds;
+
+	// for leaf nodes, the index of the first triangle in the node. for
+	// interior nodes, the index of the node's second child
+	uint offset;
+
+	// the number of triangles in a leaf node, or 0 for interior nodes
+	uint numTriangles;
+
+	bool IsLeaf() const                                    { return numTriangles > 0; }
+};
+
+/**
+ * Bounding volume hierarchy over a list of triangles, used to quickly find
+ * which triangles a ray, box or moving ellipsoid might touch without
+ * testing every single one of them. Built using the surface area heuristic
+ * with binned splits. Triangles are identified by their index in the list
+ * the hierarchy was built from (e.g. triangle 2 is vertices 6, 7 and 8).
+ *
+ * Building can take a while for large meshes, so the built hierarchy can
+ * be written to a file with Write() and loaded back in with Read().
+ */
+class TriangleBvh
+{
+public:
+	TriangleBvh();
+	virtual ~TriangleBvh();
+
+	/**
+	 * Builds the hierarchy, replacing any previously built one.
+	 * @param vertices the triangle vertices, 3 per triangle
+	 * @param numVertices the number of vertices, a multiple of 3
+	 * @param maxTrianglesPerLeaf the number of triangles a leaf node can
+	 *                            contain before it will always be split
+	 * @return true if successful
+	 */
+	bool Build(const Vector3 *vertices, uint numVertices, uint maxTrianglesPerLeaf = BVH_DEFAULT_MAX_LEAF_TRIANGLES);
+
+	/**
+	 * Frees the hierarchy.
+	 */
+	void Release();
+
+	/**
+	 * Finds the closest triangle that a ray intersects with.
+	 * @param ray the ray to test
+	 * @param intersection if not NULL, will contain the point of
+	 *                     intersection with the closest triangle if found
+	 * @param triangle if not NULL, will contain the index of the closest
+	 *                 triangle if found
+	 * @return true if the ray intersected any triangle
+	 */
+	bool Test(const Ray &ray, Vector3 *intersection, uint *triangle = NULL) const;
+
+	/**
+	 * Tests a moving ellipsoid against all triangles it could possibly
+	 * collide with, using IntersectionTester. The packet is updated with
+	 * the closest collision found, if any.
+	 * @param packet the collision packet of the moving ellipsoid. the
+	 *               triangles are in the same space as the ellipsoid's
+	 *               un-scaled (non "ellipsoid space") position
+	 * @return true if the ellipsoid collided with any triangle
+	 */
+	bool Test(CollisionPacket &packet) const;
+
+	/**
+	 * Finds all triangles whose bounds overlap a box. This is a
+	 * conservative test, the triangles themselves may not actually touch
+	 * the box.
+	 * @param box the box to test
+	 * @param triangles list to add the overlapping triangle indices to
+	 * @return the number of triangle indices that were added to the list
+	 */
+	uint GetOverlappingTriangles(const BoundingBox &box, stl::vector<uint> &triangles) const;
+
+	/**
+	 * Writes the built hierarchy to a file.
+	 * @param file the file to write to
+	 * @return true if successful
+	 */
+	bool Write(File *file) const;
+
+	/**
+	 * Reads a hierarchy previously written with Write(), replacing any
+	 * previously built one.
+	 * @param file the file to read from
+	 * @return true if successful
+	 */
+	bool Read(File *file);
+
+	/**
+	 * @return true if there is a built hierarchy with at least 1 triangle
+	 */
+	bool IsBuilt() const                                   { return m_nodes.size() > 0; }
+
+	/**
+	 * @return the number of triangles the hierarchy was built from
+	 */
+	uint GetNumTriangles() const                           { return m_triangleIndices.size(); }
+
+	/**
+	 * @return the number of nodes in the hierarchy
+	 */
+	uint GetNumNodes() const                               { return m_nodes.size(); }
+
+	/**
+	 * @return a box enclosing all of the triangles
+	 */
+	const BoundingBox& GetBounds() const                   { return m_nodes[0].bounds; }
+
+	/**
+	 * Gets the vertices of a triangle.
+	 * @param triangle the index of the triangle to get
+	 * @param a the triangle's first vertex
+	 * @param b the triangle's second vertex
+	 * @param c the triangle's third vertex
+	 */
+	void GetTriangle(uint triangle, Vector3 &a, Vector3 &b, Vector3 &c) const;
+
+private:
+	struct BuildTriangle;
+
+	uint BuildNode(stl::vector<BuildTriangle> &triangles, uint start, uint count, uint depth, uint maxTrianglesPerLeaf);
+
+	stl::vector<TriangleBvhNode> m_nodes;
+
+	// triangle vertices in the order the leaf nodes refer to them
+	stl::vector<Vector3> m_vertices;
+
+	// maps from m_vertices triangle order back to the original triangle
+	// indices (and the reverse, for GetTriangle)
+	stl::vector<uint> m_triangleIndices;
+	stl::vector<uint> m_triangleOrder;
+};
+
+#endif
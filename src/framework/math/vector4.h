@@ -3,6 +3,7 @@
 
 #include "../common.h"
 #include <math.h>
+#include "simdfloat4.h"
 
 /**
  * Represents a 4D vector and provides common methods for vector math.
@@ -213,6 +214,14 @@ inline Vector4 Vector4::Lerp(const Vector4 &a, const Vector4 &b, float interpola
 
 inline Vector4 Vector4::Normalize(const Vector4 &v)
 {
+#if !defined(SIMD_SCALAR)
+	SimdFloat4 r = SimdLoad(&v.x);
+	r = SimdMul(r, SimdInvSqrt(SimdDot4(r, r)));
+
+	Vector4 out;
+	SimdStore(&out.x, r);
+	return out;
+#else
 	float inverseLength = 1.0f / Length(v);
 	return Vector4(
 		v.x * inverseLength,
@@ -220,6 +229,7 @@ inline Vector4 Vector4::Normalize(const Vector4 &v)
 		v.z * inverseLength,
 		v.w * inverseLength
 		);
+#endif
 }
 
 inline Vector4 Vector4::SetLength(const Vector4 &v, float length)
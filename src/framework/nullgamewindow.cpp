@@ -0,0 +1,47 @@
+#ifdef NULL_GRAPHICS
+#include "debug.h"
+#include "log.h"
+
+#include "nullgamewindow.h"
+
+#include "basegameapp.h"
+
+NullGameWindow::NullGameWindow(BaseGameApp *gameApp, uint width, uint height)
+	: GameWindow(gameApp)
+{
+	m_closing = false;
+	m_width = width;
+	m_height = height;
+	m_rect.Set(0, 0, width, height);
+}
+
+NullGameWindow::~NullGameWindow()
+{
+}
+
+bool NullGameWindow::Create(GameWindowParams *params)
+{
+	LOG_INFO(LOGCAT_WINDOW, "Creating a windowless %d x %d game window.\n", m_width, m_height);
+	return true;
+}
+
+bool NullGameWindow::Resize(uint width, uint height)
+{
+	LOG_INFO(LOGCAT_WINDOW, "Resizing to %d x %d.\n", width, height);
+
+	m_width = width;
+	m_height = height;
+	m_rect.Set(0, 0, width, height);
+
+	GetGameApp()->OnResize();
+
+	return true;
+}
+
+void NullGameWindow::Close()
+{
+	LOG_INFO(LOGCAT_WINDOW, "Window marked as closing.\n");
+	m_closing = true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifdef NULL_GRAPHICS
+#ifndef __FRAMEWORK_NULLGAMEWINDOW_H_INCLUDED__
+#define __FRAMEWORK_NULLGAMEWINDOW_H_INCLUDED__
+
+#include "common.h"
+#include "gamewindow.h"
+#include "screenorientation.h"
+
+#include "math/rect.h"
+
+class BaseGameApp;
+
+/**
+ * Game window that has no actual window or display associated with it.
+ * Used together with the null OpenGL implementation to run the game
+ * windowless (e.g. for benchmarking on machines without a GPU). It is always
+ * active and always considered to have a usable "OpenGL" context.
+ */
+class NullGameWindow : public GameWindow
+{
+public:
+	/**
+	 * Creates a windowless game window.
+	 * @param gameApp the parent game application object
+	 * @param width the width to report for the window's client area
+	 * @param height the height to report for the window's client area
+	 */
+	NullGameWindow(BaseGameApp *gameApp, uint width, uint height);
+
+	virtual ~NullGameWindow();
+
+	bool Create(GameWindowParams *params);
+	bool Resize(uint width, uint height);
+	bool ToggleFullscreen()                                { return false; }
+	void Close();
+
+	uint GetWidth() const                                  { return m_width; }
+	uint GetHeight() const                                 { return m_height; }
+	const Rect& GetRect() const                            { return m_rect; }
+	uint GetBPP() const                                    { return 32; }
+	bool IsWindowed() const                                { return true; }
+	SCREEN_ORIENTATION_ANGLE GetScreenOrientation() const  { return SCREEN_ANGLE_0; }
+
+	bool IsActive() const                                  { return true; }
+	bool IsFocused() const                                 { return true; }
+	bool IsClosing() const                                 { return m_closing; }
+	bool HasGLContext() const                              { return true; }
+
+	void ProcessEvent(const OSEvent *event)                {}
+	void Flip()                                            {}
+
+private:
+	bool m_closing;
+	uint m_width;
+	uint m_height;
+	Rect m_rect;
+};
+
+#endif
+#endif
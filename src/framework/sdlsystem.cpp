@@ -6,6 +6,7 @@
 
 #include "basegameapp.h"
 #include "gamewindow.h"
+#include "nullgamewindow.h"
 #include "osevent.h"
 #include "sdlgamewindow.h"
 #include "sdlsystemevent.h"
@@ -55,7 +56,13 @@ bool SDLSystem::Initialize()
 	const SDL_version *SDLversion = SDL_Linked_Version();
 	LOG_INFO(LOGCAT_SYSTEM, "SDL Runtime Version: %u.%u.%u, Linked Version: %u.%u.%u\n", SDLversion->major, SDLversion->minor, SDLversion->patch, SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL);
 
-	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_TIMER) == -1)
+#ifdef NULL_GRAPHICS
+	// running windowless, so don't require a display to be available
+	uint initFlags = SDL_INIT_JOYSTICK | SDL_INIT_TIMER;
+#else
+	uint initFlags = SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_TIMER;
+#endif
+	if (SDL_Init(initFlags) == -1)
 	{
 		LOG_ERROR(LOGCAT_SYSTEM, "SDL_Init() failed: %s\n", SDL_GetError());
 		return false;
@@ -106,7 +113,14 @@ bool SDLSystem::CreateGameWindow(BaseGameApp *gameApp, GameWindowParams *params)
 {
 	ASSERT(m_window == NULL);
 
+#ifdef NULL_GRAPHICS
+	// there is no real OpenGL context to display anything with, so run
+	// windowless at the requested size instead
+	SDLGameWindowParams *sdlParams = (SDLGameWindowParams*)params;
+	NullGameWindow *window = new NullGameWindow(gameApp, sdlParams->width, sdlParams->height);
+#else
 	SDLGameWindow *window = new SDLGameWindow(gameApp);
+#endif
 	ASSERT(window != NULL);
 
 	if (!window->Create(params))
@@ -117,6 +131,12 @@ bool SDLSystem::CreateGameWindow(BaseGameApp *gameApp, GameWindowParams *params)
 
 	m_window = window;
 
+#ifdef NULL_GRAPHICS
+	// nothing to set up, the null OpenGL implementation supports everything
+	// the framework needs
+	m_hasShaderSupport = true;
+	m_supportedShaderVersion = 2.0f;
+#else
 	// now that we have a window (and a GL context), set up OpenGL related stuff
 
 	GLenum err = glewInit();
@@ -195,6 +215,7 @@ bool SDLSystem::CreateGameWindow(BaseGameApp *gameApp, GameWindowParams *params)
 	}
 	else
 		LOG_INFO(LOGCAT_SYSTEM, "Video card does not support shaders.\n");
+#endif
 
 	LOG_INFO(LOGCAT_SYSTEM, "GameWindow instance is ready.\n");
 
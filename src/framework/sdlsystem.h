@@ -49,7 +49,7 @@ public:
 private:
 	bool m_isQuitting;
 
-	SDLGameWindow *m_window;
+	GameWindow *m_window;
 	SDLFileSystem *m_filesystem;
 	SDLMouse *m_mouse;
 	SDLKeyboard *m_keyboard;
@@ -51,7 +51,7 @@ Grid::~Grid()
 
 void Grid::OnRender()
 {
-	m_renderState->Apply();
+	m_renderState->Apply(m_graphicsDevice);
 
 	m_graphicsDevice->BindVertexBuffer(m_horizontalPoints);
 	m_graphicsDevice->RenderLines(0, m_horizontalPoints->GetNumElements() / 2);
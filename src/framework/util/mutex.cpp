@@ -0,0 +1,37 @@
+#include "../debug.h"
+
+#include "mutex.h"
+
+#ifdef SDL
+#include "../sdlincludes.h"
+#endif
+
+Mutex::Mutex()
+{
+#ifdef SDL
+	m_mutex = SDL_CreateMutex();
+	ASSERT(m_mutex != NULL);
+#endif
+}
+
+Mutex::~Mutex()
+{
+#ifdef SDL
+	if (m_mutex != NULL)
+		SDL_DestroyMutex(m_mutex);
+#endif
+}
+
+void Mutex::Lock()
+{
+#ifdef SDL
+	SDL_LockMutex(m_mutex);
+#endif
+}
+
+void Mutex::Unlock()
+{
+#ifdef SDL
+	SDL_UnlockMutex(m_mutex);
+#endif
+}
@@ -0,0 +1,37 @@
+#ifndef __FRAMEWORK_UTIL_MUTEX_H_INCLUDED__
+#define __FRAMEWORK_UTIL_MUTEX_H_INCLUDED__
+
+#include "../common.h"
+
+#ifdef SDL
+struct SDL_mutex;
+#endif
+
+/**
+ * Mutual exclusion lock for data shared between threads. On platforms
+ * where threads aren't available, locking does nothing.
+ */
+class Mutex
+{
+public:
+	Mutex();
+	virtual ~Mutex();
+
+	/**
+	 * Locks the mutex, waiting for any other thread holding it to unlock
+	 * it first.
+	 */
+	void Lock();
+
+	/**
+	 * Unlocks the mutex.
+	 */
+	void Unlock();
+
+private:
+#ifdef SDL
+	SDL_mutex *m_mutex;
+#endif
+};
+
+#endif
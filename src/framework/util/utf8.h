@@ -0,0 +1,64 @@
+#ifndef __FRAMEWORK_UTIL_UTF8_H_INCLUDED__
+#define __FRAMEWORK_UTIL_UTF8_H_INCLUDED__
+
+#include "../common.h"
+
+const uint32_t UTF8_REPLACEMENT_CHARACTER = 0xfffd;
+
+/**
+ * Decodes the next character from a UTF-8 encoded string and moves the
+ * string pointer past it. Invalid or truncated byte sequences are skipped
+ * over one byte at a time, each decoding to UTF8_REPLACEMENT_CHARACTER.
+ * Plain ASCII strings decode to the same values as their chars.
+ * @param text the string to decode from. must not be at it's terminator
+ * @return the decoded character
+ */
+inline uint32_t DecodeUtf8(const char *&text)
+{
+	const uint8_t *p = (const uint8_t*)text;
+	uint8_t lead = p[0];
+
+	uint32_t c;
+	uint numContinuationBytes;
+	if (lead < 0x80)
+	{
+		++text;
+		return lead;
+	}
+	else if ((lead & 0xe0) == 0xc0)
+	{
+		c = lead & 0x1f;
+		numContinuationBytes = 1;
+	}
+	else if ((lead & 0xf0) == 0xe0)
+	{
+		c = lead & 0x0f;
+		numContinuationBytes = 2;
+	}
+	else if ((lead & 0xf8) == 0xf0)
+	{
+		c = lead & 0x07;
+		numContinuationBytes = 3;
+	}
+	else
+	{
+		++text;
+		return UTF8_REPLACEMENT_CHARACTER;
+	}
+
+	for (uint i = 1; i <= numContinuationBytes; ++i)
+	{
+		// also catches hitting the string's null terminator early
+		if ((p[i] & 0xc0) != 0x80)
+		{
+			++text;
+			return UTF8_REPLACEMENT_CHARACTER;
+		}
+		c = (c << 6) | (p[i] & 0x3f);
+	}
+
+	text += numContinuationBytes + 1;
+	return c;
+}
+
+#endif
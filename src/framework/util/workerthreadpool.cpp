@@ -0,0 +1,299 @@
+#include "../debug.h"
+#include "../log.h"
+
+#include "workerthreadpool.h"
+
+#ifdef SDL
+#include "../sdlincludes.h"
+#endif
+
+#ifndef MOBILE
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define WIN32_EXTRA_LEAN
+#include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#endif
+
+WorkerThreadPool::WorkerThreadPool(uint numWorkerThreads)
+{
+	m_function = NULL;
+	m_context = NULL;
+	m_count = 0;
+	m_batchSize = 0;
+	m_nextIndex = 0;
+	m_numBusyThreads = 0;
+	m_isRunningJob = false;
+	m_numRunningTasks = 0;
+	m_quit = false;
+
+#ifdef SDL
+	m_numWorkerThreads = 0;
+	m_threads = NULL;
+	m_mutex = SDL_CreateMutex();
+	m_workAvailable = SDL_CreateCond();
+	m_workFinished = SDL_CreateCond();
+	m_tasksFinished = SDL_CreateCond();
+	if (m_mutex == NULL || m_workAvailable == NULL || m_workFinished == NULL || m_tasksFinished == NULL)
+	{
+		LOG_WARN(LOGCAT_SYSTEM, "Unable to create worker thread synchronization objects. All jobs will run on the calling thread.\n");
+		numWorkerThreads = 0;
+	}
+
+	if (numWorkerThreads > 0)
+	{
+		m_threads = new SDL_Thread*[numWorkerThreads];
+		for (uint i = 0; i < numWorkerThreads; ++i)
+		{
+			m_threads[i] = SDL_CreateThread(WorkerThreadMain, this);
+			if (m_threads[i] == NULL)
+			{
+				LOG_WARN(LOGCAT_SYSTEM, "Unable to create worker thread %d.\n", i);
+				break;
+			}
+			++m_numWorkerThreads;
+		}
+	}
+#else
+	m_numWorkerThreads = 0;
+#endif
+
+	LOG_INFO(LOGCAT_SYSTEM, "Worker thread pool started with %d worker threads.\n", m_numWorkerThreads);
+}
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+	// whoever queued these tasks is probably expecting them to be run
+	WaitForTasks();
+
+#ifdef SDL
+	if (m_numWorkerThreads > 0)
+	{
+		SDL_LockMutex(m_mutex);
+		m_quit = true;
+		SDL_CondBroadcast(m_workAvailable);
+		SDL_UnlockMutex(m_mutex);
+
+		for (uint i = 0; i < m_numWorkerThreads; ++i)
+			SDL_WaitThread(m_threads[i], NULL);
+	}
+	SAFE_DELETE_ARRAY(m_threads);
+
+	if (m_tasksFinished != NULL)
+		SDL_DestroyCond(m_tasksFinished);
+	if (m_workFinished != NULL)
+		SDL_DestroyCond(m_workFinished);
+	if (m_workAvailable != NULL)
+		SDL_DestroyCond(m_workAvailable);
+	if (m_mutex != NULL)
+		SDL_DestroyMutex(m_mutex);
+#endif
+}
+
+void WorkerThreadPool::ParallelFor(WorkerThreadPoolJobFunction function, void *context, uint count, uint batchSize)
+{
+	ASSERT(function != NULL);
+	ASSERT(batchSize > 0);
+	if (count == 0)
+		return;
+
+	// not worth waking up any other threads for just a single batch
+	if (m_numWorkerThreads == 0 || count <= batchSize)
+	{
+		function(context, 0, count);
+		return;
+	}
+
+#ifdef SDL
+	SDL_LockMutex(m_mutex);
+	ASSERT(m_isRunningJob == false);
+
+	m_function = function;
+	m_context = context;
+	m_count = count;
+	m_batchSize = batchSize;
+	m_nextIndex = 0;
+	m_numBusyThreads = 0;
+	m_isRunningJob = true;
+	SDL_CondBroadcast(m_workAvailable);
+
+	// help out with the job instead of just sitting around waiting for it
+	uint start;
+	uint end;
+	while (TakeBatch(&start, &end))
+	{
+		SDL_UnlockMutex(m_mutex);
+		function(context, start, end);
+		SDL_LockMutex(m_mutex);
+		FinishBatch();
+	}
+
+	// all batches have been handed out, but some may still be running
+	while (m_numBusyThreads > 0)
+		SDL_CondWait(m_workFinished, m_mutex);
+
+	m_isRunningJob = false;
+	m_function = NULL;
+	m_context = NULL;
+	SDL_UnlockMutex(m_mutex);
+#endif
+}
+
+void WorkerThreadPool::QueueTask(WorkerThreadPoolTaskFunction function, void *context)
+{
+	ASSERT(function != NULL);
+
+	if (m_numWorkerThreads == 0)
+	{
+		function(context);
+		return;
+	}
+
+#ifdef SDL
+	Task task;
+	task.function = function;
+	task.context = context;
+
+	SDL_LockMutex(m_mutex);
+	m_tasks.push_back(task);
+	SDL_CondSignal(m_workAvailable);
+	SDL_UnlockMutex(m_mutex);
+#endif
+}
+
+void WorkerThreadPool::WaitForTasks()
+{
+#ifdef SDL
+	if (m_numWorkerThreads == 0)
+		return;
+
+	SDL_LockMutex(m_mutex);
+	while (!m_tasks.empty() || m_numRunningTasks > 0)
+		SDL_CondWait(m_tasksFinished, m_mutex);
+	SDL_UnlockMutex(m_mutex);
+#endif
+}
+
+bool WorkerThreadPool::TakeBatch(uint *start, uint *end)
+{
+	// NOTE: must be called with m_mutex locked
+	if (!m_isRunningJob || m_nextIndex >= m_count)
+		return false;
+
+	*start = m_nextIndex;
+	*end = Min(m_nextIndex + m_batchSize, m_count);
+	m_nextIndex = *end;
+	++m_numBusyThreads;
+
+	return true;
+}
+
+void WorkerThreadPool::FinishBatch()
+{
+	// NOTE: must be called with m_mutex locked
+	ASSERT(m_numBusyThreads > 0);
+	--m_numBusyThreads;
+
+#ifdef SDL
+	if (m_numBusyThreads == 0 && m_nextIndex >= m_count)
+		SDL_CondSignal(m_workFinished);
+#endif
+}
+
+bool WorkerThreadPool::TakeTask(Task *task)
+{
+	// NOTE: must be called with m_mutex locked
+	if (m_tasks.empty())
+		return false;
+
+	*task = m_tasks.front();
+	m_tasks.pop_front();
+	++m_numRunningTasks;
+
+	return true;
+}
+
+void WorkerThreadPool::FinishTask()
+{
+	// NOTE: must be called with m_mutex locked
+	ASSERT(m_numRunningTasks > 0);
+	--m_numRunningTasks;
+
+#ifdef SDL
+	if (m_numRunningTasks == 0 && m_tasks.empty())
+		SDL_CondBroadcast(m_tasksFinished);
+#endif
+}
+
+int WorkerThreadPool::WorkerThreadMain(void *data)
+{
+#ifdef SDL
+	WorkerThreadPool *pool = (WorkerThreadPool*)data;
+
+	SDL_LockMutex(pool->m_mutex);
+	while (true)
+	{
+		uint start;
+		uint end;
+		Task task;
+		bool hasBatch = false;
+		bool hasTask = false;
+		while (!pool->m_quit)
+		{
+			// another thread is waiting on jobs to finish, but not on tasks
+			hasBatch = pool->TakeBatch(&start, &end);
+			if (!hasBatch)
+				hasTask = pool->TakeTask(&task);
+			if (hasBatch || hasTask)
+				break;
+
+			SDL_CondWait(pool->m_workAvailable, pool->m_mutex);
+		}
+
+		if (pool->m_quit)
+			break;
+
+		if (hasBatch)
+		{
+			// these stay the same until every batch has finished
+			WorkerThreadPoolJobFunction function = pool->m_function;
+			void *context = pool->m_context;
+
+			SDL_UnlockMutex(pool->m_mutex);
+			function(context, start, end);
+			SDL_LockMutex(pool->m_mutex);
+
+			pool->FinishBatch();
+		}
+		else
+		{
+			SDL_UnlockMutex(pool->m_mutex);
+			task.function(task.context);
+			SDL_LockMutex(pool->m_mutex);
+
+			pool->FinishTask();
+		}
+	}
+	SDL_UnlockMutex(pool->m_mutex);
+#endif
+
+	return 0;
+}
+
+uint WorkerThreadPool::GetNumProcessors()
+{
+#if defined(MOBILE)
+	return 1;
+#elif defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return Max((uint)info.dwNumberOfProcessors, (uint)1);
+#elif defined(__linux__) || defined(__APPLE__)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0 ? (uint)count : 1);
+#else
+	return 1;
+#endif
+}
@@ -0,0 +1,125 @@
+#ifndef __FRAMEWORK_UTIL_WORKERTHREADPOOL_H_INCLUDED__
+#define __FRAMEWORK_UTIL_WORKERTHREADPOOL_H_INCLUDED__
+
+#include "../common.h"
+#include <stl/list.h>
+
+#ifdef SDL
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+#endif
+
+/**
+ * Function called to process a range of items of a parallel job.
+ * @param context the context pointer the job was started with
+ * @param start index of the first item to process
+ * @param end index one past the last item to process
+ */
+typedef void (*WorkerThreadPoolJobFunction)(void *context, uint start, uint end);
+
+/**
+ * Function called to run a background task.
+ * @param context the context pointer the task was queued with
+ */
+typedef void (*WorkerThreadPoolTaskFunction)(void *context);
+
+/**
+ * A fixed set of worker threads that can split up the processing of a
+ * large number of independent items. The thread that starts a job helps
+ * process it and doesn't return until every item has been processed.
+ * Worker threads can also run background tasks which the queueing thread
+ * doesn't wait on, in between jobs.
+ *
+ * On platforms where threads aren't available, jobs are simply run on
+ * the calling thread.
+ */
+class WorkerThreadPool
+{
+public:
+	/**
+	 * Creates a worker thread pool and starts it's threads.
+	 * @param numWorkerThreads the number of worker threads to create in
+	 *                         addition to the thread that will be starting
+	 *                         jobs. 0 runs all jobs on the calling thread.
+	 */
+	WorkerThreadPool(uint numWorkerThreads);
+
+	virtual ~WorkerThreadPool();
+
+	/**
+	 * @return the number of worker threads plus the calling thread
+	 */
+	uint GetNumThreads() const                             { return m_numWorkerThreads + 1; }
+
+	/**
+	 * Processes items [0, count) in batches spread out over all threads.
+	 * This should only be called from a single thread (e.g. the main
+	 * thread) and job functions must not start jobs themselves.
+	 * @param function the function that processes a batch of items
+	 * @param context pointer passed as-is to the function
+	 * @param count the total number of items to process
+	 * @param batchSize the maximum number of items given to a thread at
+	 *                  once. items within a batch are processed in order
+	 */
+	void ParallelFor(WorkerThreadPoolJobFunction function, void *context, uint count, uint batchSize);
+
+	/**
+	 * Queues a task to be run in the background by a worker thread and
+	 * returns immediately. Tasks are started in the order they were queued
+	 * whenever a worker thread isn't busy with a ParallelFor() job. If there
+	 * are no worker threads, the task is run on the calling thread before
+	 * this returns.
+	 * @param function the function that runs the task
+	 * @param context pointer passed as-is to the function
+	 */
+	void QueueTask(WorkerThreadPoolTaskFunction function, void *context);
+
+	/**
+	 * Waits until all queued background tasks have finished running.
+	 */
+	void WaitForTasks();
+
+	/**
+	 * @return the number of processors (cores) available, or 1 if this
+	 *         could not be determined
+	 */
+	static uint GetNumProcessors();
+
+private:
+	struct Task
+	{
+		WorkerThreadPoolTaskFunction function;
+		void *context;
+	};
+	typedef stl::list<Task> TaskQueue;
+
+	bool TakeBatch(uint *start, uint *end);
+	void FinishBatch();
+	bool TakeTask(Task *task);
+	void FinishTask();
+	static int WorkerThreadMain(void *data);
+
+	uint m_numWorkerThreads;
+
+	WorkerThreadPoolJobFunction m_function;
+	void *m_context;
+	uint m_count;
+	uint m_batchSize;
+	uint m_nextIndex;
+	uint m_numBusyThreads;
+	bool m_isRunningJob;
+	TaskQueue m_tasks;
+	uint m_numRunningTasks;
+	bool m_quit;
+
+#ifdef SDL
+	SDL_Thread **m_threads;
+	SDL_mutex *m_mutex;
+	SDL_cond *m_workAvailable;
+	SDL_cond *m_workFinished;
+	SDL_cond *m_tasksFinished;
+#endif
+};
+
+#endif
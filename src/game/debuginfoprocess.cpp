@@ -40,6 +40,9 @@ void DebugInfoProcess::OnRender(RenderContext *renderContext)
 	y += font->GetLetterHeight() * 3;
 
 	renderContext->GetSpriteBatch()->Printf(font, 5, (y += font->GetLetterHeight()), TEXT_COLOR, "UI Scale: %d", GetGameApp()->GetScreenScale());
+	const GraphicsDeviceStats *stats = renderContext->GetGraphicsDevice()->GetLastFrameStats();
+	renderContext->GetSpriteBatch()->Printf(font, 5, (y += font->GetLetterHeight()), TEXT_COLOR, "BU: %d (%d bytes)", stats->numBufferUploads, (uint)stats->bufferBytesUploaded);
+	renderContext->GetSpriteBatch()->Printf(font, 5, (y += font->GetLetterHeight()), TEXT_COLOR, "SC: %d (%d skipped)", stats->numStateCallsIssued, stats->numStateCallsSkipped);
 	renderContext->GetSpriteBatch()->Printf(font, 5, (y += font->GetLetterHeight()), TEXT_COLOR, "CP: %f, %f, %f", 
 			renderContext->GetGraphicsDevice()->GetViewContext()->GetCamera()->GetPosition().x, 
 			renderContext->GetGraphicsDevice()->GetViewContext()->GetCamera()->GetPosition().y, 
@@ -7,6 +7,7 @@
 #include "events/eventmanager.h"
 #include "framework/sdlgamewindow.h"
 #include "framework/marmaladegamewindow.h"
+#include "framework/assets/animation/animationsystem.h"
 #include "framework/content/contentmanager.h"
 #include "framework/content/imageloader.h"
 #include "framework/content/keyframemeshloader.h"
@@ -23,6 +24,7 @@
 
 GameApp::GameApp()
 {
+	m_animationSystem = NULL;
 	m_contentCache = NULL;
 	m_renderContext = NULL;
 	m_stateManager = NULL;
@@ -35,6 +37,7 @@ GameApp::~GameApp()
 	SAFE_DELETE(m_eventManager);
 	SAFE_DELETE(m_contentCache);
 	SAFE_DELETE(m_renderContext);
+	SAFE_DELETE(m_animationSystem);
 }
 
 void GameApp::OnAppGainFocus()
@@ -95,6 +98,7 @@ bool GameApp::OnInit()
 	m_stateManager = new StateManager(this);
 	m_renderContext = new RenderContext(GetGraphicsDevice(), GetContentManager());
 	m_contentCache = new ContentCache(GetContentManager());
+	m_animationSystem = new AnimationSystem(GetWorkerThreadPool());
 
 	return true;
 }
@@ -144,6 +148,9 @@ void GameApp::OnUpdate(float delta)
 
 	m_stateManager->OnUpdate(delta);
 
+	// after game logic has had a chance to change any animation sequences
+	m_animationSystem->OnUpdate(delta);
+
 	if (m_stateManager->IsEmpty())
 	{
 		LOG_INFO(LOGCAT_GAMEAPP, "No states running, quitting.\n");
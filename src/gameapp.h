@@ -5,6 +5,7 @@
 #include "framework/basegameapp.h"
 #include "contexts/rendercontext.h"
 
+class AnimationSystem;
 class ContentCache;
 class EventManager;
 class StateManager;
@@ -27,6 +28,7 @@ public:
 	void OnResize();
 	void OnUpdate(float delta);
 
+	AnimationSystem* GetAnimationSystem() const            { return m_animationSystem; }
 	ContentCache* GetContentCache() const                  { return m_contentCache; }
 	StateManager* GetStateManager() const                  { return m_stateManager; }
 	EventManager* GetEventManager() const                  { return m_eventManager; }
@@ -34,6 +36,7 @@ public:
 	uint GetScreenScale() const;
 
 private:
+	AnimationSystem *m_animationSystem;
 	ContentCache *m_contentCache;
 	RenderContext *m_renderContext;
 	StateManager *m_stateManager;
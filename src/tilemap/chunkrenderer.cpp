@@ -3,6 +3,7 @@
 #include "../framework/graphics/blendstate.h"
 #include "../framework/graphics/color.h"
 #include "../framework/graphics/graphicsdevice.h"
+#include "../framework/graphics/rendercommandqueue.h"
 #include "../framework/graphics/renderstate.h"
 #include "../framework/graphics/textureatlas.h"
 #include "../framework/graphics/vertexbuffer.h"
@@ -33,8 +34,8 @@ uint ChunkRenderer::Render(const TileChunk *chunk)
 
 	uint numVertices = chunk->GetNumVertices();
 
-	m_renderState->Apply();
-	m_defaultBlendState->Apply();
+	m_renderState->Apply(m_graphicsDevice);
+	m_defaultBlendState->Apply(m_graphicsDevice);
 	m_graphicsDevice->BindTexture(texture);
 	m_graphicsDevice->BindVertexBuffer(chunk->GetVertices());
 	m_graphicsDevice->RenderTriangles(0, numVertices / 3);
@@ -53,8 +54,8 @@ uint ChunkRenderer::RenderAlpha(const TileChunk *chunk)
 
 		numVertices = chunk->GetNumAlphaVertices();
 
-		m_renderState->Apply();
-		m_alphaBlendState->Apply();
+		m_renderState->Apply(m_graphicsDevice);
+		m_alphaBlendState->Apply(m_graphicsDevice);
 		m_graphicsDevice->BindTexture(texture);
 		m_graphicsDevice->BindVertexBuffer(chunk->GetAlphaVertices());
 		m_graphicsDevice->RenderTriangles(0, numVertices / 3);
@@ -64,3 +65,43 @@ uint ChunkRenderer::RenderAlpha(const TileChunk *chunk)
 	return numVertices;
 }
 
+uint ChunkRenderer::Submit(RenderCommandQueue *queue, const TileChunk *chunk, StandardShader *shader, float depth)
+{
+	uint numVertices = chunk->GetNumVertices();
+	if (numVertices == 0)
+		return 0;
+
+	RenderCommand command;
+	command.depth = depth;
+	command.shader = shader;
+	command.texture = chunk->GetTileMap()->GetMeshes()->GetTextureAtlas()->GetTexture();
+	command.renderState = m_renderState;
+	command.blendState = m_defaultBlendState;
+	command.vertexBuffer = chunk->GetVertices();
+	command.count = numVertices / 3;
+	queue->Submit(command);
+
+	return numVertices;
+}
+
+uint ChunkRenderer::SubmitAlpha(RenderCommandQueue *queue, const TileChunk *chunk, StandardShader *shader, float depth)
+{
+	if (!chunk->IsAlphaEnabled())
+		return 0;
+
+	uint numVertices = chunk->GetNumAlphaVertices();
+	if (numVertices == 0)
+		return 0;
+
+	RenderCommand command;
+	command.depth = depth;
+	command.shader = shader;
+	command.texture = chunk->GetTileMap()->GetMeshes()->GetTextureAtlas()->GetTexture();
+	command.renderState = m_renderState;
+	command.blendState = m_alphaBlendState;
+	command.vertexBuffer = chunk->GetAlphaVertices();
+	command.count = numVertices / 3;
+	queue->Submit(command);
+
+	return numVertices;
+}
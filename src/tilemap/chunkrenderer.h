@@ -5,7 +5,9 @@
 
 class BlendState;
 class GraphicsDevice;
+class RenderCommandQueue;
 class RenderState;
+class StandardShader;
 class TileChunk;
 
 class ChunkRenderer
@@ -17,6 +19,9 @@ public:
 	uint Render(const TileChunk *chunk);
 	uint RenderAlpha(const TileChunk *chunk);
 
+	uint Submit(RenderCommandQueue *queue, const TileChunk *chunk, StandardShader *shader, float depth);
+	uint SubmitAlpha(RenderCommandQueue *queue, const TileChunk *chunk, StandardShader *shader, float depth);
+
 private:
 	GraphicsDevice *m_graphicsDevice;
 	RenderState *m_renderState;
@@ -175,7 +175,6 @@ void ChunkVertexGenerator::Generate(TileChunk *chunk, uint &numVertices, uint &n
 uint ChunkVertexGenerator::AddMesh(const TileMesh *mesh, TileChunk *chunk, bool isAlpha, const Point3 &position, const Matrix4x4 *transform, const Color &color, uint firstVertex, uint numVertices)
 {
 	VertexBuffer *sourceBuffer = mesh->GetBuffer();
-	sourceBuffer->MoveToStart();
 
 	VertexBuffer *destBuffer;
 	if (isAlpha)
@@ -206,42 +205,23 @@ uint ChunkVertexGenerator::AddMesh(const TileMesh *mesh, TileChunk *chunk, bool
 	positionOffset.y += (float)position.y;
 	positionOffset.z += (float)position.z;
 
-	// copy vertices
-	sourceBuffer->MoveTo(firstVertex);
-	for (uint i = 0; i < numVertices; ++i)
-	{
-		CopyVertex(chunk, sourceBuffer, destBuffer, positionOffset, transform, color);
+	// copy vertices, transforming them into "tilemap space"
+	uint destIndex = destBuffer->GetCurrentPosition();
+	destBuffer->CopyPositions3(sourceBuffer, firstVertex, destIndex, numVertices, transform, positionOffset);
+	destBuffer->CopyNormals(sourceBuffer, firstVertex, destIndex, numVertices, transform);
 
-		sourceBuffer->MoveNext();
-		destBuffer->MoveNext();
-	}
+	// just directly copy the tex coords as-is
+	destBuffer->CopyTexCoords(sourceBuffer, firstVertex, destIndex, numVertices);
+
+	SetVertexColors(chunk, destBuffer, destIndex, numVertices, positionOffset, color);
+
+	destBuffer->MoveTo(destIndex + numVertices);
 
 	return verticesToAdd;
 }
 
-void ChunkVertexGenerator::CopyVertex(const TileChunk *chunk, VertexBuffer *sourceBuffer, VertexBuffer *destBuffer, const Vector3 &positionOffset, const Matrix4x4 *transform, const Color &color)
+void ChunkVertexGenerator::SetVertexColors(const TileChunk *chunk, VertexBuffer *destBuffer, uint firstVertex, uint numVertices, const Vector3 &positionOffset, const Color &color)
 {
-	Vector3 v = sourceBuffer->GetCurrentPosition3();
-	Vector3 n = sourceBuffer->GetCurrentNormal();
-
-	if (transform != NULL)
-	{
-		// need to transform the vertex + normal first before copying it
-		v = v * (*transform);
-		n = n * (*transform);
-	}
-
-	// translate vertex into "tilemap space"
-	v += positionOffset;
-
-	// copy to destination
-	destBuffer->SetCurrentPosition3(v);
-	destBuffer->SetCurrentNormal(n);
-
-	// just directly copy the tex coord as-is
-	destBuffer->SetCurrentTexCoord(sourceBuffer->GetCurrentTexCoord());
-
 	// color is the same for the entire mesh
-	destBuffer->SetCurrentColor(color);
+	destBuffer->FillColors(firstVertex, numVertices, color);
 }
-
@@ -24,7 +24,7 @@ public:
 
 private:
 	uint AddMesh(const TileMesh *mesh, TileChunk *chunk, bool isAlpha, const Point3 &position, const Matrix4x4 *transform, const Color &color, uint firstVertex, uint numVertices);
-	virtual void CopyVertex(const TileChunk *chunk, VertexBuffer *sourceBuffer, VertexBuffer *destBuffer, const Vector3 &positionOffset, const Matrix4x4 *transform, const Color &color);
+	virtual void SetVertexColors(const TileChunk *chunk, VertexBuffer *destBuffer, uint firstVertex, uint numVertices, const Vector3 &positionOffset, const Color &color);
 };
 
 #endif
@@ -28,6 +28,7 @@ public:
 
 	uint GetNumCollisionVertices() const                   { return m_numCollisionVertices; }
 	const Vector3* GetCollisionVertices() const            { return m_collisionVertices; }
+	const TriangleBvh* GetCollisionBvh() const             { return NULL; }
 
 	CUBE_FACES GetFaces() const                            { return m_faces; }
 	bool HasFace(CUBE_FACES face) const                    { return IsBitSet(face, m_faces); }
@@ -6,7 +6,6 @@
 class TileChunk;
 class VertexBuffer;
 struct Color;
-struct Matrix4x4;
 struct Vector3;
 
 class LitChunkVertexGenerator : public ChunkVertexGenerator
@@ -16,7 +15,7 @@ public:
 	virtual ~LitChunkVertexGenerator();
 
 private:
-	void CopyVertex(const TileChunk *chunk, VertexBuffer *sourceBuffer, VertexBuffer *destBuffer, const Vector3 &positionOffset, const Matrix4x4 *transform, const Color &color);
+	void SetVertexColors(const TileChunk *chunk, VertexBuffer *destBuffer, uint firstVertex, uint numVertices, const Vector3 &positionOffset, const Color &color);
 };
 
 #endif
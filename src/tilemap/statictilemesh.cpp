@@ -4,8 +4,13 @@
 #include "../framework/assets/static/staticmesh.h"
 #include "../framework/assets/static/staticmeshsubset.h"
 #include "../framework/graphics/vertexbuffer.h"
-#include "../framework/math/mathhelpers.h"
 #include "../framework/math/rectf.h"
+#include "../framework/math/trianglebvh.h"
+#include "../framework/math/vector2.h"
+
+// collision meshes with fewer triangles then this are quicker to just test
+// triangle-by-triangle
+const uint COLLISION_BVH_MIN_TRIANGLES = 32;
 
 StaticTileMesh::StaticTileMesh(const StaticMesh *mesh, const RectF *textureAtlasTileBoundaries, MESH_SIDES opaqueSides, TILE_LIGHT_VALUE lightValue, bool alpha, float translucency, const Color &color, const StaticMesh *collisionMesh)
 {
@@ -25,13 +30,7 @@ StaticTileMesh::StaticTileMesh(const StaticMesh *mesh, const RectF *textureAtlas
 
 	// adjust texture coordinates, which are likely all within the full range 0.0f to 1.0f
 	// to fit into the texture atlas tile's texture coordinate boundaries
-	for (uint i = 0; i < m_vertices->GetNumElements(); ++i)
-	{
-		Vector2 texCoord = m_vertices->GetTexCoord(i);
-		texCoord.x = ScaleRange(texCoord.x, 0.0f, 1.0f, textureAtlasTileBoundaries->left, textureAtlasTileBoundaries->right);
-		texCoord.y = ScaleRange(texCoord.y, 0.0f, 1.0f, textureAtlasTileBoundaries->top, textureAtlasTileBoundaries->bottom);
-		m_vertices->SetTexCoord(i, texCoord);
-	}
+	m_vertices->CopyTexCoords(m_vertices, 0, 0, m_vertices->GetNumElements(), Vector2(textureAtlasTileBoundaries->right - textureAtlasTileBoundaries->left, textureAtlasTileBoundaries->bottom - textureAtlasTileBoundaries->top), Vector2(textureAtlasTileBoundaries->left, textureAtlasTileBoundaries->top));
 
 	SetupCollisionVertices(collisionMesh);
 }
@@ -74,17 +73,10 @@ StaticTileMesh::StaticTileMesh(const StaticMesh *mesh, const RectF *textureAtlas
 		m_vertices->Copy(subset->GetVertices(), currentVertex);
 
 		// now we need to adjust the copied texture coordinates to match the tile boundaries
-		for (uint t = 0; t < subset->GetVertices()->GetNumElements(); ++t)
-		{
-			uint position = t + currentVertex;
-
-			Vector2 texCoord = m_vertices->GetTexCoord(position);
-			texCoord.x = ScaleRange(texCoord.x, 0.0f, 1.0f, tileBoundaries->left, tileBoundaries->right);
-			texCoord.y = ScaleRange(texCoord.y, 0.0f, 1.0f, tileBoundaries->top, tileBoundaries->bottom);
-			m_vertices->SetTexCoord(position, texCoord);
-		}
+		uint numSubsetVertices = subset->GetVertices()->GetNumElements();
+		m_vertices->CopyTexCoords(m_vertices, currentVertex, currentVertex, numSubsetVertices, Vector2(tileBoundaries->right - tileBoundaries->left, tileBoundaries->bottom - tileBoundaries->top), Vector2(tileBoundaries->left, tileBoundaries->top));
 
-		currentVertex += subset->GetVertices()->GetNumElements();
+		currentVertex += numSubsetVertices;
 	}
 
 	SetupCollisionVertices(collisionMesh);
@@ -105,10 +97,19 @@ void StaticTileMesh::SetupCollisionVertices(const StaticMesh *collisionMesh)
 
 	for (uint i = 0; i < m_numCollisionVertices; ++i)
 		m_collisionVertices[i] = srcCollisionVertices->GetPosition3(i);
+
+	m_collisionBvh = NULL;
+	if (m_numCollisionVertices / 3 >= COLLISION_BVH_MIN_TRIANGLES)
+	{
+		m_collisionBvh = new TriangleBvh();
+		ASSERT(m_collisionBvh != NULL);
+		m_collisionBvh->Build(m_collisionVertices, m_numCollisionVertices);
+	}
 }
 
 StaticTileMesh::~StaticTileMesh()
 {
 	SAFE_DELETE(m_vertices);
 	SAFE_DELETE(m_collisionVertices);
+	SAFE_DELETE(m_collisionBvh);
 }
@@ -8,6 +8,7 @@
 #include "../framework/graphics/color.h"
 
 class StaticMesh;
+class TriangleBvh;
 class VertexBuffer;
 struct RectF;
 struct Vector3;
@@ -22,6 +23,7 @@ public:
 	VertexBuffer* GetBuffer() const                        { return m_vertices; }
 	uint GetNumCollisionVertices() const                   { return m_numCollisionVertices; }
 	const Vector3* GetCollisionVertices() const            { return m_collisionVertices; }
+	const TriangleBvh* GetCollisionBvh() const             { return m_collisionBvh; }
 
 	TILEMESH_TYPE GetType() const                          { return TILEMESH_STATIC; }
 
@@ -31,6 +33,7 @@ private:
 	VertexBuffer *m_vertices;
 	uint m_numCollisionVertices;
 	Vector3 *m_collisionVertices;
+	TriangleBvh *m_collisionBvh;
 };
 
 #endif
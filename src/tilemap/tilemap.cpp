@@ -11,6 +11,7 @@
 #include "../framework/math/intersectiontester.h"
 #include "../framework/math/mathhelpers.h"
 #include "../framework/math/ray.h"
+#include "../framework/math/trianglebvh.h"
 #include "../framework/math/rectf.h"
 #include "../framework/math/vector3.h"
 
@@ -280,6 +281,20 @@ bool TileMap::CheckForCollisionWithTile(const Ray &ray, Vector3 &point, uint x,
 	// world position of this tile, will be used to move each
 	// mesh triangle into world space
 	Vector3 tileWorldPosition = Vector3((float)x, (float)y, (float)z);
+
+	// meshes with lots of triangles have a hierarchy that can find the
+	// closest one much quicker. it works with the mesh's own vertices, so
+	// the ray needs to be moved into the tile's space instead
+	const TriangleBvh *bvh = mesh->GetCollisionBvh();
+	if (bvh != NULL)
+	{
+		Ray tileSpaceRay(ray.position - tileWorldPosition, ray.direction);
+		if (!bvh->Test(tileSpaceRay, &point))
+			return false;
+
+		point += tileWorldPosition;
+		return true;
+	}
 	
 	float closestSquaredDistance = FLT_MAX;
 	bool collided = false;
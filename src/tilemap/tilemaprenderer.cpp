@@ -2,12 +2,15 @@
 
 #include "tilemaprenderer.h"
 
+#include "tilechunk.h"
 #include "tilemap.h"
 #include "../framework/graphics/graphicsdevice.h"
+#include "../framework/graphics/rendercommandqueue.h"
 #include "../framework/graphics/renderstate.h"
 #include "../framework/graphics/shader.h"
 #include "../framework/graphics/simplecolortextureshader.h"
 #include "../framework/graphics/viewcontext.h"
+#include "../framework/math/boundingbox.h"
 #include "../framework/math/camera.h"
 #include "../framework/math/frustum.h"
 
@@ -45,6 +48,9 @@ void TileMapRenderer::Render(const TileMap *tileMap, Shader *shader)
 		m_graphicsDevice->BindShader(shader);
 	}
 
+	CullChunks(tileMap);
+
+	uint index = 0;
 	for (uint y = 0; y < tileMap->GetHeightInChunks(); ++y)
 	{
 		for (uint z = 0; z < tileMap->GetDepthInChunks(); ++z)
@@ -52,7 +58,8 @@ void TileMapRenderer::Render(const TileMap *tileMap, Shader *shader)
 			for (uint x = 0; x < tileMap->GetWidthInChunks(); ++x)
 			{
 				TileChunk *chunk = tileMap->GetChunk(x, y, z);
-				if (m_graphicsDevice->GetViewContext()->GetCamera()->GetFrustum()->Test(chunk->GetBounds()))
+				bool isVisible = Frustum::IsVisible(m_chunkVisibility.data(), index++);
+				if (isVisible)
 				{
 					m_numVerticesRendered += m_chunkRenderer->Render(chunk);
 					++m_numChunksRendered;
@@ -81,6 +88,9 @@ void TileMapRenderer::RenderAlpha(const TileMap *tileMap, Shader *shader)
 		m_graphicsDevice->BindShader(shader);
 	}
 
+	CullChunks(tileMap);
+
+	uint index = 0;
 	for (uint y = 0; y < tileMap->GetHeightInChunks(); ++y)
 	{
 		for (uint z = 0; z < tileMap->GetDepthInChunks(); ++z)
@@ -88,7 +98,8 @@ void TileMapRenderer::RenderAlpha(const TileMap *tileMap, Shader *shader)
 			for (uint x = 0; x < tileMap->GetWidthInChunks(); ++x)
 			{
 				TileChunk *chunk = tileMap->GetChunk(x, y, z);
-				if (chunk->IsAlphaEnabled() && m_graphicsDevice->GetViewContext()->GetCamera()->GetFrustum()->Test(chunk->GetBounds()))
+				bool isVisible = Frustum::IsVisible(m_chunkVisibility.data(), index++);
+				if (chunk->IsAlphaEnabled() && isVisible)
 				{
 					m_numAlphaVerticesRendered += m_chunkRenderer->RenderAlpha(chunk);
 					++m_numAlphaChunksRendered;
@@ -99,3 +110,88 @@ void TileMapRenderer::RenderAlpha(const TileMap *tileMap, Shader *shader)
 
 	m_graphicsDevice->UnbindShader();
 }
+
+void TileMapRenderer::Submit(RenderCommandQueue *queue, const TileMap *tileMap, StandardShader *shader)
+{
+	ASSERT(queue != NULL);
+
+	m_numChunksRendered = 0;
+	m_numVerticesRendered = 0;
+	m_numAlphaChunksRendered = 0;
+	m_numAlphaVerticesRendered = 0;
+
+	if (shader == NULL)
+		shader = m_graphicsDevice->GetSimpleColorTextureShader();
+	ASSERT(shader->IsReadyForUse() == true);
+
+	CullChunks(tileMap);
+
+	uint index = 0;
+	for (uint y = 0; y < tileMap->GetHeightInChunks(); ++y)
+	{
+		for (uint z = 0; z < tileMap->GetDepthInChunks(); ++z)
+		{
+			for (uint x = 0; x < tileMap->GetWidthInChunks(); ++x)
+			{
+				TileChunk *chunk = tileMap->GetChunk(x, y, z);
+				bool isVisible = Frustum::IsVisible(m_chunkVisibility.data(), index++);
+				if (!isVisible)
+					continue;
+
+				float depth = GetChunkDepth(chunk);
+
+				uint numVertices = m_chunkRenderer->Submit(queue, chunk, shader, depth);
+				if (numVertices > 0)
+				{
+					m_numVerticesRendered += numVertices;
+					++m_numChunksRendered;
+				}
+
+				uint numAlphaVertices = m_chunkRenderer->SubmitAlpha(queue, chunk, shader, depth);
+				if (numAlphaVertices > 0)
+				{
+					m_numAlphaVerticesRendered += numAlphaVertices;
+					++m_numAlphaChunksRendered;
+				}
+			}
+		}
+	}
+}
+
+void TileMapRenderer::CullChunks(const TileMap *tileMap)
+{
+	// chunks are tested all at once, in the same order they're looped
+	// over in when rendering
+	uint numChunks = tileMap->GetWidthInChunks() * tileMap->GetHeightInChunks() * tileMap->GetDepthInChunks();
+	if (numChunks == 0)
+		return;
+
+	if (m_chunkBounds.GetCount() != numChunks)
+	{
+		m_chunkBounds.Resize(numChunks);
+		m_chunkVisibility.resize((numChunks + 31) / 32);
+		m_lastRejectingPlanes.clear();
+		m_lastRejectingPlanes.resize((numChunks + 3) / 4, 0);
+	}
+
+	uint index = 0;
+	for (uint y = 0; y < tileMap->GetHeightInChunks(); ++y)
+	{
+		for (uint z = 0; z < tileMap->GetDepthInChunks(); ++z)
+		{
+			for (uint x = 0; x < tileMap->GetWidthInChunks(); ++x)
+				m_chunkBounds.Set(index++, tileMap->GetChunk(x, y, z)->GetBounds());
+		}
+	}
+
+	m_graphicsDevice->GetViewContext()->GetCamera()->GetFrustum()->TestBoxes(m_chunkBounds, m_chunkVisibility.data(), m_lastRejectingPlanes.data());
+}
+
+float TileMapRenderer::GetChunkDepth(const TileChunk *chunk) const
+{
+	const Camera *camera = m_graphicsDevice->GetViewContext()->GetCamera();
+	const BoundingBox &bounds = chunk->GetBounds();
+	Vector3 center = (bounds.min + bounds.max) * 0.5f;
+
+	return Vector3::Distance(camera->GetPosition(), center) / camera->GetFarDistance();
+}
@@ -4,10 +4,15 @@
 #include "../framework/common.h"
 
 #include "chunkrenderer.h"
+#include "../framework/math/boundingboxarray.h"
+#include <stl/vector.h>
 
 class GraphicsDevice;
+class RenderCommandQueue;
+class TileChunk;
 class TileMap;
 class Shader;
+class StandardShader;
 
 class TileMapRenderer
 {
@@ -17,6 +22,7 @@ public:
 
 	void Render(const TileMap *tileMap, Shader *shader = NULL);
 	void RenderAlpha(const TileMap *tileMap, Shader *shader = NULL);
+	void Submit(RenderCommandQueue *queue, const TileMap *tileMap, StandardShader *shader = NULL);
 
 	uint GetNumVerticesRendered() const                    { return m_numVerticesRendered; }
 	uint GetNumAlphaVerticesRendered() const               { return m_numAlphaVerticesRendered; }
@@ -27,6 +33,9 @@ public:
 	uint GetTotalChunksRendered() const                    { return m_numChunksRendered + m_numAlphaChunksRendered; }
 
 private:
+	void CullChunks(const TileMap *tileMap);
+	float GetChunkDepth(const TileChunk *chunk) const;
+
 	GraphicsDevice *m_graphicsDevice;
 	ChunkRenderer *m_chunkRenderer;
 
@@ -34,6 +43,10 @@ private:
 	uint m_numAlphaVerticesRendered;
 	uint m_numChunksRendered;
 	uint m_numAlphaChunksRendered;
+
+	BoundingBoxArray m_chunkBounds;
+	stl::vector<uint32_t> m_chunkVisibility;
+	stl::vector<uint8_t> m_lastRejectingPlanes;
 };
 
 #endif
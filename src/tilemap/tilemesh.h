@@ -7,6 +7,7 @@
 #include "../framework/math/vector3.h"
 #include "../framework/graphics/color.h"
 
+class TriangleBvh;
 class VertexBuffer;
 
 const Vector3 TILEMESH_OFFSET = Vector3(0.5f, 0.5f, 0.5f);
@@ -26,6 +27,7 @@ public:
 	virtual VertexBuffer* GetBuffer() const = 0;
 	virtual uint GetNumCollisionVertices() const = 0;
 	virtual const Vector3* GetCollisionVertices() const = 0;
+	virtual const TriangleBvh* GetCollisionBvh() const = 0;
 
 	virtual TILEMESH_TYPE GetType() const = 0;
 
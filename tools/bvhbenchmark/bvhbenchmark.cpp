@@ -0,0 +1,265 @@
+// Measures how long ray and swept ellipsoid tests against a high-poly mesh
+// take with TriangleBvh, compared to testing every triangle with
+// IntersectionTester. Also checks that both find the same collisions, and
+// that a hierarchy written out and read back in gives the same results.
+//
+// Usage: bvhbenchmark [grid size] [number of queries]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <float.h>
+#include <stl/vector.h>
+
+#include "../../src/framework/debug.h"
+#include "../../src/framework/file/memoryfile.h"
+#include "../../src/framework/math/boundingbox.h"
+#include "../../src/framework/math/collisionpacket.h"
+#include "../../src/framework/math/intersectiontester.h"
+#include "../../src/framework/math/ray.h"
+#include "../../src/framework/math/trianglebvh.h"
+#include "../../src/framework/math/vector3.h"
+
+const uint DEFAULT_GRID_SIZE = 224;         // ~100k triangles
+const uint DEFAULT_NUM_QUERIES = 2000;
+const float WORLD_SIZE = 100.0f;
+
+static float RandomFloat(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static double GetMilliseconds(clock_t start, clock_t end)
+{
+	return (double)(end - start) * 1000.0 / (double)CLOCKS_PER_SEC;
+}
+
+static float GetHeight(float x, float z)
+{
+	return sinf(x * 0.3f) * cosf(z * 0.2f) * 3.0f + sinf(x * 1.7f + z * 1.3f) * 0.5f;
+}
+
+// bumpy terrain made up of gridSize x gridSize quads
+static void CreateMesh(uint gridSize, stl::vector<Vector3> &vertices)
+{
+	float step = WORLD_SIZE / (float)gridSize;
+	float origin = -WORLD_SIZE / 2.0f;
+	for (uint z = 0; z < gridSize; ++z)
+	{
+		for (uint x = 0; x < gridSize; ++x)
+		{
+			float x0 = origin + (float)x * step;
+			float z0 = origin + (float)z * step;
+			float x1 = x0 + step;
+			float z1 = z0 + step;
+			Vector3 a(x0, GetHeight(x0, z0), z0);
+			Vector3 b(x1, GetHeight(x1, z0), z0);
+			Vector3 c(x0, GetHeight(x0, z1), z1);
+			Vector3 d(x1, GetHeight(x1, z1), z1);
+			vertices.push_back(a);
+			vertices.push_back(c);
+			vertices.push_back(b);
+			vertices.push_back(b);
+			vertices.push_back(c);
+			vertices.push_back(d);
+		}
+	}
+}
+
+static bool TestAllTriangles(const stl::vector<Vector3> &vertices, const Ray &ray, Vector3 &point)
+{
+	float closestSquaredDistance = FLT_MAX;
+	bool collided = false;
+	for (uint i = 0; i < vertices.size(); i += 3)
+	{
+		Vector3 collisionPoint;
+		if (IntersectionTester::Test(ray, vertices[i], vertices[i + 1], vertices[i + 2], &collisionPoint))
+		{
+			collided = true;
+			float squaredDistance = Vector3::LengthSquared(collisionPoint - ray.position);
+			if (squaredDistance < closestSquaredDistance)
+			{
+				closestSquaredDistance = squaredDistance;
+				point = collisionPoint;
+			}
+		}
+	}
+	return collided;
+}
+
+static bool TestAllTriangles(const stl::vector<Vector3> &vertices, CollisionPacket &packet)
+{
+	bool collided = false;
+	for (uint i = 0; i < vertices.size(); i += 3)
+	{
+		if (IntersectionTester::Test(packet, vertices[i], vertices[i + 1], vertices[i + 2]))
+			collided = true;
+	}
+	return collided;
+}
+
+static CollisionPacket CreatePacket(const Vector3 &position, const Vector3 &velocity, const Vector3 &radius)
+{
+	CollisionPacket packet;
+	packet.ellipsoidRadius = radius;
+	packet.esPosition = position / radius;
+	packet.esVelocity = velocity / radius;
+	packet.esNormalizedVelocity = Vector3::Normalize(packet.esVelocity);
+	return packet;
+}
+
+int main(int argc, char **argv)
+{
+	uint gridSize = (argc > 1 ? (uint)atoi(argv[1]) : DEFAULT_GRID_SIZE);
+	uint numQueries = (argc > 2 ? (uint)atoi(argv[2]) : DEFAULT_NUM_QUERIES);
+	if (gridSize == 0 || numQueries == 0)
+	{
+		fprintf(stderr, "Usage: bvhbenchmark [grid size] [number of queries]\n");
+		return 1;
+	}
+
+	srand(1);
+
+	stl::vector<Vector3> vertices;
+	CreateMesh(gridSize, vertices);
+	uint numTriangles = vertices.size() / 3;
+
+	TriangleBvh bvh;
+	clock_t start = clock();
+	bvh.Build(vertices.data(), vertices.size());
+	clock_t end = clock();
+	printf("%d triangles, %d nodes, built in %.1f ms\n", numTriangles, bvh.GetNumNodes(), GetMilliseconds(start, end));
+
+	// round trip through a file, the rest of the tests use the loaded copy
+	size_t fileSize = 16 + bvh.GetNumNodes() * 32 + numTriangles * 40;
+	int8_t *fileData = new int8_t[fileSize];
+	MemoryFile file;
+	file.Open(fileData, fileSize, true, true);
+	bool writeSuccess = bvh.Write(&file);
+	file.Seek(0, FILESEEK_BEGINNING);
+	TriangleBvh loadedBvh;
+	bool readSuccess = loadedBvh.Read(&file);
+	printf("write %s, read %s, %d bytes\n", writeSuccess ? "ok" : "FAILED", readSuccess ? "ok" : "FAILED", (int)file.Tell());
+	file.Close();
+	delete[] fileData;
+	if (!writeSuccess || !readSuccess)
+		return 1;
+
+	// rays
+	stl::vector<Ray> rays(numQueries);
+	for (uint i = 0; i < numQueries; ++i)
+	{
+		Vector3 position(RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f), RandomFloat(5.0f, 20.0f), RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f));
+		Vector3 direction(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, -0.05f), RandomFloat(-1.0f, 1.0f));
+		rays[i] = Ray(position, Vector3::Normalize(direction));
+	}
+
+	stl::vector<bool> expectedHits(numQueries);
+	stl::vector<Vector3> expectedPoints(numQueries);
+	start = clock();
+	for (uint i = 0; i < numQueries; ++i)
+		expectedHits[i] = TestAllTriangles(vertices, rays[i], expectedPoints[i]);
+	end = clock();
+	double bruteForceTime = GetMilliseconds(start, end);
+
+	stl::vector<bool> hits(numQueries);
+	stl::vector<Vector3> points(numQueries);
+	stl::vector<uint> hitTriangles(numQueries);
+	start = clock();
+	for (uint i = 0; i < numQueries; ++i)
+		hits[i] = loadedBvh.Test(rays[i], &points[i], &hitTriangles[i]);
+	end = clock();
+	double bvhTime = GetMilliseconds(start, end);
+
+	uint numHits = 0;
+	uint numMismatches = 0;
+	for (uint i = 0; i < numQueries; ++i)
+	{
+		if (hits[i] != expectedHits[i])
+			++numMismatches;
+		else if (hits[i])
+		{
+			++numHits;
+			Vector3 a, b, c;
+			loadedBvh.GetTriangle(hitTriangles[i], a, b, c);
+			if (Vector3::Distance(points[i], expectedPoints[i]) > 0.001f || Vector3::Distance(a, vertices[hitTriangles[i] * 3]) > 0.0f)
+				++numMismatches;
+		}
+	}
+	printf("%d rays, %d hits, %d mismatches\n", numQueries, numHits, numMismatches);
+	printf("  every triangle:  %.4f ms/ray\n", bruteForceTime / numQueries);
+	printf("  TriangleBvh:     %.4f ms/ray\n", bvhTime / numQueries);
+
+	// swept ellipsoids
+	stl::vector<CollisionPacket> packets(numQueries);
+	Vector3 radius(0.5f, 1.0f, 0.5f);
+	for (uint i = 0; i < numQueries; ++i)
+	{
+		float x = RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f);
+		float z = RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f);
+		Vector3 position(x, GetHeight(x, z) + RandomFloat(1.5f, 3.0f), z);
+		Vector3 velocity(RandomFloat(-1.0f, 1.0f), RandomFloat(-2.0f, 0.0f), RandomFloat(-1.0f, 1.0f));
+		packets[i] = CreatePacket(position, velocity, radius);
+	}
+
+	stl::vector<CollisionPacket> expectedPackets = packets;
+	start = clock();
+	for (uint i = 0; i < numQueries; ++i)
+		TestAllTriangles(vertices, expectedPackets[i]);
+	end = clock();
+	bruteForceTime = GetMilliseconds(start, end);
+
+	stl::vector<CollisionPacket> bvhPackets = packets;
+	start = clock();
+	for (uint i = 0; i < numQueries; ++i)
+		loadedBvh.Test(bvhPackets[i]);
+	end = clock();
+	bvhTime = GetMilliseconds(start, end);
+
+	numHits = 0;
+	numMismatches = 0;
+	for (uint i = 0; i < numQueries; ++i)
+	{
+		if (bvhPackets[i].foundCollision != expectedPackets[i].foundCollision)
+			++numMismatches;
+		else if (bvhPackets[i].foundCollision)
+		{
+			++numHits;
+			if (fabsf(bvhPackets[i].nearestDistance - expectedPackets[i].nearestDistance) > 0.0001f)
+				++numMismatches;
+		}
+	}
+	printf("%d swept ellipsoids, %d collisions, %d mismatches\n", numQueries, numHits, numMismatches);
+	printf("  every triangle:  %.4f ms/ellipsoid\n", bruteForceTime / numQueries);
+	printf("  TriangleBvh:     %.4f ms/ellipsoid\n", bvhTime / numQueries);
+
+	// boxes
+	numMismatches = 0;
+	stl::vector<uint> overlapping;
+	for (uint i = 0; i < numQueries; ++i)
+	{
+		Vector3 center(RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f), 0.0f, RandomFloat(-WORLD_SIZE / 2.0f, WORLD_SIZE / 2.0f));
+		BoundingBox box(center, RandomFloat(0.1f, 2.0f));
+
+		uint expectedCount = 0;
+		for (uint j = 0; j < vertices.size(); j += 3)
+		{
+			const Vector3 &a = vertices[j];
+			const Vector3 &b = vertices[j + 1];
+			const Vector3 &c = vertices[j + 2];
+			BoundingBox triangleBounds;
+			triangleBounds.min = Vector3(Min(a.x, Min(b.x, c.x)), Min(a.y, Min(b.y, c.y)), Min(a.z, Min(b.z, c.z)));
+			triangleBounds.max = Vector3(Max(a.x, Max(b.x, c.x)), Max(a.y, Max(b.y, c.y)), Max(a.z, Max(b.z, c.z)));
+			if (IntersectionTester::Test(box, triangleBounds))
+				++expectedCount;
+		}
+
+		overlapping.clear();
+		if (loadedBvh.GetOverlappingTriangles(box, overlapping) != expectedCount)
+			++numMismatches;
+	}
+	printf("%d boxes, %d mismatches\n", numQueries, numMismatches);
+
+	return 0;
+}
@@ -0,0 +1,156 @@
+// Measures how long Frustum takes to cull a large number of boxes and
+// spheres each frame, comparing testing them one at a time with Test()
+// against the batch TestBoxes() / TestSpheres() functions. Also checks
+// that both give the same results.
+//
+// Usage: frustumbenchmark [number of objects] [number of frames]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <stl/vector.h>
+
+#include "../../src/framework/debug.h"
+#include "../../src/framework/math/boundingbox.h"
+#include "../../src/framework/math/boundingboxarray.h"
+#include "../../src/framework/math/boundingsphere.h"
+#include "../../src/framework/math/boundingspherearray.h"
+#include "../../src/framework/math/frustum.h"
+#include "../../src/framework/math/matrix4x4.h"
+#include "../../src/framework/math/vector3.h"
+
+const uint DEFAULT_NUM_OBJECTS = 50000;
+const uint DEFAULT_NUM_FRAMES = 200;
+const float WORLD_SIZE = 1000.0f;
+const float MAX_OBJECT_SIZE = 10.0f;
+
+static float RandomFloat(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static double GetMilliseconds(clock_t start, clock_t end, uint numFrames)
+{
+	return ((double)(end - start) * 1000.0 / (double)CLOCKS_PER_SEC) / (double)numFrames;
+}
+
+int main(int argc, char **argv)
+{
+	uint numObjects = (argc > 1 ? (uint)atoi(argv[1]) : DEFAULT_NUM_OBJECTS);
+	uint numFrames = (argc > 2 ? (uint)atoi(argv[2]) : DEFAULT_NUM_FRAMES);
+	if (numObjects == 0 || numFrames == 0)
+	{
+		fprintf(stderr, "Usage: frustumbenchmark [number of objects] [number of frames]\n");
+		return 1;
+	}
+
+	srand(1);
+
+	stl::vector<BoundingBox> boxList(numObjects);
+	stl::vector<BoundingSphere> sphereList(numObjects);
+	BoundingBoxArray boxes;
+	BoundingSphereArray spheres;
+	for (uint i = 0; i < numObjects; ++i)
+	{
+		Vector3 center(RandomFloat(-WORLD_SIZE, WORLD_SIZE), RandomFloat(-WORLD_SIZE / 10.0f, WORLD_SIZE / 10.0f), RandomFloat(-WORLD_SIZE, WORLD_SIZE));
+		float size = RandomFloat(0.5f, MAX_OBJECT_SIZE);
+		boxList[i] = BoundingBox(center, size);
+		sphereList[i] = BoundingSphere(center, size);
+		boxes.Add(boxList[i]);
+		spheres.Add(sphereList[i]);
+	}
+
+	uint numWords = (numObjects + 31) / 32;
+	stl::vector<uint32_t> visibility(numWords);
+	stl::vector<uint8_t> lastRejectingPlanes(numObjects, 0);
+	stl::vector<bool> expected(numObjects);
+
+	Frustum frustum(NULL);
+	Matrix4x4 projection = Matrix4x4::CreatePerspectiveFieldOfView(DegreesToRadians(60.0f), 16.0f / 9.0f, 1.0f, WORLD_SIZE / 2.0f);
+
+	double boxTimes[3] = { 0.0, 0.0, 0.0 };
+	double sphereTimes[3] = { 0.0, 0.0, 0.0 };
+	uint numVisible = 0;
+	uint numMismatches = 0;
+
+	for (uint frame = 0; frame < numFrames; ++frame)
+	{
+		// camera slowly spins around at the center of the world, like it
+		// would in a game, so plane coherency gets a chance to work
+		float angle = (float)frame * 0.01f;
+		Vector3 forward(cosf(angle), 0.0f, sinf(angle));
+		Matrix4x4 modelview = Matrix4x4::CreateLookAt(ZERO_VECTOR, forward, UP);
+		frustum.Calculate(projection, modelview);
+
+		clock_t start = clock();
+		for (uint i = 0; i < numObjects; ++i)
+			expected[i] = frustum.Test(boxList[i]);
+		clock_t end = clock();
+		boxTimes[0] += GetMilliseconds(start, end, numFrames);
+
+		start = clock();
+		frustum.TestBoxes(boxes, visibility.data());
+		end = clock();
+		boxTimes[1] += GetMilliseconds(start, end, numFrames);
+
+		start = clock();
+		frustum.TestBoxes(boxes, visibility.data(), lastRejectingPlanes.data());
+		end = clock();
+		boxTimes[2] += GetMilliseconds(start, end, numFrames);
+
+		for (uint i = 0; i < numObjects; ++i)
+		{
+			if (Frustum::IsVisible(visibility.data(), i) != expected[i])
+				++numMismatches;
+			if (expected[i])
+				++numVisible;
+		}
+	}
+	printf("%d boxes, %d frames, %.1f%% visible on average, %d mismatches\n", numObjects, numFrames, 100.0 * numVisible / ((double)numObjects * numFrames), numMismatches);
+	printf("  Test():                            %.3f ms/frame\n", boxTimes[0]);
+	printf("  TestBoxes():                       %.3f ms/frame\n", boxTimes[1]);
+	printf("  TestBoxes() with plane coherency:  %.3f ms/frame\n", boxTimes[2]);
+
+	numVisible = 0;
+	numMismatches = 0;
+	for (uint i = 0; i < numObjects; ++i)
+		lastRejectingPlanes[i] = 0;
+
+	for (uint frame = 0; frame < numFrames; ++frame)
+	{
+		float angle = (float)frame * 0.01f;
+		Vector3 forward(cosf(angle), 0.0f, sinf(angle));
+		Matrix4x4 modelview = Matrix4x4::CreateLookAt(ZERO_VECTOR, forward, UP);
+		frustum.Calculate(projection, modelview);
+
+		clock_t start = clock();
+		for (uint i = 0; i < numObjects; ++i)
+			expected[i] = frustum.Test(sphereList[i]);
+		clock_t end = clock();
+		sphereTimes[0] += GetMilliseconds(start, end, numFrames);
+
+		start = clock();
+		frustum.TestSpheres(spheres, visibility.data());
+		end = clock();
+		sphereTimes[1] += GetMilliseconds(start, end, numFrames);
+
+		start = clock();
+		frustum.TestSpheres(spheres, visibility.data(), lastRejectingPlanes.data());
+		end = clock();
+		sphereTimes[2] += GetMilliseconds(start, end, numFrames);
+
+		for (uint i = 0; i < numObjects; ++i)
+		{
+			if (Frustum::IsVisible(visibility.data(), i) != expected[i])
+				++numMismatches;
+			if (expected[i])
+				++numVisible;
+		}
+	}
+	printf("%d spheres, %d frames, %.1f%% visible on average, %d mismatches\n", numObjects, numFrames, 100.0 * numVisible / ((double)numObjects * numFrames), numMismatches);
+	printf("  Test():                            %.3f ms/frame\n", sphereTimes[0]);
+	printf("  TestSpheres():                     %.3f ms/frame\n", sphereTimes[1]);
+	printf("  TestSpheres() with plane coherency: %.3f ms/frame\n", sphereTimes[2]);
+
+	return 0;
+}
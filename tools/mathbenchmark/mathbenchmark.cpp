@@ -0,0 +1,324 @@
+// Checks the results of the math types' SIMD code paths against simple
+// reference implementations and measures how long they take. Build with
+// NO_SIMD defined to measure the scalar code paths instead.
+//
+// Usage: mathbenchmark [number of iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../../src/framework/debug.h"
+#include "../../src/framework/math/matrix4x4.h"
+#include "../../src/framework/math/quaternion.h"
+#include "../../src/framework/math/simdfloat4.h"
+#include "../../src/framework/math/vector3.h"
+#include "../../src/framework/math/vector4.h"
+
+const uint DEFAULT_NUM_ITERATIONS = 2000000;
+const uint NUM_INPUTS = 1024;
+
+// the SIMD paths round differently here and there, but not by much
+const double MAX_ERROR = 0.0001;
+const double MAX_SLERP_ERROR = 0.001;
+
+static Matrix4x4 matrices[NUM_INPUTS];
+static Vector3 vectors3[NUM_INPUTS];
+static Vector4 vectors4[NUM_INPUTS];
+static Quaternion quaternions[NUM_INPUTS];
+
+static float RandomFloat(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static Quaternion RandomQuaternion()
+{
+	Vector3 axis(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+	if (Vector3::LengthSquared(axis) < 0.0001f)
+		axis = UP;
+	return Quaternion::CreateFromAxisAngle(RandomFloat(-PI, PI), Vector3::Normalize(axis));
+}
+
+static Matrix4x4 RandomMatrix()
+{
+	// typical world transform: rotation, non-uniform scale and translation
+	Matrix4x4 m = RandomQuaternion().ToMatrix();
+	m = m * Matrix4x4::CreateScale(RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f), RandomFloat(0.5f, 2.0f));
+	m = Matrix4x4::CreateTranslation(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f)) * m;
+	return m;
+}
+
+static double GetMilliseconds(clock_t start, clock_t end)
+{
+	return (double)(end - start) * 1000.0 / (double)CLOCKS_PER_SEC;
+}
+
+static void ReportError(const char *name, double error, double maxError, bool &passed)
+{
+	bool ok = (error <= maxError);
+	printf("  %-12s max error %g %s\n", name, error, (ok ? "" : "FAILED"));
+	if (!ok)
+		passed = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// reference implementations, in double precision and written without
+// caring about speed
+
+static void ReferenceMultiply(const Matrix4x4 &a, const Matrix4x4 &b, double *out)
+{
+	for (int column = 0; column < 4; ++column)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			double sum = 0.0;
+			for (int k = 0; k < 4; ++k)
+				sum += (double)a.m[k * 4 + row] * (double)b.m[column * 4 + k];
+			out[column * 4 + row] = sum;
+		}
+	}
+}
+
+static void ReferenceTransform(const Matrix4x4 &m, const double *v, int numComponents, double w, double *out)
+{
+	for (int row = 0; row < 4; ++row)
+	{
+		double sum = (double)m.m[12 + row] * w;
+		for (int k = 0; k < numComponents; ++k)
+			sum += (double)m.m[k * 4 + row] * v[k];
+		out[row] = sum;
+	}
+}
+
+static void ReferenceNormalize(const float *v, double *out)
+{
+	double length = sqrt((double)v[0] * v[0] + (double)v[1] * v[1] + (double)v[2] * v[2] + (double)v[3] * v[3]);
+	for (int i = 0; i < 4; ++i)
+		out[i] = v[i] / length;
+}
+
+static void ReferenceSlerp(const Quaternion &a, const Quaternion &b, double t, double *out)
+{
+	double qa[4] = { a.x, a.y, a.z, a.w };
+	double qb[4] = { b.x, b.y, b.z, b.w };
+	double cosAngle = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+	if (cosAngle < 0.0)
+	{
+		for (int i = 0; i < 4; ++i)
+			qb[i] = -qb[i];
+		cosAngle = -cosAngle;
+	}
+	if (cosAngle > 1.0)
+		cosAngle = 1.0;
+
+	double angle = acos(cosAngle);
+	double blendA = 1.0 - t;
+	double blendB = t;
+	if (angle > 0.000001)
+	{
+		blendA = sin(angle * (1.0 - t)) / sin(angle);
+		blendB = sin(angle * t) / sin(angle);
+	}
+
+	double length = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		out[i] = qa[i] * blendA + qb[i] * blendB;
+		length += out[i] * out[i];
+	}
+	length = sqrt(length);
+	for (int i = 0; i < 4; ++i)
+		out[i] /= length;
+}
+
+static double MaxDifference(const float *a, const double *b, int count)
+{
+	double error = 0.0;
+	for (int i = 0; i < count; ++i)
+	{
+		// relative for large values (e.g. translations), absolute otherwise
+		double difference = fabs((double)a[i] - b[i]) / (fabs(b[i]) > 1.0 ? fabs(b[i]) : 1.0);
+		if (difference > error)
+			error = difference;
+	}
+	return error;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool CheckResults()
+{
+	bool passed = true;
+	double error;
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		const Matrix4x4 &a = matrices[i];
+		const Matrix4x4 &b = matrices[(i + 1) % NUM_INPUTS];
+		double expected[16];
+		ReferenceMultiply(a, b, expected);
+		Matrix4x4 result = a * b;
+		error = Max(error, MaxDifference(result.m, expected, 16));
+	}
+	ReportError("mul", error, MAX_ERROR, passed);
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		// the inverse times the original should be the identity
+		Matrix4x4 inverse = Matrix4x4::Inverse(matrices[i]);
+		double product[16];
+		ReferenceMultiply(matrices[i], inverse, product);
+		error = Max(error, MaxDifference(IDENTITY_MATRIX.m, product, 16));
+	}
+	ReportError("inverse", error, MAX_ERROR, passed);
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		const Vector3 &v = vectors3[i];
+		double in[3] = { v.x, v.y, v.z };
+		double expected[4];
+		ReferenceTransform(matrices[i], in, 3, 1.0, expected);
+		Vector3 result = v * matrices[i];
+		error = Max(error, MaxDifference(&result.x, expected, 3));
+
+		ReferenceTransform(matrices[i], in, 3, 0.0, expected);
+		result = Matrix4x4::TransformUsingRotationOnly(matrices[i], v);
+		error = Max(error, MaxDifference(&result.x, expected, 3));
+	}
+	ReportError("transform3", error, MAX_ERROR, passed);
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		const Vector4 &v = vectors4[i];
+		double in[3] = { v.x, v.y, v.z };
+		double expected[4];
+		ReferenceTransform(matrices[i], in, 3, v.w, expected);
+		Vector4 result = v * matrices[i];
+		error = Max(error, MaxDifference(&result.x, expected, 4));
+	}
+	ReportError("transform4", error, MAX_ERROR, passed);
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		double expected[4];
+		ReferenceNormalize(&vectors4[i].x, expected);
+		Vector4 result = Vector4::Normalize(vectors4[i]);
+		error = Max(error, MaxDifference(&result.x, expected, 4));
+
+		Quaternion q = quaternions[i] * 3.0f;
+		ReferenceNormalize(&q.x, expected);
+		Quaternion resultQ = Quaternion::Normalize(q);
+		error = Max(error, MaxDifference(&resultQ.x, expected, 4));
+	}
+	ReportError("normalize", error, MAX_ERROR, passed);
+
+	error = 0.0;
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		const Quaternion &a = quaternions[i];
+		const Quaternion &b = quaternions[(i + 1) % NUM_INPUTS];
+		float t = (float)(i % 11) / 10.0f;
+		double expected[4];
+		ReferenceSlerp(a, b, t, expected);
+		Quaternion result = Quaternion::Slerp(a, b, t);
+		error = Max(error, MaxDifference(&result.x, expected, 4));
+	}
+	ReportError("slerp", error, MAX_SLERP_ERROR, passed);
+
+	return passed;
+}
+
+static void RunBenchmarks(uint numIterations)
+{
+	// results get summed up so that the compiler can't skip any of the work
+	float sink = 0.0f;
+	clock_t start;
+	clock_t end;
+
+	start = clock();
+	Matrix4x4 m = IDENTITY_MATRIX;
+	for (uint i = 0; i < numIterations; ++i)
+		m = matrices[i % NUM_INPUTS] * matrices[(i + 7) % NUM_INPUTS];
+	sink += m.m[0];
+	end = clock();
+	printf("  %-12s %.2f ns/op\n", "mul", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	start = clock();
+	for (uint i = 0; i < numIterations; ++i)
+		sink += Matrix4x4::Inverse(matrices[i % NUM_INPUTS]).m[_14];
+	end = clock();
+	printf("  %-12s %.2f ns/op\n", "inverse", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	// transforming a list of vertices by the same matrix is the usual case
+	static Vector3 transformed3[NUM_INPUTS];
+	start = clock();
+	for (uint i = 0; i < numIterations; ++i)
+		transformed3[i % NUM_INPUTS] = vectors3[i % NUM_INPUTS] * matrices[(i / NUM_INPUTS) % NUM_INPUTS];
+	end = clock();
+	sink += transformed3[0].x;
+	printf("  %-12s %.2f ns/op\n", "transform3", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	static Vector4 transformed4[NUM_INPUTS];
+	start = clock();
+	for (uint i = 0; i < numIterations; ++i)
+		transformed4[i % NUM_INPUTS] = vectors4[i % NUM_INPUTS] * matrices[(i / NUM_INPUTS) % NUM_INPUTS];
+	end = clock();
+	sink += transformed4[0].x;
+	printf("  %-12s %.2f ns/op\n", "transform4", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	start = clock();
+	for (uint i = 0; i < numIterations; ++i)
+		sink += Quaternion::Normalize(quaternions[i % NUM_INPUTS]).x;
+	end = clock();
+	printf("  %-12s %.2f ns/op\n", "normalize", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	start = clock();
+	for (uint i = 0; i < numIterations; ++i)
+		sink += Quaternion::Slerp(quaternions[i % NUM_INPUTS], quaternions[(i + 1) % NUM_INPUTS], 0.3f).x;
+	end = clock();
+	printf("  %-12s %.2f ns/op\n", "slerp", GetMilliseconds(start, end) * 1000000.0 / numIterations);
+
+	printf("(%g)\n", sink);
+}
+
+int main(int argc, char **argv)
+{
+	uint numIterations = (argc > 1 ? (uint)atoi(argv[1]) : DEFAULT_NUM_ITERATIONS);
+	if (numIterations == 0)
+	{
+		fprintf(stderr, "Usage: mathbenchmark [number of iterations]\n");
+		return 1;
+	}
+
+#if defined(SIMD_SSE)
+	printf("Using SSE\n");
+#elif defined(SIMD_NEON)
+	printf("Using NEON\n");
+#else
+	printf("Using scalar code\n");
+#endif
+
+	srand(1);
+	for (uint i = 0; i < NUM_INPUTS; ++i)
+	{
+		matrices[i] = RandomMatrix();
+		vectors3[i] = Vector3(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f));
+		vectors4[i] = Vector4(RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(-100.0f, 100.0f), RandomFloat(0.5f, 2.0f));
+		quaternions[i] = RandomQuaternion();
+	}
+
+	printf("Checking results:\n");
+	bool passed = CheckResults();
+
+	printf("Timing %d iterations:\n", numIterations);
+	RunBenchmarks(numIterations);
+
+	return (passed ? 0 : 1);
+}
@@ -0,0 +1,254 @@
+// Converts an image file (anything stb_image can read) into a converted
+// texture file that the framework's TextureLoader can upload directly,
+// without needing to decode anything at load time. See
+// src/framework/graphics/texturefileformat.h for the file layout.
+//
+// Usage: textureconverter [options] <input image> <output .tex file>
+//
+// Options:
+//   -nomips         don't generate mipmaps
+//   -premultiply    multiply color components by alpha (RGBA images only)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <stb_image.h>
+#include "../../src/framework/graphics/texturefileformat.h"
+
+struct MipLevel
+{
+	uint width;
+	uint height;
+	std::vector<uint8_t> pixels;
+};
+
+static bool IsPowerOfTwo(uint n)
+{
+	return n != 0 && (n & (n - 1)) == 0;
+}
+
+static void Premultiply(std::vector<uint8_t> &pixels)
+{
+	for (size_t i = 0; i < pixels.size(); i += 4)
+	{
+		uint alpha = pixels[i + 3];
+		pixels[i + 0] = (uint8_t)((pixels[i + 0] * alpha + 127) / 255);
+		pixels[i + 1] = (uint8_t)((pixels[i + 1] * alpha + 127) / 255);
+		pixels[i + 2] = (uint8_t)((pixels[i + 2] * alpha + 127) / 255);
+	}
+}
+
+static void Downsample(const MipLevel &source, MipLevel &dest, uint bytesPerPixel, bool weightByAlpha)
+{
+	dest.width = (source.width > 1 ? source.width / 2 : 1);
+	dest.height = (source.height > 1 ? source.height / 2 : 1);
+	dest.pixels.resize(dest.width * dest.height * bytesPerPixel);
+
+	// box filter. when one dimension is already down to 1 pixel, the same
+	// source pixels just get sampled twice along it
+	for (uint y = 0; y < dest.height; ++y)
+	{
+		for (uint x = 0; x < dest.width; ++x)
+		{
+			uint sx0 = Min(x * 2, source.width - 1);
+			uint sx1 = Min(x * 2 + 1, source.width - 1);
+			uint sy0 = Min(y * 2, source.height - 1);
+			uint sy1 = Min(y * 2 + 1, source.height - 1);
+			const uint8_t *samples[4] = {
+				&source.pixels[(sy0 * source.width + sx0) * bytesPerPixel],
+				&source.pixels[(sy0 * source.width + sx1) * bytesPerPixel],
+				&source.pixels[(sy1 * source.width + sx0) * bytesPerPixel],
+				&source.pixels[(sy1 * source.width + sx1) * bytesPerPixel]
+			};
+			uint8_t *out = &dest.pixels[(y * dest.width + x) * bytesPerPixel];
+
+			if (weightByAlpha)
+			{
+				// stops the color of fully transparent pixels from bleeding
+				// into neighbouring visible ones
+				uint totalAlpha = samples[0][3] + samples[1][3] + samples[2][3] + samples[3][3];
+				for (uint c = 0; c < 3; ++c)
+				{
+					uint sum = 0;
+					if (totalAlpha > 0)
+					{
+						for (uint s = 0; s < 4; ++s)
+							sum += samples[s][c] * samples[s][3];
+						out[c] = (uint8_t)((sum + totalAlpha / 2) / totalAlpha);
+					}
+					else
+					{
+						for (uint s = 0; s < 4; ++s)
+							sum += samples[s][c];
+						out[c] = (uint8_t)((sum + 2) / 4);
+					}
+				}
+				out[3] = (uint8_t)((totalAlpha + 2) / 4);
+			}
+			else
+			{
+				for (uint c = 0; c < bytesPerPixel; ++c)
+					out[c] = (uint8_t)((samples[0][c] + samples[1][c] + samples[2][c] + samples[3][c] + 2) / 4);
+			}
+		}
+	}
+}
+
+static uint32_t Align(uint32_t offset)
+{
+	return (offset + TEXTURE_FILE_DATA_ALIGNMENT - 1) / TEXTURE_FILE_DATA_ALIGNMENT * TEXTURE_FILE_DATA_ALIGNMENT;
+}
+
+static bool Write(const char *filename, const TextureFileHeader &header, const std::vector<MipLevel> &levels)
+{
+	std::vector<TextureFileMipLevel> table(levels.size());
+	uint32_t offset = Align(sizeof(TextureFileHeader) + sizeof(TextureFileMipLevel) * levels.size());
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		table[i].width = levels[i].width;
+		table[i].height = levels[i].height;
+		table[i].offset = offset;
+		table[i].size = (uint32_t)levels[i].pixels.size();
+		offset = Align(offset + table[i].size);
+	}
+
+	std::vector<uint8_t> data(offset, 0);
+	memcpy(&data[0], &header, sizeof(TextureFileHeader));
+	memcpy(&data[sizeof(TextureFileHeader)], &table[0], sizeof(TextureFileMipLevel) * table.size());
+	for (size_t i = 0; i < levels.size(); ++i)
+		memcpy(&data[table[i].offset], &levels[i].pixels[0], table[i].size);
+
+	if (!IsValidTextureFile(&data[0], data.size()))
+	{
+		fprintf(stderr, "Error: generated texture file failed validation.\n");
+		return false;
+	}
+
+	FILE *fp = fopen(filename, "wb");
+	if (fp == NULL)
+	{
+		fprintf(stderr, "Error: could not open \"%s\" for writing.\n", filename);
+		return false;
+	}
+	bool success = (fwrite(&data[0], 1, data.size(), fp) == data.size());
+	fclose(fp);
+
+	if (!success)
+		fprintf(stderr, "Error: could not write to \"%s\".\n", filename);
+	return success;
+}
+
+int main(int argc, char **argv)
+{
+	bool generateMips = true;
+	bool premultiply = false;
+	const char *inputFilename = NULL;
+	const char *outputFilename = NULL;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-nomips") == 0)
+			generateMips = false;
+		else if (strcmp(argv[i], "-premultiply") == 0)
+			premultiply = true;
+		else if (inputFilename == NULL)
+			inputFilename = argv[i];
+		else if (outputFilename == NULL)
+			outputFilename = argv[i];
+	}
+	if (inputFilename == NULL || outputFilename == NULL)
+	{
+		fprintf(stderr, "Usage: textureconverter [-nomips] [-premultiply] <input image> <output%s file>\n", TEXTURE_FILE_EXTENSION);
+		return 1;
+	}
+
+	int width;
+	int height;
+	int componentsPerPixel;
+	uint8_t *pixels = stbi_load(inputFilename, &width, &height, &componentsPerPixel, 0);
+	if (pixels == NULL)
+	{
+		fprintf(stderr, "Error: could not load \"%s\": %s\n", inputFilename, stbi_failure_reason());
+		return 1;
+	}
+
+	// greyscale images are treated as alpha-only, the same as font glyphs
+	// are. greyscale + alpha gets expanded out to RGBA
+	TEXTURE_FORMAT format;
+	uint bytesPerPixel;
+	if (componentsPerPixel == 1)
+	{
+		format = TEXTURE_FORMAT_ALPHA;
+		bytesPerPixel = 1;
+	}
+	else if (componentsPerPixel == 3)
+	{
+		format = TEXTURE_FORMAT_RGB;
+		bytesPerPixel = 3;
+	}
+	else
+	{
+		format = TEXTURE_FORMAT_RGBA;
+		bytesPerPixel = 4;
+	}
+
+	std::vector<MipLevel> levels(1);
+	levels[0].width = (uint)width;
+	levels[0].height = (uint)height;
+	levels[0].pixels.resize(width * height * bytesPerPixel);
+	if (componentsPerPixel == 2)
+	{
+		for (int i = 0; i < width * height; ++i)
+		{
+			levels[0].pixels[i * 4 + 0] = pixels[i * 2];
+			levels[0].pixels[i * 4 + 1] = pixels[i * 2];
+			levels[0].pixels[i * 4 + 2] = pixels[i * 2];
+			levels[0].pixels[i * 4 + 3] = pixels[i * 2 + 1];
+		}
+	}
+	else
+		memcpy(&levels[0].pixels[0], pixels, levels[0].pixels.size());
+	stbi_image_free(pixels);
+
+	if (premultiply && format != TEXTURE_FORMAT_RGBA)
+	{
+		fprintf(stderr, "Warning: image has no alpha channel, ignoring -premultiply.\n");
+		premultiply = false;
+	}
+	if (premultiply)
+		Premultiply(levels[0].pixels);
+
+	if (generateMips && (!IsPowerOfTwo(levels[0].width) || !IsPowerOfTwo(levels[0].height)))
+	{
+		fprintf(stderr, "Warning: %d x %d image is not a power of two size, not generating mipmaps.\n", width, height);
+		generateMips = false;
+	}
+	if (generateMips)
+	{
+		// premultiplied pixels can just be averaged directly
+		bool weightByAlpha = (format == TEXTURE_FORMAT_RGBA && !premultiply);
+		uint32_t numLevels = GetTextureFileFullMipLevelCount(levels[0].width, levels[0].height);
+		levels.resize(numLevels);
+		for (uint32_t i = 1; i < numLevels; ++i)
+			Downsample(levels[i - 1], levels[i], bytesPerPixel, weightByAlpha);
+	}
+
+	TextureFileHeader header;
+	memset(&header, 0, sizeof(TextureFileHeader));
+	memcpy(header.id, TEXTURE_FILE_ID, sizeof(header.id));
+	header.version = TEXTURE_FILE_VERSION;
+	header.width = levels[0].width;
+	header.height = levels[0].height;
+	header.format = format;
+	header.numMipLevels = (uint32_t)levels.size();
+	header.flags = (premultiply ? TEXTURE_FILE_FLAG_PREMULTIPLIED_ALPHA : 0);
+
+	if (!Write(outputFilename, header, levels))
+		return 1;
+
+	printf("Converted \"%s\" to \"%s\" (%d x %d, %d bytes per pixel, %d mip levels%s)\n",
+		   inputFilename, outputFilename, width, height, bytesPerPixel, header.numMipLevels, (premultiply ? ", premultiplied alpha" : ""));
+	return 0;
+}